@@ -9,6 +9,8 @@
 #include <benchmark/benchmark.h>
 #include <trivia/util.h>
 
+#include "box/hint_search.h"
+
 #define BPS_TREE_NO_DEBUG 1
 
 /* A simple test tree. */
@@ -84,6 +86,56 @@
 #undef bps_tree_key_t
 #undef BPS_INNER_CARD
 
+/*
+ * Tree of hinted elements with the block search narrowed by hints, like
+ * the one of a memtx tree index with hints.
+ */
+
+struct treeh_i64_elem_t {
+	int64_t value;
+	hint_t hint;
+
+	treeh_i64_elem_t(int64_t value = 0) : value(value), hint(value) {}
+};
+
+static inline void
+treeh_i64_narrow(struct treeh_i64_elem_t **begin,
+		 struct treeh_i64_elem_t **end, hint_t hint)
+{
+	size_t lt, le;
+	if (hint_search == NULL ||
+	    !hint_search(*begin, *end - *begin, hint, &lt, &le))
+		return;
+	*end = *begin + le;
+	*begin += lt;
+}
+
+#define treeh_i64_EXTENT_SIZE 8192
+#define treeh_i64_key_t int64_t
+#define BPS_TREE_NAME treeh_i64_t
+#define BPS_TREE_BLOCK_SIZE 512
+#define BPS_TREE_EXTENT_SIZE treeh_i64_EXTENT_SIZE
+#define BPS_TREE_IS_IDENTICAL(a, b) ((a).value == (b).value)
+#define BPS_TREE_COMPARE(a, b, arg) ((a).value - (b).value)
+#define BPS_TREE_COMPARE_KEY(a, b, arg) ((a).value - (b))
+#define BPS_TREE_NARROW_KEY(begin, end, key, arg) \
+	treeh_i64_narrow(begin, end, key)
+#define BPS_TREE_NARROW_ELEM(begin, end, elem, arg) \
+	treeh_i64_narrow(begin, end, (elem).hint)
+#define bps_tree_elem_t struct treeh_i64_elem_t
+#define bps_tree_key_t treeh_i64_key_t
+#include "salad/bps_tree.h"
+#undef BPS_TREE_NAME
+#undef BPS_TREE_BLOCK_SIZE
+#undef BPS_TREE_EXTENT_SIZE
+#undef BPS_TREE_IS_IDENTICAL
+#undef BPS_TREE_COMPARE
+#undef BPS_TREE_COMPARE_KEY
+#undef BPS_TREE_NARROW_KEY
+#undef BPS_TREE_NARROW_ELEM
+#undef bps_tree_elem_t
+#undef bps_tree_key_t
+
 /**
  * Generate the benchmark variations required.
  */
@@ -199,6 +251,7 @@ public: \
 	using tree_t = tree##_t; \
 	using elem_t = tree##_elem_t; \
 	using key_t = tree##_key_t; \
+	using builder_t = struct tree##_t_builder; \
 	using Allocator_Base = \
 		DummyAllocator<tree##_EXTENT_SIZE>; \
 	struct Allocator: public Allocator_Base { \
@@ -221,6 +274,9 @@ public: \
 						    max_count_in_inner; \
 	static constexpr auto create = ::tree##_t_create; \
 	static constexpr auto build = ::tree##_t_build; \
+	static constexpr auto build_begin = ::tree##_t_build_begin; \
+	static constexpr auto build_next = ::tree##_t_build_next; \
+	static constexpr auto build_end = ::tree##_t_build_end; \
 	static constexpr auto destroy = ::tree##_t_destroy; \
 	static constexpr auto find = ::tree##_t_find; \
 	static constexpr auto insert = ::tree##_t_insert; \
@@ -231,6 +287,7 @@ public: \
 CREATE_TREE_CLASS(tree_i64);
 CREATE_TREE_CLASS(treecc_i64);
 CREATE_TREE_CLASS(treeic_i64);
+CREATE_TREE_CLASS(treeh_i64);
 
 /**
  * Value generators to make key-independent benchmarks.
@@ -342,6 +399,66 @@ test_build(benchmark::State &state, size_t count)
 
 generate_benchmarks_size(build, 1000000);
 
+/*
+ * Building a tree from a sorted stream of elements with the given fill
+ * factor. Compare with insert_sorted, which builds the same tree by
+ * inserting the elements one by one.
+ */
+
+template<class tree>
+static void
+test_build_stream(benchmark::State &state, size_t count, double fill_factor)
+{
+	typename tree::Allocator allocator(count);
+	for (auto _ : state) {
+		typename tree::tree_t t;
+		typename tree::builder_t builder;
+		tree::create(&t, 0, &allocator.matras_allocator, NULL);
+		tree::build_begin(&t, &builder, count, fill_factor);
+		for (size_t i = 0; i < count; i++)
+			tree::build_next(&builder, i);
+		tree::build_end(&builder);
+		tree::destroy(&t);
+		allocator.reset();
+	}
+}
+
+template<class tree>
+static void
+test_build_stream_fill_100(benchmark::State &state, size_t count)
+{
+	test_build_stream<tree>(state, count, 1);
+}
+
+generate_benchmarks_size(build_stream_fill_100, 1000000);
+
+template<class tree>
+static void
+test_build_stream_fill_75(benchmark::State &state, size_t count)
+{
+	test_build_stream<tree>(state, count, 0.75);
+}
+
+generate_benchmarks_size(build_stream_fill_75, 1000000);
+
+template<class tree>
+static void
+test_insert_sorted(benchmark::State &state, size_t count)
+{
+	typename tree::Allocator allocator(count * 2);
+	typename tree::elem_t replaced, successor;
+	for (auto _ : state) {
+		typename tree::tree_t t;
+		tree::create(&t, 0, &allocator.matras_allocator, NULL);
+		for (size_t i = 0; i < count; i++)
+			tree::insert(&t, i, &replaced, &successor);
+		tree::destroy(&t);
+		allocator.reset();
+	}
+}
+
+generate_benchmarks_size(insert_sorted, 1000000);
+
 template<class tree, class KeyGen>
 static void
 test_find(benchmark::State &state, size_t count, KeyGen kg)
@@ -565,6 +682,49 @@ test_insert_rand(benchmark::State &state, size_t count)
 
 generate_benchmarks_size_iterations(insert_rand, 1000000);
 
+/*
+ * Random insertions into a tree built with the given fill factor: the
+ * free space left in blocks on build saves block splits.
+ */
+
+template<class tree>
+static void
+test_insert_rand_after_build(benchmark::State &state, size_t count,
+			     double fill_factor)
+{
+	typename tree::Allocator allocator(count * 4);
+	typename tree::tree_t t;
+	typename tree::builder_t builder;
+	tree::create(&t, 0, &allocator.matras_allocator, NULL);
+	tree::build_begin(&t, &builder, count, fill_factor);
+	for (size_t i = 0; i < count; i++)
+		tree::build_next(&builder, i * 2);
+	tree::build_end(&builder);
+	RandomKey kg(count);
+	typename tree::elem_t replaced, successor;
+	for (auto _ : state)
+		tree::insert(&t, kg() * 2 + 1, &replaced, &successor);
+	tree::destroy(&t);
+}
+
+template<class tree>
+static void
+test_insert_rand_after_build_fill_100(benchmark::State &state, size_t count)
+{
+	test_insert_rand_after_build<tree>(state, count, 1);
+}
+
+generate_benchmarks_size_iterations(insert_rand_after_build_fill_100, 1000000);
+
+template<class tree>
+static void
+test_insert_rand_after_build_fill_75(benchmark::State &state, size_t count)
+{
+	test_insert_rand_after_build<tree>(state, count, 0.75);
+}
+
+generate_benchmarks_size_iterations(insert_rand_after_build_fill_75, 1000000);
+
 template<class tree, class KeyGen>
 static void
 test_delete(benchmark::State &state, size_t count, KeyGen kg)
@@ -604,6 +764,58 @@ test_delete_rand(benchmark::State &state, size_t count)
 
 generate_benchmarks_size_iterations(delete_rand, 1000000);
 
+/*
+ * Compare the lookups and the inserts in the hinted tree with the block
+ * search narrowed by the vectorized hint search and without it.
+ */
+
+static void
+set_hint_search(bool use_hint_search)
+{
+	if (use_hint_search)
+		hint_search_init();
+	else
+		hint_search = NULL;
+}
+
+template<class tree>
+static void
+test_find_rand_hint_search(benchmark::State &state, size_t count)
+{
+	set_hint_search(true);
+	test_find_rand<tree>(state, count);
+}
+
+template<class tree>
+static void
+test_find_rand_no_hint_search(benchmark::State &state, size_t count)
+{
+	set_hint_search(false);
+	test_find_rand<tree>(state, count);
+}
+
+template<class tree>
+static void
+test_delete_insert_rand_hint_search(benchmark::State &state, size_t count)
+{
+	set_hint_search(true);
+	test_delete_insert_rand<tree>(state, count);
+}
+
+template<class tree>
+static void
+test_delete_insert_rand_no_hint_search(benchmark::State &state, size_t count)
+{
+	set_hint_search(false);
+	test_delete_insert_rand<tree>(state, count);
+}
+
+generate_benchmark_size(treeh_i64, find_rand_hint_search, 1000000);
+generate_benchmark_size(treeh_i64, find_rand_no_hint_search, 1000000);
+generate_benchmark_size(treeh_i64, delete_insert_rand_hint_search, 1000000);
+generate_benchmark_size(treeh_i64, delete_insert_rand_no_hint_search,
+			1000000);
+
 BENCHMARK_MAIN();
 
 #include "debug_warning.h"
@@ -4,6 +4,7 @@
 
 #include "box/allocator.h"
 #include "box/box.h"
+#include "box/hint_search.h"
 #include "box/index_def.h"
 #include "box/iproto_constants.h"
 #include "box/memtx_allocator.h"
@@ -90,6 +91,7 @@ class Memtx final {
 	Memtx()
 	{
 		::memory_init();
+		::hint_search_init();
 		::fiber_init(fiber_c_invoke);
 		::memtx_tx_manager_init();
 		::event_init();
@@ -125,6 +127,7 @@ class Memtx final {
 					   memtx_tuple_arena_max_size,
 					   memtx_objsize_min,
 					   /*dontdump=*/true,
+					   /*use_huge_pages=*/false,
 					   memtx_granularity, "small",
 					   memtx_alloc_factor,
 					   /*threads_num=*/0,
@@ -320,6 +323,35 @@ BENCHMARK_F(MemtxFixture, TreeGetRandomExistingKeys)
 	state.SetItemsProcessed(counter);
 }
 
+/**
+ * Same as TreeGetRandomExistingKeys, but with the vectorized hint search
+ * disabled so that tree blocks are searched with plain binary search.
+ */
+BENCHMARK_F(MemtxFixture, TreeGetRandomExistingKeysNoHintSearch)
+(benchmark::State &state)
+{
+	hint_search_f saved_hint_search = hint_search;
+	hint_search = NULL;
+	auto itr = key_subset.begin();
+	int64_t counter = 0;
+	struct tuple *t;
+	for (MAYBE_UNUSED auto _ : state) {
+		if (itr == key_subset.end()) {
+			state.PauseTiming();
+			generate_key_subset();
+			state.ResumeTiming();
+			itr = key_subset.begin();
+		}
+		benchmark::DoNotOptimize(::box_index_get(
+			sid, tree_index_id, itr->first,
+			itr->second, &t));
+		++counter;
+		++itr;
+	}
+	state.SetItemsProcessed(counter);
+	hint_search = saved_hint_search;
+}
+
 /**
  * Benchmark a `get` of one random exist key from the tree index. This benchmark
  * is supposed to exercise the CPU.
@@ -389,6 +421,35 @@ BENCHMARK_F(MemtxFixture, TreeReplaceRandomExistingKeys)
 	state.SetItemsProcessed(counter);
 }
 
+/**
+ * Same as TreeReplaceRandomExistingKeys, but with the vectorized hint search
+ * disabled so that tree blocks are searched with plain binary search.
+ */
+BENCHMARK_F(MemtxFixture, TreeReplaceRandomExistingKeysNoHintSearch)
+(benchmark::State & state)
+{
+	hint_search_f saved_hint_search = hint_search;
+	hint_search = NULL;
+	auto itr = key_subset.begin();
+	int64_t counter = 0;
+	for (MAYBE_UNUSED auto _ : state) {
+		if (itr == key_subset.end()) {
+			state.PauseTiming();
+			generate_key_subset();
+			state.ResumeTiming();
+			itr = key_subset.begin();
+		}
+		struct tuple *result;
+		if (::box_replace(sid, itr->first, itr->second, &result) != 0)
+			panic("failed to replace the tuple");
+		benchmark::DoNotOptimize(result);
+		++counter;
+		++itr;
+	}
+	state.SetItemsProcessed(counter);
+	hint_search = saved_hint_search;
+}
+
 BENCHMARK_MAIN();
 
 #include "debug_warning.h"
@@ -240,6 +240,12 @@ index_opts_validate(struct index_opts *opts)
 			 "run_size_ratio must be greater than 1");
 		return -1;
 	}
+	if (opts->compaction_strategy == index_compaction_strategy_MAX) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 "compaction_strategy must be either 'tiered' or "
+			 "'leveled'");
+		return -1;
+	}
 	if (opts->bloom_fpr <= 0 || opts->bloom_fpr > 1) {
 		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
 			 "bloom_fpr must be greater than 0 and "
@@ -422,7 +428,8 @@ index_def_new_from_tuple(struct tuple *tuple, struct space *space)
 	bool for_func_index = opts.func_id > 0;
 	key_def = key_def_new(part_def, part_count,
 			      (type != TREE ? KEY_DEF_UNORDERED : 0) |
-			      (for_func_index ? KEY_DEF_FOR_FUNC_INDEX : 0));
+			      (for_func_index ? KEY_DEF_FOR_FUNC_INDEX : 0) |
+			      (opts.prefix_hint ? KEY_DEF_PREFIX_HINT : 0));
 	if (key_def == NULL)
 		return NULL;
 	struct index_def *index_def =
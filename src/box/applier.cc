@@ -62,6 +62,9 @@
 #include "tt_static.h"
 #include "memory.h"
 #include "ssl_error.h"
+#include "space.h"
+#include "index.h"
+#include "tweaks.h"
 
 STRS(applier_state, applier_STATE);
 
@@ -74,6 +77,21 @@ enum {
 	APPLIER_THREAD_TX_MAX = 100,
 };
 
+/**
+ * The number of fibers applying independent transactions of a batch
+ * concurrently, see applier_apply_parallel(). Values less than 2
+ * disable parallel apply.
+ */
+static uint64_t applier_parallel_apply_fibers = 0;
+TWEAK_UINT(applier_parallel_apply_fibers);
+
+/**
+ * If set, the applier asks the master to compress the replication
+ * stream, provided the master supports it.
+ */
+static bool applier_stream_compression = false;
+TWEAK_BOOL(applier_stream_compression);
+
 static inline void
 applier_set_state(struct applier *applier, enum applier_state state)
 {
@@ -897,6 +915,11 @@ applier_fetch_snapshot(struct applier *applier)
 
 struct applier_read_ctx {
 	struct ibuf *ibuf;
+	/**
+	 * Rows unpacked from IPROTO_COMPRESSED_ROWS packets or NULL if
+	 * compressed packets aren't expected.
+	 */
+	struct xrow_unpack_buf *unpack_buf;
 	struct applier_tx_row *(*alloc_row)(struct applier *);
 	void (*save_body)(struct applier *, struct xrow_header *);
 };
@@ -996,6 +1019,7 @@ applier_wait_register(struct applier *applier, uint64_t row_count)
 
 	const struct applier_read_ctx ctx = {
 		.ibuf = &applier->ibuf,
+		.unpack_buf = NULL,
 		.alloc_row = tx_alloc_row,
 		.save_body = tx_save_body,
 	};
@@ -1108,7 +1132,23 @@ applier_read_tx_row(struct applier *applier, const struct applier_read_ctx *ctx,
 
 	ERROR_INJECT_YIELD(ERRINJ_APPLIER_READ_TX_ROW_DELAY);
 
-	coio_read_xrow_timeout_xc(io, ctx->ibuf, row, timeout);
+	while (true) {
+		int rc = ctx->unpack_buf == NULL ? 1 :
+			 xrow_unpack_buf_get(ctx->unpack_buf, row);
+		if (rc < 0)
+			diag_raise();
+		if (rc == 0)
+			break;
+		coio_read_xrow_timeout_xc(io, ctx->ibuf, row, timeout);
+		if (row->type != IPROTO_COMPRESSED_ROWS)
+			break;
+		if (ctx->unpack_buf == NULL) {
+			tnt_raise(ClientError, ER_PROTOCOL,
+				  "Unexpected compressed rows");
+		}
+		if (xrow_unpack_buf_put(ctx->unpack_buf, row) != 0)
+			diag_raise();
+	}
 
 	if (row->tm > 0)
 		applier->lag = ev_now(loop()) - row->tm;
@@ -1399,8 +1439,12 @@ applier_handle_raft_request(struct applier *applier, struct raft_request *req)
 	return box_raft_process(req, applier->instance_id);
 }
 
-static int
-apply_plain_tx(uint32_t replica_id, struct stailq *rows)
+/**
+ * Apply rows of a transaction and prepare it for commit. Returns the
+ * transaction to be submitted with txn_commit_submit() or NULL on error.
+ */
+static struct txn *
+applier_prepare_plain_tx(uint32_t replica_id, struct stailq *rows)
 {
 	/*
 	 * Explicitly begin the transaction so that we can
@@ -1411,7 +1455,7 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows)
 	struct txn *txn = txn_begin();
 	struct applier_tx_row *item;
 	if (txn == NULL)
-		 return -1;
+		 return NULL;
 	txn->isolation = TXN_ISOLATION_READ_COMMITTED;
 
 	stailq_foreach_entry(item, rows, next) {
@@ -1496,10 +1540,19 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows)
 	rcb->txn_last_tm = item->row.tm;
 	trigger_create(on_wal_write, applier_txn_wal_write_cb, rcb, NULL);
 	txn_on_wal_write(txn, on_wal_write);
-	return txn_commit_submit(txn);
+	return txn;
 fail:
 	txn_abort(txn);
-	return -1;
+	return NULL;
+}
+
+static int
+apply_plain_tx(uint32_t replica_id, struct stailq *rows)
+{
+	struct txn *txn = applier_prepare_plain_tx(replica_id, rows);
+	if (txn == NULL)
+		return -1;
+	return txn_commit_submit(txn);
 }
 
 /**
@@ -1740,6 +1793,361 @@ applier_apply_tx(struct applier *applier, struct stailq *rows)
 	return rc;
 }
 
+/** A transaction applied by applier_apply_parallel(). */
+struct applier_parallel_tx {
+	/** Link in applier_parallel_lane::txs. */
+	struct stailq_entry in_lane;
+	/** The transaction rows. */
+	struct stailq *rows;
+	/** Position of the transaction in the commit order. */
+	int64_t seq;
+	/**
+	 * Set if the transaction may yield before commit, i.e. all the
+	 * spaces it modifies belong to an engine supporting MVCC.
+	 * Otherwise it waits for its turn to commit before it starts.
+	 */
+	bool can_yield;
+};
+
+/** State shared by fibers applying transactions in parallel. */
+struct applier_parallel {
+	/** Sequence number of the next transaction to commit. */
+	int64_t next_commit;
+	/** Signaled when next_commit is advanced or on failure. */
+	struct fiber_cond cond;
+	/** Set if a transaction failed. The rest are not committed. */
+	bool is_failed;
+	/** The error of the first failed transaction. */
+	struct diag diag;
+	/** Id of the instance the transactions are received from. */
+	uint32_t instance_id;
+	/** Session of the applier fiber, used by the apply fibers. */
+	struct session *session;
+};
+
+/** A sequence of transactions applied one by one by one fiber. */
+struct applier_parallel_lane {
+	/** The shared state. */
+	struct applier_parallel *ctx;
+	/** Transactions to apply, linked by applier_parallel_tx::in_lane. */
+	struct stailq txs;
+	/** The fiber applying the transactions or NULL. */
+	struct fiber *fiber;
+};
+
+/**
+ * Return true if changes of the space may depend on or affect other
+ * spaces: the space has foreign keys, is referenced by foreign keys of
+ * other spaces, or has constraints, which may call functions reading
+ * other spaces. Applying such changes in a different order than on the
+ * master may fail a constraint check that passed on the master.
+ */
+static bool
+applier_space_has_dependencies(struct space *space)
+{
+	if (space->has_foreign_keys)
+		return true;
+	enum space_cache_holder_type pin_type;
+	if (space_cache_is_pinned(space, &pin_type))
+		return true;
+	struct tuple_format *format = space->format;
+	if (format->constraint_count > 0)
+		return true;
+	for (uint32_t i = 0; i < tuple_format_field_count(format); i++) {
+		if (tuple_format_field(format, i)->constraint_count > 0)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Return the lane of a parallel apply a transaction must be applied in
+ * so that it's ordered against all the conflicting transactions, or -1
+ * if the transaction must be applied alone.
+ *
+ * Transactions modifying the same primary key are assigned to the same
+ * lane. A space with unique secondary indexes is assigned to a lane as
+ * a whole, because transactions modifying different primary keys may
+ * still conflict in such a space. Transactions modifying system spaces,
+ * spaces with replace triggers, foreign keys or constraints, or spanning
+ * several lanes can't be applied in parallel with others.
+ */
+static int
+applier_parallel_tx_lane(struct stailq *rows, int lane_count, bool *can_yield)
+{
+	struct region *region = &fiber()->gc;
+	RegionGuard region_guard(region);
+	int lane = -1;
+	*can_yield = true;
+	struct applier_tx_row *item;
+	stailq_foreach_entry(item, rows, next) {
+		struct request *req = &item->req.dml;
+		if (item->row.type == IPROTO_NOP)
+			continue;
+		struct space *space = space_by_id(req->space_id);
+		if (space == NULL || space_is_system(space) ||
+		    space_has_before_replace_triggers(space) ||
+		    space_has_on_replace_triggers(space) ||
+		    applier_space_has_dependencies(space))
+			return -1;
+		struct index *pk = space_index(space, 0);
+		if (pk == NULL)
+			return -1;
+		if ((space->engine->flags & ENGINE_SUPPORTS_MVCC) == 0)
+			*can_yield = false;
+		bool lock_space = false;
+		for (uint32_t i = 1; i < space->index_count; i++) {
+			if (space->index[i]->def->opts.is_unique)
+				lock_space = true;
+		}
+		struct key_def *key_def = pk->def->key_def;
+		uint32_t hash = req->space_id;
+		if (!lock_space) {
+			const char *key;
+			uint32_t key_size;
+			switch (item->row.type) {
+			case IPROTO_INSERT:
+			case IPROTO_REPLACE:
+			case IPROTO_UPSERT:
+				key = tuple_extract_key_raw_to_region(
+					req->tuple, req->tuple_end, key_def,
+					MULTIKEY_NONE, &key_size, region);
+				if (key == NULL) {
+					diag_clear(diag_get());
+					return -1;
+				}
+				break;
+			case IPROTO_DELETE:
+			case IPROTO_UPDATE:
+				key = req->key;
+				break;
+			default:
+				return -1;
+			}
+			if (mp_decode_array(&key) != key_def->part_count)
+				return -1;
+			hash ^= key_hash(key, key_def);
+		}
+		int row_lane = hash % lane_count;
+		if (lane >= 0 && lane != row_lane)
+			return -1;
+		lane = row_lane;
+	}
+	return lane >= 0 ? lane : 0;
+}
+
+/** Wait until it's the turn of a transaction to commit. */
+static int
+applier_parallel_wait_turn(struct applier_parallel *ctx, int64_t seq)
+{
+	while (ctx->next_commit != seq && !ctx->is_failed)
+		fiber_cond_wait(&ctx->cond);
+	if (ctx->is_failed) {
+		diag_set(ClientError, ER_CASCADE_ROLLBACK);
+		return -1;
+	}
+	return 0;
+}
+
+/** Apply and commit a transaction in its turn. */
+static int
+applier_parallel_apply_tx(struct applier_parallel *ctx,
+			  struct applier_parallel_tx *ptx)
+{
+	if (!ptx->can_yield && applier_parallel_wait_turn(ctx, ptx->seq) != 0)
+		return -1;
+	struct txn *txn = applier_prepare_plain_tx(ctx->instance_id, ptx->rows);
+	if (txn == NULL)
+		return -1;
+	if (ptx->can_yield && applier_parallel_wait_turn(ctx, ptx->seq) != 0) {
+		txn_abort(txn);
+		return -1;
+	}
+	if (txn_commit_submit(txn) != 0)
+		return -1;
+	struct xrow_header *last_row =
+		&stailq_last_entry(ptx->rows, struct applier_tx_row, next)->row;
+	vclock_follow(&replicaset.applier.vclock, last_row->replica_id,
+		      last_row->lsn);
+	ctx->next_commit++;
+	fiber_cond_broadcast(&ctx->cond);
+	return 0;
+}
+
+static int
+applier_parallel_lane_f(va_list ap)
+{
+	struct applier_parallel_lane *lane =
+		va_arg(ap, struct applier_parallel_lane *);
+	struct applier_parallel *ctx = lane->ctx;
+	fiber_set_session(fiber(), ctx->session);
+	fiber_set_user(fiber(), &ctx->session->credentials);
+	int rc = 0;
+	struct applier_parallel_tx *ptx;
+	stailq_foreach_entry(ptx, &lane->txs, in_lane) {
+		rc = applier_parallel_apply_tx(ctx, ptx);
+		if (rc != 0)
+			break;
+	}
+	if (rc != 0 && !ctx->is_failed) {
+		ctx->is_failed = true;
+		diag_move(diag_get(), &ctx->diag);
+		fiber_cond_broadcast(&ctx->cond);
+	}
+	fiber_set_user(fiber(), NULL);
+	fiber_set_session(fiber(), NULL);
+	/* The error, if any, is reported by applier_apply_parallel(). */
+	return 0;
+}
+
+/**
+ * Check if a transaction may be applied by applier_apply_parallel()
+ * together with the transactions received from the given instance.
+ */
+static bool
+applier_parallel_tx_is_eligible(struct applier *applier, struct stailq *rows,
+				uint32_t replica_id)
+{
+	struct xrow_header *first_row =
+		&stailq_first_entry(rows, struct applier_tx_row, next)->row;
+	struct xrow_header *last_row =
+		&stailq_last_entry(rows, struct applier_tx_row, next)->row;
+	return applier->state != APPLIER_FINAL_JOIN &&
+	       applier->version_id >= version_id(2, 11, 0) &&
+	       last_row->lsn != 0 && first_row->replica_id == replica_id &&
+	       last_row->replica_id == replica_id &&
+	       !iproto_type_is_synchro_request(first_row->type);
+}
+
+/**
+ * Apply a sequence of independent transactions starting with @a first
+ * concurrently in several fibers. Transactions that may conflict are
+ * applied one after another by the same fiber, while the commit order
+ * matches the order the transactions are received in, so WAL and the
+ * replicaset vclock are advanced exactly as on sequential apply. The
+ * sequence ends at the first transaction that can't be applied this
+ * way, which is left for applier_apply_tx().
+ *
+ * Returns the first transaction not processed or NULL if all the rest
+ * of the batch was processed. Sets @a rc to -1 and diag on error.
+ */
+static struct applier_tx *
+applier_apply_parallel(struct applier *applier, struct applier_tx *first,
+		       int *rc)
+{
+	*rc = 0;
+	struct xrow_header *first_row =
+		&stailq_first_entry(&first->rows, struct applier_tx_row,
+				    next)->row;
+	uint32_t replica_id = first_row->replica_id;
+	struct replica *replica = replica_by_id(replica_id);
+	if (replica == NULL)
+		return first;
+	int lane_count = MIN(applier_parallel_apply_fibers,
+			     APPLIER_THREAD_TX_MAX);
+	struct region *region = &fiber()->gc;
+	RegionGuard region_guard(region);
+	struct applier_parallel_lane *lanes =
+		xregion_alloc_array(region, typeof(*lanes), lane_count);
+	struct applier_parallel ctx;
+	ctx.next_commit = 0;
+	fiber_cond_create(&ctx.cond);
+	ctx.is_failed = false;
+	diag_create(&ctx.diag);
+	ctx.instance_id = applier->instance_id;
+	ctx.session = current_session();
+	for (int i = 0; i < lane_count; i++) {
+		lanes[i].ctx = &ctx;
+		stailq_create(&lanes[i].txs);
+		lanes[i].fiber = NULL;
+	}
+	/* See applier_apply_tx() for the explanation of the checks. */
+	latch_lock(&replica->order_latch);
+	if (fiber_is_cancelled()) {
+		latch_unlock(&replica->order_latch);
+		diag_set(FiberIsCancelled);
+		*rc = -1;
+		return NULL;
+	}
+	int64_t seq = 0;
+	struct applier_tx *tx = first;
+	for (; tx != NULL; tx = stailq_next_entry(tx, next)) {
+		if (!applier_parallel_tx_is_eligible(applier, &tx->rows,
+						     replica_id))
+			break;
+		bool can_yield;
+		int lane = applier_parallel_tx_lane(&tx->rows, lane_count,
+						    &can_yield);
+		if (lane < 0)
+			break;
+		struct xrow_header *row =
+			&stailq_last_entry(&tx->rows, struct applier_tx_row,
+					   next)->row;
+		if (vclock_get(&replicaset.applier.vclock,
+			       replica_id) >= row->lsn)
+			continue;
+		while (true) {
+			row = &stailq_first_entry(&tx->rows,
+						  struct applier_tx_row,
+						  next)->row;
+			if (row->lsn > vclock_get(&replicaset.applier.vclock,
+						  replica_id))
+				break;
+			stailq_shift(&tx->rows);
+		}
+		if (applier_synchro_filter_tx(&tx->rows) != 0) {
+			/*
+			 * Apply the preceding transactions and then
+			 * report the error, like applier_apply_tx() does.
+			 */
+			*rc = -1;
+			break;
+		}
+		struct applier_parallel_tx *ptx =
+			xregion_alloc_object(region, typeof(*ptx));
+		ptx->rows = &tx->rows;
+		ptx->seq = seq++;
+		ptx->can_yield = can_yield;
+		stailq_add_tail_entry(&lanes[lane].txs, ptx, in_lane);
+	}
+	int started = 0;
+	for (int i = 0; i < lane_count; i++) {
+		if (stailq_empty(&lanes[i].txs))
+			continue;
+		struct fiber *f = fiber_new_system("applier_lane",
+						   applier_parallel_lane_f);
+		if (f == NULL) {
+			if (!ctx.is_failed) {
+				ctx.is_failed = true;
+				diag_move(diag_get(), &ctx.diag);
+				fiber_cond_broadcast(&ctx.cond);
+			}
+			break;
+		}
+		fiber_set_joinable(f, true);
+		lanes[i].fiber = f;
+		fiber_start(f, &lanes[i]);
+		started++;
+	}
+#ifndef NDEBUG
+	struct errinj *inj = errinj(ERRINJ_APPLIER_PARALLEL_LANES, ERRINJ_INT);
+	inj->iparam = MAX(inj->iparam, started);
+#else
+	(void)started;
+#endif
+	for (int i = 0; i < lane_count; i++) {
+		if (lanes[i].fiber != NULL)
+			fiber_join(lanes[i].fiber);
+	}
+	latch_unlock(&replica->order_latch);
+	fiber_cond_destroy(&ctx.cond);
+	if (ctx.is_failed) {
+		diag_move(&ctx.diag, diag_get());
+		*rc = -1;
+	}
+	return *rc == 0 ? tx : NULL;
+}
+
 /**
  * Notify the applier's write fiber that there are more ACKs to
  * send to master.
@@ -1911,8 +2319,19 @@ applier_process_batch(struct cmsg *base)
 {
 	struct applier_data_msg *msg = (struct applier_data_msg *)base;
 	struct applier *applier = msg->base.applier;
-	struct applier_tx *tx;
-	stailq_foreach_entry(tx, &msg->txs, next) {
+	struct applier_tx *tx = stailq_first_entry(&msg->txs,
+						   struct applier_tx, next);
+	for (; tx != NULL; tx = stailq_next_entry(tx, next)) {
+		if (applier_parallel_apply_fibers > 1) {
+			int rc;
+			struct applier_tx *next =
+				applier_apply_parallel(applier, tx, &rc);
+			if (rc != 0)
+				diag_raise();
+			if (next == NULL)
+				break;
+			tx = next;
+		}
 		struct applier_tx_row *last_txr =
 			stailq_last_entry(&tx->rows, struct applier_tx_row,
 					  next);
@@ -2083,6 +2502,7 @@ applier_thread_reader_f(va_list ap)
 	struct lsregion *lsr = &applier->thread.lsr;
 	const struct applier_read_ctx ctx = {
 		.ibuf = &applier->thread.ibuf,
+		.unpack_buf = &applier->thread.unpack_buf,
 		.alloc_row = thread_alloc_row,
 		.save_body = thread_save_body,
 	};
@@ -2221,6 +2641,7 @@ static void
 applier_thread_ibuf_init(struct applier *applier)
 {
 	ibuf_create(&applier->thread.ibuf, &cord()->slabc, 1024);
+	xrow_unpack_buf_create(&applier->thread.unpack_buf);
 	/*
 	 * Move unparsed data, if any, from the previously used tx ibuf to the
 	 * new buf.
@@ -2303,6 +2724,7 @@ applier_thread_detach_applier(struct cbus_call_msg *base)
 	lsregion_destroy(&applier->thread.lsr);
 	fiber_cond_destroy(&applier->thread.writer_cond);
 	ibuf_destroy(&applier->thread.ibuf);
+	xrow_unpack_buf_destroy(&applier->thread.unpack_buf);
 	diag_clear(&applier->thread.exit_msg.diag);
 
 	return 0;
@@ -2407,6 +2829,9 @@ applier_subscribe(struct applier *applier)
 	 * instance as soon as local WAL starts accepting writes.
 	 */
 	req.id_filter = box_is_waiting_for_own_rows() ? 0 : 1 << instance_id;
+	req.is_compressed = applier_stream_compression &&
+		iproto_features_test(&applier->features,
+				     IPROTO_FEATURE_REPLICATION_COMPRESSION);
 	RegionGuard region_guard(&fiber()->gc);
 	xrow_encode_subscribe(&row, &req);
 	coio_write_xrow(io, &row);
@@ -47,6 +47,7 @@
 #include "cbus.h"
 
 #include "xrow.h"
+#include "xrow_io.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -234,6 +235,8 @@ struct applier {
 		struct applier_data_msg msgs[2];
 		/** The input buffer used in thread to read rows. */
 		struct ibuf ibuf;
+		/** Rows unpacked from a compressed packet, not read yet. */
+		struct xrow_unpack_buf unpack_buf;
 		/** The lsregion for allocating rows in thread. */
 		struct lsregion lsr;
 		/** A growing identifier to track lsregion allocations. */
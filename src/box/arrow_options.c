@@ -0,0 +1,43 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2025, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "arrow_options.h"
+
+#include "trivia/util.h"
+
+box_arrow_options_t *
+box_arrow_options_new(void)
+{
+	struct arrow_options *options = xmalloc(sizeof(*options));
+	arrow_options_create(options);
+	return options;
+}
+
+void
+box_arrow_options_delete(box_arrow_options_t *options)
+{
+	free(options);
+}
+
+void
+box_arrow_options_set_batch_row_count(box_arrow_options_t *options,
+				      uint32_t batch_row_count)
+{
+	options->batch_row_count = batch_row_count;
+}
+
+void
+box_arrow_options_set_iterator(box_arrow_options_t *options,
+			       enum iterator_type iterator)
+{
+	options->iterator = iterator;
+}
+
+void
+box_arrow_options_set_force_view_types(box_arrow_options_t *options,
+				       bool force_view_types)
+{
+	options->force_view_types = force_view_types;
+}
@@ -0,0 +1,85 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2025, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "iterator_type.h"
+#include "trivia/util.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+enum {
+	/** Default max number of rows in an Arrow stream batch. */
+	ARROW_OPTIONS_BATCH_ROW_COUNT_DEFAULT = 4096,
+};
+
+/** Options of an index Arrow stream. */
+struct arrow_options {
+	/** Max number of rows in a batch returned by the stream. */
+	uint32_t batch_row_count;
+	/** Iterator type used to select rows. */
+	enum iterator_type iterator;
+	/**
+	 * Export strings and binary data with view types ("vu" and "vz")
+	 * instead of offset-based ones ("u" and "z").
+	 */
+	bool force_view_types;
+};
+
+/** Initializes Arrow stream options with default values. */
+static inline void
+arrow_options_create(struct arrow_options *options)
+{
+	options->batch_row_count = ARROW_OPTIONS_BATCH_ROW_COUNT_DEFAULT;
+	options->iterator = ITER_ALL;
+	options->force_view_types = false;
+}
+
+/** \cond public */
+
+typedef struct arrow_options box_arrow_options_t;
+
+/**
+ * Allocates Arrow stream options and initializes them with default values.
+ * Never fails. The options must be freed with box_arrow_options_delete().
+ */
+API_EXPORT box_arrow_options_t *
+box_arrow_options_new(void);
+
+/** Frees Arrow stream options. */
+API_EXPORT void
+box_arrow_options_delete(box_arrow_options_t *options);
+
+/**
+ * Sets the max number of rows in a batch returned by an Arrow stream.
+ * The default is 4096.
+ */
+API_EXPORT void
+box_arrow_options_set_batch_row_count(box_arrow_options_t *options,
+				      uint32_t batch_row_count);
+
+/** Sets the iterator type used by an Arrow stream. The default is ALL. */
+API_EXPORT void
+box_arrow_options_set_iterator(box_arrow_options_t *options,
+			       enum iterator_type iterator);
+
+/**
+ * Makes an Arrow stream export strings and binary data with view types.
+ * Not every engine supports view types. Disabled by default.
+ */
+API_EXPORT void
+box_arrow_options_set_force_view_types(box_arrow_options_t *options,
+				       bool force_view_types);
+
+/** \endcond public */
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
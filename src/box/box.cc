@@ -1876,6 +1876,19 @@ box_check_wal_retention_period()
 	return value;
 }
 
+/** Validate that wal_commit_delay is >= 0. */
+static double
+box_check_wal_commit_delay(void)
+{
+	double value = cfg_getd("wal_commit_delay");
+	if (value < 0) {
+		diag_set(ClientError, ER_CFG, "wal_commit_delay",
+			 "the value must be >= 0");
+		return -1;
+	}
+	return value;
+}
+
 /** Validate wal_retention_period and raise error, if needed. */
 static double
 box_check_wal_retention_period_xc()
@@ -1898,6 +1911,22 @@ box_check_memory_quota(const char *quota_name)
 	return -1;
 }
 
+/**
+ * Checks the vinyl_max_subcompactions configuration option.
+ * Returns the option value or -1 on error.
+ */
+static int
+box_check_vinyl_max_subcompactions(void)
+{
+	int max_subcompactions = cfg_geti("vinyl_max_subcompactions");
+	if (max_subcompactions < 1) {
+		diag_set(ClientError, ER_CFG, "vinyl_max_subcompactions",
+			 "must be greater than or equal to 1");
+		return -1;
+	}
+	return max_subcompactions;
+}
+
 static void
 box_check_vinyl_options(void)
 {
@@ -1937,6 +1966,8 @@ box_check_vinyl_options(void)
 		tnt_raise(ClientError, ER_CFG, "vinyl_bloom_fpr",
 			  "must be greater than 0 and less than or equal to 1");
 	}
+	if (box_check_vinyl_max_subcompactions() < 0)
+		diag_raise();
 }
 
 static int
@@ -2172,6 +2203,8 @@ box_check_config(void)
 		diag_raise();
 	if (box_check_wal_retention_period() < 0)
 		diag_raise();
+	if (box_check_wal_commit_delay() < 0)
+		diag_raise();
 	if (box_check_memory_quota("memtx_memory") < 0)
 		diag_raise();
 	box_check_memtx_min_tuple_size(cfg_geti64("memtx_min_tuple_size"));
@@ -3590,6 +3623,16 @@ box_set_wal_cleanup_delay(void)
 	return 0;
 }
 
+int
+box_set_wal_commit_delay(void)
+{
+	double delay = box_check_wal_commit_delay();
+	if (delay < 0)
+		return -1;
+	wal_set_commit_delay(delay);
+	return 0;
+}
+
 int
 box_set_wal_retention_period(void)
 {
@@ -3628,6 +3671,14 @@ box_set_vinyl_cache(void)
 	vinyl_engine_set_cache(vinyl, cfg_geti64("vinyl_cache"));
 }
 
+void
+box_set_vinyl_page_cache(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_page_cache(vinyl, cfg_geti64("vinyl_page_cache"));
+}
+
 void
 box_set_vinyl_timeout(void)
 {
@@ -3636,6 +3687,17 @@ box_set_vinyl_timeout(void)
 	vinyl_engine_set_timeout(vinyl,	cfg_getd("vinyl_timeout"));
 }
 
+void
+box_set_vinyl_max_subcompactions(void)
+{
+	int max_subcompactions = box_check_vinyl_max_subcompactions();
+	if (max_subcompactions < 0)
+		diag_raise();
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_max_subcompactions(vinyl, max_subcompactions);
+}
+
 void
 box_set_force_recovery(void)
 {
@@ -5306,6 +5368,8 @@ box_process_subscribe(struct iostream *io, const struct xrow_header *header)
 		 tt_uuid_str(&req.instance_uuid), sio_socketname(io->fd));
 	say_info("remote vclock %s local vclock %s",
 		 vclock_to_string(&req.vclock), vclock_to_string(&rsp.vclock));
+	if (req.is_compressed)
+		say_info("replication stream compression requested");
 	uint64_t sent_raft_term = 0;
 	if (req.version_id >= version_id(2, 6, 0) && !req.is_anon) {
 		/*
@@ -5335,7 +5399,8 @@ box_process_subscribe(struct iostream *io, const struct xrow_header *header)
 	 * indefinitely).
 	 */
 	relay_subscribe(replica, io, header->sync, &start_vclock,
-			req.version_id, req.id_filter, sent_raft_term);
+			req.version_id, req.id_filter, sent_raft_term,
+			req.is_compressed);
 }
 
 void
@@ -5445,6 +5510,7 @@ engine_init()
 				    cfg_getd("memtx_memory"),
 				    cfg_geti("memtx_min_tuple_size"),
 				    cfg_geti("strip_core"),
+				    cfg_geti("memtx_use_huge_pages"),
 				    cfg_geti("slab_alloc_granularity"),
 				    cfg_gets("memtx_allocator"),
 				    cfg_getd("slab_alloc_factor"),
@@ -5465,6 +5531,8 @@ engine_init()
 	engine_register(vinyl);
 	box_set_vinyl_max_tuple_size();
 	box_set_vinyl_cache();
+	box_set_vinyl_page_cache();
+	box_set_vinyl_max_subcompactions();
 	box_set_vinyl_timeout();
 
 	quiver_engine_register();
@@ -6127,6 +6195,8 @@ box_cfg_xc(void)
 		diag_raise();
 	if (box_set_wal_queue_max_size() != 0)
 		diag_raise();
+	if (box_set_wal_commit_delay() != 0)
+		diag_raise();
 	cfg_replication_anon = box_check_replication_anon();
 	box_broadcast_ballot();
 	/*
@@ -6634,7 +6704,7 @@ box_storage_init(void)
 	txn_limbo_init();
 	journal_on_cascading_rollback = box_on_journal_cascading_rollback;
 	replication_init(cfg_geti_default("replication_threads", 1));
-	iproto_init(cfg_geti("iproto_threads"));
+	iproto_init(cfg_geti("iproto_threads"), cfg_getb("iproto_reuseport"));
 	sql_init();
 	audit_log_init();
 	security_cfg();
@@ -0,0 +1,138 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2025, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "hint_search.h"
+
+#include <string.h>
+
+#include "cpu_feature.h"
+#include "trivia/config.h"
+#include "trivia/util.h"
+
+hint_search_f hint_search = NULL;
+
+#if defined(HAVE_CPUID) && defined(__x86_64__)
+
+#include <immintrin.h>
+
+/**
+ * Hints are unsigned while SIMD instructions compare signed integers,
+ * so the sign bit is flipped in both operands.
+ */
+#define HINT_SEARCH_SIGN_BIT ((long long)(1ULL << 63))
+
+/** Count the elements starting from the given one without SIMD. */
+static inline bool
+hint_search_tail(const char *elems, size_t begin, size_t count, hint_t hint,
+		 size_t *n_lt, size_t *n_gt)
+{
+	for (size_t i = begin; i < count; i++) {
+		hint_t elem_hint;
+		memcpy(&elem_hint, elems + i * HINT_SEARCH_ELEM_SIZE +
+		       sizeof(hint_t), sizeof(elem_hint));
+		if (elem_hint == HINT_NONE)
+			return false;
+		*n_lt += elem_hint < hint;
+		*n_gt += elem_hint > hint;
+	}
+	return true;
+}
+
+__attribute__((target("sse4.2")))
+static bool
+hint_search_sse42(const void *elems, size_t count, hint_t hint,
+		  size_t *lt, size_t *le)
+{
+	const char *data = (const char *)elems;
+	const __m128i sign = _mm_set1_epi64x(HINT_SEARCH_SIGN_BIT);
+	const __m128i none = _mm_set1_epi64x((long long)HINT_NONE);
+	const __m128i key = _mm_xor_si128(_mm_set1_epi64x((long long)hint),
+					  sign);
+	size_t n_lt = 0, n_gt = 0;
+	int has_none = 0;
+	size_t i = 0;
+	for (; i + 2 <= count; i += 2) {
+		const char *p = data + i * HINT_SEARCH_ELEM_SIZE;
+		__m128i a = _mm_loadu_si128((const __m128i *)p);
+		__m128i b = _mm_loadu_si128((const __m128i *)
+					    (p + HINT_SEARCH_ELEM_SIZE));
+		/* {payload0, hint0}, {payload1, hint1} -> {hint0, hint1} */
+		__m128i hints = _mm_unpackhi_epi64(a, b);
+		__m128i x = _mm_xor_si128(hints, sign);
+		has_none |= _mm_movemask_pd(_mm_castsi128_pd(
+			_mm_cmpeq_epi64(hints, none)));
+		n_lt += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(
+			_mm_cmpgt_epi64(key, x))));
+		n_gt += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(
+			_mm_cmpgt_epi64(x, key))));
+	}
+	if (has_none != 0 ||
+	    !hint_search_tail(data, i, count, hint, &n_lt, &n_gt))
+		return false;
+	*lt = n_lt;
+	*le = count - n_gt;
+	return true;
+}
+
+__attribute__((target("avx2")))
+static bool
+hint_search_avx2(const void *elems, size_t count, hint_t hint,
+		 size_t *lt, size_t *le)
+{
+	const char *data = (const char *)elems;
+	const __m256i sign = _mm256_set1_epi64x(HINT_SEARCH_SIGN_BIT);
+	const __m256i none = _mm256_set1_epi64x((long long)HINT_NONE);
+	const __m256i key = _mm256_xor_si256(
+		_mm256_set1_epi64x((long long)hint), sign);
+	size_t n_lt = 0, n_gt = 0;
+	int has_none = 0;
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const char *p = data + i * HINT_SEARCH_ELEM_SIZE;
+		__m256i a = _mm256_loadu_si256((const __m256i *)p);
+		__m256i b = _mm256_loadu_si256((const __m256i *)
+					       (p + 2 * HINT_SEARCH_ELEM_SIZE));
+		/*
+		 * The unpack works within 128-bit lanes, so the hints are
+		 * shuffled: {hint0, hint2, hint1, hint3}. The order doesn't
+		 * matter for counting.
+		 */
+		__m256i hints = _mm256_unpackhi_epi64(a, b);
+		__m256i x = _mm256_xor_si256(hints, sign);
+		has_none |= _mm256_movemask_pd(_mm256_castsi256_pd(
+			_mm256_cmpeq_epi64(hints, none)));
+		n_lt += __builtin_popcount(_mm256_movemask_pd(
+			_mm256_castsi256_pd(_mm256_cmpgt_epi64(key, x))));
+		n_gt += __builtin_popcount(_mm256_movemask_pd(
+			_mm256_castsi256_pd(_mm256_cmpgt_epi64(x, key))));
+	}
+	if (has_none != 0 ||
+	    !hint_search_tail(data, i, count, hint, &n_lt, &n_gt))
+		return false;
+	*lt = n_lt;
+	*le = count - n_gt;
+	return true;
+}
+
+void
+hint_search_init(void)
+{
+	if (avx2_enabled_cpu())
+		hint_search = hint_search_avx2;
+	else if (sse42_enabled_cpu())
+		hint_search = hint_search_sse42;
+	else
+		hint_search = NULL;
+}
+
+#else /* !(defined(HAVE_CPUID) && defined(__x86_64__)) */
+
+void
+hint_search_init(void)
+{
+	hint_search = NULL;
+}
+
+#endif
@@ -0,0 +1,48 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2025, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "tuple_compare.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Size of an element of the array hint_search() works with. Each element
+ * is a pointer-sized payload padded to 8 bytes followed by a hint, like
+ * the data stored in a hinted memtx tree.
+ */
+enum { HINT_SEARCH_ELEM_SIZE = 2 * sizeof(hint_t) };
+
+/**
+ * Given an array of elements sorted by their hints, counts the elements
+ * with hints less than the given hint and the elements with hints less
+ * than or equal to it. Returns false if any element has HINT_NONE, in
+ * which case the array isn't ordered by hints and nothing is counted.
+ * The given hint must not be HINT_NONE.
+ */
+typedef bool
+(*hint_search_f)(const void *elems, size_t count, hint_t hint,
+		 size_t *lt, size_t *le);
+
+/**
+ * Vectorized implementation of the hint search for the current CPU or
+ * NULL if there's none, in which case callers should do the regular
+ * binary search.
+ */
+extern hint_search_f hint_search;
+
+/** Select the hint search implementation supported by the CPU. */
+void
+hint_search_init(void);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
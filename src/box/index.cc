@@ -30,6 +30,8 @@
  */
 #include "index.h"
 #include "index_def.h"
+#include "index_aggregate.h"
+#include "arrow_options.h"
 #include "tuple.h"
 #include "say.h"
 #include "schema.h"
@@ -618,6 +620,162 @@ box_index_count(uint32_t space_id, uint32_t index_id, int type,
 	return count;
 }
 
+int
+box_index_arrow_stream(uint32_t space_id, uint32_t index_id,
+		       uint32_t field_count, const uint32_t *fields,
+		       const char *key, const char *key_end,
+		       const struct arrow_options *options,
+		       struct ArrowArrayStream *stream)
+{
+	assert(key != NULL && key_end != NULL);
+	mp_tuple_assert(key, key_end);
+	if (options->iterator >= iterator_type_MAX) {
+		diag_set(IllegalParams, "Invalid iterator type");
+		return -1;
+	}
+	if (options->batch_row_count == 0) {
+		diag_set(IllegalParams, "batch_row_count must be positive");
+		return -1;
+	}
+	if (box_check_slice() != 0)
+		return -1;
+	struct space *space;
+	struct index *index;
+	if (check_index(space_id, index_id, &space, &index) != 0)
+		return -1;
+	const char *key_array = key;
+	uint32_t part_count = mp_decode_array(&key);
+	if (iterator_validate(index->def, options->iterator, key, part_count))
+		return -1;
+	box_run_on_select(space, index, options->iterator, key_array);
+	size_t region_svp = region_used(&fiber()->gc);
+	if (fields == NULL) {
+		field_count = tuple_format_field_count(space->format);
+		uint32_t *all_fields = xregion_alloc_array(
+			&fiber()->gc, uint32_t, MAX(field_count, 1));
+		for (uint32_t i = 0; i < field_count; i++)
+			all_fields[i] = i;
+		fields = all_fields;
+	}
+	int rc = index_create_arrow_stream(index, field_count, fields,
+					   key, part_count, options, stream);
+	region_truncate(&fiber()->gc, region_svp);
+	return rc;
+}
+
+int
+box_index_aggregate(uint32_t space_id, uint32_t index_id, int type,
+		    const char *key, const char *key_end,
+		    const char *filters, const char *aggregates,
+		    const char **result, const char **result_end)
+{
+	assert(key != NULL && key_end != NULL);
+	mp_tuple_assert(key, key_end);
+	if (type < 0 || type >= iterator_type_MAX) {
+		diag_set(IllegalParams, "Invalid iterator type");
+		return -1;
+	}
+	enum iterator_type itype = (enum iterator_type) type;
+	if (box_check_slice() != 0)
+		return -1;
+	struct space *space;
+	struct index *index;
+	if (check_index(space_id, index_id, &space, &index) != 0)
+		return -1;
+	const char *key_array = key;
+	uint32_t part_count = mp_decode_array(&key);
+	if (iterator_validate(index->def, itype, key, part_count))
+		return -1;
+	box_run_on_select(space, index, itype, key_array);
+	struct region *region = &fiber()->gc;
+	struct index_filter *filter_array;
+	uint32_t filter_count;
+	if (index_filters_decode(&filters, region, &filter_array,
+				 &filter_count) != 0)
+		return -1;
+	struct index_aggregate *aggregate_array;
+	uint32_t aggregate_count;
+	if (index_aggregates_decode(&aggregates, region, &aggregate_array,
+				    &aggregate_count) != 0)
+		return -1;
+	/* Start transaction in the engine. */
+	struct txn *txn;
+	struct txn_ro_savepoint svp;
+	if (txn_begin_ro_stmt(space, &txn, &svp) != 0)
+		return -1;
+	int rc = index_aggregate(index, itype, key, part_count,
+				 filter_array, filter_count,
+				 aggregate_array, aggregate_count);
+	txn_end_ro_stmt(txn, &svp);
+	if (rc == 0) {
+		const char **values = xregion_alloc_array(
+			region, const char *, MAX(aggregate_count, 1));
+		uint32_t *sizes = xregion_alloc_array(
+			region, uint32_t, MAX(aggregate_count, 1));
+		size_t size = mp_sizeof_array(aggregate_count);
+		for (uint32_t i = 0; i < aggregate_count; i++) {
+			values[i] = index_aggregate_result(&aggregate_array[i],
+							   region, &sizes[i]);
+			size += sizes[i];
+		}
+		char *data = (char *)xregion_alloc(region, size);
+		char *data_end = mp_encode_array(data, aggregate_count);
+		for (uint32_t i = 0; i < aggregate_count; i++) {
+			memcpy(data_end, values[i], sizes[i]);
+			data_end += sizes[i];
+		}
+		assert(data_end == data + size);
+		*result = data;
+		*result_end = data_end;
+	}
+	for (uint32_t i = 0; i < aggregate_count; i++)
+		index_aggregate_destroy(&aggregate_array[i]);
+	return rc;
+}
+
+int
+box_index_get_many(uint32_t space_id, uint32_t index_id,
+		   const char *keys, const char *keys_end,
+		   box_tuple_t **result)
+{
+	assert(keys != NULL && keys_end != NULL && result != NULL);
+	mp_tuple_assert(keys, keys_end);
+	if (box_check_slice() != 0)
+		return -1;
+	struct space *space;
+	struct index *index;
+	if (check_index(space_id, index_id, &space, &index) != 0)
+		return -1;
+	uint32_t key_count = mp_decode_array(&keys);
+	const char *key = keys;
+	for (uint32_t i = 0; i < key_count; i++) {
+		if (mp_typeof(*key) != MP_ARRAY) {
+			diag_set(IllegalParams, "key must be an array");
+			return -1;
+		}
+		const char *key_array = key;
+		uint32_t part_count = mp_decode_array(&key);
+		if (exact_key_validate(index->def, key, part_count) != 0)
+			return -1;
+		box_run_on_select(space, index, ITER_EQ, key_array);
+		key = key_array;
+		mp_next(&key);
+	}
+	assert(key == keys_end);
+	/* Start transaction in the engine. */
+	struct txn *txn;
+	struct txn_ro_savepoint svp;
+	if (txn_begin_ro_stmt(space, &txn, &svp) != 0)
+		return -1;
+	int rc = index_get_many(index, keys, key_count, result);
+	txn_end_ro_stmt(txn, &svp);
+	if (rc != 0)
+		return -1;
+	/* Count statistics. */
+	rmean_collect(rmean_box, IPROTO_SELECT, key_count);
+	return 0;
+}
+
 /* }}} */
 
 /* {{{ Iterators ************************************************/
@@ -1151,6 +1309,27 @@ generic_index_get(struct index *index, const char *key,
 	return -1;
 }
 
+int
+generic_index_get_many(struct index *index, const char *keys,
+		       uint32_t key_count, struct tuple **result)
+{
+	for (uint32_t i = 0; i < key_count; i++) {
+		const char *key = keys;
+		uint32_t part_count = mp_decode_array(&key);
+		if (index_get(index, key, part_count, &result[i]) != 0) {
+			for (uint32_t j = 0; j < i; j++) {
+				if (result[j] != NULL)
+					tuple_unref(result[j]);
+			}
+			return -1;
+		}
+		if (result[i] != NULL)
+			tuple_ref(result[i]);
+		mp_next(&keys);
+	}
+	return 0;
+}
+
 int
 generic_index_replace(struct index *index, struct tuple *old_tuple,
 		      struct tuple *new_tuple, enum dup_replace_mode mode,
@@ -1251,6 +1430,256 @@ generic_index_create_arrow_stream(struct index *index,
 	return -1;
 }
 
+enum {
+	/** Max number of tuples processed by an aggregate scan at once. */
+	INDEX_AGGREGATE_BATCH_SIZE = 256,
+};
+
+/**
+ * Fields accessed by an aggregate scan. The fields of a batch of tuples
+ * are decoded at once, in one pass over each tuple, so that filters and
+ * aggregates referring to the same or neighbouring fields don't decode
+ * the tuple over and over again.
+ */
+struct index_aggregate_columns {
+	/** Number of distinct fields. */
+	uint32_t count;
+	/** Zero-based field numbers, sorted in ascending order. */
+	uint32_t *fieldno;
+	/** Set if the field is accessed via the field map of format. */
+	bool *has_offset;
+	/** Format has_offset was computed for. */
+	struct tuple_format *format;
+	/**
+	 * Decoded fields of the current batch, NULL if missing:
+	 * values[column * INDEX_AGGREGATE_BATCH_SIZE + row].
+	 */
+	const char **values;
+};
+
+/**
+ * Adds a field to the set of columns unless it's already there and
+ * returns its column number. The columns must have room for the field.
+ */
+static uint32_t
+index_aggregate_columns_add(struct index_aggregate_columns *columns,
+			    uint32_t fieldno)
+{
+	uint32_t i = 0;
+	while (i < columns->count && columns->fieldno[i] < fieldno)
+		i++;
+	if (i < columns->count && columns->fieldno[i] == fieldno)
+		return i;
+	memmove(&columns->fieldno[i + 1], &columns->fieldno[i],
+		(columns->count - i) * sizeof(uint32_t));
+	columns->fieldno[i] = fieldno;
+	columns->count++;
+	return i;
+}
+
+/** Returns the column number of a field added to the set of columns. */
+static uint32_t
+index_aggregate_columns_find(const struct index_aggregate_columns *columns,
+			     uint32_t fieldno)
+{
+	for (uint32_t i = 0; i < columns->count; i++) {
+		if (columns->fieldno[i] == fieldno)
+			return i;
+	}
+	unreachable();
+	return 0;
+}
+
+/**
+ * Creates the set of columns accessed by the given filters and
+ * aggregates on the region.
+ */
+static void
+index_aggregate_columns_create(struct index_aggregate_columns *columns,
+			       const struct index_filter *filters,
+			       uint32_t filter_count,
+			       const struct index_aggregate *aggregates,
+			       uint32_t aggregate_count,
+			       struct region *region)
+{
+	uint32_t max_count = MAX(filter_count + aggregate_count, 1);
+	columns->count = 0;
+	columns->fieldno = xregion_alloc_array(region, uint32_t, max_count);
+	for (uint32_t i = 0; i < filter_count; i++)
+		index_aggregate_columns_add(columns, filters[i].fieldno);
+	for (uint32_t i = 0; i < aggregate_count; i++) {
+		if (aggregates[i].fieldno != INDEX_AGGREGATE_FIELDNO_NONE)
+			index_aggregate_columns_add(columns,
+						    aggregates[i].fieldno);
+	}
+	columns->has_offset = xregion_alloc_array(region, bool, max_count);
+	columns->format = NULL;
+	columns->values = xregion_alloc_array(
+		region, const char *,
+		MAX(columns->count, 1) * INDEX_AGGREGATE_BATCH_SIZE);
+}
+
+/**
+ * Decodes the columns of a tuple of the batch. Fields that have an offset
+ * slot are looked up in the field map, the rest are found in one pass
+ * over the tuple data.
+ */
+static void
+index_aggregate_columns_decode(struct index_aggregate_columns *columns,
+			       uint32_t row, struct tuple *tuple)
+{
+	struct tuple_format *format = tuple_format(tuple);
+	if (format != columns->format) {
+		uint32_t field_count = tuple_format_field_count(format);
+		for (uint32_t i = 0; i < columns->count; i++) {
+			uint32_t fieldno = columns->fieldno[i];
+			columns->has_offset[i] = fieldno < field_count &&
+				tuple_format_field(format, fieldno)->
+				offset_slot != TUPLE_OFFSET_SLOT_NIL;
+		}
+		columns->format = format;
+	}
+	const char *data = tuple_data(tuple);
+	uint32_t field_count = mp_decode_array(&data);
+	uint32_t pos = 0;
+	const char **values = &columns->values[row];
+	for (uint32_t i = 0; i < columns->count; i++) {
+		uint32_t fieldno = columns->fieldno[i];
+		const char *field;
+		if (columns->has_offset[i]) {
+			field = tuple_field(tuple, fieldno);
+		} else if (fieldno >= field_count) {
+			field = NULL;
+		} else {
+			for (; pos < fieldno; pos++)
+				mp_next(&data);
+			field = data;
+		}
+		values[i * INDEX_AGGREGATE_BATCH_SIZE] = field;
+	}
+}
+
+/**
+ * Applies filters to a batch of decoded tuples. Each filter is applied
+ * to all the tuples that passed the previous filters before moving on
+ * to the next one, so that the inner loop is tight. Returns the number
+ * of tuples that passed all the filters, their positions are stored in
+ * selected.
+ */
+static uint32_t
+index_aggregate_filter_batch(const struct index_aggregate_columns *columns,
+			     uint32_t batch_size,
+			     const struct index_filter *filters,
+			     const uint32_t *filter_columns,
+			     uint32_t filter_count, uint16_t *selected)
+{
+	for (uint32_t i = 0; i < batch_size; i++)
+		selected[i] = i;
+	uint32_t selected_count = batch_size;
+	for (uint32_t i = 0; i < filter_count; i++) {
+		const struct index_filter *filter = &filters[i];
+		const char **values = &columns->values[filter_columns[i] *
+						       INDEX_AGGREGATE_BATCH_SIZE];
+		uint32_t count = 0;
+		for (uint32_t j = 0; j < selected_count; j++) {
+			selected[count] = selected[j];
+			count += index_filter_match(filter,
+						    values[selected[j]]);
+		}
+		selected_count = count;
+	}
+	return selected_count;
+}
+
+int
+generic_index_aggregate(struct index *index, enum iterator_type type,
+			const char *key, uint32_t part_count,
+			const struct index_filter *filters,
+			uint32_t filter_count,
+			struct index_aggregate *aggregates,
+			uint32_t aggregate_count)
+{
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct index_aggregate_columns columns;
+	index_aggregate_columns_create(&columns, filters, filter_count,
+				       aggregates, aggregate_count, region);
+	uint32_t *filter_columns = xregion_alloc_array(
+		region, uint32_t, MAX(filter_count, 1));
+	for (uint32_t i = 0; i < filter_count; i++)
+		filter_columns[i] = index_aggregate_columns_find(
+			&columns, filters[i].fieldno);
+	uint32_t *aggregate_columns = xregion_alloc_array(
+		region, uint32_t, MAX(aggregate_count, 1));
+	for (uint32_t i = 0; i < aggregate_count; i++) {
+		uint32_t fieldno = aggregates[i].fieldno;
+		aggregate_columns[i] =
+			fieldno == INDEX_AGGREGATE_FIELDNO_NONE ? UINT32_MAX :
+			index_aggregate_columns_find(&columns, fieldno);
+	}
+	struct iterator *it = index_create_iterator(index, type, key,
+						    part_count);
+	if (it == NULL) {
+		region_truncate(region, region_svp);
+		return -1;
+	}
+	struct tuple *batch[INDEX_AGGREGATE_BATCH_SIZE];
+	uint16_t selected[INDEX_AGGREGATE_BATCH_SIZE];
+	bool is_eof = false;
+	int rc = 0;
+	while (!is_eof && rc == 0) {
+		/*
+		 * Tuples are referenced, because the iterator may yield or
+		 * return tuples that are only valid until the next call.
+		 */
+		uint32_t batch_size = 0;
+		while (batch_size < INDEX_AGGREGATE_BATCH_SIZE) {
+			struct tuple *tuple;
+			if (iterator_next(it, &tuple) != 0) {
+				rc = -1;
+				break;
+			}
+			if (tuple == NULL) {
+				is_eof = true;
+				break;
+			}
+			tuple_ref(tuple);
+			batch[batch_size++] = tuple;
+		}
+		uint32_t selected_count = 0;
+		if (rc == 0) {
+			for (uint32_t i = 0; i < batch_size; i++)
+				index_aggregate_columns_decode(&columns, i,
+							       batch[i]);
+			selected_count = index_aggregate_filter_batch(
+				&columns, batch_size, filters, filter_columns,
+				filter_count, selected);
+		}
+		for (uint32_t i = 0; i < aggregate_count && rc == 0; i++) {
+			struct index_aggregate *agg = &aggregates[i];
+			const char **values = aggregate_columns[i] ==
+				UINT32_MAX ? NULL :
+				&columns.values[aggregate_columns[i] *
+						INDEX_AGGREGATE_BATCH_SIZE];
+			for (uint32_t j = 0; j < selected_count; j++) {
+				uint32_t row = selected[j];
+				const char *field = values == NULL ? NULL :
+						    values[row];
+				if (index_aggregate_update(agg, batch[row],
+							   field) != 0) {
+					rc = -1;
+					break;
+				}
+			}
+		}
+		for (uint32_t i = 0; i < batch_size; i++)
+			tuple_unref(batch[i]);
+	}
+	iterator_delete(it);
+	region_truncate(region, region_svp);
+	return rc;
+}
+
 int
 generic_index_read_view_create_arrow_stream(
 	struct index_read_view *rv,
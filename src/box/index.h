@@ -54,6 +54,8 @@ struct key_def;
 struct info_handler;
 struct arrow_options;
 struct ArrowArrayStream;
+struct index_filter;
+struct index_aggregate;
 
 typedef struct tuple box_tuple_t;
 typedef struct key_def box_key_def_t;
@@ -95,6 +97,8 @@ box_run_on_select(struct space *space, struct index *index,
 /** \cond public */
 
 typedef struct iterator box_iterator_t;
+struct arrow_options;
+struct ArrowArrayStream;
 
 /**
  * Allocate and initialize iterator for space_id, index_id.
@@ -287,6 +291,33 @@ char *
 box_tuple_extract_key(box_tuple_t *tuple, uint32_t space_id,
 		      uint32_t index_id, uint32_t *key_size);
 
+/**
+ * Create an Arrow stream that returns the given fields of the index tuples
+ * matching the key.
+ *
+ * The stream returns a consistent image of the index: changes made after
+ * the stream was created aren't visible to it. The stream must be released
+ * in the tx thread. Only supported by engines with columnar storage.
+ *
+ * \param space_id space identifier.
+ * \param index_id index identifier.
+ * \param field_count number of fields to return.
+ * \param fields 0-based numbers of the fields to return. If NULL, all
+ *        fields of the space format are returned.
+ * \param key encoded key in MsgPack Array format ([part1, part2, ...]).
+ * \param key_end the end of encoded \a key
+ * \param options stream options, see box_arrow_options_new().
+ * \param[out] stream the created stream.
+ * \retval 0 on success
+ * \retval -1 on error (check box_error_last())
+ */
+int
+box_index_arrow_stream(uint32_t space_id, uint32_t index_id,
+		       uint32_t field_count, const uint32_t *fields,
+		       const char *key, const char *key_end,
+		       const struct arrow_options *options,
+		       struct ArrowArrayStream *stream);
+
 /** \endcond public */
 
 /**
@@ -301,6 +332,35 @@ box_index_iterator_with_offset(uint32_t space_id, uint32_t index_id, int type,
 			       const char *packed_pos,
 			       const char *packed_pos_end, uint32_t offset);
 
+/**
+ * Compute aggregates over the index tuples matching the key and filters.
+ *
+ * Filters are encoded as a MsgPack array of [fieldno, op, value] arrays,
+ * aggregates as a MsgPack array of [func, fieldno] arrays, see
+ * index_filters_decode() and index_aggregates_decode(). Field numbers are
+ * zero-based. On success, the results are returned as a MsgPack array
+ * allocated on the fiber region, one value per aggregate.
+ */
+int
+box_index_aggregate(uint32_t space_id, uint32_t index_id, int type,
+		    const char *key, const char *key_end,
+		    const char *filters, const char *aggregates,
+		    const char **result, const char **result_end);
+
+/**
+ * Look up tuples by several full keys at once.
+ *
+ * The keys are encoded as a MsgPack array of keys, each of which is
+ * a MsgPack array. On success, the found tuples are stored in @a result,
+ * one per key in the same order, NULL if the key isn't found. The result
+ * array must have room for as many tuples as there are keys. The returned
+ * tuples are referenced and must be unreferenced by the caller.
+ */
+int
+box_index_get_many(uint32_t space_id, uint32_t index_id,
+		   const char *keys, const char *keys_end,
+		   box_tuple_t **result);
+
 /**
  * A helper for position extractors. Get packed position of tuple in
  * index by its cmp_def. Returned position is allocated on the fiber region.
@@ -630,6 +690,14 @@ struct index_vtab {
 			    uint32_t part_count, struct tuple **result);
 	int (*get)(struct index *index, const char *key,
 		   uint32_t part_count, struct tuple **result);
+	/**
+	 * Look up tuples by @a key_count full keys encoded as MsgPack
+	 * arrays following one another. Stores a referenced tuple or NULL
+	 * per key in @a result. An engine that reads from disk may look
+	 * up the keys concurrently.
+	 */
+	int (*get_many)(struct index *index, const char *keys,
+			uint32_t key_count, struct tuple **result);
 	/**
 	 * Main entrance point for changing data in index. Once built and
 	 * before deletion this is the only way to insert, replace and delete
@@ -669,6 +737,16 @@ struct index_vtab {
 				   const char *key, uint32_t part_count,
 				   const struct arrow_options *options,
 				   struct ArrowArrayStream *stream);
+	/**
+	 * Compute aggregates over the index tuples matching the key and
+	 * all the filters. On success, the aggregates hold the results.
+	 */
+	int (*aggregate)(struct index *index, enum iterator_type type,
+			 const char *key, uint32_t part_count,
+			 const struct index_filter *filters,
+			 uint32_t filter_count,
+			 struct index_aggregate *aggregates,
+			 uint32_t aggregate_count);
 	/** Create an index read view. */
 	struct index_read_view *(*create_read_view)(struct index *index);
 	/** Introspection (index:stat()) */
@@ -1031,6 +1109,13 @@ index_get(struct index *index, const char *key,
 	return index->vtab->get(index, key, part_count, result);
 }
 
+static inline int
+index_get_many(struct index *index, const char *keys,
+	       uint32_t key_count, struct tuple **result)
+{
+	return index->vtab->get_many(index, keys, key_count, result);
+}
+
 static inline int
 index_replace(struct index *index, struct tuple *old_tuple,
 	      struct tuple *new_tuple, enum dup_replace_mode mode,
@@ -1077,6 +1162,17 @@ index_create_arrow_stream(struct index *index,
 						stream);
 }
 
+static inline int
+index_aggregate(struct index *index, enum iterator_type type,
+		const char *key, uint32_t part_count,
+		const struct index_filter *filters, uint32_t filter_count,
+		struct index_aggregate *aggregates, uint32_t aggregate_count)
+{
+	return index->vtab->aggregate(index, type, key, part_count,
+				      filters, filter_count,
+				      aggregates, aggregate_count);
+}
+
 static inline struct index_read_view *
 index_create_read_view(struct index *index)
 {
@@ -1267,6 +1363,9 @@ int
 generic_index_get_internal(struct index *index, const char *key,
 			   uint32_t part_count, struct tuple **result);
 int generic_index_get(struct index *, const char *, uint32_t, struct tuple **);
+int
+generic_index_get_many(struct index *index, const char *keys,
+		       uint32_t key_count, struct tuple **result);
 int generic_index_replace(struct index *, struct tuple *, struct tuple *,
 			  enum dup_replace_mode,
 			  struct tuple **, struct tuple **);
@@ -1299,6 +1398,13 @@ generic_index_create_arrow_stream(struct index *index,
 				  const struct arrow_options *options,
 				  struct ArrowArrayStream *stream);
 int
+generic_index_aggregate(struct index *index, enum iterator_type type,
+			const char *key, uint32_t part_count,
+			const struct index_filter *filters,
+			uint32_t filter_count,
+			struct index_aggregate *aggregates,
+			uint32_t aggregate_count);
+int
 generic_index_read_view_create_arrow_stream(
 	struct index_read_view *rv,
 	uint32_t field_count, const uint32_t *fields,
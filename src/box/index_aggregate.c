@@ -0,0 +1,409 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2025, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "index_aggregate.h"
+
+#include <string.h>
+
+#include "diag.h"
+#include "error.h"
+#include "errcode.h"
+#include "field_def.h"
+#include "key_def.h"
+#include "mp_extension_types.h"
+#include "msgpuck.h"
+#include "small/region.h"
+#include "trivia/util.h"
+#include "tuple.h"
+#include "tuple_dictionary.h"
+
+const char *index_filter_op_strs[] = {
+	/* [INDEX_FILTER_EQ] = */ "==",
+	/* [INDEX_FILTER_NE] = */ "~=",
+	/* [INDEX_FILTER_LT] = */ "<",
+	/* [INDEX_FILTER_LE] = */ "<=",
+	/* [INDEX_FILTER_GT] = */ ">",
+	/* [INDEX_FILTER_GE] = */ ">=",
+};
+
+static_assert(lengthof(index_filter_op_strs) == index_filter_op_MAX,
+	      "index_filter_op_strs must match enum index_filter_op");
+
+const char *index_aggregate_func_strs[] = {
+	/* [INDEX_AGGREGATE_COUNT] = */ "count",
+	/* [INDEX_AGGREGATE_SUM]   = */ "sum",
+	/* [INDEX_AGGREGATE_MIN]   = */ "min",
+	/* [INDEX_AGGREGATE_MAX]   = */ "max",
+};
+
+static_assert(lengthof(index_aggregate_func_strs) == index_aggregate_func_MAX,
+	      "index_aggregate_func_strs must match enum index_aggregate_func");
+
+/**
+ * Returns true if the MsgPack value can be compared with other scalars
+ * by tuple_compare_field() with FIELD_TYPE_SCALAR.
+ */
+static bool
+mp_is_comparable_scalar(const char *data)
+{
+	switch (mp_typeof(*data)) {
+	case MP_UINT:
+	case MP_INT:
+	case MP_FLOAT:
+	case MP_DOUBLE:
+	case MP_STR:
+	case MP_BIN:
+	case MP_BOOL:
+		return true;
+	case MP_EXT: {
+		int8_t type;
+		mp_decode_extl(&data, &type);
+		return type == MP_DECIMAL || type == MP_UUID ||
+		       type == MP_DATETIME;
+	}
+	default:
+		return false;
+	}
+}
+
+bool
+index_filter_match(const struct index_filter *filter, const char *field)
+{
+	if (field == NULL || mp_typeof(*field) == MP_NIL ||
+	    !mp_is_comparable_scalar(field))
+		return false;
+	int rc = tuple_compare_field(field, filter->value,
+				     FIELD_TYPE_SCALAR, NULL);
+	switch (filter->op) {
+	case INDEX_FILTER_EQ:
+		return rc == 0;
+	case INDEX_FILTER_NE:
+		return rc != 0;
+	case INDEX_FILTER_LT:
+		return rc < 0;
+	case INDEX_FILTER_LE:
+		return rc <= 0;
+	case INDEX_FILTER_GT:
+		return rc > 0;
+	case INDEX_FILTER_GE:
+		return rc >= 0;
+	default:
+		unreachable();
+	}
+	return false;
+}
+
+void
+index_aggregate_create(struct index_aggregate *agg,
+		       enum index_aggregate_func func, uint32_t fieldno)
+{
+	memset(agg, 0, sizeof(*agg));
+	agg->func = func;
+	agg->fieldno = fieldno;
+}
+
+void
+index_aggregate_destroy(struct index_aggregate *agg)
+{
+	if (agg->value_tuple != NULL)
+		tuple_unref(agg->value_tuple);
+	agg->value_tuple = NULL;
+	agg->value = NULL;
+}
+
+/** Returns a description of the aggregated field for error messages. */
+static const char *
+index_aggregate_field_str(const struct index_aggregate *agg,
+			  struct tuple *tuple)
+{
+	struct tuple_dictionary *dict = tuple_format(tuple)->dict;
+	if (agg->fieldno < dict->name_count) {
+		return tt_sprintf("%u (%s)", agg->fieldno + TUPLE_INDEX_BASE,
+				  dict->names[agg->fieldno]);
+	}
+	return int2str(agg->fieldno + TUPLE_INDEX_BASE);
+}
+
+/**
+ * Adds an integer to the SUM accumulator. The value is unsigned unless
+ * is_neg is set. Returns -1 on overflow.
+ */
+static int
+index_aggregate_add_int(struct index_aggregate *agg, int64_t value,
+			bool is_neg)
+{
+	uint64_t sum = (uint64_t)agg->sum;
+	uint64_t u = (uint64_t)value;
+	if (agg->is_neg && is_neg) {
+		if (agg->sum < INT64_MIN - value)
+			return -1;
+	} else if (!agg->is_neg && !is_neg) {
+		if (UINT64_MAX - sum < u)
+			return -1;
+	} else if (is_neg) {
+		agg->is_neg = 0 - u > sum;
+	} else {
+		agg->is_neg = 0 - sum > u;
+	}
+	agg->sum = (int64_t)(sum + u);
+	return 0;
+}
+
+/** Adds a field value to the SUM accumulator. */
+static int
+index_aggregate_update_sum(struct index_aggregate *agg, struct tuple *tuple,
+			   const char *field)
+{
+	double value;
+	switch (mp_typeof(*field)) {
+	case MP_UINT: {
+		uint64_t u = mp_decode_uint(&field);
+		if (agg->is_double) {
+			agg->sum_double += u;
+			return 0;
+		}
+		if (index_aggregate_add_int(agg, (int64_t)u, false) != 0)
+			goto overflow;
+		return 0;
+	}
+	case MP_INT: {
+		int64_t i = mp_decode_int(&field);
+		if (agg->is_double) {
+			agg->sum_double += i;
+			return 0;
+		}
+		if (index_aggregate_add_int(agg, i, true) != 0)
+			goto overflow;
+		return 0;
+	}
+	case MP_FLOAT:
+		value = mp_decode_float(&field);
+		break;
+	case MP_DOUBLE:
+		value = mp_decode_double(&field);
+		break;
+	default:
+		diag_set(ClientError, ER_FIELD_TYPE,
+			 index_aggregate_field_str(agg, tuple),
+			 "integer or double", mp_type_strs[mp_typeof(*field)]);
+		return -1;
+	}
+	if (!agg->is_double) {
+		agg->is_double = true;
+		agg->sum_double = agg->is_neg ? (double)agg->sum :
+				  (double)(uint64_t)agg->sum;
+	}
+	agg->sum_double += value;
+	return 0;
+overflow:
+	diag_set(ClientError, ER_UPDATE_INTEGER_OVERFLOW, '+',
+		 index_aggregate_field_str(agg, tuple));
+	return -1;
+}
+
+/** Adds a field value to the MIN or MAX accumulator. */
+static int
+index_aggregate_update_min_max(struct index_aggregate *agg,
+			       struct tuple *tuple, const char *field)
+{
+	if (!mp_is_comparable_scalar(field)) {
+		diag_set(ClientError, ER_FIELD_TYPE,
+			 index_aggregate_field_str(agg, tuple), "scalar",
+			 mp_type_strs[mp_typeof(*field)]);
+		return -1;
+	}
+	if (agg->value != NULL) {
+		int rc = tuple_compare_field(field, agg->value,
+					     FIELD_TYPE_SCALAR, NULL);
+		if (agg->func == INDEX_AGGREGATE_MIN ? rc >= 0 : rc <= 0)
+			return 0;
+	}
+	if (agg->value_tuple != tuple) {
+		tuple_ref(tuple);
+		if (agg->value_tuple != NULL)
+			tuple_unref(agg->value_tuple);
+		agg->value_tuple = tuple;
+	}
+	agg->value = field;
+	return 0;
+}
+
+int
+index_aggregate_update(struct index_aggregate *agg, struct tuple *tuple,
+		       const char *field)
+{
+	if (agg->fieldno == INDEX_AGGREGATE_FIELDNO_NONE) {
+		assert(agg->func == INDEX_AGGREGATE_COUNT);
+		agg->count++;
+		return 0;
+	}
+	if (field == NULL || mp_typeof(*field) == MP_NIL)
+		return 0;
+	switch (agg->func) {
+	case INDEX_AGGREGATE_COUNT:
+		break;
+	case INDEX_AGGREGATE_SUM:
+		if (index_aggregate_update_sum(agg, tuple, field) != 0)
+			return -1;
+		break;
+	case INDEX_AGGREGATE_MIN:
+	case INDEX_AGGREGATE_MAX:
+		if (index_aggregate_update_min_max(agg, tuple, field) != 0)
+			return -1;
+		break;
+	default:
+		unreachable();
+	}
+	agg->count++;
+	return 0;
+}
+
+const char *
+index_aggregate_result(const struct index_aggregate *agg,
+		       struct region *region, uint32_t *size)
+{
+	char *data;
+	char *data_end;
+	switch (agg->func) {
+	case INDEX_AGGREGATE_COUNT:
+		data = xregion_alloc(region, mp_sizeof_uint(agg->count));
+		data_end = mp_encode_uint(data, agg->count);
+		break;
+	case INDEX_AGGREGATE_SUM:
+		data = xregion_alloc(region, 9);
+		if (agg->count == 0)
+			data_end = mp_encode_nil(data);
+		else if (agg->is_double)
+			data_end = mp_encode_double(data, agg->sum_double);
+		else if (agg->is_neg)
+			data_end = mp_encode_int(data, agg->sum);
+		else
+			data_end = mp_encode_uint(data, (uint64_t)agg->sum);
+		break;
+	case INDEX_AGGREGATE_MIN:
+	case INDEX_AGGREGATE_MAX: {
+		if (agg->value == NULL) {
+			data = xregion_alloc(region, mp_sizeof_nil());
+			data_end = mp_encode_nil(data);
+			break;
+		}
+		const char *value_end = agg->value;
+		mp_next(&value_end);
+		data = xregion_alloc(region, value_end - agg->value);
+		memcpy(data, agg->value, value_end - agg->value);
+		data_end = data + (value_end - agg->value);
+		break;
+	}
+	default:
+		unreachable();
+	}
+	*size = data_end - data;
+	return data;
+}
+
+int
+index_filters_decode(const char **data, struct region *region,
+		     struct index_filter **filters, uint32_t *filter_count)
+{
+	if (mp_typeof(**data) != MP_ARRAY) {
+		diag_set(IllegalParams, "filters must be an array");
+		return -1;
+	}
+	uint32_t count = mp_decode_array(data);
+	struct index_filter *result =
+		xregion_alloc_array(region, struct index_filter, MAX(count, 1));
+	for (uint32_t i = 0; i < count; i++) {
+		struct index_filter *filter = &result[i];
+		if (mp_typeof(**data) != MP_ARRAY ||
+		    mp_decode_array(data) != 3 ||
+		    mp_typeof(**data) != MP_UINT)
+			goto invalid;
+		uint64_t fieldno = mp_decode_uint(data);
+		if (fieldno >= INDEX_AGGREGATE_FIELDNO_NONE ||
+		    mp_typeof(**data) != MP_STR)
+			goto invalid;
+		uint32_t len;
+		const char *op = mp_decode_str(data, &len);
+		if (len == 1 && op[0] == '=')
+			filter->op = INDEX_FILTER_EQ;
+		else if (len == 2 && memcmp(op, "!=", 2) == 0)
+			filter->op = INDEX_FILTER_NE;
+		else
+			filter->op = STRN2ENUM(index_filter_op, op, len);
+		if (filter->op == index_filter_op_MAX) {
+			diag_set(IllegalParams, "unknown filter operator '%.*s'",
+				 (int)len, op);
+			return -1;
+		}
+		if (!mp_is_comparable_scalar(*data)) {
+			diag_set(IllegalParams, "filter value must be a scalar");
+			return -1;
+		}
+		filter->fieldno = fieldno;
+		filter->value = *data;
+		mp_next(data);
+	}
+	*filters = result;
+	*filter_count = count;
+	return 0;
+invalid:
+	diag_set(IllegalParams, "filter must be [fieldno, op, value]");
+	return -1;
+}
+
+int
+index_aggregates_decode(const char **data, struct region *region,
+			struct index_aggregate **aggregates,
+			uint32_t *aggregate_count)
+{
+	if (mp_typeof(**data) != MP_ARRAY) {
+		diag_set(IllegalParams, "aggregates must be an array");
+		return -1;
+	}
+	uint32_t count = mp_decode_array(data);
+	struct index_aggregate *result = xregion_alloc_array(
+		region, struct index_aggregate, MAX(count, 1));
+	for (uint32_t i = 0; i < count; i++) {
+		if (mp_typeof(**data) != MP_ARRAY)
+			goto invalid;
+		uint32_t size = mp_decode_array(data);
+		if (size < 1 || size > 2 || mp_typeof(**data) != MP_STR)
+			goto invalid;
+		uint32_t len;
+		const char *name = mp_decode_str(data, &len);
+		enum index_aggregate_func func =
+			STRN2ENUM(index_aggregate_func, name, len);
+		if (func == index_aggregate_func_MAX) {
+			diag_set(IllegalParams,
+				 "unknown aggregate function '%.*s'",
+				 (int)len, name);
+			return -1;
+		}
+		uint64_t fieldno = INDEX_AGGREGATE_FIELDNO_NONE;
+		if (size == 2 && mp_typeof(**data) == MP_UINT) {
+			fieldno = mp_decode_uint(data);
+			if (fieldno >= INDEX_AGGREGATE_FIELDNO_NONE)
+				goto invalid;
+		} else if (size == 2 && mp_typeof(**data) == MP_NIL) {
+			mp_decode_nil(data);
+		} else if (size == 2) {
+			goto invalid;
+		}
+		if (fieldno == INDEX_AGGREGATE_FIELDNO_NONE &&
+		    func != INDEX_AGGREGATE_COUNT) {
+			diag_set(IllegalParams,
+				 "aggregate function '%s' requires a field",
+				 index_aggregate_func_strs[func]);
+			return -1;
+		}
+		index_aggregate_create(&result[i], func, fieldno);
+	}
+	*aggregates = result;
+	*aggregate_count = count;
+	return 0;
+invalid:
+	diag_set(IllegalParams, "aggregate must be [func, fieldno]");
+	return -1;
+}
@@ -0,0 +1,141 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2025, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct region;
+struct tuple;
+
+/** Comparison operator of an index scan filter. */
+enum index_filter_op {
+	INDEX_FILTER_EQ,
+	INDEX_FILTER_NE,
+	INDEX_FILTER_LT,
+	INDEX_FILTER_LE,
+	INDEX_FILTER_GT,
+	INDEX_FILTER_GE,
+	index_filter_op_MAX,
+};
+
+/** Operator names: "==", "~=", "<", "<=", ">", ">=". */
+extern const char *index_filter_op_strs[];
+
+/**
+ * Index scan filter: a tuple matches the filter if the given field
+ * compared with the value satisfies the operator. Fields and values are
+ * compared as scalars. A missing or null field never matches.
+ */
+struct index_filter {
+	/** Zero-based field number. */
+	uint32_t fieldno;
+	/** Comparison operator. */
+	enum index_filter_op op;
+	/** MsgPack scalar to compare the field with. */
+	const char *value;
+};
+
+/**
+ * Returns true if the field (MsgPack, NULL if missing) matches
+ * the filter.
+ */
+bool
+index_filter_match(const struct index_filter *filter, const char *field);
+
+/** Aggregate function computed over an index scan. */
+enum index_aggregate_func {
+	/** Number of non-null field values or number of tuples. */
+	INDEX_AGGREGATE_COUNT,
+	/** Sum of non-null numeric field values. */
+	INDEX_AGGREGATE_SUM,
+	/** Min non-null field value. */
+	INDEX_AGGREGATE_MIN,
+	/** Max non-null field value. */
+	INDEX_AGGREGATE_MAX,
+	index_aggregate_func_MAX,
+};
+
+/** Function names: "count", "sum", "min", "max". */
+extern const char *index_aggregate_func_strs[];
+
+/** Field number used by COUNT to count tuples rather than values. */
+#define INDEX_AGGREGATE_FIELDNO_NONE UINT32_MAX
+
+/** Aggregate function and its accumulator. */
+struct index_aggregate {
+	/** Aggregate function. */
+	enum index_aggregate_func func;
+	/** Zero-based aggregated field number. */
+	uint32_t fieldno;
+	/** Number of aggregated non-null values. */
+	uint64_t count;
+	/** SUM: set if a non-integer value was summed. */
+	bool is_double;
+	/** SUM: set if the integer sum is negative. */
+	bool is_neg;
+	/** SUM: integer sum, unsigned unless is_neg is set. */
+	int64_t sum;
+	/** SUM: floating point sum, valid if is_double is set. */
+	double sum_double;
+	/** MIN/MAX: current value, NULL if no values were aggregated. */
+	const char *value;
+	/** MIN/MAX: referenced tuple holding the current value. */
+	struct tuple *value_tuple;
+};
+
+/** Initializes an aggregate accumulator. */
+void
+index_aggregate_create(struct index_aggregate *agg,
+		       enum index_aggregate_func func, uint32_t fieldno);
+
+/** Releases the tuple referenced by an aggregate accumulator. */
+void
+index_aggregate_destroy(struct index_aggregate *agg);
+
+/**
+ * Adds a field (MsgPack, NULL if missing) of the tuple to the aggregate.
+ * MIN and MAX reference the tuple holding the current value. Returns -1
+ * and sets diag if the field can't be aggregated, e.g. on integer
+ * overflow.
+ */
+int
+index_aggregate_update(struct index_aggregate *agg, struct tuple *tuple,
+		       const char *field);
+
+/** Encodes the aggregate result in MsgPack on the region. */
+const char *
+index_aggregate_result(const struct index_aggregate *agg,
+		       struct region *region, uint32_t *size);
+
+/**
+ * Decodes an array of filters from MsgPack. Each filter is encoded as
+ * [fieldno, op, value] with zero-based fieldno. The filter values point
+ * to the source data. The array is allocated on the region. Returns -1
+ * and sets diag on error.
+ */
+int
+index_filters_decode(const char **data, struct region *region,
+		     struct index_filter **filters, uint32_t *filter_count);
+
+/**
+ * Decodes an array of aggregates from MsgPack. Each aggregate is encoded
+ * as [func, fieldno] with zero-based fieldno, which may be omitted or nil
+ * for COUNT. The array is allocated on the region and initialized with
+ * index_aggregate_create(). Returns -1 and sets diag on error.
+ */
+int
+index_aggregates_decode(const char **data, struct region *region,
+			struct index_aggregate **aggregates,
+			uint32_t *aggregate_count);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -67,6 +67,23 @@ enum rtree_index_distance_type {
 };
 extern const char *rtree_index_distance_type_strs[];
 
+/** Vinyl LSM tree compaction strategy. */
+enum index_compaction_strategy {
+	/**
+	 * Size-tiered: each level may store up to run_count_per_level
+	 * runs, which are merged into a new run when the level is full.
+	 */
+	INDEX_COMPACTION_TIERED,
+	/**
+	 * Leveled: each level but the first one stores at most one run.
+	 * When a level is full, its runs are merged with the run of
+	 * the next level.
+	 */
+	INDEX_COMPACTION_LEVELED,
+	index_compaction_strategy_MAX
+};
+extern const char *index_compaction_strategy_strs[];
+
 /** Covered field attributes. */
 struct covered_field_def {
 	/** Fieldno of covered field. */
@@ -106,6 +123,8 @@ struct index_opts {
 	 * previous one.
 	 */
 	double run_size_ratio;
+	/** Vinyl LSM tree compaction strategy. */
+	enum index_compaction_strategy compaction_strategy;
 	/* Bloom filter false positive rate. */
 	double bloom_fpr;
 	/**
@@ -118,6 +137,17 @@ struct index_opts {
 	 * Use hint optimization for tree index.
 	 */
 	enum index_hint_cfg hint;
+	/**
+	 * Store the key itself instead of its hash in a memtx hash
+	 * index when possible, so that the key equality can be checked
+	 * without accessing the tuple.
+	 */
+	bool fingerprint;
+	/**
+	 * Build tree index comparison hints from a prefix of all key
+	 * parts rather than from the first part only.
+	 */
+	bool prefix_hint;
 	/**
 	 * Engine dependent. For engines supporting covering indexes means
 	 * explicitly covered fields. That is fields other then fields of
@@ -184,12 +214,18 @@ index_opts_is_equal(const struct index_opts *o1, const struct index_opts *o2)
 		return false;
 	if (o1->run_size_ratio != o2->run_size_ratio)
 		return false;
+	if (o1->compaction_strategy != o2->compaction_strategy)
+		return false;
 	if (o1->bloom_fpr != o2->bloom_fpr)
 		return false;
 	if (o1->func_id != o2->func_id)
 		return false;
 	if (o1->hint != o2->hint)
 		return false;
+	if (o1->fingerprint != o2->fingerprint)
+		return false;
+	if (o1->prefix_hint != o2->prefix_hint)
+		return false;
 	if (o1->covered_field_count != o2->covered_field_count)
 		return false;
 	for (uint32_t i = 0; i < o1->covered_field_count; i++) {
@@ -79,6 +79,7 @@
 #include "box/mp_box_ctx.h"
 #include "box/tuple.h"
 #include "mpstream/mpstream.h"
+#include "tweaks.h"
 
 enum {
 	IPROTO_PACKET_SIZE_MAX = 2UL * 1024 * 1024 * 1024,
@@ -188,6 +189,7 @@ struct iproto_thread {
 	struct cmsg_hop misc_route[2];
 	struct cmsg_hop call_route[2];
 	struct cmsg_hop select_route[2];
+	struct cmsg_hop select_batch_route[2];
 	struct cmsg_hop process1_route[2];
 	struct cmsg_hop sql_route[2];
 	struct cmsg_hop join_route[2];
@@ -320,6 +322,14 @@ unsigned iproto_readahead = 16320;
 /* The maximal number of iproto messages in fly. */
 static int iproto_msg_max = IPROTO_MSG_MAX_MIN;
 
+/**
+ * The maximal number of consecutive SELECT requests read from a connection
+ * at once that are sent to TX in one message and processed there by one
+ * fiber back-to-back. Values less than 2 disable batching.
+ */
+static uint64_t iproto_select_batch_size = 0;
+TWEAK_UINT(iproto_select_batch_size);
+
 /**
  * Request handlers meta information. The IPROTO request of each type can be
  * overridden by the following types of handlers (listed in priority order):
@@ -612,6 +622,14 @@ struct iproto_msg
 	struct rlist in_inprogress;
 	/** TX thread fiber that processing this message. */
 	struct fiber *fiber;
+	/**
+	 * SELECT requests following this one in the input buffer that are
+	 * processed in TX together with it, see iproto_select_batch_size.
+	 * Linked by in_batch.
+	 */
+	struct stailq batch;
+	/** Link in the batch of the first message in the batch. */
+	struct stailq_entry in_batch;
 };
 
 /**
@@ -1012,6 +1030,7 @@ iproto_msg_new(struct iproto_connection *con)
 	msg->connection = con;
 	msg->stream = NULL;
 	msg->fiber = NULL;
+	stailq_create(&msg->batch);
 	rmean_collect(con->iproto_thread->rmean, IPROTO_REQUESTS, 1);
 	con->request_count++;
 	return msg;
@@ -1337,6 +1356,63 @@ iproto_msg_start_processing_in_stream(struct iproto_msg *msg)
 	return false;
 }
 
+/**
+ * A batch of SELECT requests collected by iproto_enqueue_batch().
+ */
+struct iproto_select_batch {
+	/** The first message of the batch or NULL if there's no batch. */
+	struct iproto_msg *head;
+	/** The number of messages in the batch. */
+	uint64_t size;
+};
+
+/** Send the collected SELECT batch, if any, to TX. */
+static inline void
+iproto_select_batch_submit(struct iproto_select_batch *batch)
+{
+	if (batch->head == NULL)
+		return;
+	struct iproto_connection *con = batch->head->connection;
+	cpipe_push(&con->iproto_thread->tx_pipe, &batch->head->base);
+	batch->head = NULL;
+	batch->size = 0;
+}
+
+/**
+ * Send a message to TX. Consecutive SELECT requests are collected into
+ * a batch that is sent as one message, see iproto_select_batch_size.
+ * The batch must be submitted with iproto_select_batch_submit() before
+ * the input processing is over.
+ */
+static void
+iproto_msg_enqueue(struct iproto_msg *msg, struct iproto_select_batch *batch)
+{
+	struct iproto_thread *iproto_thread = msg->connection->iproto_thread;
+	bool is_batchable = iproto_select_batch_size > 1 &&
+			    msg->base.route == iproto_thread->select_route &&
+			    msg->stream == NULL;
+	if (!is_batchable) {
+		iproto_select_batch_submit(batch);
+		cpipe_push(&iproto_thread->tx_pipe, &msg->base);
+		return;
+	}
+	if (batch->head == NULL) {
+		/*
+		 * Don't push the message until the batch is complete:
+		 * the pipe may be flushed on push and TX would start
+		 * processing the batch while we're still filling it.
+		 */
+		batch->head = msg;
+		batch->size = 1;
+		return;
+	}
+	if (batch->size == 1)
+		cmsg_init(&batch->head->base, iproto_thread->select_batch_route);
+	stailq_add_tail_entry(&batch->head->batch, msg, in_batch);
+	if (++batch->size >= iproto_select_batch_size)
+		iproto_select_batch_submit(batch);
+}
+
 /**
  * Enqueue all requests which were read up. If a request limit is
  * reached - stop the connection input even if not the whole batch
@@ -1353,10 +1429,12 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 {
 	assert(rlist_empty(&con->in_stop_list));
 	int n_requests = 0;
+	struct iproto_select_batch batch = {NULL, 0};
 	const char *errmsg;
 	while (con->parse_size != 0 && !con->is_in_replication) {
 		if (iproto_check_msg_max(con->iproto_thread)) {
 			iproto_connection_stop_msg_max_limit(con);
+			iproto_select_batch_submit(&batch);
 			cpipe_submit_flush(&con->iproto_thread->tx_pipe);
 			return 0;
 		}
@@ -1366,6 +1444,7 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 		if (mp_typeof(*pos) != MP_UINT) {
 			errmsg = "packet length";
 err_msgpack:
+			iproto_select_batch_submit(&batch);
 			cpipe_submit_flush(&con->iproto_thread->tx_pipe);
 			diag_set(ClientError, ER_INVALID_MSGPACK,
 				 errmsg);
@@ -1392,7 +1471,7 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 
 		iproto_msg_prepare(msg, &pos, reqend);
 		if (iproto_msg_start_processing_in_stream(msg)) {
-			cpipe_push(&con->iproto_thread->tx_pipe, &msg->base);
+			iproto_msg_enqueue(msg, &batch);
 			n_requests++;
 		}
 
@@ -1401,6 +1480,7 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 		assert(con->parse_size >= (size_t) (reqend - reqstart));
 		con->parse_size -= reqend - reqstart;
 	}
+	iproto_select_batch_submit(&batch);
 	if (con->is_in_replication) {
 		/**
 		 * Don't mess with the file descriptor
@@ -1772,6 +1852,9 @@ tx_process1(struct cmsg *msg);
 static void
 tx_process_select(struct cmsg *msg);
 
+static void
+tx_process_select_batch(struct cmsg *msg);
+
 static void
 tx_process_sql(struct cmsg *msg);
 
@@ -1787,6 +1870,9 @@ net_send_msg(struct cmsg *msg);
 static void
 net_send_error(struct cmsg *msg);
 
+static void
+net_send_select_batch(struct cmsg *msg);
+
 static void
 tx_process_replication(struct cmsg *msg);
 
@@ -2615,6 +2701,25 @@ tx_process_select(struct cmsg *m)
 	tx_end_msg(msg, &svp);
 }
 
+/**
+ * Process a batch of SELECT requests collected by iproto_enqueue_batch()
+ * one after another in the current fiber. The replies are written to the
+ * output buffer in the request order and flushed at once by the first
+ * message of the batch when it gets back to the iproto thread.
+ */
+static void
+tx_process_select_batch(struct cmsg *m)
+{
+	struct iproto_msg *msg = (struct iproto_msg *)m;
+	tx_process_select(&msg->base);
+	struct iproto_msg *next;
+	stailq_foreach_entry(next, &msg->batch, in_batch) {
+		fiber_check_gc();
+		tx_process_select(&next->base);
+		msg->wpos = next->wpos;
+	}
+}
+
 static int
 tx_process_call_on_yield(struct trigger *trigger, void *event)
 {
@@ -3267,6 +3372,24 @@ net_send_msg(struct cmsg *m)
 	iproto_msg_delete(msg);
 }
 
+/**
+ * Complete a batch of SELECT requests: discard the input of all of them
+ * and flush the replies.
+ */
+static void
+net_send_select_batch(struct cmsg *m)
+{
+	struct iproto_msg *msg = (struct iproto_msg *)m;
+	struct iproto_msg *next, *tmp;
+	stailq_foreach_entry_safe(next, tmp, &msg->batch, in_batch) {
+		assert(next->stream == NULL);
+		assert(next->len != 0);
+		iproto_msg_finish_input(next);
+		iproto_msg_delete(next);
+	}
+	net_send_msg(m);
+}
+
 /**
  * Complete sending an iproto error:
  * recycle the error object and flush output.
@@ -3457,6 +3580,11 @@ net_cord_f(va_list  ap)
 
 	evio_service_create(loop(), &iproto_thread->binary, "binary",
 			    iproto_on_accept_cb, iproto_thread);
+	/*
+	 * If box.cfg.iproto_reuseport is set, TX binds a SO_REUSEPORT
+	 * acceptor socket for each iproto thread, see iproto_init().
+	 */
+	iproto_thread->binary.acceptor_idx = iproto_thread->id;
 
 	char endpoint_name[ENDPOINT_NAME_MAX];
 	snprintf(endpoint_name, ENDPOINT_NAME_MAX, "net%u",
@@ -3655,6 +3783,9 @@ iproto_thread_init_routes(struct iproto_thread *iproto_thread)
 	iproto_thread->select_route[0] =
 		{ tx_process_select, &iproto_thread->net_pipe };
 	iproto_thread->select_route[1] = { net_send_msg, NULL };
+	iproto_thread->select_batch_route[0] =
+		{ tx_process_select_batch, &iproto_thread->net_pipe };
+	iproto_thread->select_batch_route[1] = { net_send_select_batch, NULL };
 	iproto_thread->process1_route[0] =
 		{ tx_process1, &iproto_thread->net_pipe };
 	iproto_thread->process1_route[1] = { net_send_msg, NULL };
@@ -3880,7 +4011,7 @@ TRIGGER(trigger_on_change, trigger_on_change_iproto_notify);
 
 /** Initialize the iproto subsystem and start network io thread */
 void
-iproto_init(int threads_count)
+iproto_init(int threads_count, bool reuseport)
 {
 	iproto_threads_count = 0;
 	struct session_vtab iproto_session_vtab = {
@@ -3893,6 +4024,8 @@ iproto_init(int threads_count)
 	 * we don't need any accept functions.
 	 */
 	evio_service_create(loop(), &tx_binary, "tx_binary", NULL, NULL);
+	if (reuseport)
+		tx_binary.acceptor_count = threads_count;
 	iproto_threads = xalloc_array(struct iproto_thread, threads_count);
 	memset(iproto_threads, 0, sizeof(struct iproto_thread) * threads_count);
 	fiber_cond_create(&drop_finished_cond);
@@ -4188,7 +4321,10 @@ iproto_listen(const struct uri_set *uri_set)
 	 * Please note, we bind sockets in main thread, and then
 	 * listen these sockets in all iproto threads! With this
 	 * implementation, we rely on the Linux kernel to distribute
-	 * incoming connections across iproto threads.
+	 * incoming connections across iproto threads. If
+	 * box.cfg.iproto_reuseport is set, TX binds a separate
+	 * SO_REUSEPORT socket for each iproto thread instead, so
+	 * the kernel balances connections between the threads.
 	 */
 	if (evio_service_start(&tx_binary, uri_set) != 0)
 		return -1;
@@ -143,8 +143,13 @@ int
 iproto_override(uint32_t req_type, iproto_handler_t cb,
 		iproto_handler_destroy_t destroy, void *ctx);
 
+/**
+ * Initialize the iproto subsystem and start `threads_count` network
+ * threads. If `reuseport` is set, the threads bind their own acceptor
+ * sockets with SO_REUSEPORT instead of sharing the ones bound by TX.
+ */
 void
-iproto_init(int threads_count);
+iproto_init(int threads_count, bool reuseport);
 
 int
 iproto_listen(const struct uri_set *uri_set);
@@ -238,6 +238,11 @@ extern const char *iproto_flag_bit_strs[];
 	  * true and CHECKPOINT_VCLOCK to be set.
 	  */								\
 	 _(CHECKPOINT_LSN, 0x64, MP_UINT)				\
+	 /**
+	  * Flag indicating whether the replica wants the master to send
+	  * the replication stream in IPROTO_COMPRESSED_ROWS packets.
+	  */								\
+	 _(IS_COMPRESSED, 0x65, MP_BOOL)				\
 
 #define IPROTO_KEY_MEMBER(s, v, ...) IPROTO_ ## s = v,
 
@@ -410,6 +415,12 @@ iproto_key_bit(unsigned char key)
 	 * a notification key without subscribing to changes.
 	 */								\
 	_(WATCH_ONCE, 77)						\
+	/**
+	 * A batch of replication rows compressed with zstd. The body is
+	 * MP_BIN holding a zstd frame, which decompresses into a sequence
+	 * of ordinary packets, each prefixed with its length.
+	 */								\
+	_(COMPRESSED_ROWS, 78)						\
 									\
 	/**
 	 * The following three requests are reserved for vinyl types.
@@ -120,6 +120,14 @@ extern "C" {
 	 * Available since IPROTO protocol version 10.
 	 */								\
 	_(INSERT_ARROW, 12)						\
+	/**
+	 * Replication stream compression support:
+	 * IPROTO_IS_COMPRESSED flag in IPROTO_SUBSCRIBE and
+	 * IPROTO_COMPRESSED_ROWS packets.
+	 *
+	 * Available since IPROTO protocol version 11.
+	 */								\
+	_(REPLICATION_COMPRESSION, 13)					\
 
 #define IPROTO_FEATURE_MEMBER(s, v) IPROTO_FEATURE_ ## s = v,
 
@@ -144,7 +152,7 @@ struct iproto_features {
  * `box.iproto.protocol_version` needs to be updated correspondingly.
  */
 enum {
-	IPROTO_CURRENT_VERSION = 10,
+	IPROTO_CURRENT_VERSION = 11,
 };
 
 /**
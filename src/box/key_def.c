@@ -293,6 +293,7 @@ key_def_new(const struct key_part_def *parts, uint32_t part_count,
 	def->unique_part_count = part_count;
 	def->for_func_index = (flags & KEY_DEF_FOR_FUNC_INDEX) != 0;
 	def->is_unordered = (flags & KEY_DEF_UNORDERED) != 0;
+	def->has_prefix_hint = (flags & KEY_DEF_PREFIX_HINT) != 0;
 	/* A pointer to the JSON paths data in the new key_def. */
 	char *path_pool = (char *)def + key_def_sizeof(part_count, 0);
 	for (uint32_t i = 0; i < part_count; i++) {
@@ -1183,6 +1184,7 @@ key_def_merge(const struct key_def *first, const struct key_def *second)
 	new_def->is_multikey = first->is_multikey || second->is_multikey;
 	new_def->for_func_index = first->for_func_index;
 	new_def->is_unordered = first->is_unordered;
+	new_def->has_prefix_hint = first->has_prefix_hint;
 	new_def->func_index_func = first->func_index_func;
 
 	/* JSON paths data in the new key_def. */
@@ -218,6 +218,11 @@ struct key_def {
 	bool for_func_index;
 	/** True if it is unordered index key definition. */
 	bool is_unordered;
+	/**
+	 * True if comparison hints are built from a prefix of all
+	 * key parts rather than from the first part only.
+	 */
+	bool has_prefix_hint;
 	/**
 	 * True, if some key parts can be absent in a tuple. These
 	 * fields assumed to be MP_NIL.
@@ -662,6 +667,7 @@ key_def_sizeof(uint32_t part_count, uint32_t path_pool_size)
 enum key_def_new_flags {
 	KEY_DEF_FOR_FUNC_INDEX = 1 << 0,
 	KEY_DEF_UNORDERED = 1 << 1,
+	KEY_DEF_PREFIX_HINT = 1 << 2,
 };
 
 /**
@@ -1610,6 +1610,15 @@ I['iproto.readahead'] = format_text([[
     leave this setting at its default.
 ]])
 
+I['iproto.reuseport'] = format_text([[
+    If `true`, each network thread binds its own listening socket for every
+    `iproto.listen` URI using the `SO_REUSEPORT` socket option, so that the
+    operating system kernel balances incoming connections between the
+    threads. Otherwise, all the network threads accept connections on the
+    same listening socket. Makes sense only if `iproto.threads` is 2 or more.
+    UNIX domain sockets are always shared between the threads.
+]])
+
 I['iproto.ssl'] = format_text([[
     SSL parameters required for encrypted connections. These parameters would be
     used to set up SSL IProto sockets and to connect to other instances which
@@ -1916,6 +1925,15 @@ I['memtx.use_sort_data'] = format_text([[
     (if the latter is available) and write the data during `box.snapshot()`.
 ]])
 
+I['memtx.use_huge_pages'] = format_text([[
+    Whether to map the memory used for tuples and indexes with huge pages
+    to reduce TLB misses on random lookups in large datasets. Explicit huge
+    pages are used if the system pool has enough of them for
+    `memtx.memory`, otherwise transparent huge pages are requested. If
+    neither is available, regular pages are used. The huge page coverage
+    is reported in `box.stat.memtx().huge_pages`.
+]])
+
 -- }}} memtx configuration
 
 -- {{{ metrics configuration
@@ -2727,6 +2745,14 @@ I['vinyl.dir'] = format_text([[
     relative to `process.work_dir`.
 ]])
 
+I['vinyl.max_subcompactions'] = format_text([[
+    The maximum number of parts compaction of a big range can be split
+    into. The parts are compacted in parallel by different write threads,
+    and the range is replaced with one range per part on completion.
+    The number of parts is also limited by the number of idle write
+    threads and by the range size. Set to 1 to disable splitting.
+]])
+
 I['vinyl.max_tuple_size'] = format_text([[
     The size of the largest allocation unit, for the vinyl storage engine.
     It can be increased if it is necessary to store large tuples.
@@ -2736,6 +2762,13 @@ I['vinyl.memory'] = format_text([[
     The maximum number of in-memory bytes that vinyl uses.
 ]])
 
+I['vinyl.page_cache'] = format_text([[
+    The size of the cache of decompressed run pages for the vinyl storage
+    engine. Pages that are read from disk repeatedly are kept in memory so
+    that they don't need to be read and decompressed again. Set to 0 to
+    disable the cache. The cache can be resized dynamically.
+]])
+
 I['vinyl.page_size'] = format_text([[
     The page size. A page is a read/write unit for vinyl disk operations.
     The `vinyl.page_size` setting is a default value for the page_size option
@@ -2835,6 +2868,15 @@ I['wal.cleanup_delay'] = format_text([[
     `wal.cleanup_delay` has not expired.
 ]])
 
+I['wal.commit_delay'] = format_text([[
+    The maximum time in seconds a transaction may wait for other
+    transactions to be written to the write-ahead log together with it
+    (group commit). Collecting more transactions in one write reduces
+    the number of disk syncs when `wal.mode` is `fsync`, at the cost of
+    higher commit latency. The actual delay doesn't exceed the average
+    time it takes to write to the log. `0` disables the delay.
+]])
+
 I['wal.dir'] = format_text([[
     A directory where write-ahead log (`.xlog`) files are stored. A relative
     path in this option is interpreted as relative to `process.work_dir`.
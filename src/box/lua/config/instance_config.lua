@@ -854,6 +854,12 @@ return schema.new('instance_config', schema.record({
             box_cfg_nondynamic = true,
             default = 1,
         }),
+        reuseport = schema.scalar({
+            type = 'boolean',
+            box_cfg = 'iproto_reuseport',
+            box_cfg_nondynamic = true,
+            default = false,
+        }),
         net_msg_max = schema.scalar({
             type = 'integer',
             box_cfg = 'net_msg_max',
@@ -1000,6 +1006,12 @@ return schema.new('instance_config', schema.record({
             box_cfg = 'memtx_use_sort_data',
             default = false,
         }),
+        use_huge_pages = schema.scalar({
+            type = 'boolean',
+            box_cfg = 'memtx_use_huge_pages',
+            box_cfg_nondynamic = true,
+            default = false,
+        }),
     }),
     vinyl = schema.record({
         bloom_fpr = schema.scalar({
@@ -1030,6 +1042,11 @@ return schema.new('instance_config', schema.record({
             box_cfg = 'vinyl_max_tuple_size',
             default = 1024 * 1024,
         }),
+        max_subcompactions = schema.scalar({
+            type = 'integer',
+            box_cfg = 'vinyl_max_subcompactions',
+            default = 1,
+        }),
         memory = schema.scalar({
             type = 'integer',
             box_cfg = 'vinyl_memory',
@@ -1041,6 +1058,11 @@ return schema.new('instance_config', schema.record({
             box_cfg_nondynamic = true,
             default = 8 * 1024,
         }),
+        page_cache = schema.scalar({
+            type = 'integer',
+            box_cfg = 'vinyl_page_cache',
+            default = 0,
+        }),
         range_size = schema.scalar({
             type = 'integer',
             box_cfg = 'vinyl_range_size',
@@ -1129,6 +1151,11 @@ return schema.new('instance_config', schema.record({
             box_cfg = 'wal_queue_max_size',
             default = 16 * 1024 * 1024,
         }),
+        commit_delay = schema.scalar({
+            type = 'number',
+            box_cfg = 'wal_commit_delay',
+            default = 0,
+        }),
         cleanup_delay = schema.scalar({
             type = 'number',
             box_cfg = 'wal_cleanup_delay',
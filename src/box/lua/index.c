@@ -34,8 +34,10 @@
 #include "info/info.h"
 #include "box/box.h"
 #include "box/index.h"
+#include "box/arrow_options.h"
 #include "box/lua/tuple.h"
 #include "box/lua/misc.h"
+#include "lua/msgpack.h"
 #include "small/region.h"
 #include "arrow_ipc.h"
 #include "fiber.h"
@@ -214,6 +216,48 @@ lbox_index_get(lua_State *L)
 	return rc == 0 ? luaT_pushtupleornil(L, tuple) : luaT_error(L);
 }
 
+static int
+lbox_index_get_many(lua_State *L)
+{
+	if (lua_gettop(L) != 3 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2) ||
+	    !lua_istable(L, 3)) {
+		diag_set(IllegalParams,
+			 "Usage: index.get_many(space_id, index_id, keys)");
+		return luaT_error(L);
+	}
+
+	uint32_t space_id = lua_tonumber(L, 1);
+	uint32_t index_id = lua_tonumber(L, 2);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	size_t keys_len;
+	const char *keys = lbox_encode_tuple_on_gc(L, 3, &keys_len);
+	if (keys == NULL)
+		return luaT_error(L);
+	const char *keys_end = keys + keys_len;
+	const char *data = keys;
+	uint32_t count = mp_decode_array(&data);
+	struct tuple **result = xregion_alloc_array(region, struct tuple *,
+						    MAX(count, 1));
+	if (box_index_get_many(space_id, index_id, keys, keys_end,
+			       result) != 0) {
+		region_truncate(region, region_svp);
+		return luaT_error(L);
+	}
+	lua_createtable(L, count, 0);
+	for (uint32_t i = 0; i < count; i++) {
+		if (result[i] != NULL) {
+			luaT_pushtuple(L, result[i]);
+			tuple_unref(result[i]);
+		} else {
+			luaL_pushnull(L);
+		}
+		lua_rawseti(L, -2, i + 1);
+	}
+	region_truncate(region, region_svp);
+	return 1;
+}
+
 static int
 lbox_index_min(lua_State *L)
 {
@@ -384,6 +428,53 @@ lbox_truncate(struct lua_State *L)
 
 /* {{{ Introspection */
 
+static int
+lbox_index_aggregate(lua_State *L)
+{
+	if (lua_gettop(L) != 6 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2) ||
+	    !lua_isnumber(L, 3) || !lua_istable(L, 5) || !lua_istable(L, 6)) {
+		diag_set(IllegalParams,
+			 "Usage: index.aggregate(space_id, index_id, "
+			 "iterator, key, filters, aggregates)");
+		return luaT_error(L);
+	}
+
+	uint32_t space_id = lua_tonumber(L, 1);
+	uint32_t index_id = lua_tonumber(L, 2);
+	uint32_t iterator = lua_tonumber(L, 3);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	size_t key_len, filters_len, aggregates_len;
+	const char *key = lbox_encode_tuple_on_gc(L, 4, &key_len);
+	if (key == NULL)
+		return luaT_error(L);
+	const char *filters = lbox_encode_tuple_on_gc(L, 5, &filters_len);
+	if (filters == NULL) {
+		region_truncate(region, region_svp);
+		return luaT_error(L);
+	}
+	const char *aggregates = lbox_encode_tuple_on_gc(L, 6,
+							 &aggregates_len);
+	if (aggregates == NULL) {
+		region_truncate(region, region_svp);
+		return luaT_error(L);
+	}
+	const char *result, *result_end;
+	if (box_index_aggregate(space_id, index_id, iterator, key,
+				key + key_len, filters, aggregates,
+				&result, &result_end) != 0) {
+		region_truncate(region, region_svp);
+		return luaT_error(L);
+	}
+	uint32_t count = mp_decode_array(&result);
+	luaL_checkstack(L, count, "too many aggregates");
+	for (uint32_t i = 0; i < count; i++)
+		luamp_decode(L, luaL_msgpack_default, &result);
+	assert(result == result_end);
+	region_truncate(region, region_svp);
+	return count;
+}
+
 static int
 lbox_index_stat(lua_State *L)
 {
@@ -442,6 +533,92 @@ lbox_insert_arrow(lua_State *L)
 	return 0;
 }
 
+static int
+lbox_index_select_arrow(lua_State *L)
+{
+	if (lua_gettop(L) != 6 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2) ||
+	    !lua_isnumber(L, 3) || !lua_isnumber(L, 5) ||
+	    (!lua_isnil(L, 6) && !lua_istable(L, 6))) {
+		diag_set(IllegalParams,
+			 "Usage: index.select_arrow(space_id, index_id, "
+			 "iterator, key, batch_row_count, fields)");
+		return luaT_error(L);
+	}
+	uint32_t space_id = lua_tonumber(L, 1);
+	uint32_t index_id = lua_tonumber(L, 2);
+	struct arrow_options options;
+	arrow_options_create(&options);
+	options.iterator = lua_tonumber(L, 3);
+	options.batch_row_count = lua_tonumber(L, 5);
+
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	size_t key_len;
+	const char *key = lbox_encode_tuple_on_gc(L, 4, &key_len);
+	if (key == NULL)
+		return luaT_error(L);
+	uint32_t field_count = 0;
+	uint32_t *fields = NULL;
+	if (!lua_isnil(L, 6)) {
+		field_count = lua_objlen(L, 6);
+		fields = xregion_alloc_array(region, uint32_t,
+					     MAX(field_count, 1));
+		for (uint32_t i = 0; i < field_count; i++) {
+			lua_rawgeti(L, 6, i + 1);
+			if (!lua_isnumber(L, -1) || lua_tonumber(L, -1) < 1) {
+				region_truncate(region, region_svp);
+				diag_set(IllegalParams, "fields must be a table "
+					 "of positive field numbers");
+				return luaT_error(L);
+			}
+			fields[i] = lua_tonumber(L, -1) - 1;
+			lua_pop(L, 1);
+		}
+	}
+	struct ArrowArrayStream stream;
+	int rc = box_index_arrow_stream(space_id, index_id, field_count,
+					fields, key, key + key_len, &options,
+					&stream);
+	region_truncate(region, region_svp);
+	if (rc != 0)
+		return luaT_error(L);
+
+	struct ArrowSchema schema;
+	rc = stream.get_schema(&stream, &schema);
+	if (rc != 0) {
+		diag_set(EncodeError, "Arrow", stream.get_last_error(&stream));
+		stream.release(&stream);
+		return luaT_error(L);
+	}
+	lua_newtable(L);
+	for (int i = 1; ; i++) {
+		struct ArrowArray array;
+		rc = stream.get_next(&stream, &array);
+		if (rc != 0) {
+			diag_set(EncodeError, "Arrow",
+				 stream.get_last_error(&stream));
+			break;
+		}
+		if (array.release == NULL)
+			break;
+		const char *data, *data_end;
+		rc = arrow_ipc_encode(&array, &schema, region,
+				      &data, &data_end);
+		array.release(&array);
+		if (rc != 0)
+			break;
+		lua_pushlstring(L, data, data_end - data);
+		lua_rawseti(L, -2, i);
+		region_truncate(region, region_svp);
+	}
+	region_truncate(region, region_svp);
+	schema.release(&schema);
+	stream.release(&stream);
+	if (rc != 0)
+		return luaT_error(L);
+	return 1;
+}
+
 /* }}} */
 
 void
@@ -467,15 +644,18 @@ box_lua_index_init(struct lua_State *L)
 		{"delete",  lbox_index_delete},
 		{"random", lbox_index_random},
 		{"get",  lbox_index_get},
+		{"get_many", lbox_index_get_many},
 		{"min", lbox_index_min},
 		{"max", lbox_index_max},
 		{"count", lbox_index_count},
+		{"aggregate", lbox_index_aggregate},
 		{"iterator", lbox_index_iterator},
 		{"iterator_next", lbox_iterator_next},
 		{"truncate", lbox_truncate},
 		{"stat", lbox_index_stat},
 		{"compact", lbox_index_compact},
 		{"insert_arrow", lbox_insert_arrow},
+		{"select_arrow", lbox_index_select_arrow},
 		{NULL, NULL}
 	};
 
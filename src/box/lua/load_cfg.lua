@@ -94,11 +94,13 @@ local default_cfg = {
     listen              = nil,
     memtx_memory        = 256 * 1024 *1024,
     strip_core          = true,
+    memtx_use_huge_pages = false,
     memtx_min_tuple_size = 16,
     memtx_max_tuple_size = 1024 * 1024,
     slab_alloc_granularity = 8,
     slab_alloc_factor   = 1.05,
     iproto_threads      = 1,
+    iproto_reuseport    = false,
     memtx_allocator     = "small",
     work_dir            = nil,
     memtx_dir           = ".",
@@ -107,10 +109,12 @@ local default_cfg = {
     vinyl_dir           = '.',
     vinyl_memory        = 128 * 1024 * 1024,
     vinyl_cache         = 128 * 1024 * 1024,
+    vinyl_page_cache    = 0,
     vinyl_max_tuple_size = 1024 * 1024,
     vinyl_read_threads  = 1,
     vinyl_write_threads = 4,
     vinyl_timeout       = 60,
+    vinyl_max_subcompactions = 1,
     vinyl_defer_deletes = false,
     vinyl_run_count_per_level = 2,
     vinyl_run_size_ratio      = 3.5,
@@ -166,6 +170,7 @@ local default_cfg = {
     wal_max_size        = 256 * 1024 * 1024,
     wal_dir_rescan_delay= 2,
     wal_queue_max_size  = 16 * 1024 * 1024,
+    wal_commit_delay    = 0,
     wal_cleanup_delay   = nil,
     wal_retention_period = ifdef_wal_retention_period(0),
     wal_ext             = ifdef_wal_ext(nil),
@@ -304,11 +309,13 @@ local template_cfg = {
     listen              = 'string, number, table',
     memtx_memory        = 'number',
     strip_core          = 'boolean',
+    memtx_use_huge_pages = 'boolean',
     memtx_min_tuple_size  = 'number',
     memtx_max_tuple_size  = 'number',
     slab_alloc_granularity = 'number',
     slab_alloc_factor   = 'number',
     iproto_threads      = 'number',
+    iproto_reuseport    = 'boolean',
     memtx_allocator     = 'string',
     work_dir            = 'string',
     memtx_dir            = 'string',
@@ -316,10 +323,12 @@ local template_cfg = {
     vinyl_dir           = 'string',
     vinyl_memory        = 'number',
     vinyl_cache               = 'number',
+    vinyl_page_cache          = 'number',
     vinyl_max_tuple_size      = 'number',
     vinyl_read_threads        = 'number',
     vinyl_write_threads       = 'number',
     vinyl_timeout             = 'number',
+    vinyl_max_subcompactions  = 'number',
     vinyl_defer_deletes       = 'boolean',
     vinyl_run_count_per_level = 'number',
     vinyl_run_size_ratio      = 'number',
@@ -392,6 +401,7 @@ local template_cfg = {
     checkpoint_interval = 'number',
     checkpoint_wal_threshold = 'number',
     wal_queue_max_size  = 'number',
+    wal_commit_delay    = 'number',
     checkpoint_count    = 'number',
     read_only           = 'boolean',
     hot_standby         = 'boolean',
@@ -538,7 +548,9 @@ local dynamic_cfg = {
     vinyl_memory            = private.cfg_set_vinyl_memory,
     vinyl_max_tuple_size    = private.cfg_set_vinyl_max_tuple_size,
     vinyl_cache             = private.cfg_set_vinyl_cache,
+    vinyl_page_cache        = private.cfg_set_vinyl_page_cache,
     vinyl_timeout           = private.cfg_set_vinyl_timeout,
+    vinyl_max_subcompactions = private.cfg_set_vinyl_max_subcompactions,
     vinyl_defer_deletes     = nop,
     quiver_memory           = private.cfg_set_quiver_memory,
     quiver_run_size         = private.cfg_set_quiver_run_size,
@@ -546,6 +558,7 @@ local dynamic_cfg = {
     checkpoint_interval     = private.cfg_set_checkpoint_interval,
     checkpoint_wal_threshold = private.cfg_set_checkpoint_wal_threshold,
     wal_queue_max_size      = private.cfg_set_wal_queue_max_size,
+    wal_commit_delay        = private.cfg_set_wal_commit_delay,
     worker_pool_threads     = private.cfg_set_worker_pool_threads,
     -- do nothing, affects new replicas, which query this value on start
     wal_dir_rescan_delay    = nop,
@@ -733,7 +746,9 @@ local dynamic_cfg_skip_at_load = {
     vinyl_memory            = true,
     vinyl_max_tuple_size    = true,
     vinyl_cache             = true,
+    vinyl_page_cache        = true,
     vinyl_timeout           = true,
+    vinyl_max_subcompactions = true,
     quiver_memory           = ifdef_quiver(true),
     quiver_run_size         = ifdef_quiver(true),
     too_long_threshold      = true,
@@ -757,6 +772,7 @@ local dynamic_cfg_skip_at_load = {
     bootstrap_leader        = true,
     wal_dir_rescan_delay    = true,
     wal_queue_max_size      = true,
+    wal_commit_delay        = true,
     custom_proc_title       = true,
     force_recovery          = true,
     instance_uuid           = true,
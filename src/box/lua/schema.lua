@@ -853,6 +853,7 @@ box.schema.space.create = function(name, options)
         temporary = 'boolean',
         is_sync = 'boolean',
         defer_deletes = 'boolean',
+        value_log_threshold = 'number',
         constraint = 'string, table',
         foreign_key = 'table',
     }
@@ -905,6 +906,7 @@ box.schema.space.create = function(name, options)
         type = options.type,
         is_sync = options.is_sync,
         defer_deletes = options.defer_deletes and true or nil,
+        value_log_threshold = options.value_log_threshold,
         constraint = constraint,
         foreign_key = foreign_key,
     })
@@ -1560,11 +1562,14 @@ local index_options = {
     distance = 'string',
     run_count_per_level = 'number',
     run_size_ratio = 'number',
+    compaction_strategy = 'string',
     range_size = 'number',
     page_size = 'number',
     bloom_fpr = 'number',
     func = 'number, string',
     hint = 'boolean',
+    fingerprint = 'boolean',
+    prefix_hint = 'boolean',
     covers = 'table',
     layout = 'string',
     aggregates = 'table',
@@ -1777,9 +1782,12 @@ box.schema.index.create = atomic_wrapper(function(space_id, name, options)
             range_size = options.range_size,
             run_count_per_level = options.run_count_per_level,
             run_size_ratio = options.run_size_ratio,
+            compaction_strategy = options.compaction_strategy,
             bloom_fpr = options.bloom_fpr,
             func = options.func,
             hint = options.hint,
+            fingerprint = options.fingerprint,
+            prefix_hint = options.prefix_hint,
             covers = options.covers,
             layout = options.layout,
             aggregates = options.aggregates,
@@ -2658,6 +2666,99 @@ base_index_mt.count_luac = function(index, key, opts)
     return internal.count(index.space_id, index.id, itype, key);
 end
 
+-- Returns the 1-based number of a space field given by number or name.
+local function index_fieldno(index, field, level)
+    if type(field) == 'number' then
+        return field
+    end
+    local space = box.space[index.space_id]
+    local fieldno = type(field) == 'string' and
+                    format_field_index_by_name(space:format(), field)
+    if not fieldno then
+        box.error(box.error.NO_SUCH_FIELD_NAME_IN_SPACE, tostring(field),
+                  space.name, level + 1)
+    end
+    return fieldno
+end
+
+-- Selects the given fields of the tuples matching the key in Arrow format.
+-- Returns an array of Arrow IPC streams, each containing a single record
+-- batch of at most opts.batch_row_count rows.
+base_index_mt.select_arrow = function(index, key, opts)
+    check_index_arg(index, 'select_arrow', 2)
+    key = keify(key)
+    local itype = check_iterator_type(opts, #key == 0, 2)
+    local batch_row_count = box.NULL
+    local fields = box.NULL
+    if type(opts) == 'table' then
+        batch_row_count = opts.batch_row_count
+        fields = opts.fields
+    end
+    if batch_row_count == nil then
+        batch_row_count = 4096
+    elseif type(batch_row_count) ~= 'number' or batch_row_count < 1 then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "options parameter 'batch_row_count' should be " ..
+                  "a positive number", 2)
+    end
+    if fields ~= nil then
+        if type(fields) ~= 'table' then
+            box.error(box.error.ILLEGAL_PARAMS,
+                      "options parameter 'fields' should be a table", 2)
+        end
+        local fieldnos = {}
+        for i, field in ipairs(fields) do
+            fieldnos[i] = index_fieldno(index, field, 2)
+        end
+        fields = fieldnos
+    end
+    return internal.select_arrow(index.space_id, index.id, itype, key,
+                                 batch_row_count, fields)
+end
+
+-- Computes aggregates over the tuples matching the key and filters without
+-- passing the tuples to Lua. Returns one value per aggregate.
+base_index_mt.aggregate = function(index, key, opts)
+    check_index_arg(index, 'aggregate', 2)
+    key = keify(key)
+    local itype = check_iterator_type(opts, #key == 0, 2)
+    if type(opts) ~= 'table' or type(opts.aggregates) ~= 'table' then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "options parameter 'aggregates' should be a table", 2)
+    end
+    local aggregates = {}
+    for i, agg in ipairs(opts.aggregates) do
+        if type(agg) == 'string' then
+            agg = {agg}
+        elseif type(agg) ~= 'table' then
+            box.error(box.error.ILLEGAL_PARAMS,
+                      "aggregate should be a string or a table", 2)
+        end
+        local fieldno = box.NULL
+        if agg[2] ~= nil then
+            fieldno = index_fieldno(index, agg[2], 2) - 1
+        end
+        aggregates[i] = {agg[1], fieldno}
+    end
+    local filters = {}
+    if opts.filter ~= nil then
+        if type(opts.filter) ~= 'table' then
+            box.error(box.error.ILLEGAL_PARAMS,
+                      "options parameter 'filter' should be a table", 2)
+        end
+        for i, filter in ipairs(opts.filter) do
+            if type(filter) ~= 'table' or filter[1] == nil then
+                box.error(box.error.ILLEGAL_PARAMS,
+                          "filter should be a table {field, op, value}", 2)
+            end
+            filters[i] = {index_fieldno(index, filter[1], 2) - 1,
+                          filter[2], filter[3]}
+        end
+    end
+    return internal.aggregate(index.space_id, index.id, itype, key,
+                              filters, aggregates)
+end
+
 -- 0-based iterator-relative offset of the first matching tuple. If such tuple
 -- does not exist, returns the offset at which it would be located if existed.
 --
@@ -2700,6 +2801,21 @@ base_index_mt.get_luac = function(index, key)
     return internal.get(index.space_id, index.id, key)
 end
 
+-- Looks up tuples by several full keys at once. Returns an array of tuples,
+-- one per key, with box.NULL for keys that are not found. Vinyl looks up
+-- the keys concurrently, so that disk reads for different keys overlap.
+base_index_mt.get_many = function(index, keys)
+    check_index_arg(index, 'get_many', 2)
+    if type(keys) ~= 'table' then
+        box.error(box.error.ILLEGAL_PARAMS, "keys should be a table", 2)
+    end
+    local normalized = {}
+    for i, key in ipairs(keys) do
+        normalized[i] = keify(key)
+    end
+    return internal.get_many(index.space_id, index.id, normalized)
+end
+
 local function check_select_opts(opts, key_is_nil, level)
     local offset = 0
     local limit = 4294967295
@@ -2889,6 +3005,10 @@ space_mt.get = function(space, key)
     check_space_arg(space, 'get', 2)
     return check_primary_index(space, 2):get(key)
 end
+space_mt.get_many = function(space, keys)
+    check_space_arg(space, 'get_many', 2)
+    return check_primary_index(space, 2):get_many(keys)
+end
 space_mt.select = function(space, key, opts)
     check_space_arg(space, 'select', 2)
     return check_primary_index(space, 2):select(key, opts)
@@ -535,6 +535,9 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 		lua_pushstring(L, "defer_deletes");
 		lua_pushboolean(L, space->def->opts.defer_deletes);
 		lua_settable(L, i);
+		lua_pushstring(L, "value_log_threshold");
+		lua_pushinteger(L, space->def->opts.value_log_threshold);
+		lua_settable(L, i);
 	}
 
 	lua_getfield(L, i, "index");
@@ -615,6 +618,20 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			lua_pushnil(L);
 			lua_setfield(L, -2, "hint");
 		}
+		if (space_is_memtx(space) && index_def->type == HASH) {
+			lua_pushboolean(L, index_opts->fingerprint);
+			lua_setfield(L, -2, "fingerprint");
+		} else {
+			lua_pushnil(L);
+			lua_setfield(L, -2, "fingerprint");
+		}
+		if (space_is_memtx(space) && index_def->type == TREE) {
+			lua_pushboolean(L, index_opts->prefix_hint);
+			lua_setfield(L, -2, "prefix_hint");
+		} else {
+			lua_pushnil(L);
+			lua_setfield(L, -2, "prefix_hint");
+		}
 
 		if (index_opts->func_id > 0) {
 			lua_pushstring(L, "func");
@@ -710,6 +727,13 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			lua_pushnumber(L, index_opts->run_size_ratio);
 			lua_setfield(L, -2, "run_size_ratio");
 
+			if (index_opts->compaction_strategy !=
+			    INDEX_COMPACTION_TIERED) {
+				lua_pushstring(L, index_compaction_strategy_strs[
+					index_opts->compaction_strategy]);
+				lua_setfield(L, -2, "compaction_strategy");
+			}
+
 			lua_pushnumber(L, index_opts->bloom_fpr);
 			lua_setfield(L, -2, "bloom_fpr");
 
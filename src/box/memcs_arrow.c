@@ -0,0 +1,638 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2025, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "memcs_arrow.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arrow/abi.h"
+#include "arrow_options.h"
+#include "diag.h"
+#include "errcode.h"
+#include "error.h"
+#include "index.h"
+#include "memcs_index.h"
+#include "msgpuck.h"
+#include "small/region.h"
+#include "space.h"
+#include "space_cache.h"
+#include "space_def.h"
+#include "tuple.h"
+
+/** Aligns a buffer size so that the next buffer is 8-byte aligned. */
+static inline size_t
+memcs_arrow_align(size_t size)
+{
+	return (size + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+}
+
+/** Returns true if the given bit is set in an Arrow validity bitmap. */
+static inline bool
+memcs_arrow_bit(const void *bitmap, int64_t i)
+{
+	return (((const uint8_t *)bitmap)[i >> 3] >> (i & 7)) & 1;
+}
+
+/** Sets the given bit in an Arrow bitmap. */
+static inline void
+memcs_arrow_set_bit(uint8_t *bitmap, int64_t i)
+{
+	bitmap[i >> 3] |= 1 << (i & 7);
+}
+
+/* {{{ Import *****************************************************/
+
+/** Returns true if values of the given Arrow format can be inserted. */
+static bool
+memcs_arrow_format_is_supported(const char *format)
+{
+	if (format == NULL || format[0] == '\0' || format[1] != '\0')
+		return false;
+	switch (format[0]) {
+	case 'C': case 'S': case 'I': case 'L':
+	case 'c': case 's': case 'i': case 'l':
+	case 'f': case 'g': case 'b': case 'u': case 'z':
+		return true;
+	default:
+		return false;
+	}
+}
+
+int
+memcs_arrow_batch_create(struct memcs_arrow_batch *batch,
+			 const struct space_def *def,
+			 const struct ArrowArray *array,
+			 const struct ArrowSchema *schema,
+			 struct region *region)
+{
+	if (schema->format == NULL || strcmp(schema->format, "+s") != 0) {
+		diag_set(ClientError, ER_UNSUPPORTED, "memcs",
+			 "Arrow arrays other than struct");
+		return -1;
+	}
+	if (array->n_children != schema->n_children ||
+	    (array->null_count != 0 && array->buffers[0] != NULL)) {
+		diag_set(DecodeError, "Arrow", "invalid struct array");
+		return -1;
+	}
+	batch->length = array->length;
+	batch->offset = array->offset;
+	batch->field_count = def->field_count;
+	batch->arrays = xregion_alloc_array(region, const struct ArrowArray *,
+					    MAX(def->field_count, 1));
+	batch->schemas = xregion_alloc_array(region,
+					     const struct ArrowSchema *,
+					     MAX(def->field_count, 1));
+	memset(batch->arrays, 0, def->field_count * sizeof(*batch->arrays));
+	memset(batch->schemas, 0, def->field_count * sizeof(*batch->schemas));
+	for (int64_t i = 0; i < schema->n_children; i++) {
+		const struct ArrowSchema *child_schema = schema->children[i];
+		const struct ArrowArray *child = array->children[i];
+		const char *name = child_schema->name != NULL ?
+				   child_schema->name : "";
+		uint32_t fieldno;
+		for (fieldno = 0; fieldno < def->field_count; fieldno++) {
+			if (strcmp(def->fields[fieldno].name, name) == 0)
+				break;
+		}
+		if (fieldno == def->field_count) {
+			diag_set(ClientError, ER_NO_SUCH_FIELD_NAME_IN_SPACE,
+				 name, def->name);
+			return -1;
+		}
+		if (!memcs_arrow_format_is_supported(child_schema->format)) {
+			diag_set(ClientError, ER_UNSUPPORTED, "memcs",
+				 tt_sprintf("Arrow format '%s'",
+					    child_schema->format));
+			return -1;
+		}
+		if (batch->arrays[fieldno] != NULL) {
+			diag_set(DecodeError, "Arrow",
+				 tt_sprintf("duplicate column '%s'", name));
+			return -1;
+		}
+		if (child->length < array->offset + array->length) {
+			diag_set(DecodeError, "Arrow",
+				 tt_sprintf("invalid length of column '%s'",
+					    name));
+			return -1;
+		}
+		batch->arrays[fieldno] = child;
+		batch->schemas[fieldno] = child_schema;
+	}
+	return 0;
+}
+
+/**
+ * Returns true if a batch column value is null. The row number accounts
+ * for the batch and the column offsets.
+ */
+static inline bool
+memcs_arrow_is_null(const struct ArrowArray *array, int64_t i)
+{
+	return array->null_count != 0 && array->buffers[0] != NULL &&
+	       !memcs_arrow_bit(array->buffers[0], i);
+}
+
+/** Returns a string value of a batch column. */
+static inline const char *
+memcs_arrow_str(const struct ArrowArray *array, int64_t i, uint32_t *len)
+{
+	const int32_t *offsets = array->buffers[1];
+	const char *data = array->buffers[2];
+	*len = offsets[i + 1] - offsets[i];
+	return data + offsets[i];
+}
+
+void
+memcs_arrow_batch_encode_row(const struct memcs_arrow_batch *batch,
+			     int64_t row, struct region *region,
+			     const char **data, const char **data_end)
+{
+	/* Trailing nulls are omitted. */
+	uint32_t field_count = 0;
+	size_t size = mp_sizeof_array(batch->field_count) +
+		      batch->field_count * mp_sizeof_nil();
+	for (uint32_t i = 0; i < batch->field_count; i++) {
+		const struct ArrowArray *array = batch->arrays[i];
+		if (array == NULL)
+			continue;
+		int64_t j = array->offset + batch->offset + row;
+		if (memcs_arrow_is_null(array, j))
+			continue;
+		field_count = i + 1;
+		if (batch->schemas[i]->format[0] == 'u' ||
+		    batch->schemas[i]->format[0] == 'z') {
+			uint32_t len;
+			memcs_arrow_str(array, j, &len);
+			size += mp_sizeof_str(len);
+		} else {
+			size += mp_sizeof_double(0);
+		}
+	}
+	char *buf = xregion_alloc(region, size);
+	char *p = mp_encode_array(buf, field_count);
+	for (uint32_t i = 0; i < field_count; i++) {
+		const struct ArrowArray *array = batch->arrays[i];
+		int64_t j = array == NULL ? 0 :
+			    array->offset + batch->offset + row;
+		if (array == NULL || memcs_arrow_is_null(array, j)) {
+			p = mp_encode_nil(p);
+			continue;
+		}
+		const void *values = array->buffers[1];
+		int64_t v;
+		switch (batch->schemas[i]->format[0]) {
+		case 'C':
+			p = mp_encode_uint(p, ((const uint8_t *)values)[j]);
+			break;
+		case 'S':
+			p = mp_encode_uint(p, ((const uint16_t *)values)[j]);
+			break;
+		case 'I':
+			p = mp_encode_uint(p, ((const uint32_t *)values)[j]);
+			break;
+		case 'L':
+			p = mp_encode_uint(p, ((const uint64_t *)values)[j]);
+			break;
+		case 'c':
+			v = ((const int8_t *)values)[j];
+			goto encode_int;
+		case 's':
+			v = ((const int16_t *)values)[j];
+			goto encode_int;
+		case 'i':
+			v = ((const int32_t *)values)[j];
+			goto encode_int;
+		case 'l':
+			v = ((const int64_t *)values)[j];
+encode_int:
+			p = v < 0 ? mp_encode_int(p, v) : mp_encode_uint(p, v);
+			break;
+		case 'f':
+			p = mp_encode_float(p, ((const float *)values)[j]);
+			break;
+		case 'g':
+			p = mp_encode_double(p, ((const double *)values)[j]);
+			break;
+		case 'b':
+			p = mp_encode_bool(p, memcs_arrow_bit(values, j));
+			break;
+		case 'u': {
+			uint32_t len;
+			const char *str = memcs_arrow_str(array, j, &len);
+			p = mp_encode_str(p, str, len);
+			break;
+		}
+		case 'z': {
+			uint32_t len;
+			const char *str = memcs_arrow_str(array, j, &len);
+			p = mp_encode_bin(p, str, len);
+			break;
+		}
+		default:
+			unreachable();
+		}
+	}
+	assert(p <= buf + size);
+	*data = buf;
+	*data_end = p;
+}
+
+/* }}} */
+
+/* {{{ Export *****************************************************/
+
+/** Private data of an Arrow stream returned by a memcs index. */
+struct memcs_arrow_stream {
+	/** Cursor over the index rows. */
+	struct memcs_index_cursor *cursor;
+	/** Column definitions of the space. */
+	struct memcs_column_def *columns;
+	/** Number of fields returned by the stream. */
+	uint32_t field_count;
+	/** Numbers of fields returned by the stream. */
+	uint32_t *fields;
+	/** Names of fields returned by the stream. */
+	char **names;
+	/** Max number of rows in a batch. */
+	uint32_t batch_row_count;
+	/** Buffer for row ids of a batch. */
+	uint64_t *rows;
+	/** Description of the last error or NULL. */
+	const char *last_error;
+};
+
+/** Returns the Arrow format of a column. */
+static const char *
+memcs_arrow_format(const struct memcs_column_def *column)
+{
+	switch (column->type) {
+	case MEMCS_TYPE_UINT:
+		return "L";
+	case MEMCS_TYPE_INT:
+		return "l";
+	case MEMCS_TYPE_DOUBLE:
+		return "g";
+	case MEMCS_TYPE_BOOL:
+		return "b";
+	case MEMCS_TYPE_STR:
+		return column->field_type == FIELD_TYPE_VARBINARY ? "z" : "u";
+	default:
+		unreachable();
+	}
+	return NULL;
+}
+
+static void
+memcs_arrow_child_schema_release(struct ArrowSchema *schema)
+{
+	/* Memory is owned by the parent schema. */
+	schema->release = NULL;
+}
+
+static void
+memcs_arrow_schema_release(struct ArrowSchema *schema)
+{
+	for (int64_t i = 0; i < schema->n_children; i++) {
+		struct ArrowSchema *child = schema->children[i];
+		if (child->release != NULL)
+			child->release(child);
+	}
+	free(schema->private_data);
+	schema->release = NULL;
+}
+
+static int
+memcs_arrow_stream_get_schema(struct ArrowArrayStream *stream,
+			      struct ArrowSchema *out)
+{
+	struct memcs_arrow_stream *s = stream->private_data;
+	uint32_t n = s->field_count;
+	size_t size = n * (sizeof(struct ArrowSchema *) +
+			   sizeof(struct ArrowSchema));
+	char *buf = xmalloc(MAX(size, 1));
+	struct ArrowSchema **children = (struct ArrowSchema **)buf;
+	struct ArrowSchema *child = (struct ArrowSchema *)(children + n);
+	for (uint32_t i = 0; i < n; i++, child++) {
+		const struct memcs_column_def *column =
+			&s->columns[s->fields[i]];
+		memset(child, 0, sizeof(*child));
+		child->format = memcs_arrow_format(column);
+		child->name = s->names[i];
+		child->flags = column->is_nullable ? ARROW_FLAG_NULLABLE : 0;
+		child->release = memcs_arrow_child_schema_release;
+		children[i] = child;
+	}
+	memset(out, 0, sizeof(*out));
+	out->format = "+s";
+	out->name = "";
+	out->n_children = n;
+	out->children = children;
+	out->release = memcs_arrow_schema_release;
+	out->private_data = buf;
+	return 0;
+}
+
+static void
+memcs_arrow_child_array_release(struct ArrowArray *array)
+{
+	free(array->private_data);
+	array->release = NULL;
+}
+
+static void
+memcs_arrow_array_release(struct ArrowArray *array)
+{
+	for (int64_t i = 0; i < array->n_children; i++) {
+		struct ArrowArray *child = array->children[i];
+		if (child->release != NULL)
+			child->release(child);
+	}
+	free(array->private_data);
+	array->release = NULL;
+}
+
+/**
+ * Returns the length of the run of rows that start at rows[i] and are
+ * stored one after another in the same chunk. The chunk and the position
+ * of the first row in the chunk are returned in the output arguments.
+ */
+static uint32_t
+memcs_arrow_row_run(const struct memcs_store *store, const uint64_t *rows,
+		    uint32_t count, uint32_t i,
+		    const struct memcs_chunk **chunk, uint32_t *pos)
+{
+	uint64_t row = rows[i];
+	*chunk = memcs_store_chunk(store, memcs_row_chunk_no(row));
+	*pos = memcs_row_pos(row);
+	uint32_t max_len = MIN(count - i, (*chunk)->size - *pos);
+	uint32_t len = 1;
+	while (len < max_len && rows[i + len] == row + len)
+		len++;
+	return len;
+}
+
+/**
+ * Fills a child array with values of a column. Returns -1 if the column
+ * data doesn't fit in an Arrow string array.
+ */
+static int
+memcs_arrow_column_export(const struct memcs_store *store, uint32_t column,
+			  const uint64_t *rows, uint32_t count,
+			  struct ArrowArray *out)
+{
+	enum memcs_type type = store->columns[column].type;
+	/* Compute the null count and the size of string data. */
+	int64_t null_count = 0;
+	size_t data_size = 0;
+	const struct memcs_chunk *chunk;
+	uint32_t pos, len;
+	for (uint32_t i = 0; i < count; i += len) {
+		len = memcs_arrow_row_run(store, rows, count, i, &chunk, &pos);
+		const struct memcs_chunk_column *c = &chunk->columns[column];
+		for (uint32_t k = 0; k < len; k++) {
+			null_count += c->validity[pos + k] == 0;
+			if (type == MEMCS_TYPE_STR) {
+				const struct memcs_str *str = c->values;
+				data_size += str[pos + k].len;
+			}
+		}
+	}
+	if (data_size > INT32_MAX)
+		return -1;
+	size_t bitmap_size = memcs_arrow_align((count + 7) / 8);
+	size_t values_size;
+	switch (type) {
+	case MEMCS_TYPE_BOOL:
+		values_size = bitmap_size;
+		break;
+	case MEMCS_TYPE_STR:
+		values_size = memcs_arrow_align((count + 1) *
+						sizeof(int32_t));
+		break;
+	default:
+		values_size = count * sizeof(uint64_t);
+		break;
+	}
+	size_t size = memcs_arrow_align(3 * sizeof(void *)) + values_size +
+		      data_size;
+	if (null_count > 0)
+		size += bitmap_size;
+	char *buf = xmalloc(size);
+	const void **buffers = (const void **)buf;
+	char *p = buf + memcs_arrow_align(3 * sizeof(void *));
+	uint8_t *validity = NULL;
+	if (null_count > 0) {
+		validity = (uint8_t *)p;
+		memset(validity, 0, bitmap_size);
+		p += bitmap_size;
+	}
+	char *values = p;
+	p += values_size;
+	if (type == MEMCS_TYPE_BOOL)
+		memset(values, 0, bitmap_size);
+	int32_t *offsets = (int32_t *)values;
+	char *data = p;
+	int32_t offset = 0;
+	if (type == MEMCS_TYPE_STR)
+		offsets[0] = 0;
+	for (uint32_t i = 0; i < count; i += len) {
+		len = memcs_arrow_row_run(store, rows, count, i, &chunk, &pos);
+		const struct memcs_chunk_column *c = &chunk->columns[column];
+		if (validity != NULL) {
+			for (uint32_t k = 0; k < len; k++) {
+				if (c->validity[pos + k] != 0)
+					memcs_arrow_set_bit(validity, i + k);
+			}
+		}
+		switch (type) {
+		case MEMCS_TYPE_UINT:
+		case MEMCS_TYPE_INT:
+		case MEMCS_TYPE_DOUBLE:
+			memcpy(values + i * sizeof(uint64_t),
+			       (const char *)c->values +
+			       pos * sizeof(uint64_t),
+			       len * sizeof(uint64_t));
+			break;
+		case MEMCS_TYPE_BOOL: {
+			const uint8_t *src = c->values;
+			for (uint32_t k = 0; k < len; k++) {
+				if (src[pos + k] != 0)
+					memcs_arrow_set_bit((uint8_t *)values,
+							    i + k);
+			}
+			break;
+		}
+		case MEMCS_TYPE_STR: {
+			const struct memcs_str *src = c->values;
+			for (uint32_t k = 0; k < len; k++) {
+				const struct memcs_str *str = &src[pos + k];
+				memcpy(data + offset, str->data, str->len);
+				offset += str->len;
+				offsets[i + k + 1] = offset;
+			}
+			break;
+		}
+		default:
+			unreachable();
+		}
+	}
+	memset(out, 0, sizeof(*out));
+	out->length = count;
+	out->null_count = null_count;
+	out->n_buffers = type == MEMCS_TYPE_STR ? 3 : 2;
+	buffers[0] = validity;
+	buffers[1] = values;
+	buffers[2] = data;
+	out->buffers = buffers;
+	out->release = memcs_arrow_child_array_release;
+	out->private_data = buf;
+	return 0;
+}
+
+static int
+memcs_arrow_stream_get_next(struct ArrowArrayStream *stream,
+			    struct ArrowArray *out)
+{
+	struct memcs_arrow_stream *s = stream->private_data;
+	s->last_error = NULL;
+	uint32_t count = memcs_index_cursor_next(s->cursor, s->rows,
+						 s->batch_row_count);
+	memset(out, 0, sizeof(*out));
+	if (count == 0) {
+		/* End of stream. */
+		return 0;
+	}
+	const struct memcs_store *store = memcs_index_cursor_store(s->cursor);
+	uint32_t n = s->field_count;
+	size_t size = n * (sizeof(struct ArrowArray *) +
+			   sizeof(struct ArrowArray)) + sizeof(void *);
+	char *buf = xmalloc(size);
+	struct ArrowArray **children = (struct ArrowArray **)buf;
+	struct ArrowArray *child = (struct ArrowArray *)(children + n);
+	const void **buffers = (const void **)(child + n);
+	buffers[0] = NULL;
+	out->length = count;
+	out->n_buffers = 1;
+	out->buffers = buffers;
+	out->n_children = n;
+	out->children = children;
+	out->release = memcs_arrow_array_release;
+	out->private_data = buf;
+	for (uint32_t i = 0; i < n; i++, child++) {
+		children[i] = child;
+		child->release = NULL;
+	}
+	for (uint32_t i = 0; i < n; i++) {
+		if (memcs_arrow_column_export(store, s->fields[i], s->rows,
+					      count, children[i]) != 0) {
+			out->release(out);
+			s->last_error = "string data of a batch column "
+					"exceeds 2 GB, reduce batch_row_count";
+			return EOVERFLOW;
+		}
+	}
+	return 0;
+}
+
+static const char *
+memcs_arrow_stream_get_last_error(struct ArrowArrayStream *stream)
+{
+	struct memcs_arrow_stream *s = stream->private_data;
+	return s->last_error;
+}
+
+static void
+memcs_arrow_stream_release(struct ArrowArrayStream *stream)
+{
+	struct memcs_arrow_stream *s = stream->private_data;
+	memcs_index_cursor_delete(s->cursor);
+	free(s->columns);
+	TRASH(s);
+	free(s);
+	stream->release = NULL;
+}
+
+int
+memcs_index_create_arrow_stream(struct index *index,
+				uint32_t field_count, const uint32_t *fields,
+				const char *key, uint32_t part_count,
+				const struct arrow_options *options,
+				struct ArrowArrayStream *stream)
+{
+	if (options->iterator > ITER_GT) {
+		diag_set(UnsupportedIndexFeature, index->def,
+			 "requested iterator type");
+		return -1;
+	}
+	if (options->force_view_types) {
+		diag_set(ClientError, ER_UNSUPPORTED, "memcs",
+			 "Arrow view types");
+		return -1;
+	}
+	struct space *space = space_by_id(index->def->space_id);
+	assert(space != NULL);
+	/*
+	 * Columns of an empty store may be out of date, so use the space
+	 * format. They are the same for a non-empty store.
+	 */
+	uint32_t column_count;
+	struct memcs_column_def *columns =
+		memcs_column_defs_new(space->format, &column_count);
+	if (columns == NULL)
+		return -1;
+	size_t names_size = 0;
+	for (uint32_t i = 0; i < field_count; i++) {
+		if (fields[i] >= column_count) {
+			diag_set(ClientError, ER_NO_SUCH_FIELD_NO,
+				 fields[i] + TUPLE_INDEX_BASE);
+			free(columns);
+			return -1;
+		}
+		if (fields[i] < space->def->field_count)
+			names_size += strlen(space->def->fields[fields[i]].name);
+		else
+			names_size += strlen(int2str(fields[i] +
+						     TUPLE_INDEX_BASE));
+		names_size += 1;
+	}
+	size_t size = sizeof(struct memcs_arrow_stream) +
+		      field_count * sizeof(char *) +
+		      options->batch_row_count * sizeof(uint64_t) +
+		      field_count * sizeof(uint32_t) + names_size;
+	struct memcs_arrow_stream *s = xmalloc(size);
+	s->names = (char **)(s + 1);
+	s->rows = (uint64_t *)(s->names + field_count);
+	s->fields = (uint32_t *)(s->rows + options->batch_row_count);
+	char *name = (char *)(s->fields + field_count);
+	for (uint32_t i = 0; i < field_count; i++) {
+		s->fields[i] = fields[i];
+		const char *src = fields[i] < space->def->field_count ?
+				  space->def->fields[fields[i]].name :
+				  int2str(fields[i] + TUPLE_INDEX_BASE);
+		size_t len = strlen(src) + 1;
+		memcpy(name, src, len);
+		s->names[i] = name;
+		name += len;
+	}
+	assert(name == (char *)s + size);
+	s->columns = columns;
+	s->field_count = field_count;
+	s->batch_row_count = options->batch_row_count;
+	s->last_error = NULL;
+	s->cursor = memcs_index_cursor_new(index, options->iterator,
+					   key, part_count);
+	stream->get_schema = memcs_arrow_stream_get_schema;
+	stream->get_next = memcs_arrow_stream_get_next;
+	stream->get_last_error = memcs_arrow_stream_get_last_error;
+	stream->release = memcs_arrow_stream_release;
+	stream->private_data = s;
+	return 0;
+}
+
+/* }}} */
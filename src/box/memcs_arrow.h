@@ -0,0 +1,79 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2025, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct ArrowArray;
+struct ArrowArrayStream;
+struct ArrowSchema;
+struct arrow_options;
+struct index;
+struct region;
+struct space_def;
+
+/**
+ * Arrow record batch being inserted into a memcs space. Batch columns
+ * are matched with space fields by name.
+ */
+struct memcs_arrow_batch {
+	/** Number of rows in the batch. */
+	int64_t length;
+	/** Offset of the first row in the batch. */
+	int64_t offset;
+	/**
+	 * Batch column arrays, one per space field, NULL if the batch
+	 * doesn't have a column for the field.
+	 */
+	const struct ArrowArray **arrays;
+	/** Batch column schemas, one per space field. */
+	const struct ArrowSchema **schemas;
+	/** Number of space fields. */
+	uint32_t field_count;
+};
+
+/**
+ * Prepares a record batch for inserting into a space with the given
+ * definition. The batch arrays are allocated on the region. Returns -1
+ * and sets diag if the batch has an unsupported layout.
+ */
+int
+memcs_arrow_batch_create(struct memcs_arrow_batch *batch,
+			 const struct space_def *def,
+			 const struct ArrowArray *array,
+			 const struct ArrowSchema *schema,
+			 struct region *region);
+
+/**
+ * Encodes a batch row in MsgPack on the region. Fields missing from the
+ * batch are encoded as nulls. The result must be validated against the
+ * space format.
+ */
+void
+memcs_arrow_batch_encode_row(const struct memcs_arrow_batch *batch,
+			     int64_t row, struct region *region,
+			     const char **data, const char **data_end);
+
+/**
+ * Creates an Arrow stream that returns the given fields of the memcs index
+ * rows matching the key. The stream returns a frozen image of the index:
+ * changes made after the stream was created aren't visible. The stream
+ * must be released in the tx thread.
+ */
+int
+memcs_index_create_arrow_stream(struct index *index,
+				uint32_t field_count, const uint32_t *fields,
+				const char *key, uint32_t part_count,
+				const struct arrow_options *options,
+				struct ArrowArrayStream *stream);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -0,0 +1,1052 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2025, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "memcs_engine.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "small/matras.h"
+#include "small/region.h"
+#include "small/rlist.h"
+
+#include "arrow/abi.h"
+#include "column_mask.h"
+#include "diag.h"
+#include "engine.h"
+#include "errcode.h"
+#include "errinj.h"
+#include "error.h"
+#include "fiber.h"
+#include "index.h"
+#include "iproto_constants.h"
+#include "memcs_arrow.h"
+#include "memcs_index.h"
+#include "space.h"
+#include "space_def.h"
+#include "tuple.h"
+#include "txn.h"
+#include "xrow.h"
+#include "xrow_update.h"
+
+struct memcs_engine {
+	/** Base class. */
+	struct engine base;
+	/** Allocator of primary key tree extents. */
+	struct matras_allocator tree_allocator;
+};
+
+struct memcs_space {
+	/** Base class. */
+	struct space base;
+	/** Column definitions built from the space format. */
+	struct memcs_column_def *columns;
+	/** Number of columns. */
+	uint32_t column_count;
+};
+
+/** A row change done by a statement. */
+struct memcs_undo {
+	/** Replaced or deleted row or MEMCS_ROW_NONE. */
+	uint64_t old_row;
+	/** Inserted row or MEMCS_ROW_NONE. */
+	uint64_t new_row;
+};
+
+/**
+ * Row changes done by a statement, stored in txn_stmt::engine_savepoint.
+ * Allocated on the transaction region.
+ */
+struct memcs_undo_log {
+	/** Number of changes. */
+	uint32_t count;
+	/** Changes in the order they were done. */
+	struct memcs_undo entries[0];
+};
+
+static inline enum dup_replace_mode
+dup_replace_mode(uint16_t op)
+{
+	return op == IPROTO_INSERT ? DUP_INSERT : DUP_REPLACE_OR_INSERT;
+}
+
+/* {{{ DML ********************************************************/
+
+/**
+ * Returns the store of a space primary key with the columns bound to
+ * the current space format.
+ */
+static struct memcs_store *
+memcs_space_store(struct space *base, struct index *pk)
+{
+	struct memcs_space *space = (struct memcs_space *)base;
+	struct memcs_store *store = memcs_index_store(pk);
+	/*
+	 * The format of an empty space may be altered without rebuilding
+	 * the primary key so bind the columns on the first write.
+	 */
+	if (store->chunk_count == 0 &&
+	    !memcs_column_defs_equal(store->columns, store->column_count,
+				     space->columns, space->column_count))
+		memcs_store_set_columns(store, space->columns,
+					space->column_count);
+	return store;
+}
+
+/**
+ * Reserves memory needed to change a row so that neither the change nor
+ * its commit or rollback can fail half-way. Returns -1 and sets diag on
+ * memory allocation error.
+ */
+static int
+memcs_space_reserve(struct space *space, struct memcs_store *store)
+{
+	struct memcs_engine *memcs = (struct memcs_engine *)space->engine;
+	if (matras_allocator_reserve(&memcs->tree_allocator,
+				     MEMCS_TREE_RESERVE_EXTENTS) != 0)
+		return -1;
+	return memcs_store_reserve_free(store);
+}
+
+/**
+ * Allocates an undo log with the given capacity for the current statement.
+ * The statement is rolled back with the engine as soon as the log is set.
+ * Returns NULL and sets diag on memory allocation error.
+ */
+static struct memcs_undo_log *
+memcs_undo_log_new(struct txn *txn, uint32_t capacity)
+{
+	size_t size = sizeof(struct memcs_undo_log) +
+		      (size_t)capacity * sizeof(struct memcs_undo);
+	ERROR_INJECT(ERRINJ_MEMCS_UNDO_ALLOC, {
+		diag_set(OutOfMemory, size, "region_aligned_alloc",
+			 "memcs undo log");
+		return NULL;
+	});
+	struct region *region = tx_region_acquire(txn);
+	struct memcs_undo_log *log = region_aligned_alloc(
+		region, size, alignof(struct memcs_undo_log));
+	tx_region_release(txn, TX_ALLOC_SYSTEM);
+	if (log == NULL) {
+		diag_set(OutOfMemory, size, "region_aligned_alloc",
+			 "memcs undo log");
+		return NULL;
+	}
+	log->count = 0;
+	txn_current_stmt(txn)->engine_savepoint = log;
+	return log;
+}
+
+/**
+ * Sets a statement diag error for a duplicate key found in the primary
+ * key. Tuples are materialized only to format the error message.
+ */
+static void
+memcs_space_set_dup_error(struct tuple_format *format, struct index *pk,
+			  struct tuple *old_tuple, const char *data,
+			  const char *data_end, uint64_t dup_row,
+			  enum dup_replace_mode mode)
+{
+	struct tuple *new_tuple = tuple_new(format, data, data_end);
+	if (new_tuple == NULL)
+		return;
+	tuple_ref(new_tuple);
+	struct tuple *dup_tuple = NULL;
+	if (dup_row != MEMCS_ROW_NONE) {
+		dup_tuple = memcs_index_tuple_new(pk, format, dup_row);
+		if (dup_tuple == NULL)
+			goto out;
+		tuple_ref(dup_tuple);
+	}
+	int rc = index_check_dup(pk, old_tuple, new_tuple, dup_tuple, mode);
+	assert(rc != 0);
+	(void)rc;
+	if (dup_tuple != NULL)
+		tuple_unref(dup_tuple);
+out:
+	tuple_unref(new_tuple);
+}
+
+/**
+ * Inserts a row decoded from the given MsgPack data into the primary key.
+ * The data must have been validated against the space format.
+ *
+ * If @a old_row is MEMCS_ROW_NONE, the row with the same key is replaced
+ * (or a duplicate key error is raised, depending on @a mode). Otherwise
+ * @a old_row is replaced, and it must have the same key as the new row.
+ * @a old_tuple is the materialized @a old_row, used for error messages.
+ *
+ * The replaced row id is returned in @a replaced_row. The change is
+ * appended to the undo log. The replaced row is freed when the change is
+ * committed, the new row when it's rolled back.
+ */
+static int
+memcs_space_insert_row(struct space *space, struct index *pk,
+		       struct memcs_undo_log *log, const char *data,
+		       const char *data_end, uint64_t old_row,
+		       struct tuple *old_tuple, enum dup_replace_mode mode,
+		       uint64_t *replaced_row)
+{
+	struct memcs_store *store = memcs_space_store(space, pk);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	int rc = -1;
+	struct memcs_field *fields = xregion_alloc_array(
+		region, struct memcs_field, MAX(store->column_count, 1));
+	uint32_t field_count;
+	if (memcs_store_decode(store, data, fields, &field_count) != 0)
+		goto out;
+	uint64_t dup_row = memcs_index_find_fields(pk, fields);
+	if ((mode == DUP_INSERT && dup_row != MEMCS_ROW_NONE) ||
+	    (mode == DUP_REPLACE && dup_row != old_row)) {
+		memcs_space_set_dup_error(space->format, pk, old_tuple, data,
+					  data_end, dup_row, mode);
+		goto out;
+	}
+	if (old_row == MEMCS_ROW_NONE)
+		old_row = dup_row;
+	if (memcs_space_reserve(space, store) != 0)
+		goto out;
+	uint64_t new_row;
+	if (memcs_store_append(store, fields, field_count, &new_row) != 0) {
+		memcs_store_free_row(store, MEMCS_ROW_NONE);
+		goto out;
+	}
+	if ((old_row != MEMCS_ROW_NONE ?
+	     memcs_index_replace_row(pk, old_row, new_row) :
+	     memcs_index_insert_row(pk, new_row)) != 0) {
+		/* The new row has never been visible. */
+		memcs_store_free_row(store, new_row);
+		goto out;
+	}
+	struct memcs_undo *undo = &log->entries[log->count++];
+	undo->old_row = old_row;
+	undo->new_row = new_row;
+	*replaced_row = old_row;
+	rc = 0;
+out:
+	region_truncate(region, region_svp);
+	return rc;
+}
+
+static int
+memcs_space_execute_replace(struct space *space, struct txn *txn,
+			    struct request *request, struct tuple **result)
+{
+	struct index *pk = index_find(space, 0);
+	if (pk == NULL)
+		return -1;
+	/* Validates the tuple against the space format. */
+	struct tuple *new_tuple = tuple_new(space->format, request->tuple,
+					    request->tuple_end);
+	if (new_tuple == NULL) {
+		error_set_space(diag_last_error(diag_get()), space->def);
+		return -1;
+	}
+	tuple_ref(new_tuple);
+	int rc = -1;
+	struct tuple *old_tuple = NULL;
+	struct memcs_undo_log *log = memcs_undo_log_new(txn, 1);
+	if (log == NULL)
+		goto out;
+	uint64_t old_row;
+	if (memcs_space_insert_row(space, pk, log, request->tuple,
+				   request->tuple_end, MEMCS_ROW_NONE, NULL,
+				   dup_replace_mode(request->type),
+				   &old_row) != 0)
+		goto out;
+	if (old_row != MEMCS_ROW_NONE) {
+		old_tuple = memcs_index_tuple_new(pk, space->format, old_row);
+		if (old_tuple == NULL)
+			goto out;
+		tuple_ref(old_tuple);
+	}
+	txn_stmt_set_tuples(txn_current_stmt(txn), old_tuple, new_tuple);
+	*result = new_tuple;
+	rc = 0;
+out:
+	if (old_tuple != NULL)
+		tuple_unref(old_tuple);
+	tuple_unref(new_tuple);
+	return rc;
+}
+
+static int
+memcs_space_execute_delete(struct space *space, struct txn *txn,
+			   struct request *request, struct tuple **result)
+{
+	struct index *pk = index_find(space, request->index_id);
+	if (pk == NULL)
+		return -1;
+	const char *key = request->key;
+	uint32_t part_count = mp_decode_array(&key);
+	if (exact_key_validate(pk->def, key, part_count) != 0)
+		return -1;
+	uint64_t old_row = memcs_index_find_key(pk, key, part_count);
+	if (old_row == MEMCS_ROW_NONE) {
+		*result = NULL;
+		return 0;
+	}
+	struct tuple *old_tuple = memcs_index_tuple_new(pk, space->format,
+							old_row);
+	if (old_tuple == NULL)
+		return -1;
+	tuple_ref(old_tuple);
+	struct memcs_store *store = memcs_index_store(pk);
+	struct memcs_undo_log *log = memcs_undo_log_new(txn, 1);
+	if (log == NULL || memcs_space_reserve(space, store) != 0) {
+		tuple_unref(old_tuple);
+		return -1;
+	}
+	if (memcs_index_delete_row(pk, old_row) != 0) {
+		memcs_store_free_row(store, MEMCS_ROW_NONE);
+		tuple_unref(old_tuple);
+		return -1;
+	}
+	struct memcs_undo *undo = &log->entries[log->count++];
+	undo->old_row = old_row;
+	undo->new_row = MEMCS_ROW_NONE;
+	txn_stmt_set_tuples(txn_current_stmt(txn), old_tuple, NULL);
+	tuple_bless(old_tuple);
+	tuple_unref(old_tuple);
+	*result = old_tuple;
+	return 0;
+}
+
+static int
+memcs_space_execute_update(struct space *space, struct txn *txn,
+			   struct request *request, struct tuple **result)
+{
+	struct index *pk = index_find(space, request->index_id);
+	if (pk == NULL)
+		return -1;
+	const char *key = request->key;
+	uint32_t part_count = mp_decode_array(&key);
+	if (exact_key_validate(pk->def, key, part_count) != 0)
+		return -1;
+	uint64_t old_row = memcs_index_find_key(pk, key, part_count);
+	if (old_row == MEMCS_ROW_NONE) {
+		*result = NULL;
+		return 0;
+	}
+	struct tuple *old_tuple = memcs_index_tuple_new(pk, space->format,
+							old_row);
+	if (old_tuple == NULL)
+		return -1;
+	tuple_ref(old_tuple);
+	int rc = -1;
+	struct tuple *new_tuple = NULL;
+	/* Update the tuple; legacy, request ops are in request->tuple */
+	uint32_t new_size = 0, bsize;
+	const char *old_data = tuple_data_range(old_tuple, &bsize);
+	size_t region_svp = region_used(&fiber()->gc);
+	const char *new_data =
+		xrow_update_execute(request->tuple, request->tuple_end,
+				    old_data, old_data + bsize, space->format,
+				    &new_size, request->index_base, NULL);
+	if (new_data == NULL) {
+		error_set_index(diag_last_error(diag_get()), pk->def);
+		goto out;
+	}
+	new_tuple = tuple_new(space->format, new_data, new_data + new_size);
+	if (new_tuple == NULL) {
+		error_set_index(diag_last_error(diag_get()), pk->def);
+		goto out;
+	}
+	tuple_ref(new_tuple);
+	struct memcs_undo_log *log = memcs_undo_log_new(txn, 1);
+	if (log == NULL)
+		goto out;
+	uint64_t replaced_row;
+	if (memcs_space_insert_row(space, pk, log, new_data,
+				   new_data + new_size, old_row, old_tuple,
+				   DUP_REPLACE, &replaced_row) != 0)
+		goto out;
+	assert(replaced_row == old_row);
+	txn_stmt_set_tuples(txn_current_stmt(txn), old_tuple, new_tuple);
+	*result = new_tuple;
+	rc = 0;
+out:
+	region_truncate(&fiber()->gc, region_svp);
+	if (new_tuple != NULL)
+		tuple_unref(new_tuple);
+	tuple_unref(old_tuple);
+	return rc;
+}
+
+static int
+memcs_space_execute_upsert(struct space *space, struct txn *txn,
+			   struct request *request)
+{
+	/*
+	 * Check all tuple fields: we should produce an error on
+	 * malformed tuple even if upsert turns into an update.
+	 */
+	if (tuple_validate_raw(space->format, request->tuple)) {
+		error_set_space(diag_last_error(diag_get()), space->def);
+		return -1;
+	}
+	struct index *pk = index_find(space, 0);
+	if (pk == NULL)
+		return -1;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	int rc = -1;
+	struct tuple *old_tuple = NULL;
+	struct tuple *new_tuple = NULL;
+	uint64_t old_row = MEMCS_ROW_NONE;
+	/* Extract the primary key from tuple. */
+	const char *key = tuple_extract_key_raw(request->tuple,
+						request->tuple_end,
+						pk->def->key_def,
+						MULTIKEY_NONE, NULL);
+	if (key == NULL)
+		goto out;
+	/* Cut array header */
+	uint32_t part_count = mp_decode_array(&key);
+	old_row = memcs_index_find_key(pk, key, part_count);
+	const char *new_data;
+	uint32_t new_size;
+	if (old_row == MEMCS_ROW_NONE) {
+		/* See the comment in memtx_space_execute_upsert(). */
+		if (xrow_update_check_ops(request->ops, request->ops_end,
+					  space->format,
+					  request->index_base) != 0) {
+			error_set_space(diag_last_error(diag_get()),
+					space->def);
+			goto out;
+		}
+		new_data = request->tuple;
+		new_size = request->tuple_end - request->tuple;
+	} else {
+		old_tuple = memcs_index_tuple_new(pk, space->format, old_row);
+		if (old_tuple == NULL)
+			goto out;
+		tuple_ref(old_tuple);
+		uint32_t bsize;
+		const char *old_data = tuple_data_range(old_tuple, &bsize);
+		/*
+		 * Update the tuple.
+		 * xrow_upsert_execute() fails on totally wrong
+		 * tuple ops, but ignores ops that not suitable
+		 * for the tuple.
+		 */
+		uint64_t column_mask = COLUMN_MASK_FULL;
+		new_data = xrow_upsert_execute(request->ops, request->ops_end,
+					       old_data, old_data + bsize,
+					       space->format, &new_size,
+					       request->index_base, false,
+					       &column_mask);
+		if (new_data == NULL) {
+			error_set_space(diag_last_error(diag_get()),
+					space->def);
+			goto out;
+		}
+	}
+	new_tuple = tuple_new(space->format, new_data, new_data + new_size);
+	if (new_tuple == NULL) {
+		error_set_space(diag_last_error(diag_get()), space->def);
+		goto out;
+	}
+	tuple_ref(new_tuple);
+	if (old_tuple != NULL &&
+	    tuple_compare(old_tuple, HINT_NONE, new_tuple, HINT_NONE,
+			  pk->def->key_def) != 0) {
+		/* Primary key is changed: log error and do nothing. */
+		diag_set(ClientError, ER_CANT_UPDATE_PRIMARY_KEY,
+			 space_name(space), space_id(space),
+			 old_tuple, new_tuple, NULL);
+		diag_log();
+		rc = 0;
+		goto out;
+	}
+	struct memcs_undo_log *log = memcs_undo_log_new(txn, 1);
+	if (log == NULL)
+		goto out;
+	uint64_t replaced_row;
+	/*
+	 * It's OK to use DUP_REPLACE_OR_INSERT: we don't risk
+	 * inserting a new tuple if the old one exists, since
+	 * we checked this case explicitly and skipped the upsert
+	 * above.
+	 */
+	if (memcs_space_insert_row(space, pk, log, new_data,
+				   new_data + new_size, old_row, old_tuple,
+				   DUP_REPLACE_OR_INSERT, &replaced_row) != 0)
+		goto out;
+	assert(replaced_row == old_row);
+	txn_stmt_set_tuples(txn_current_stmt(txn), old_tuple, new_tuple);
+	/* Return nothing: UPSERT does not return data. */
+	rc = 0;
+out:
+	region_truncate(region, region_svp);
+	if (new_tuple != NULL)
+		tuple_unref(new_tuple);
+	if (old_tuple != NULL)
+		tuple_unref(old_tuple);
+	return rc;
+}
+
+static int
+memcs_space_execute_insert_arrow(struct space *space, struct txn *txn,
+				 struct ArrowArray *array,
+				 struct ArrowSchema *schema)
+{
+	struct index *pk = index_find(space, 0);
+	if (pk == NULL)
+		return -1;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	int rc = -1;
+	struct memcs_arrow_batch batch;
+	if (memcs_arrow_batch_create(&batch, space->def, array, schema,
+				     region) != 0)
+		goto out;
+	if (batch.length > UINT32_MAX) {
+		diag_set(ClientError, ER_UNSUPPORTED, "memcs",
+			 "Arrow batches with more than 4294967295 rows");
+		goto out;
+	}
+	/*
+	 * Rows inserted before an error are removed when the statement
+	 * is rolled back.
+	 */
+	struct memcs_undo_log *log = memcs_undo_log_new(txn, batch.length);
+	if (log == NULL)
+		goto out;
+	for (int64_t i = 0; i < batch.length; i++) {
+		size_t row_svp = region_used(region);
+		const char *data, *data_end;
+		memcs_arrow_batch_encode_row(&batch, i, region,
+					     &data, &data_end);
+		if (tuple_validate_raw(space->format, data) != 0) {
+			error_set_space(diag_last_error(diag_get()),
+					space->def);
+			goto out;
+		}
+		uint64_t unused;
+		if (memcs_space_insert_row(space, pk, log, data, data_end,
+					   MEMCS_ROW_NONE, NULL, DUP_INSERT,
+					   &unused) != 0)
+			goto out;
+		region_truncate(region, row_svp);
+	}
+	rc = 0;
+out:
+	region_truncate(region, region_svp);
+	return rc;
+}
+
+/* }}} */
+
+/* {{{ DDL ********************************************************/
+
+static void
+memcs_space_destroy(struct space *base)
+{
+	struct memcs_space *space = (struct memcs_space *)base;
+	free(space->columns);
+	TRASH(space);
+	free(space);
+}
+
+static size_t
+memcs_space_bsize(struct space *space)
+{
+	struct index *pk = space_index(space, 0);
+	if (pk == NULL)
+		return 0;
+	return memcs_index_store(pk)->mem_used;
+}
+
+static int
+memcs_space_check_index_def(struct space *space, struct index_def *index_def)
+{
+	if (index_def->type != TREE) {
+		diag_set(ClientError, ER_INDEX_TYPE,
+			 index_def->name, space_name(space));
+		return -1;
+	}
+	if (index_def->iid != 0) {
+		diag_set(ClientError, ER_UNSUPPORTED, "memcs",
+			 "secondary indexes");
+		return -1;
+	}
+	struct key_def *key_def = index_def->key_def;
+	if (key_def->is_nullable) {
+		diag_set(ClientError, ER_NULLABLE_PRIMARY, space_name(space));
+		return -1;
+	}
+	if (index_def_check_field_types(index_def, space_name(space)) != 0)
+		return -1;
+	if (key_def->for_func_index) {
+		diag_set(ClientError, ER_UNSUPPORTED, "memcs",
+			 "functional index");
+		return -1;
+	}
+	if (key_def->is_multikey || key_def->has_json_paths) {
+		diag_set(ClientError, ER_UNSUPPORTED, "memcs",
+			 "JSON path indexes");
+		return -1;
+	}
+	for (uint32_t i = 0; i < key_def->part_count; i++) {
+		const struct key_part *part = &key_def->parts[i];
+		enum memcs_type type = memcs_type_by_field_type(part->type);
+		if (type == memcs_type_MAX) {
+			diag_set(ClientError, ER_MODIFY_INDEX,
+				 index_def->name, space_name(space),
+				 tt_sprintf("field type '%s' is not supported "
+					    "by memcs",
+					    field_type_strs[part->type]));
+			return -1;
+		}
+		if (part->coll != NULL) {
+			diag_set(ClientError, ER_UNSUPPORTED, "memcs",
+				 "collations");
+			return -1;
+		}
+		if (part->fieldno < space->def->field_count &&
+		    memcs_type_by_field_type(
+			space->def->fields[part->fieldno].type) != type) {
+			diag_set(ClientError, ER_MODIFY_INDEX,
+				 index_def->name, space_name(space),
+				 "index part type must match the space "
+				 "field type");
+			return -1;
+		}
+	}
+	if (index_def->opts.hint == INDEX_HINT_ON) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name(space),
+			 "hint is only reasonable with memtx tree index");
+		return -1;
+	}
+	if (index_def->opts.fingerprint) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name(space), "fingerprint is only reasonable "
+			 "with memtx hash index over one unsigned field");
+		return -1;
+	}
+	if (index_def->opts.prefix_hint) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name(space), "prefix_hint is only reasonable "
+			 "with memtx tree index with hints");
+		return -1;
+	}
+	if (index_def->opts.covered_field_count != 0) {
+		diag_set(ClientError, ER_UNSUPPORTED, "memcs",
+			 "covering index");
+		return -1;
+	}
+	if (index_def->opts.layout != NULL) {
+		diag_set(ClientError, ER_UNSUPPORTED, "memcs",
+			 "'layout' option");
+		return -1;
+	}
+	if (index_def->opts.aggregates != NULL) {
+		diag_set(ClientError, ER_UNSUPPORTED, "memcs",
+			 "'aggregates' option");
+		return -1;
+	}
+	return 0;
+}
+
+static struct index *
+memcs_space_create_index(struct space *space, struct index_def *index_def)
+{
+	assert(index_def->type == TREE && index_def->iid == 0);
+	struct memcs_engine *memcs = (struct memcs_engine *)space->engine;
+	return memcs_index_new(&memcs->base, index_def,
+			       &memcs->tree_allocator);
+}
+
+static int
+memcs_space_check_format(struct space *space, struct tuple_format *format)
+{
+	struct index *pk = space_index(space, 0);
+	if (pk == NULL)
+		return 0;
+	uint32_t column_count;
+	struct memcs_column_def *columns =
+		memcs_column_defs_new(format, &column_count);
+	if (columns == NULL)
+		return -1;
+	int rc = 0;
+	const struct key_def *key_def = pk->def->key_def;
+	for (uint32_t i = 0; i < key_def->part_count; i++) {
+		const struct key_part *part = &key_def->parts[i];
+		if (part->fieldno < column_count &&
+		    columns[part->fieldno].type !=
+		    memcs_type_by_field_type(part->type)) {
+			diag_set(ClientError, ER_ALTER_SPACE,
+				 space_name(space),
+				 "can not change the type of a primary key "
+				 "field of a memcs space");
+			rc = -1;
+			goto out;
+		}
+	}
+	/*
+	 * Rows are stored in columns of fixed types so the format of
+	 * a space that has data can't be changed without a rebuild.
+	 */
+	const struct memcs_store *store = memcs_index_store(pk);
+	if (store->chunk_count > 0 &&
+	    !memcs_column_defs_equal(store->columns, store->column_count,
+				     columns, column_count)) {
+		diag_set(ClientError, ER_ALTER_SPACE, space_name(space),
+			 "can not change field types of a non-empty "
+			 "memcs space");
+		rc = -1;
+	}
+out:
+	free(columns);
+	return rc;
+}
+
+static int
+memcs_space_build_index(struct space *src_space, struct index *new_index,
+			struct tuple_format *new_format,
+			bool check_unique_constraint)
+{
+	(void)check_unique_constraint;
+	assert(new_index->def->iid == 0);
+	struct index *pk = space_index(src_space, 0);
+	if (pk == NULL)
+		return 0;
+	uint32_t column_count;
+	struct memcs_column_def *columns =
+		memcs_column_defs_new(new_format, &column_count);
+	if (columns == NULL)
+		return -1;
+	struct memcs_store *store = memcs_index_store(new_index);
+	memcs_store_set_columns(store, columns, column_count);
+	free(columns);
+	const struct memcs_store *src_store = memcs_index_store(pk);
+	struct memcs_index_cursor *cursor =
+		memcs_index_cursor_new(pk, ITER_ALL, NULL, 0);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct memcs_field *fields = xregion_alloc_array(
+		region, struct memcs_field, MAX(column_count, 1));
+	int rc = -1;
+	uint64_t row;
+	while (memcs_index_cursor_next(cursor, &row, 1) > 0) {
+		size_t row_svp = region_used(region);
+		uint32_t size = memcs_store_row_bsize(src_store, row);
+		char *data = xregion_alloc(region, size);
+		char *data_end = memcs_store_row_encode(src_store, row, data);
+		uint32_t field_count;
+		if (tuple_validate_raw(new_format, data) != 0 ||
+		    memcs_store_decode(store, data, fields,
+				       &field_count) != 0)
+			goto out;
+		uint64_t dup_row = memcs_index_find_fields(new_index, fields);
+		if (dup_row != MEMCS_ROW_NONE) {
+			memcs_space_set_dup_error(new_format, new_index, NULL,
+						  data, data_end, dup_row,
+						  DUP_INSERT);
+			goto out;
+		}
+		uint64_t new_row;
+		if (memcs_store_append(store, fields, field_count,
+				       &new_row) != 0 ||
+		    memcs_index_insert_row(new_index, new_row) != 0)
+			goto out;
+		region_truncate(region, row_svp);
+	}
+	rc = 0;
+out:
+	region_truncate(region, region_svp);
+	memcs_index_cursor_delete(cursor);
+	return rc;
+}
+
+static const struct space_vtab memcs_space_vtab = {
+	/* .destroy = */ memcs_space_destroy,
+	/* .bsize = */ memcs_space_bsize,
+	/* .execute_replace = */ memcs_space_execute_replace,
+	/* .execute_delete = */ memcs_space_execute_delete,
+	/* .execute_update = */ memcs_space_execute_update,
+	/* .execute_upsert = */ memcs_space_execute_upsert,
+	/* .execute_insert_arrow = */ memcs_space_execute_insert_arrow,
+	/* .ephemeral_replace = */ generic_space_ephemeral_replace,
+	/* .ephemeral_delete = */ generic_space_ephemeral_delete,
+	/* .ephemeral_rowid_next = */ generic_space_ephemeral_rowid_next,
+	/* .init_system_space = */ generic_init_system_space,
+	/* .init_ephemeral_space = */ generic_init_ephemeral_space,
+	/* .check_index_def = */ memcs_space_check_index_def,
+	/* .create_index = */ memcs_space_create_index,
+	/* .add_primary_key = */ generic_space_add_primary_key,
+	/* .drop_primary_key = */ generic_space_drop_primary_key,
+	/* .check_format = */ memcs_space_check_format,
+	/* .build_index = */ memcs_space_build_index,
+	/* .swap_index = */ generic_space_swap_index,
+	/* .prepare_alter = */ generic_space_prepare_alter,
+	/* .finish_alter = */ generic_space_finish_alter,
+	/* .prepare_upgrade = */ generic_space_prepare_upgrade,
+	/* .invalidate = */ generic_space_invalidate,
+};
+
+/* }}} */
+
+/* {{{ Engine *****************************************************/
+
+static void
+memcs_engine_free(struct engine *engine)
+{
+	struct memcs_engine *memcs = (struct memcs_engine *)engine;
+	matras_allocator_destroy(&memcs->tree_allocator);
+	TRASH(memcs);
+	free(memcs);
+}
+
+static struct space *
+memcs_engine_create_space(struct engine *engine, struct space_def *def,
+			  struct rlist *key_list)
+{
+	/* Create a format from key and field definitions. */
+	int key_count = 0;
+	size_t region_svp = region_used(&fiber()->gc);
+	struct key_def **keys = index_def_to_key_def(key_list, &key_count);
+	struct tuple_format *format =
+		space_tuple_format_new(&tuple_format_runtime->vtab, NULL,
+				       keys, key_count, def);
+	region_truncate(&fiber()->gc, region_svp);
+	if (format == NULL)
+		return NULL;
+	tuple_format_ref(format);
+	uint32_t column_count;
+	struct memcs_column_def *columns =
+		memcs_column_defs_new(format, &column_count);
+	if (columns == NULL) {
+		tuple_format_unref(format);
+		return NULL;
+	}
+	struct memcs_space *space = xcalloc(1, sizeof(*space));
+	if (space_create(&space->base, engine, &memcs_space_vtab,
+			 def, key_list, format) != 0) {
+		tuple_format_unref(format);
+		free(columns);
+		free(space);
+		return NULL;
+	}
+	/* Format is now referenced by the space. */
+	tuple_format_unref(format);
+	space->columns = columns;
+	space->column_count = column_count;
+	return &space->base;
+}
+
+static void
+memcs_engine_read_view_free(struct engine_read_view *rv)
+{
+	free(rv);
+}
+
+/**
+ * Rows are immutable and index read views keep the primary key alive so
+ * there's nothing to do engine-wide.
+ */
+static struct engine_read_view *
+memcs_engine_create_read_view(struct engine *engine,
+			      const struct read_view_opts *opts)
+{
+	static const struct engine_read_view_vtab vtab = {
+		.free = memcs_engine_read_view_free,
+	};
+	(void)engine;
+	(void)opts;
+	struct engine_read_view *rv = malloc(sizeof(*rv));
+	if (rv == NULL) {
+		diag_set(OutOfMemory, sizeof(*rv), "malloc",
+			 "struct engine_read_view");
+		return NULL;
+	}
+	rv->vtab = &vtab;
+	return rv;
+}
+
+static void
+memcs_engine_begin(struct engine *engine, struct txn *txn)
+{
+	(void)engine;
+	/* Changes are applied in place and aren't isolated. */
+	txn_can_yield(txn, false);
+}
+
+/** Frees rows replaced or deleted by a transaction. */
+static void
+memcs_engine_commit(struct engine *engine, struct txn *txn)
+{
+	struct txn_stmt *stmt;
+	stailq_foreach_entry(stmt, &txn->stmts, next) {
+		struct memcs_undo_log *log = stmt->engine_savepoint;
+		if (stmt->engine != engine || stmt->space == NULL ||
+		    log == NULL)
+			continue;
+		struct index *pk = space_index(stmt->space, 0);
+		assert(pk != NULL);
+		struct memcs_store *store = memcs_index_store(pk);
+		for (uint32_t i = 0; i < log->count; i++)
+			memcs_store_free_row(store, log->entries[i].old_row);
+		log->count = 0;
+	}
+}
+
+static void
+memcs_engine_rollback_statement(struct engine *engine, struct txn *txn,
+				struct txn_stmt *stmt)
+{
+	(void)engine;
+	(void)txn;
+	struct space *space = stmt->space;
+	if (space == NULL) {
+		/* The space was deleted. Nothing to rollback. */
+		return;
+	}
+	/* Only roll back the changes if they were made. */
+	struct memcs_undo_log *log = stmt->engine_savepoint;
+	if (log == NULL)
+		return;
+	struct index *pk = space_index(space, 0);
+	assert(pk != NULL);
+	struct memcs_store *store = memcs_index_store(pk);
+	for (uint32_t i = log->count; i > 0; i--) {
+		struct memcs_undo *undo = &log->entries[i - 1];
+		/*
+		 * Rollback must not fail. Tree extents it may need were
+		 * reserved before the change, see memcs_space_reserve().
+		 */
+		int rc;
+		if (undo->new_row == MEMCS_ROW_NONE)
+			rc = memcs_index_insert_row(pk, undo->old_row);
+		else if (undo->old_row == MEMCS_ROW_NONE)
+			rc = memcs_index_delete_row(pk, undo->new_row);
+		else
+			rc = memcs_index_replace_row(pk, undo->new_row,
+						     undo->old_row);
+		if (rc != 0) {
+			diag_log();
+			panic("failed to rollback change");
+		}
+		memcs_store_free_row(store, undo->new_row);
+	}
+	log->count = 0;
+}
+
+/** space_foreach() callback that accounts memory used by memcs spaces. */
+static int
+memcs_space_memory_stat(struct space *space, void *arg)
+{
+	void **args = arg;
+	struct engine *engine = args[0];
+	struct engine_memory_stat *stat = args[1];
+	struct index *pk = space_index(space, 0);
+	if (space->engine != engine || pk == NULL)
+		return 0;
+	stat->data += memcs_index_store(pk)->mem_used;
+	stat->index += index_bsize(pk);
+	return 0;
+}
+
+static void
+memcs_engine_memory_stat(struct engine *engine,
+			 struct engine_memory_stat *stat)
+{
+	void *args[] = {engine, stat};
+	space_foreach(memcs_space_memory_stat, args);
+}
+
+static int
+memcs_engine_check_space_def(struct space_def *def)
+{
+	for (uint32_t i = 0; i < def->field_count; i++) {
+		if (def->fields[i].compression_type != COMPRESSION_TYPE_NONE) {
+			diag_set(ClientError, ER_UNSUPPORTED, "memcs",
+				 "compression");
+			return -1;
+		}
+		if (def->fields[i].layout != NULL) {
+			diag_set(ClientError, ER_UNSUPPORTED, "memcs",
+				 "'layout' option");
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static const struct engine_vtab memcs_engine_vtab = {
+	/* .free = */ memcs_engine_free,
+	/* .shutdown = */ generic_engine_shutdown,
+	/* .create_space = */ memcs_engine_create_space,
+	/* .create_read_view = */ memcs_engine_create_read_view,
+	/* .prepare_join = */ generic_engine_prepare_join,
+	/* .join = */ generic_engine_join,
+	/* .complete_join = */ generic_engine_complete_join,
+	/* .begin = */ memcs_engine_begin,
+	/* .begin_statement = */ generic_engine_begin_statement,
+	/* .prepare = */ generic_engine_prepare,
+	/* .commit = */ memcs_engine_commit,
+	/* .rollback_statement = */ memcs_engine_rollback_statement,
+	/* .rollback = */ generic_engine_rollback,
+	/* .send_to_read_view = */ generic_engine_send_to_read_view,
+	/* .abort_with_conflict = */ generic_engine_abort_with_conflict,
+	/* .bootstrap = */ generic_engine_bootstrap,
+	/* .begin_initial_recovery = */ generic_engine_begin_initial_recovery,
+	/* .begin_final_recovery = */ generic_engine_begin_final_recovery,
+	/* .begin_hot_standby = */ generic_engine_begin_hot_standby,
+	/* .end_recovery = */ generic_engine_end_recovery,
+	/* .begin_checkpoint = */ generic_engine_begin_checkpoint,
+	/* .wait_checkpoint = */ generic_engine_wait_checkpoint,
+	/* .commit_checkpoint = */ generic_engine_commit_checkpoint,
+	/* .abort_checkpoint = */ generic_engine_abort_checkpoint,
+	/* .collect_garbage = */ generic_engine_collect_garbage,
+	/* .backup = */ generic_engine_backup,
+	/* .memory_stat = */ memcs_engine_memory_stat,
+	/* .reset_stat = */ generic_engine_reset_stat,
+	/* .check_space_def = */ memcs_engine_check_space_def,
+};
+
+static void *
+memcs_tree_extent_alloc(struct matras_allocator *allocator)
+{
+	(void)allocator;
+	void *extent = malloc(MEMCS_TREE_EXTENT_SIZE);
+	if (extent == NULL) {
+		diag_set(OutOfMemory, MEMCS_TREE_EXTENT_SIZE, "malloc",
+			 "memcs_tree_extent");
+	}
+	return extent;
+}
+
+static void
+memcs_tree_extent_free(struct matras_allocator *allocator, void *extent)
+{
+	(void)allocator;
+	free(extent);
+}
+
+void
+memcs_engine_register(void)
+{
+	struct memcs_engine *memcs = xcalloc(1, sizeof(*memcs));
+	matras_allocator_create(&memcs->tree_allocator,
+				MEMCS_TREE_EXTENT_SIZE,
+				memcs_tree_extent_alloc,
+				memcs_tree_extent_free);
+	memcs->base.vtab = &memcs_engine_vtab;
+	memcs->base.name = "memcs";
+	/*
+	 * Data is checkpointed and sent to replicas by memtx through
+	 * index read views.
+	 */
+	memcs->base.flags = ENGINE_SUPPORTS_READ_VIEW |
+			    ENGINE_CHECKPOINT_BY_MEMTX |
+			    ENGINE_JOIN_BY_MEMTX;
+	engine_register(&memcs->base);
+}
+
+/* }}} */
@@ -15,8 +15,16 @@
 extern "C" {
 #endif /* defined(__cplusplus) */
 
-static inline void
-memcs_engine_register(void) {}
+/**
+ * Registers the columnar in-memory storage engine.
+ *
+ * A memcs space stores rows column-wise in chunked vectors, which makes
+ * full scans exported as Arrow streams and batch inserts from Arrow arrays
+ * cheap. A space has a single TREE primary index. The data is checkpointed
+ * and sent to replicas by memtx.
+ */
+void
+memcs_engine_register(void);
 
 #if defined(__cplusplus)
 } /* extern "C" */
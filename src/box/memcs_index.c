@@ -0,0 +1,922 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2025, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "memcs_index.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "diag.h"
+#include "error.h"
+#include "fiber.h"
+#include "index.h"
+#include "memcs_arrow.h"
+#include "msgpuck.h"
+#include "say.h"
+#include "space.h"
+#include "space_cache.h"
+#include "tuple.h"
+
+struct memcs_index;
+
+/** A part of a search key decoded from MsgPack. */
+struct memcs_key_part {
+	/** Key part value. */
+	union memcs_value value;
+	/**
+	 * Set if the value is greater than any value that can be stored
+	 * in the column, e.g. an unsigned integer greater than INT64_MAX
+	 * in an 'integer' column.
+	 */
+	bool is_out_of_range;
+};
+
+/** A search key. */
+struct memcs_key {
+	/** Key parts. */
+	const struct memcs_key_part *parts;
+	/** Number of key parts. */
+	uint32_t part_count;
+};
+
+static int
+memcs_tree_compare(uint64_t a, uint64_t b, struct memcs_index *index);
+
+static int
+memcs_tree_compare_key(uint64_t row, const struct memcs_key *key,
+		       struct memcs_index *index);
+
+#define BPS_TREE_NAME memcs_tree
+#define BPS_TREE_BLOCK_SIZE 512
+#define BPS_TREE_EXTENT_SIZE MEMCS_TREE_EXTENT_SIZE
+#define BPS_TREE_COMPARE(a, b, arg) memcs_tree_compare(a, b, arg)
+#define BPS_TREE_COMPARE_KEY(a, b, arg) memcs_tree_compare_key(a, b, arg)
+#define BPS_TREE_IS_IDENTICAL(a, b) ((a) == (b))
+#define BPS_TREE_NO_DEBUG 1
+#define bps_tree_elem_t uint64_t
+#define bps_tree_key_t const struct memcs_key *
+#define bps_tree_arg_t struct memcs_index *
+
+#include "salad/bps_tree.h"
+
+#undef BPS_TREE_NAME
+#undef BPS_TREE_BLOCK_SIZE
+#undef BPS_TREE_EXTENT_SIZE
+#undef BPS_TREE_COMPARE
+#undef BPS_TREE_COMPARE_KEY
+#undef BPS_TREE_IS_IDENTICAL
+#undef BPS_TREE_NO_DEBUG
+#undef bps_tree_elem_t
+#undef bps_tree_key_t
+#undef bps_tree_arg_t
+
+struct memcs_index {
+	/** Base class. */
+	struct index base;
+	/** Space rows. */
+	struct memcs_store *store;
+	/** Ids of live rows ordered by the key. */
+	struct memcs_tree tree;
+};
+
+static int
+memcs_tree_compare(uint64_t a, uint64_t b, struct memcs_index *index)
+{
+	const struct memcs_store *store = index->store;
+	const struct key_def *key_def = index->base.def->key_def;
+	for (uint32_t i = 0; i < key_def->part_count; i++) {
+		const struct key_part *part = &key_def->parts[i];
+		struct memcs_field field_a, field_b;
+		memcs_store_get(store, a, part->fieldno, &field_a);
+		memcs_store_get(store, b, part->fieldno, &field_b);
+		assert(!field_a.is_null && !field_b.is_null);
+		int rc = memcs_value_compare(store->columns[part->fieldno].type,
+					     &field_a.value, &field_b.value);
+		if (rc != 0)
+			return part->sort_order == SORT_ORDER_DESC ? -rc : rc;
+	}
+	return 0;
+}
+
+static int
+memcs_tree_compare_key(uint64_t row, const struct memcs_key *key,
+		       struct memcs_index *index)
+{
+	const struct memcs_store *store = index->store;
+	const struct key_def *key_def = index->base.def->key_def;
+	assert(key->part_count <= key_def->part_count);
+	for (uint32_t i = 0; i < key->part_count; i++) {
+		const struct key_part *part = &key_def->parts[i];
+		const struct memcs_key_part *key_part = &key->parts[i];
+		int rc;
+		if (key_part->is_out_of_range) {
+			rc = -1;
+		} else {
+			struct memcs_field field;
+			memcs_store_get(store, row, part->fieldno, &field);
+			assert(!field.is_null);
+			rc = memcs_value_compare(
+				store->columns[part->fieldno].type,
+				&field.value, &key_part->value);
+		}
+		if (rc != 0)
+			return part->sort_order == SORT_ORDER_DESC ? -rc : rc;
+	}
+	return 0;
+}
+
+/**
+ * Decodes a MsgPack key (without the array header) into key parts.
+ * The key must have been validated.
+ */
+static void
+memcs_key_decode(const struct key_def *key_def, const char *data,
+		 uint32_t part_count, struct memcs_key_part *parts)
+{
+	assert(part_count <= key_def->part_count);
+	for (uint32_t i = 0; i < part_count; i++) {
+		enum memcs_type type =
+			memcs_type_by_field_type(key_def->parts[i].type);
+		struct memcs_key_part *part = &parts[i];
+		union memcs_value *value = &part->value;
+		part->is_out_of_range = false;
+		switch (mp_typeof(*data)) {
+		case MP_UINT:
+			value->u = mp_decode_uint(&data);
+			if (type == MEMCS_TYPE_DOUBLE)
+				value->d = value->u;
+			else if (type == MEMCS_TYPE_INT && value->u > INT64_MAX)
+				part->is_out_of_range = true;
+			break;
+		case MP_INT:
+			value->i = mp_decode_int(&data);
+			if (type == MEMCS_TYPE_DOUBLE)
+				value->d = value->i;
+			break;
+		case MP_FLOAT:
+			value->d = mp_decode_float(&data);
+			break;
+		case MP_DOUBLE:
+			value->d = mp_decode_double(&data);
+			break;
+		case MP_BOOL:
+			value->b = mp_decode_bool(&data);
+			break;
+		case MP_STR:
+			value->s.data = mp_decode_str(&data, &value->s.len);
+			break;
+		case MP_BIN:
+			value->s.data = mp_decode_bin(&data, &value->s.len);
+			break;
+		default:
+			unreachable();
+		}
+	}
+}
+
+/** Positions a tree iterator according to the iterator type and key. */
+static struct memcs_tree_iterator
+memcs_tree_start(struct memcs_tree *tree, enum iterator_type type,
+		 const struct memcs_key *key)
+{
+	struct memcs_tree_iterator itr;
+	if (key->part_count == 0) {
+		return iterator_type_is_reverse(type) ?
+		       memcs_tree_last(tree) : memcs_tree_first(tree);
+	}
+	switch (type) {
+	case ITER_ALL:
+	case ITER_EQ:
+	case ITER_GE:
+		itr = memcs_tree_lower_bound(tree, key, NULL);
+		break;
+	case ITER_GT:
+		itr = memcs_tree_upper_bound(tree, key, NULL);
+		break;
+	case ITER_REQ:
+	case ITER_LE:
+		itr = memcs_tree_upper_bound(tree, key, NULL);
+		memcs_tree_iterator_prev(tree, &itr);
+		break;
+	case ITER_LT:
+		itr = memcs_tree_lower_bound(tree, key, NULL);
+		memcs_tree_iterator_prev(tree, &itr);
+		break;
+	default:
+		unreachable();
+	}
+	return itr;
+}
+
+/** Same as memcs_tree_start() but for a tree view. */
+static struct memcs_tree_iterator
+memcs_tree_view_start(struct memcs_tree_view *view, enum iterator_type type,
+		      const struct memcs_key *key)
+{
+	struct memcs_tree_iterator itr;
+	if (key->part_count == 0) {
+		return iterator_type_is_reverse(type) ?
+		       memcs_tree_view_last(view) : memcs_tree_view_first(view);
+	}
+	switch (type) {
+	case ITER_ALL:
+	case ITER_EQ:
+	case ITER_GE:
+		itr = memcs_tree_view_lower_bound(view, key, NULL);
+		break;
+	case ITER_GT:
+		itr = memcs_tree_view_upper_bound(view, key, NULL);
+		break;
+	case ITER_REQ:
+	case ITER_LE:
+		itr = memcs_tree_view_upper_bound(view, key, NULL);
+		memcs_tree_view_iterator_prev(view, &itr);
+		break;
+	case ITER_LT:
+		itr = memcs_tree_view_lower_bound(view, key, NULL);
+		memcs_tree_view_iterator_prev(view, &itr);
+		break;
+	default:
+		unreachable();
+	}
+	return itr;
+}
+
+/** Returns true if the iterator must stop on the first mismatching row. */
+static inline bool
+memcs_iterator_type_is_eq(enum iterator_type type,
+			  const struct memcs_key *key)
+{
+	return key->part_count > 0 &&
+	       (type == ITER_EQ || type == ITER_REQ);
+}
+
+/**
+ * Copies a MsgPack key to the given buffer and decodes it. The buffer must
+ * be large enough to store the key parts followed by the key data, see
+ * memcs_key_copy_size().
+ */
+static void
+memcs_key_copy(const struct key_def *key_def, const char *data,
+	       uint32_t part_count, char *buf, struct memcs_key *key)
+{
+	struct memcs_key_part *parts = (struct memcs_key_part *)buf;
+	char *data_copy = buf + part_count * sizeof(*parts);
+	const char *data_end = data;
+	for (uint32_t i = 0; i < part_count; i++)
+		mp_next(&data_end);
+	if (part_count > 0)
+		memcpy(data_copy, data, data_end - data);
+	memcs_key_decode(key_def, data_copy, part_count, parts);
+	key->parts = parts;
+	key->part_count = part_count;
+}
+
+/** Returns the size of a buffer for memcs_key_copy(). */
+static size_t
+memcs_key_copy_size(const char *data, uint32_t part_count)
+{
+	const char *data_end = data;
+	for (uint32_t i = 0; i < part_count; i++)
+		mp_next(&data_end);
+	return part_count * sizeof(struct memcs_key_part) + (data_end - data);
+}
+
+struct memcs_store *
+memcs_index_store(struct index *base)
+{
+	struct memcs_index *index = (struct memcs_index *)base;
+	return index->store;
+}
+
+uint64_t
+memcs_index_find_fields(struct index *base, const struct memcs_field *fields)
+{
+	struct memcs_index *index = (struct memcs_index *)base;
+	const struct key_def *key_def = base->def->key_def;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct memcs_key_part *parts = xregion_alloc_array(
+		region, struct memcs_key_part, key_def->part_count);
+	for (uint32_t i = 0; i < key_def->part_count; i++) {
+		const struct memcs_field *field =
+			&fields[key_def->parts[i].fieldno];
+		assert(!field->is_null);
+		parts[i].value = field->value;
+		parts[i].is_out_of_range = false;
+	}
+	struct memcs_key key = {parts, key_def->part_count};
+	uint64_t *elem = memcs_tree_find(&index->tree, &key);
+	region_truncate(region, region_svp);
+	return elem != NULL ? *elem : MEMCS_ROW_NONE;
+}
+
+uint64_t
+memcs_index_find_key(struct index *base, const char *data,
+		     uint32_t part_count)
+{
+	struct memcs_index *index = (struct memcs_index *)base;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct memcs_key_part *parts = xregion_alloc_array(
+		region, struct memcs_key_part, part_count);
+	memcs_key_decode(base->def->key_def, data, part_count, parts);
+	struct memcs_key key = {parts, part_count};
+	uint64_t *elem = memcs_tree_find(&index->tree, &key);
+	region_truncate(region, region_svp);
+	return elem != NULL ? *elem : MEMCS_ROW_NONE;
+}
+
+int
+memcs_index_insert_row(struct index *base, uint64_t row)
+{
+	struct memcs_index *index = (struct memcs_index *)base;
+	uint64_t replaced = MEMCS_ROW_NONE;
+	if (memcs_tree_insert(&index->tree, row, &replaced, NULL) != 0) {
+		diag_set(OutOfMemory, MEMCS_TREE_EXTENT_SIZE,
+			 "memcs_index", "replace");
+		return -1;
+	}
+	assert(replaced == MEMCS_ROW_NONE);
+	return 0;
+}
+
+int
+memcs_index_replace_row(struct index *base, uint64_t old_row, uint64_t new_row)
+{
+	struct memcs_index *index = (struct memcs_index *)base;
+	uint64_t replaced = MEMCS_ROW_NONE;
+	if (memcs_tree_insert(&index->tree, new_row, &replaced, NULL) != 0) {
+		diag_set(OutOfMemory, MEMCS_TREE_EXTENT_SIZE,
+			 "memcs_index", "replace");
+		return -1;
+	}
+	assert(replaced == old_row);
+	(void)old_row;
+	return 0;
+}
+
+int
+memcs_index_delete_row(struct index *base, uint64_t row)
+{
+	struct memcs_index *index = (struct memcs_index *)base;
+	uint64_t deleted = MEMCS_ROW_NONE;
+	if (memcs_tree_delete(&index->tree, row, &deleted) != 0) {
+		diag_set(OutOfMemory, MEMCS_TREE_EXTENT_SIZE,
+			 "memcs_index", "delete");
+		return -1;
+	}
+	assert(deleted == row);
+	(void)deleted;
+	return 0;
+}
+
+struct tuple *
+memcs_index_tuple_new(struct index *base, struct tuple_format *format,
+		      uint64_t row)
+{
+	struct memcs_index *index = (struct memcs_index *)base;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t size = memcs_store_row_bsize(index->store, row);
+	char *data = xregion_alloc(region, size);
+	char *data_end = memcs_store_row_encode(index->store, row, data);
+	assert(data_end == data + size);
+	struct tuple *tuple = tuple_new(format, data, data_end);
+	region_truncate(region, region_svp);
+	return tuple;
+}
+
+/* {{{ Iterator ***************************************************/
+
+struct memcs_iterator {
+	/** Base class. */
+	struct iterator base;
+	/** Iterator type. */
+	enum iterator_type type;
+	/** Search key. Points to the memory allocated with the iterator. */
+	struct memcs_key key;
+	/** Tree iterator positioned at the last returned row. */
+	struct memcs_tree_iterator tree_iterator;
+	/** Last returned row or MEMCS_ROW_NONE if the iteration hasn't
+	 * started yet. */
+	uint64_t last;
+	/**
+	 * Key of the last returned row. The row may be deleted and its
+	 * slot reused so the position is restored by the key.
+	 */
+	struct memcs_key last_key;
+	/** Buffer storing the last key parts and strings. */
+	char *last_key_buf;
+	/** Size of the last key buffer. */
+	size_t last_key_buf_size;
+};
+
+static void
+memcs_iterator_free(struct iterator *base)
+{
+	struct memcs_iterator *it = (struct memcs_iterator *)base;
+	free(it->last_key_buf);
+	TRASH(it);
+	free(it);
+}
+
+/**
+ * Remembers a row as the last one returned by an iterator, copying its
+ * key. Returns -1 and sets diag on memory allocation error.
+ */
+static int
+memcs_iterator_set_last(struct memcs_iterator *it, struct memcs_index *index,
+			uint64_t row)
+{
+	const struct memcs_store *store = index->store;
+	const struct key_def *key_def = index->base.def->key_def;
+	uint32_t part_count = key_def->part_count;
+	size_t size = part_count * sizeof(struct memcs_key_part);
+	for (uint32_t i = 0; i < part_count; i++) {
+		uint32_t fieldno = key_def->parts[i].fieldno;
+		if (store->columns[fieldno].type != MEMCS_TYPE_STR)
+			continue;
+		struct memcs_field field;
+		memcs_store_get(store, row, fieldno, &field);
+		size += field.value.s.len;
+	}
+	if (size > it->last_key_buf_size) {
+		char *buf = realloc(it->last_key_buf, size);
+		if (buf == NULL) {
+			diag_set(OutOfMemory, size, "realloc",
+				 "memcs_iterator");
+			return -1;
+		}
+		it->last_key_buf = buf;
+		it->last_key_buf_size = size;
+	}
+	struct memcs_key_part *parts =
+		(struct memcs_key_part *)it->last_key_buf;
+	char *data = it->last_key_buf + part_count * sizeof(*parts);
+	for (uint32_t i = 0; i < part_count; i++) {
+		uint32_t fieldno = key_def->parts[i].fieldno;
+		struct memcs_field field;
+		memcs_store_get(store, row, fieldno, &field);
+		assert(!field.is_null);
+		parts[i].value = field.value;
+		parts[i].is_out_of_range = false;
+		if (store->columns[fieldno].type == MEMCS_TYPE_STR) {
+			memcpy(data, field.value.s.data, field.value.s.len);
+			parts[i].value.s.data = data;
+			data += field.value.s.len;
+		}
+	}
+	it->last_key.parts = parts;
+	it->last_key.part_count = part_count;
+	it->last = row;
+	return 0;
+}
+
+static int
+memcs_iterator_next(struct iterator *base, struct tuple **ret)
+{
+	struct memcs_iterator *it = (struct memcs_iterator *)base;
+	struct space *space;
+	struct index *index_base;
+	index_weak_ref_get_checked(&base->index_ref, &space, &index_base);
+	struct memcs_index *index = (struct memcs_index *)index_base;
+	struct memcs_tree *tree = &index->tree;
+	bool is_reverse = iterator_type_is_reverse(it->type);
+	uint64_t *elem;
+	if (it->last == MEMCS_ROW_NONE) {
+		it->tree_iterator = memcs_tree_start(tree, it->type, &it->key);
+	} else {
+		elem = memcs_tree_iterator_get_elem(tree, &it->tree_iterator);
+		if (elem == NULL || *elem != it->last ||
+		    memcs_tree_compare_key(*elem, &it->last_key, index) != 0) {
+			/* The tree was modified, restore the position. */
+			if (is_reverse) {
+				it->tree_iterator = memcs_tree_lower_bound(
+					tree, &it->last_key, NULL);
+				memcs_tree_iterator_prev(tree,
+							 &it->tree_iterator);
+			} else {
+				it->tree_iterator = memcs_tree_upper_bound(
+					tree, &it->last_key, NULL);
+			}
+		} else if (is_reverse) {
+			memcs_tree_iterator_prev(tree, &it->tree_iterator);
+		} else {
+			memcs_tree_iterator_next(tree, &it->tree_iterator);
+		}
+	}
+	elem = memcs_tree_iterator_get_elem(tree, &it->tree_iterator);
+	if (elem == NULL ||
+	    (memcs_iterator_type_is_eq(it->type, &it->key) &&
+	     memcs_tree_compare_key(*elem, &it->key, index) != 0)) {
+		base->next = exhausted_iterator_next;
+		base->next_internal = exhausted_iterator_next;
+		*ret = NULL;
+		return 0;
+	}
+	if (memcs_iterator_set_last(it, index, *elem) != 0)
+		return -1;
+	*ret = memcs_index_tuple_new(&index->base, space->format, *elem);
+	if (*ret == NULL)
+		return -1;
+	tuple_bless(*ret);
+	return 0;
+}
+
+/* }}} */
+
+/* {{{ Read view **************************************************/
+
+struct memcs_read_view {
+	/** Base class. */
+	struct index_read_view base;
+	/** Read view index. Ref counter incremented. */
+	struct memcs_index *index;
+	/** Tree read view. */
+	struct memcs_tree_view tree_view;
+	/** Keeps rows in the tree view from being reclaimed. */
+	struct memcs_store_view store_view;
+};
+
+struct memcs_read_view_iterator {
+	/** Base class. */
+	struct index_read_view_iterator_base base;
+	/** Tree view iterator. */
+	struct memcs_tree_iterator tree_iterator;
+};
+
+static_assert(sizeof(struct memcs_read_view_iterator) <=
+	      INDEX_READ_VIEW_ITERATOR_SIZE,
+	      "sizeof(struct memcs_read_view_iterator) must be less than "
+	      "or equal to INDEX_READ_VIEW_ITERATOR_SIZE");
+
+static void
+memcs_read_view_free(struct index_read_view *base)
+{
+	struct memcs_read_view *rv = (struct memcs_read_view *)base;
+	memcs_tree_view_destroy(&rv->tree_view);
+	memcs_store_close_view(rv->index->store, &rv->store_view);
+	index_unref(&rv->index->base);
+	TRASH(rv);
+	free(rv);
+}
+
+/**
+ * Encodes a row on the fiber region and returns it as a read view tuple.
+ * The region is truncated by the caller.
+ */
+static void
+memcs_read_view_tuple(const struct memcs_store *store, uint64_t row,
+		      struct read_view_tuple *result)
+{
+	uint32_t size = memcs_store_row_bsize(store, row);
+	char *data = xregion_alloc(&fiber()->gc, size);
+	memcs_store_row_encode(store, row, data);
+	result->needs_upgrade = false;
+	result->data = data;
+	result->size = size;
+	result->ptr = NULL;
+}
+
+static int
+memcs_read_view_get_raw(struct index_read_view *base, const char *key,
+			uint32_t part_count, struct read_view_tuple *result)
+{
+	struct memcs_read_view *rv = (struct memcs_read_view *)base;
+	struct region *region = &fiber()->gc;
+	struct memcs_key_part *parts = xregion_alloc_array(
+		region, struct memcs_key_part, part_count);
+	memcs_key_decode(base->def->key_def, key, part_count, parts);
+	struct memcs_key search_key = {parts, part_count};
+	uint64_t *elem = memcs_tree_view_find(&rv->tree_view, &search_key);
+	if (elem == NULL) {
+		*result = read_view_tuple_none();
+		return 0;
+	}
+	memcs_read_view_tuple(rv->index->store, *elem, result);
+	return 0;
+}
+
+static int
+memcs_read_view_iterator_next_raw(struct index_read_view_iterator *iterator,
+				  struct read_view_tuple *result)
+{
+	struct memcs_read_view_iterator *it =
+		(struct memcs_read_view_iterator *)iterator;
+	struct memcs_read_view *rv = (struct memcs_read_view *)it->base.index;
+	uint64_t *elem = memcs_tree_view_iterator_get_elem(&rv->tree_view,
+							   &it->tree_iterator);
+	if (elem == NULL) {
+		*result = read_view_tuple_none();
+		return 0;
+	}
+	memcs_tree_view_iterator_next(&rv->tree_view, &it->tree_iterator);
+	memcs_read_view_tuple(rv->index->store, *elem, result);
+	return 0;
+}
+
+static int
+memcs_read_view_create_iterator(struct index_read_view *base,
+				enum iterator_type type,
+				const char *key, uint32_t part_count,
+				const char *pos,
+				struct index_read_view_iterator *iterator)
+{
+	/* Only used for checkpointing and replica join. */
+	assert(type == ITER_ALL);
+	assert(part_count == 0);
+	assert(pos == NULL);
+	(void)type;
+	(void)key;
+	(void)part_count;
+	(void)pos;
+	struct memcs_read_view *rv = (struct memcs_read_view *)base;
+	struct memcs_read_view_iterator *it =
+		(struct memcs_read_view_iterator *)iterator;
+	it->base.index = base;
+	it->base.destroy = generic_index_read_view_iterator_destroy;
+	it->base.next_raw = memcs_read_view_iterator_next_raw;
+	it->base.position = generic_index_read_view_iterator_position;
+	it->tree_iterator = memcs_tree_view_first(&rv->tree_view);
+	return 0;
+}
+
+static struct index_read_view *
+memcs_index_create_read_view(struct index *base)
+{
+	static const struct index_read_view_vtab vtab = {
+		.free = memcs_read_view_free,
+		.count = generic_index_read_view_count,
+		.get_raw = memcs_read_view_get_raw,
+		.create_iterator = memcs_read_view_create_iterator,
+		.create_iterator_with_offset =
+			generic_index_read_view_create_iterator_with_offset,
+		.create_arrow_stream =
+			generic_index_read_view_create_arrow_stream,
+	};
+	struct memcs_index *index = (struct memcs_index *)base;
+	struct memcs_read_view *rv = xmalloc(sizeof(*rv));
+	index_read_view_create(&rv->base, &vtab, base->def);
+	rv->index = index;
+	index_ref(base);
+	memcs_tree_view_create(&rv->tree_view, &index->tree);
+	memcs_store_open_view(index->store, &rv->store_view);
+	return &rv->base;
+}
+
+/* }}} */
+
+/* {{{ Cursor *****************************************************/
+
+struct memcs_index_cursor {
+	/** Cursor index. Ref counter incremented. */
+	struct memcs_index *index;
+	/** Tree read view. */
+	struct memcs_tree_view tree_view;
+	/** Keeps rows in the tree view from being reclaimed. */
+	struct memcs_store_view store_view;
+	/** Tree view iterator positioned at the next row to return. */
+	struct memcs_tree_iterator tree_iterator;
+	/** Iterator type. */
+	enum iterator_type type;
+	/** Search key. Points to the memory allocated with the cursor. */
+	struct memcs_key key;
+	/** Set if the iterator was positioned. */
+	bool is_started;
+	/** Set if there are no more rows to return. */
+	bool is_eof;
+};
+
+struct memcs_index_cursor *
+memcs_index_cursor_new(struct index *base, enum iterator_type type,
+		       const char *key, uint32_t part_count)
+{
+	struct memcs_index *index = (struct memcs_index *)base;
+	size_t key_size = memcs_key_copy_size(key, part_count);
+	struct memcs_index_cursor *cursor =
+		xmalloc(sizeof(*cursor) + key_size);
+	memcs_key_copy(base->def->key_def, key, part_count,
+		       (char *)(cursor + 1), &cursor->key);
+	cursor->index = index;
+	index_ref(base);
+	memcs_tree_view_create(&cursor->tree_view, &index->tree);
+	memcs_store_open_view(index->store, &cursor->store_view);
+	cursor->type = type;
+	cursor->is_started = false;
+	cursor->is_eof = false;
+	return cursor;
+}
+
+void
+memcs_index_cursor_delete(struct memcs_index_cursor *cursor)
+{
+	memcs_tree_view_destroy(&cursor->tree_view);
+	memcs_store_close_view(cursor->index->store, &cursor->store_view);
+	index_unref(&cursor->index->base);
+	TRASH(cursor);
+	free(cursor);
+}
+
+uint32_t
+memcs_index_cursor_next(struct memcs_index_cursor *cursor, uint64_t *rows,
+			uint32_t count)
+{
+	if (cursor->is_eof)
+		return 0;
+	struct memcs_tree_view *view = &cursor->tree_view;
+	if (!cursor->is_started) {
+		cursor->tree_iterator = memcs_tree_view_start(
+			view, cursor->type, &cursor->key);
+		cursor->is_started = true;
+	}
+	bool is_reverse = iterator_type_is_reverse(cursor->type);
+	bool is_eq = memcs_iterator_type_is_eq(cursor->type, &cursor->key);
+	uint32_t n = 0;
+	while (n < count) {
+		uint64_t *elem = memcs_tree_view_iterator_get_elem(
+			view, &cursor->tree_iterator);
+		if (elem == NULL ||
+		    (is_eq && memcs_tree_compare_key(*elem, &cursor->key,
+						     cursor->index) != 0)) {
+			cursor->is_eof = true;
+			break;
+		}
+		rows[n++] = *elem;
+		if (is_reverse)
+			memcs_tree_view_iterator_prev(view,
+						      &cursor->tree_iterator);
+		else
+			memcs_tree_view_iterator_next(view,
+						      &cursor->tree_iterator);
+	}
+	return n;
+}
+
+const struct memcs_store *
+memcs_index_cursor_store(struct memcs_index_cursor *cursor)
+{
+	return cursor->index->store;
+}
+
+/* }}} */
+
+/* {{{ Index ******************************************************/
+
+static void
+memcs_index_destroy(struct index *base)
+{
+	struct memcs_index *index = (struct memcs_index *)base;
+	memcs_tree_destroy(&index->tree);
+	memcs_store_delete(index->store);
+	TRASH(index);
+	free(index);
+}
+
+static bool
+memcs_index_def_change_requires_rebuild(struct index *index,
+					const struct index_def *new_def)
+{
+	const struct index_def *old_def = index->def;
+	if (old_def->type != new_def->type)
+		return true;
+	const struct key_def *old_key_def = old_def->key_def;
+	const struct key_def *new_key_def = new_def->key_def;
+	if (old_key_def->part_count != new_key_def->part_count)
+		return true;
+	for (uint32_t i = 0; i < old_key_def->part_count; i++) {
+		const struct key_part *old_part = &old_key_def->parts[i];
+		const struct key_part *new_part = &new_key_def->parts[i];
+		if (old_part->fieldno != new_part->fieldno ||
+		    old_part->type != new_part->type ||
+		    old_part->sort_order != new_part->sort_order)
+			return true;
+	}
+	return false;
+}
+
+static ssize_t
+memcs_index_size(struct index *base)
+{
+	struct memcs_index *index = (struct memcs_index *)base;
+	return memcs_tree_size(&index->tree);
+}
+
+static ssize_t
+memcs_index_bsize(struct index *base)
+{
+	struct memcs_index *index = (struct memcs_index *)base;
+	return memcs_tree_mem_used(&index->tree);
+}
+
+static ssize_t
+memcs_index_count(struct index *base, enum iterator_type type,
+		  const char *key, uint32_t part_count)
+{
+	if (part_count == 0)
+		return memcs_index_size(base);
+	return generic_index_count(base, type, key, part_count);
+}
+
+static int
+memcs_index_get(struct index *base, const char *key,
+		uint32_t part_count, struct tuple **result)
+{
+	assert(base->def->opts.is_unique &&
+	       part_count == base->def->key_def->part_count);
+	uint64_t row = memcs_index_find_key(base, key, part_count);
+	if (row == MEMCS_ROW_NONE) {
+		*result = NULL;
+		return 0;
+	}
+	struct space *space = space_by_id(base->def->space_id);
+	assert(space != NULL);
+	*result = memcs_index_tuple_new(base, space->format, row);
+	if (*result == NULL)
+		return -1;
+	tuple_bless(*result);
+	return 0;
+}
+
+static struct iterator *
+memcs_index_create_iterator(struct index *base, enum iterator_type type,
+			    const char *key, uint32_t part_count,
+			    const char *pos)
+{
+	assert(part_count == 0 || key != NULL);
+	if (type > ITER_GT) {
+		diag_set(UnsupportedIndexFeature, base->def,
+			 "requested iterator type");
+		return NULL;
+	}
+	if (pos != NULL) {
+		diag_set(UnsupportedIndexFeature, base->def, "pagination");
+		return NULL;
+	}
+	size_t key_size = memcs_key_copy_size(key, part_count);
+	struct memcs_iterator *it = xmalloc(sizeof(*it) + key_size);
+	iterator_create(&it->base, base);
+	it->base.next_internal = memcs_iterator_next;
+	it->base.next = memcs_iterator_next;
+	it->base.position = generic_iterator_position;
+	it->base.free = memcs_iterator_free;
+	it->type = type;
+	memcs_key_copy(base->def->key_def, key, part_count,
+		       (char *)(it + 1), &it->key);
+	it->tree_iterator = memcs_tree_invalid_iterator();
+	it->last = MEMCS_ROW_NONE;
+	it->last_key_buf = NULL;
+	it->last_key_buf_size = 0;
+	return &it->base;
+}
+
+static const struct index_vtab memcs_index_vtab = {
+	/* .destroy = */ memcs_index_destroy,
+	/* .commit_create = */ generic_index_commit_create,
+	/* .abort_create = */ generic_index_abort_create,
+	/* .commit_modify = */ generic_index_commit_modify,
+	/* .commit_drop = */ generic_index_commit_drop,
+	/* .update_def = */ generic_index_update_def,
+	/* .depends_on_pk = */ generic_index_depends_on_pk,
+	/* .def_change_requires_rebuild = */
+		memcs_index_def_change_requires_rebuild,
+	/* .size = */ memcs_index_size,
+	/* .bsize = */ memcs_index_bsize,
+	/* .quantile = */ generic_index_quantile,
+	/* .min = */ generic_index_min,
+	/* .max = */ generic_index_max,
+	/* .random = */ generic_index_random,
+	/* .count = */ memcs_index_count,
+	/* .get_internal = */ memcs_index_get,
+	/* .get = */ memcs_index_get,
+	/* .get_many = */ generic_index_get_many,
+	/* .replace = */ generic_index_replace,
+	/* .create_iterator = */ memcs_index_create_iterator,
+	/* .create_iterator_with_offset = */
+		generic_index_create_iterator_with_offset,
+	/* .create_arrow_stream = */ memcs_index_create_arrow_stream,
+	/* .aggregate = */ generic_index_aggregate,
+	/* .create_read_view = */ memcs_index_create_read_view,
+	/* .stat = */ generic_index_stat,
+	/* .compact = */ generic_index_compact,
+	/* .reset_stat = */ generic_index_reset_stat,
+	/* .begin_build = */ generic_index_begin_build,
+	/* .reserve = */ generic_index_reserve,
+	/* .build_next = */ generic_index_build_next,
+	/* .end_build = */ generic_index_end_build,
+};
+
+struct index *
+memcs_index_new(struct engine *engine, struct index_def *def,
+		struct matras_allocator *allocator)
+{
+	struct memcs_index *index = xcalloc(1, sizeof(*index));
+	index_create(&index->base, engine, &memcs_index_vtab, def);
+	index->store = memcs_store_new();
+	memcs_tree_create(&index->tree, index, allocator, NULL);
+	return &index->base;
+}
+
+/* }}} */
@@ -0,0 +1,126 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2025, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "iterator_type.h"
+#include "memcs_store.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct engine;
+struct index;
+struct index_def;
+struct matras_allocator;
+struct tuple;
+struct tuple_format;
+
+/** Size of an extent allocated for the primary key tree. */
+#define MEMCS_TREE_EXTENT_SIZE (16 * 1024)
+
+/**
+ * Number of tree extents reserved before a row change so that neither
+ * the change nor its rollback has to allocate memory.
+ */
+#define MEMCS_TREE_RESERVE_EXTENTS 32
+
+/**
+ * Creates the primary index of a memcs space. The index owns the store
+ * with the space rows and a BPS tree of row ids ordered by the key.
+ * Tree extents are allocated with the given allocator.
+ */
+struct index *
+memcs_index_new(struct engine *engine, struct index_def *def,
+		struct matras_allocator *allocator);
+
+/** Returns the store of a memcs index. */
+struct memcs_store *
+memcs_index_store(struct index *index);
+
+/**
+ * Looks up the row that has the same key as the given row fields.
+ * Returns MEMCS_ROW_NONE if there's no such row.
+ */
+uint64_t
+memcs_index_find_fields(struct index *index, const struct memcs_field *fields);
+
+/**
+ * Looks up a row by a full key (without the MsgPack array header).
+ * Returns MEMCS_ROW_NONE if there's no such row.
+ */
+uint64_t
+memcs_index_find_key(struct index *index, const char *key,
+		     uint32_t part_count);
+
+/**
+ * Inserts a row into the index. There must be no row with the same key.
+ * Returns -1 and sets diag on memory allocation error.
+ */
+int
+memcs_index_insert_row(struct index *index, uint64_t row);
+
+/**
+ * Replaces a row in the index with a row that has the same key. The old
+ * row must be in the index. Returns -1 and sets diag on memory allocation
+ * error.
+ */
+int
+memcs_index_replace_row(struct index *index, uint64_t old_row,
+			uint64_t new_row);
+
+/**
+ * Deletes a row from the index. The row must be in the index. Returns -1
+ * and sets diag on memory allocation error.
+ */
+int
+memcs_index_delete_row(struct index *index, uint64_t row);
+
+/**
+ * Materializes a row as a tuple of the given format. The tuple isn't
+ * referenced. Returns NULL and sets diag on error.
+ */
+struct tuple *
+memcs_index_tuple_new(struct index *index, struct tuple_format *format,
+		      uint64_t row);
+
+/**
+ * Cursor over a frozen image of a memcs index. Returns row ids in the
+ * index order. A cursor may only be created and destroyed in the tx
+ * thread. Rows returned by a cursor stay readable until it's destroyed.
+ */
+struct memcs_index_cursor;
+
+/**
+ * Creates a cursor over rows matching the given iterator type and key.
+ * The key must have been validated.
+ */
+struct memcs_index_cursor *
+memcs_index_cursor_new(struct index *index, enum iterator_type type,
+		       const char *key, uint32_t part_count);
+
+/** Destroys a cursor. */
+void
+memcs_index_cursor_delete(struct memcs_index_cursor *cursor);
+
+/**
+ * Fills the given array with ids of up to @a count next rows. Returns the
+ * number of row ids written, 0 on EOF.
+ */
+uint32_t
+memcs_index_cursor_next(struct memcs_index_cursor *cursor, uint64_t *rows,
+			uint32_t count);
+
+/** Returns the store the rows returned by a cursor belong to. */
+const struct memcs_store *
+memcs_index_cursor_store(struct memcs_index_cursor *cursor);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
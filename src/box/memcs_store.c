@@ -0,0 +1,713 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2025, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "memcs_store.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "diag.h"
+#include "errcode.h"
+#include "errinj.h"
+#include "error.h"
+#include "msgpuck.h"
+#include "tuple_format.h"
+
+const uint32_t memcs_type_size[] = {
+	/* [MEMCS_TYPE_UINT] = */ sizeof(uint64_t),
+	/* [MEMCS_TYPE_INT] = */ sizeof(int64_t),
+	/* [MEMCS_TYPE_DOUBLE] = */ sizeof(double),
+	/* [MEMCS_TYPE_BOOL] = */ sizeof(uint8_t),
+	/* [MEMCS_TYPE_STR] = */ sizeof(struct memcs_str),
+};
+
+static_assert(lengthof(memcs_type_size) == memcs_type_MAX,
+	      "memcs_type_size must have an entry for each column type");
+
+enum memcs_type
+memcs_type_by_field_type(enum field_type type)
+{
+	switch (type) {
+	case FIELD_TYPE_UNSIGNED:
+	case FIELD_TYPE_UINT8:
+	case FIELD_TYPE_UINT16:
+	case FIELD_TYPE_UINT32:
+	case FIELD_TYPE_UINT64:
+		return MEMCS_TYPE_UINT;
+	case FIELD_TYPE_INTEGER:
+	case FIELD_TYPE_INT8:
+	case FIELD_TYPE_INT16:
+	case FIELD_TYPE_INT32:
+	case FIELD_TYPE_INT64:
+		return MEMCS_TYPE_INT;
+	case FIELD_TYPE_DOUBLE:
+	case FIELD_TYPE_FLOAT32:
+	case FIELD_TYPE_FLOAT64:
+		return MEMCS_TYPE_DOUBLE;
+	case FIELD_TYPE_BOOLEAN:
+		return MEMCS_TYPE_BOOL;
+	case FIELD_TYPE_STRING:
+	case FIELD_TYPE_VARBINARY:
+		return MEMCS_TYPE_STR;
+	default:
+		return memcs_type_MAX;
+	}
+}
+
+struct memcs_column_def *
+memcs_column_defs_new(struct tuple_format *format, uint32_t *column_count)
+{
+	uint32_t count = tuple_format_field_count(format);
+	struct memcs_column_def *columns = xcalloc(MAX(count, 1),
+						   sizeof(*columns));
+	for (uint32_t i = 0; i < count; i++) {
+		struct tuple_field *field = tuple_format_field(format, i);
+		struct memcs_column_def *column = &columns[i];
+		column->field_type = field->type;
+		column->is_nullable = tuple_field_is_nullable(field);
+		column->type = memcs_type_by_field_type(field->type);
+		if (column->type == memcs_type_MAX) {
+			diag_set(ClientError, ER_UNSUPPORTED, "memcs",
+				 tt_sprintf("field type '%s'",
+					    field_type_strs[field->type]));
+			free(columns);
+			return NULL;
+		}
+	}
+	*column_count = count;
+	return columns;
+}
+
+bool
+memcs_column_defs_equal(const struct memcs_column_def *a, uint32_t a_count,
+			const struct memcs_column_def *b, uint32_t b_count)
+{
+	if (a_count != b_count)
+		return false;
+	for (uint32_t i = 0; i < a_count; i++) {
+		if (a[i].field_type != b[i].field_type ||
+		    a[i].is_nullable != b[i].is_nullable)
+			return false;
+	}
+	return true;
+}
+
+/**
+ * A memory block strings are allocated from. A string longer than
+ * MEMCS_STRING_SIZE_MAX gets a page of its own, allocated with malloc,
+ * with the string data following the header. Other strings are allocated
+ * from pages of MEMCS_STRING_PAGE_SIZE bytes aligned by their size.
+ */
+struct memcs_string_page {
+	/** Link in memcs_store::string_pages. */
+	struct rlist in_store;
+	/** Size of the page, including the header. */
+	size_t size;
+	/** Number of strings of live or not reclaimed rows in the page. */
+	uint32_t ref_count;
+};
+
+/** Returns the page a non-empty string is stored in. */
+static inline struct memcs_string_page *
+memcs_string_page(const struct memcs_str *str)
+{
+	assert(str->len > 0);
+	if (str->len > MEMCS_STRING_SIZE_MAX)
+		return (struct memcs_string_page *)str->data - 1;
+	uintptr_t mask = ~((uintptr_t)MEMCS_STRING_PAGE_SIZE - 1);
+	return (struct memcs_string_page *)((uintptr_t)str->data & mask);
+}
+
+struct memcs_store *
+memcs_store_new(void)
+{
+	struct memcs_store *store = xcalloc(1, sizeof(*store));
+	rlist_create(&store->string_pages);
+	rlist_create(&store->views);
+	return store;
+}
+
+void
+memcs_store_delete(struct memcs_store *store)
+{
+	assert(rlist_empty(&store->views));
+	for (uint32_t i = 0; i < store->chunk_count; i++) {
+		free(memcs_store_chunk(store, i));
+	}
+	for (uint32_t i = 0; i < MEMCS_DIR_SIZE && store->dir[i] != NULL; i++)
+		free(store->dir[i]);
+	struct memcs_string_page *page, *next;
+	rlist_foreach_entry_safe(page, &store->string_pages, in_store, next)
+		free(page);
+	free(store->dead_rows);
+	free(store->free_rows);
+	free(store->columns);
+	TRASH(store);
+	free(store);
+}
+
+void
+memcs_store_set_columns(struct memcs_store *store,
+			const struct memcs_column_def *columns,
+			uint32_t column_count)
+{
+	assert(store->chunk_count == 0);
+	free(store->columns);
+	store->columns = xcalloc(MAX(column_count, 1), sizeof(*columns));
+	memcpy(store->columns, columns, column_count * sizeof(*columns));
+	store->column_count = column_count;
+}
+
+/**
+ * Allocates a new chunk with the given capacity. Returns NULL and sets
+ * diag on memory allocation error.
+ */
+static struct memcs_chunk *
+memcs_chunk_new(struct memcs_store *store, uint32_t capacity)
+{
+	assert(capacity % 64 == 0);
+	size_t size = sizeof(struct memcs_chunk) +
+		      store->column_count * sizeof(struct memcs_chunk_column);
+	size = (size + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+	size_t field_count_offset = size;
+	size += capacity * sizeof(uint32_t);
+	for (uint32_t i = 0; i < store->column_count; i++) {
+		enum memcs_type type = store->columns[i].type;
+		size += capacity * (memcs_type_size[type] + 1);
+	}
+	ERROR_INJECT(ERRINJ_MEMCS_ALLOC, {
+		diag_set(OutOfMemory, size, "malloc", "memcs_chunk");
+		return NULL;
+	});
+	char *buf = malloc(size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, size, "malloc", "memcs_chunk");
+		return NULL;
+	}
+	struct memcs_chunk *chunk = (struct memcs_chunk *)buf;
+	chunk->capacity = capacity;
+	chunk->size = 0;
+	chunk->field_count = (uint32_t *)(buf + field_count_offset);
+	/*
+	 * Capacity is a multiple of 64 so value vectors stay aligned if we
+	 * place them before validity vectors.
+	 */
+	char *p = buf + field_count_offset + capacity * sizeof(uint32_t);
+	for (uint32_t i = 0; i < store->column_count; i++) {
+		enum memcs_type type = store->columns[i].type;
+		chunk->columns[i].values = p;
+		p += capacity * memcs_type_size[type];
+	}
+	for (uint32_t i = 0; i < store->column_count; i++) {
+		chunk->columns[i].validity = (uint8_t *)p;
+		p += capacity;
+	}
+	assert(p == buf + size);
+	store->mem_used += size;
+	return chunk;
+}
+
+/**
+ * Returns a chunk with free space for at least one row, appending a new
+ * chunk if the last one is full. Returns NULL and sets diag if the store
+ * can't have more chunks or on memory allocation error.
+ */
+static struct memcs_chunk *
+memcs_store_tail(struct memcs_store *store)
+{
+	if (store->chunk_count > 0) {
+		struct memcs_chunk *chunk =
+			memcs_store_chunk(store, store->chunk_count - 1);
+		if (chunk->size < chunk->capacity)
+			return chunk;
+	}
+	uint32_t chunk_no = store->chunk_count;
+	uint32_t page_no = chunk_no >> MEMCS_DIR_PAGE_LOG2;
+	if (page_no >= MEMCS_DIR_SIZE) {
+		diag_set(ClientError, ER_UNSUPPORTED, "memcs",
+			 tt_sprintf("more than %llu rows in a space",
+				    (unsigned long long)MEMCS_DIR_SIZE *
+				    MEMCS_DIR_PAGE_SIZE *
+				    MEMCS_CHUNK_ROWS_MAX));
+		return NULL;
+	}
+	if (store->dir[page_no] == NULL) {
+		size_t size = MEMCS_DIR_PAGE_SIZE * sizeof(struct memcs_chunk *);
+		store->dir[page_no] = malloc(size);
+		if (store->dir[page_no] == NULL) {
+			diag_set(OutOfMemory, size, "malloc", "memcs_store");
+			return NULL;
+		}
+		store->mem_used += size;
+	}
+	uint32_t capacity_log2 = MIN(MEMCS_CHUNK_ROWS_MIN_LOG2 + chunk_no,
+				     (uint32_t)MEMCS_CHUNK_ROWS_LOG2);
+	struct memcs_chunk *chunk = memcs_chunk_new(store, 1 << capacity_log2);
+	if (chunk == NULL)
+		return NULL;
+	store->dir[page_no][chunk_no & (MEMCS_DIR_PAGE_SIZE - 1)] = chunk;
+	store->chunk_count++;
+	return chunk;
+}
+
+/** Unlinks a string page from the store and frees it. */
+static void
+memcs_store_free_string_page(struct memcs_store *store,
+			     struct memcs_string_page *page)
+{
+	assert(page->ref_count == 0);
+	assert(page != store->string_page);
+	rlist_del_entry(page, in_store);
+	store->mem_used -= page->size;
+	free(page);
+}
+
+/**
+ * Allocates a string page of the given size, including the header, and
+ * links it to the store. Returns NULL and sets diag on memory allocation
+ * error.
+ */
+static struct memcs_string_page *
+memcs_store_new_string_page(struct memcs_store *store, size_t size)
+{
+	struct memcs_string_page *page;
+	if (size == MEMCS_STRING_PAGE_SIZE)
+		page = aligned_alloc(MEMCS_STRING_PAGE_SIZE, size);
+	else
+		page = malloc(size);
+	if (page == NULL) {
+		diag_set(OutOfMemory, size, "malloc", "memcs_string_page");
+		return NULL;
+	}
+	page->size = size;
+	page->ref_count = 0;
+	rlist_add_entry(&store->string_pages, page, in_store);
+	store->mem_used += size;
+	return page;
+}
+
+/**
+ * Copies a string to the store memory. Returns NULL and sets diag on
+ * memory allocation error.
+ */
+static const char *
+memcs_store_copy_string(struct memcs_store *store, const char *data,
+			uint32_t len)
+{
+	if (len == 0)
+		return "";
+	struct memcs_string_page *page;
+	char *dst;
+	if (len > MEMCS_STRING_SIZE_MAX) {
+		page = memcs_store_new_string_page(store, sizeof(*page) + len);
+		if (page == NULL)
+			return NULL;
+		dst = (char *)(page + 1);
+	} else {
+		if (store->string_pos + len > store->string_end) {
+			page = memcs_store_new_string_page(
+				store, MEMCS_STRING_PAGE_SIZE);
+			if (page == NULL)
+				return NULL;
+			struct memcs_string_page *old = store->string_page;
+			store->string_page = page;
+			store->string_pos = (char *)(page + 1);
+			store->string_end = (char *)page +
+					    MEMCS_STRING_PAGE_SIZE;
+			if (old != NULL && old->ref_count == 0)
+				memcs_store_free_string_page(store, old);
+		}
+		page = store->string_page;
+		dst = store->string_pos;
+		store->string_pos += len;
+	}
+	page->ref_count++;
+	memcpy(dst, data, len);
+	return dst;
+}
+
+/** Releases a string copied with memcs_store_copy_string(). */
+static void
+memcs_store_release_string(struct memcs_store *store,
+			   const struct memcs_str *str)
+{
+	if (str->len == 0)
+		return;
+	struct memcs_string_page *page = memcs_string_page(str);
+	assert(page->ref_count > 0);
+	if (--page->ref_count == 0 && page != store->string_page)
+		memcs_store_free_string_page(store, page);
+}
+
+/** Releases strings stored in the given columns of a chunk row. */
+static void
+memcs_store_release_row_strings(struct memcs_store *store,
+				struct memcs_chunk *chunk, uint32_t pos,
+				uint32_t column_count)
+{
+	for (uint32_t i = 0; i < column_count; i++) {
+		if (store->columns[i].type != MEMCS_TYPE_STR ||
+		    chunk->columns[i].validity[pos] == 0)
+			continue;
+		const struct memcs_str *values = chunk->columns[i].values;
+		memcs_store_release_string(store, &values[pos]);
+	}
+}
+
+int
+memcs_store_decode(const struct memcs_store *store, const char *data,
+		   struct memcs_field *fields, uint32_t *field_count)
+{
+	uint32_t count = mp_decode_array(&data);
+	if (count > store->column_count) {
+		diag_set(ClientError, ER_UNSUPPORTED, "memcs",
+			 "tuple fields not described by the space format");
+		return -1;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		const struct memcs_column_def *column = &store->columns[i];
+		struct memcs_field *field = &fields[i];
+		enum mp_type mp_type = mp_typeof(*data);
+		if (mp_type == MP_NIL) {
+			mp_decode_nil(&data);
+			field->is_null = true;
+			continue;
+		}
+		field->is_null = false;
+		union memcs_value *value = &field->value;
+		switch (column->type) {
+		case MEMCS_TYPE_UINT:
+			assert(mp_type == MP_UINT);
+			value->u = mp_decode_uint(&data);
+			break;
+		case MEMCS_TYPE_INT:
+			if (mp_type == MP_INT) {
+				value->i = mp_decode_int(&data);
+				break;
+			}
+			assert(mp_type == MP_UINT);
+			value->u = mp_decode_uint(&data);
+			if (value->u > INT64_MAX) {
+				diag_set(ClientError, ER_UNSUPPORTED, "memcs",
+					 "integer values greater than "
+					 "INT64_MAX");
+				return -1;
+			}
+			break;
+		case MEMCS_TYPE_DOUBLE:
+			switch (mp_type) {
+			case MP_UINT:
+				value->d = mp_decode_uint(&data);
+				break;
+			case MP_INT:
+				value->d = mp_decode_int(&data);
+				break;
+			case MP_FLOAT:
+				value->d = mp_decode_float(&data);
+				break;
+			case MP_DOUBLE:
+				value->d = mp_decode_double(&data);
+				break;
+			default:
+				unreachable();
+			}
+			break;
+		case MEMCS_TYPE_BOOL:
+			assert(mp_type == MP_BOOL);
+			value->b = mp_decode_bool(&data);
+			break;
+		case MEMCS_TYPE_STR:
+			if (mp_type == MP_STR) {
+				value->s.data = mp_decode_str(&data,
+							      &value->s.len);
+				break;
+			}
+			assert(mp_type == MP_BIN);
+			value->s.data = mp_decode_bin(&data, &value->s.len);
+			break;
+		default:
+			unreachable();
+		}
+	}
+	for (uint32_t i = count; i < store->column_count; i++)
+		fields[i].is_null = true;
+	*field_count = count;
+	return 0;
+}
+
+int
+memcs_store_append(struct memcs_store *store,
+		   const struct memcs_field *fields, uint32_t field_count,
+		   uint64_t *row)
+{
+	assert(field_count <= store->column_count);
+	struct memcs_chunk *chunk;
+	uint32_t pos;
+	bool is_reused = store->free_count > 0;
+	if (is_reused) {
+		*row = store->free_rows[--store->free_count];
+		chunk = memcs_store_chunk(store, memcs_row_chunk_no(*row));
+		pos = memcs_row_pos(*row);
+	} else {
+		chunk = memcs_store_tail(store);
+		if (chunk == NULL)
+			return -1;
+		pos = chunk->size;
+		*row = memcs_row_id(store->chunk_count - 1, pos);
+	}
+	for (uint32_t i = 0; i < store->column_count; i++) {
+		struct memcs_chunk_column *column = &chunk->columns[i];
+		const struct memcs_field *field = &fields[i];
+		enum memcs_type type = store->columns[i].type;
+		char *value = (char *)column->values +
+			      pos * memcs_type_size[type];
+		if (field->is_null) {
+			column->validity[pos] = 0;
+			memset(value, 0, memcs_type_size[type]);
+			continue;
+		}
+		switch (type) {
+		case MEMCS_TYPE_UINT:
+		case MEMCS_TYPE_INT:
+		case MEMCS_TYPE_DOUBLE:
+			memcpy(value, &field->value, 8);
+			break;
+		case MEMCS_TYPE_BOOL:
+			*value = field->value.b;
+			break;
+		case MEMCS_TYPE_STR: {
+			struct memcs_str str;
+			str.len = field->value.s.len;
+			str.data = memcs_store_copy_string(
+				store, field->value.s.data, str.len);
+			if (str.data == NULL) {
+				memcs_store_release_row_strings(store, chunk,
+								pos, i);
+				if (is_reused)
+					store->free_rows[store->free_count++] =
+						*row;
+				return -1;
+			}
+			memcpy(value, &str, sizeof(str));
+			break;
+		}
+		default:
+			unreachable();
+		}
+		column->validity[pos] = 1;
+	}
+	chunk->field_count[pos] = field_count;
+	if (!is_reused)
+		chunk->size++;
+	return 0;
+}
+
+/**
+ * Makes sure an array has room for at least @a count elements of the
+ * given size. Returns the array, which may be moved. Returns NULL and
+ * sets diag on memory allocation error.
+ */
+static void *
+memcs_store_grow_array(struct memcs_store *store, void *array,
+		       uint32_t *capacity, uint32_t count, size_t elem_size)
+{
+	assert(count > 0);
+	if (count <= *capacity)
+		return array;
+	uint32_t new_capacity = MAX(*capacity * 2, 64);
+	while (new_capacity < count)
+		new_capacity *= 2;
+	void *new_array = realloc(array, new_capacity * elem_size);
+	if (new_array == NULL) {
+		diag_set(OutOfMemory, new_capacity * elem_size, "realloc",
+			 "memcs_store");
+		return NULL;
+	}
+	store->mem_used += (new_capacity - *capacity) * elem_size;
+	*capacity = new_capacity;
+	return new_array;
+}
+
+int
+memcs_store_reserve_free(struct memcs_store *store)
+{
+	uint32_t count = store->dead_count - store->dead_head +
+			 store->free_reserved + 1;
+	struct memcs_dead_row *dead_rows = memcs_store_grow_array(
+		store, store->dead_rows, &store->dead_capacity, count,
+		sizeof(*dead_rows));
+	if (dead_rows == NULL)
+		return -1;
+	store->dead_rows = dead_rows;
+	uint64_t *free_rows = memcs_store_grow_array(
+		store, store->free_rows, &store->free_capacity,
+		store->free_count + count, sizeof(*free_rows));
+	if (free_rows == NULL)
+		return -1;
+	store->free_rows = free_rows;
+	store->free_reserved++;
+	return 0;
+}
+
+/**
+ * Reclaims freed rows that aren't visible to any open view: releases
+ * their strings and makes their slots available for reuse.
+ */
+static void
+memcs_store_collect_garbage(struct memcs_store *store)
+{
+	uint64_t generation = UINT64_MAX;
+	if (!rlist_empty(&store->views)) {
+		generation = rlist_first_entry(&store->views,
+					       struct memcs_store_view,
+					       in_store)->generation;
+	}
+	while (store->dead_head < store->dead_count) {
+		struct memcs_dead_row *dead =
+			&store->dead_rows[store->dead_head];
+		/* The row is visible to the oldest view. */
+		if (dead->generation >= generation)
+			break;
+		struct memcs_chunk *chunk =
+			memcs_store_chunk(store, memcs_row_chunk_no(dead->row));
+		memcs_store_release_row_strings(store, chunk,
+						memcs_row_pos(dead->row),
+						store->column_count);
+		assert(store->free_count < store->free_capacity);
+		store->free_rows[store->free_count++] = dead->row;
+		store->dead_head++;
+	}
+	if (store->dead_head == store->dead_count)
+		store->dead_head = store->dead_count = 0;
+}
+
+void
+memcs_store_free_row(struct memcs_store *store, uint64_t row)
+{
+	assert(store->free_reserved > 0);
+	store->free_reserved--;
+	if (row == MEMCS_ROW_NONE)
+		return;
+	if (store->dead_count == store->dead_capacity) {
+		/* There's room reserved before dead_head. */
+		assert(store->dead_head > 0);
+		store->dead_count -= store->dead_head;
+		memmove(store->dead_rows, store->dead_rows + store->dead_head,
+			store->dead_count * sizeof(*store->dead_rows));
+		store->dead_head = 0;
+	}
+	struct memcs_dead_row *dead = &store->dead_rows[store->dead_count++];
+	dead->row = row;
+	dead->generation = store->view_generation;
+	memcs_store_collect_garbage(store);
+}
+
+void
+memcs_store_open_view(struct memcs_store *store, struct memcs_store_view *view)
+{
+	view->generation = ++store->view_generation;
+	rlist_add_tail_entry(&store->views, view, in_store);
+}
+
+void
+memcs_store_close_view(struct memcs_store *store,
+		       struct memcs_store_view *view)
+{
+	rlist_del_entry(view, in_store);
+	memcs_store_collect_garbage(store);
+}
+
+uint32_t
+memcs_store_row_bsize(const struct memcs_store *store, uint64_t row)
+{
+	const struct memcs_chunk *chunk =
+		memcs_store_chunk(store, memcs_row_chunk_no(row));
+	uint32_t pos = memcs_row_pos(row);
+	uint32_t field_count = chunk->field_count[pos];
+	uint32_t size = mp_sizeof_array(field_count);
+	for (uint32_t i = 0; i < field_count; i++) {
+		const struct memcs_column_def *column = &store->columns[i];
+		struct memcs_field field;
+		memcs_chunk_get(chunk, column, i, pos, &field);
+		if (field.is_null) {
+			size += mp_sizeof_nil();
+			continue;
+		}
+		switch (column->type) {
+		case MEMCS_TYPE_UINT:
+			size += mp_sizeof_uint(field.value.u);
+			break;
+		case MEMCS_TYPE_INT:
+			size += field.value.i < 0 ?
+				mp_sizeof_int(field.value.i) :
+				mp_sizeof_uint(field.value.i);
+			break;
+		case MEMCS_TYPE_DOUBLE:
+			size += column->field_type == FIELD_TYPE_FLOAT32 ?
+				mp_sizeof_float(field.value.d) :
+				mp_sizeof_double(field.value.d);
+			break;
+		case MEMCS_TYPE_BOOL:
+			size += mp_sizeof_bool(field.value.b);
+			break;
+		case MEMCS_TYPE_STR:
+			size += column->field_type == FIELD_TYPE_VARBINARY ?
+				mp_sizeof_bin(field.value.s.len) :
+				mp_sizeof_str(field.value.s.len);
+			break;
+		default:
+			unreachable();
+		}
+	}
+	return size;
+}
+
+char *
+memcs_store_row_encode(const struct memcs_store *store, uint64_t row,
+		       char *buf)
+{
+	const struct memcs_chunk *chunk =
+		memcs_store_chunk(store, memcs_row_chunk_no(row));
+	uint32_t pos = memcs_row_pos(row);
+	uint32_t field_count = chunk->field_count[pos];
+	buf = mp_encode_array(buf, field_count);
+	for (uint32_t i = 0; i < field_count; i++) {
+		const struct memcs_column_def *column = &store->columns[i];
+		struct memcs_field field;
+		memcs_chunk_get(chunk, column, i, pos, &field);
+		if (field.is_null) {
+			buf = mp_encode_nil(buf);
+			continue;
+		}
+		switch (column->type) {
+		case MEMCS_TYPE_UINT:
+			buf = mp_encode_uint(buf, field.value.u);
+			break;
+		case MEMCS_TYPE_INT:
+			buf = field.value.i < 0 ?
+			      mp_encode_int(buf, field.value.i) :
+			      mp_encode_uint(buf, field.value.i);
+			break;
+		case MEMCS_TYPE_DOUBLE:
+			buf = column->field_type == FIELD_TYPE_FLOAT32 ?
+			      mp_encode_float(buf, field.value.d) :
+			      mp_encode_double(buf, field.value.d);
+			break;
+		case MEMCS_TYPE_BOOL:
+			buf = mp_encode_bool(buf, field.value.b);
+			break;
+		case MEMCS_TYPE_STR:
+			buf = column->field_type == FIELD_TYPE_VARBINARY ?
+			      mp_encode_bin(buf, field.value.s.data,
+					    field.value.s.len) :
+			      mp_encode_str(buf, field.value.s.data,
+					    field.value.s.len);
+			break;
+		default:
+			unreachable();
+		}
+	}
+	return buf;
+}
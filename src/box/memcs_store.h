@@ -0,0 +1,417 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2025, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "field_def.h"
+#include "small/rlist.h"
+#include "trivia/util.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Column-wise storage of memcs space rows.
+ *
+ * Rows are stored in chunks. A chunk stores up to MEMCS_CHUNK_ROWS_MAX
+ * rows, each column in a separate contiguous vector. Rows are never
+ * modified after they have been written. A replaced or deleted row is
+ * removed from the primary index and handed back to the store with
+ * memcs_store_free_row() when the change is committed (or, for a new row,
+ * rolled back). Its slot and strings are reclaimed as soon as all views
+ * that were open at that moment are closed, and the slot is reused for
+ * the next appended row.
+ *
+ * A row is identified by its id, which is composed of the chunk number and
+ * the row position in the chunk. Row ids of reclaimed rows are reused so
+ * one may only keep a row id while the row is in the index or while a view
+ * opened before the row was freed is open.
+ *
+ * Chunks are addressed through a two-level directory with fixed-size pages
+ * so that the chunk of a row can be looked up without any locking from
+ * any thread while new chunks are appended in the tx thread.
+ */
+
+struct memcs_string_page;
+struct tuple_format;
+
+enum {
+	/** Log2 of the max number of rows in a chunk. */
+	MEMCS_CHUNK_ROWS_LOG2 = 12,
+	/** Max number of rows in a chunk. */
+	MEMCS_CHUNK_ROWS_MAX = 1 << MEMCS_CHUNK_ROWS_LOG2,
+	/**
+	 * Log2 of the number of rows in the first chunk. Each next chunk
+	 * is twice as big as the previous one until MEMCS_CHUNK_ROWS_MAX
+	 * is reached so that small spaces don't waste memory.
+	 */
+	MEMCS_CHUNK_ROWS_MIN_LOG2 = 6,
+	/** Log2 of the number of chunk pointers in a directory page. */
+	MEMCS_DIR_PAGE_LOG2 = 12,
+	/** Number of chunk pointers in a directory page. */
+	MEMCS_DIR_PAGE_SIZE = 1 << MEMCS_DIR_PAGE_LOG2,
+	/** Max number of directory pages. */
+	MEMCS_DIR_SIZE = 1 << 12,
+	/**
+	 * Size of a page used for storing strings. Pages are aligned by
+	 * their size so that the page of a string can be found by its
+	 * address.
+	 */
+	MEMCS_STRING_PAGE_SIZE = 64 * 1024,
+	/**
+	 * Strings longer than this are allocated separately rather than
+	 * in a string page.
+	 */
+	MEMCS_STRING_SIZE_MAX = MEMCS_STRING_PAGE_SIZE / 4,
+};
+
+/** Row id that doesn't refer to any row. */
+#define MEMCS_ROW_NONE UINT64_MAX
+
+/** Type of values stored in a column. */
+enum memcs_type {
+	/** uint64_t */
+	MEMCS_TYPE_UINT,
+	/** int64_t */
+	MEMCS_TYPE_INT,
+	/** double */
+	MEMCS_TYPE_DOUBLE,
+	/** bool */
+	MEMCS_TYPE_BOOL,
+	/** struct memcs_str */
+	MEMCS_TYPE_STR,
+	memcs_type_MAX,
+};
+
+/** A string or a binary value stored in a column. */
+struct memcs_str {
+	/** String data, not null-terminated. */
+	const char *data;
+	/** String length. */
+	uint32_t len;
+};
+
+/** A value stored in a column. */
+union memcs_value {
+	uint64_t u;
+	int64_t i;
+	double d;
+	bool b;
+	struct memcs_str s;
+};
+
+/** A value of a row field. */
+struct memcs_field {
+	/** The value, undefined if the field is null. */
+	union memcs_value value;
+	/** Set if the field is null or absent. */
+	bool is_null;
+};
+
+/** Column definition. */
+struct memcs_column_def {
+	/** Type of the space field stored in the column. */
+	enum field_type field_type;
+	/** Type of the column values. */
+	enum memcs_type type;
+	/** Set if the column may store nulls. */
+	bool is_nullable;
+};
+
+/** Size of a column value, in bytes, by column type. */
+extern const uint32_t memcs_type_size[];
+
+/**
+ * Returns the type of a column that stores values of the given field type
+ * or memcs_type_MAX if such values can't be stored in a column.
+ */
+enum memcs_type
+memcs_type_by_field_type(enum field_type type);
+
+/** Column vectors of a chunk. */
+struct memcs_chunk_column {
+	/** Column values, memcs_type_size[] bytes per row. */
+	void *values;
+	/** One byte per row: 1 if the value is present, 0 if it's null. */
+	uint8_t *validity;
+};
+
+/** A chunk of rows. */
+struct memcs_chunk {
+	/** Max number of rows that can be stored in the chunk. */
+	uint32_t capacity;
+	/** Number of rows appended to the chunk. */
+	uint32_t size;
+	/** Number of fields in each row. */
+	uint32_t *field_count;
+	/** Column vectors. */
+	struct memcs_chunk_column columns[0];
+};
+
+/**
+ * A reader of rows that may outlive their removal from the index, like
+ * an index read view. Rows freed while a view is open aren't reclaimed
+ * until the view is closed.
+ */
+struct memcs_store_view {
+	/** Link in memcs_store::views. */
+	struct rlist in_store;
+	/** Value of memcs_store::view_generation when the view was opened. */
+	uint64_t generation;
+};
+
+/** A row freed while there were open views. */
+struct memcs_dead_row {
+	/** Row id. */
+	uint64_t row;
+	/** Value of memcs_store::view_generation when the row was freed. */
+	uint64_t generation;
+};
+
+/** Column-wise row storage. */
+struct memcs_store {
+	/** Column definitions. */
+	struct memcs_column_def *columns;
+	/** Number of columns. */
+	uint32_t column_count;
+	/** Number of chunks. */
+	uint32_t chunk_count;
+	/** Number of bytes allocated for chunks and strings. */
+	size_t mem_used;
+	/** List of string pages, linked by memcs_string_page::in_store. */
+	struct rlist string_pages;
+	/** Page new strings are allocated from or NULL. */
+	struct memcs_string_page *string_page;
+	/** Free space left in the current string page. */
+	char *string_pos;
+	/** End of the current string page. */
+	char *string_end;
+	/** Open views, oldest first. */
+	struct rlist views;
+	/** Incremented whenever a view is opened. */
+	uint64_t view_generation;
+	/**
+	 * Freed rows that may be visible to open views, ordered by
+	 * generation. Entries before dead_head have been reclaimed.
+	 */
+	struct memcs_dead_row *dead_rows;
+	/** Index of the first not reclaimed entry in dead_rows. */
+	uint32_t dead_head;
+	/** Number of entries in dead_rows. */
+	uint32_t dead_count;
+	/** Capacity of dead_rows. */
+	uint32_t dead_capacity;
+	/** Ids of reclaimed rows that can be reused. */
+	uint64_t *free_rows;
+	/** Number of entries in free_rows. */
+	uint32_t free_count;
+	/** Capacity of free_rows. */
+	uint32_t free_capacity;
+	/**
+	 * Number of memcs_store_free_row() calls reserved with
+	 * memcs_store_reserve_free(). Both dead_rows and free_rows have
+	 * room for all of them so freeing a row never fails.
+	 */
+	uint32_t free_reserved;
+	/** Chunk directory. */
+	struct memcs_chunk **dir[MEMCS_DIR_SIZE];
+};
+
+/** Returns the id of a row given its chunk number and position. */
+static inline uint64_t
+memcs_row_id(uint32_t chunk_no, uint32_t pos)
+{
+	return ((uint64_t)chunk_no << MEMCS_CHUNK_ROWS_LOG2) | pos;
+}
+
+/** Returns the chunk number of a row. */
+static inline uint32_t
+memcs_row_chunk_no(uint64_t row)
+{
+	return row >> MEMCS_CHUNK_ROWS_LOG2;
+}
+
+/** Returns the position of a row in its chunk. */
+static inline uint32_t
+memcs_row_pos(uint64_t row)
+{
+	return row & (MEMCS_CHUNK_ROWS_MAX - 1);
+}
+
+/** Returns a chunk by number. */
+static inline struct memcs_chunk *
+memcs_store_chunk(const struct memcs_store *store, uint32_t chunk_no)
+{
+	assert(chunk_no < store->chunk_count);
+	return store->dir[chunk_no >> MEMCS_DIR_PAGE_LOG2]
+			 [chunk_no & (MEMCS_DIR_PAGE_SIZE - 1)];
+}
+
+/** Returns the value of a chunk row field. */
+static inline void
+memcs_chunk_get(const struct memcs_chunk *chunk,
+		const struct memcs_column_def *column_def,
+		uint32_t column, uint32_t pos, struct memcs_field *field)
+{
+	const struct memcs_chunk_column *c = &chunk->columns[column];
+	field->is_null = c->validity[pos] == 0;
+	const char *values = (const char *)c->values;
+	switch (column_def->type) {
+	case MEMCS_TYPE_UINT:
+	case MEMCS_TYPE_INT:
+	case MEMCS_TYPE_DOUBLE:
+		memcpy(&field->value, values + pos * 8, 8);
+		break;
+	case MEMCS_TYPE_BOOL:
+		field->value.b = values[pos] != 0;
+		break;
+	case MEMCS_TYPE_STR:
+		field->value.s = ((const struct memcs_str *)values)[pos];
+		break;
+	default:
+		unreachable();
+	}
+}
+
+/** Returns the value of a row field. */
+static inline void
+memcs_store_get(const struct memcs_store *store, uint64_t row,
+		uint32_t column, struct memcs_field *field)
+{
+	assert(column < store->column_count);
+	const struct memcs_chunk *chunk =
+		memcs_store_chunk(store, memcs_row_chunk_no(row));
+	memcs_chunk_get(chunk, &store->columns[column], column,
+			memcs_row_pos(row), field);
+}
+
+/** Compares two non-null values of the given type. */
+static inline int
+memcs_value_compare(enum memcs_type type, const union memcs_value *a,
+		    const union memcs_value *b)
+{
+	switch (type) {
+	case MEMCS_TYPE_UINT:
+		return a->u < b->u ? -1 : a->u > b->u;
+	case MEMCS_TYPE_INT:
+		return a->i < b->i ? -1 : a->i > b->i;
+	case MEMCS_TYPE_DOUBLE:
+		return a->d < b->d ? -1 : a->d > b->d;
+	case MEMCS_TYPE_BOOL:
+		return (int)a->b - (int)b->b;
+	case MEMCS_TYPE_STR: {
+		uint32_t len = MIN(a->s.len, b->s.len);
+		int rc = memcmp(a->s.data, b->s.data, len);
+		if (rc != 0)
+			return rc;
+		return a->s.len < b->s.len ? -1 : a->s.len > b->s.len;
+	}
+	default:
+		unreachable();
+	}
+	return 0;
+}
+
+/**
+ * Builds column definitions for the given tuple format, one column per
+ * top-level field. The result is allocated with malloc. Returns NULL and
+ * sets diag if a field has a type that can't be stored in a column.
+ */
+struct memcs_column_def *
+memcs_column_defs_new(struct tuple_format *format, uint32_t *column_count);
+
+/** Returns true if two column definition arrays are equal. */
+bool
+memcs_column_defs_equal(const struct memcs_column_def *a, uint32_t a_count,
+			const struct memcs_column_def *b, uint32_t b_count);
+
+/** Allocates an empty store without columns. */
+struct memcs_store *
+memcs_store_new(void);
+
+/** Frees a store. */
+void
+memcs_store_delete(struct memcs_store *store);
+
+/**
+ * Sets the store columns. The columns are copied. May only be called
+ * while the store has no chunks.
+ */
+void
+memcs_store_set_columns(struct memcs_store *store,
+			const struct memcs_column_def *columns,
+			uint32_t column_count);
+
+/**
+ * Decodes a MsgPack array into row fields, one per column. The data must
+ * have been validated against the space format. Strings aren't copied.
+ * Returns -1 and sets diag if the data can't be stored in the columns.
+ */
+int
+memcs_store_decode(const struct memcs_store *store, const char *data,
+		   struct memcs_field *fields, uint32_t *field_count);
+
+/**
+ * Appends a row to the store, copying strings. A slot of a reclaimed row
+ * is reused if there's any. The fields array must have an entry for each
+ * store column. Returns the row id in @a row. On failure returns -1 and
+ * sets diag.
+ */
+int
+memcs_store_append(struct memcs_store *store,
+		   const struct memcs_field *fields, uint32_t field_count,
+		   uint64_t *row);
+
+/**
+ * Reserves memory for a memcs_store_free_row() call so that a change that
+ * is going to free a row on commit or rollback can't fail there. Returns
+ * -1 and sets diag on memory allocation error.
+ */
+int
+memcs_store_reserve_free(struct memcs_store *store);
+
+/**
+ * Frees a row that has been removed from the index, consuming a
+ * reservation made with memcs_store_reserve_free(). The row is reclaimed
+ * once all views that are open now are closed. If @a row is
+ * MEMCS_ROW_NONE, only the reservation is released.
+ */
+void
+memcs_store_free_row(struct memcs_store *store, uint64_t row);
+
+/**
+ * Opens a view. Rows freed after this call stay readable until the view
+ * is closed.
+ */
+void
+memcs_store_open_view(struct memcs_store *store, struct memcs_store_view *view);
+
+/** Closes a view and reclaims rows that aren't visible any more. */
+void
+memcs_store_close_view(struct memcs_store *store,
+		       struct memcs_store_view *view);
+
+/** Returns the size of a row encoded in MsgPack. */
+uint32_t
+memcs_store_row_bsize(const struct memcs_store *store, uint64_t row);
+
+/**
+ * Encodes a row in MsgPack. The buffer must be at least
+ * memcs_store_row_bsize() bytes. Returns the end of the encoded data.
+ */
+char *
+memcs_store_row_encode(const struct memcs_store *store, uint64_t row,
+		       char *buf);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
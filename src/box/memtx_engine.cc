@@ -66,7 +66,9 @@
 #include "assoc.h"
 #include "scoped_guard.h"
 #include "xlog_reader.h"
+#include "tweaks.h"
 
+#include <sys/mman.h>
 #include <type_traits>
 
 /* sync snapshot every 16MB */
@@ -92,6 +94,17 @@ static inline struct tuple *
 memtx_tuple_new_raw_impl(struct tuple_format *format, const char *data,
 			 const char *end, unsigned flags);
 
+/**
+ * Copies a tuple to a new block if the allocator places the copy at a lower
+ * address. Returns NULL if the tuple should stay where it is. Set to NULL
+ * if the tuple allocator doesn't support relocation.
+ */
+static struct tuple *
+(*memtx_tuple_relocate)(struct tuple *tuple);
+
+static struct tuple *
+memtx_tuple_relocate_small(struct tuple *tuple);
+
 static void
 memtx_engine_run_gc(struct memtx_engine *memtx, bool *stop);
 
@@ -329,6 +342,9 @@ static void
 memtx_engine_shutdown(struct engine *engine)
 {
 	struct memtx_engine *memtx = (struct memtx_engine *)engine;
+	fiber_cancel(memtx->compaction_fiber);
+	fiber_join(memtx->compaction_fiber);
+	memtx->compaction_fiber = NULL;
 	fiber_cancel(memtx->gc_fiber);
 	fiber_join(memtx->gc_fiber);
 	memtx->gc_fiber = NULL;
@@ -562,12 +578,14 @@ memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
 	struct tuple *unused;
 	/*
 	 * We use transaction in case of force recovery merely to
-	 * simplify the code.
+	 * simplify the code. Spaces of other engines checkpointed
+	 * by memtx are recovered with the generic DML path, too.
 	 */
-	if (recovering_system_spaces ||
+	if (recovering_system_spaces || !space_is_memtx(space) ||
 	    space_events_are_enabled() || txn_events_are_enabled() ||
 	    memtx->force_recovery) {
-		if (!recovering_system_spaces && !memtx->force_recovery)
+		if (!recovering_system_spaces && space_is_memtx(space) &&
+		    !memtx->force_recovery)
 			say_warn_once(
 				"snapshot recovery performance is better with"
 				" new value of"
@@ -1867,15 +1885,300 @@ memtx_engine_gc_f(va_list va)
 	return 0;
 }
 
+/* {{{ Tuple arena compaction */
+
+/**
+ * The tuple arena compaction starts when the ratio of memory used for tuples
+ * to memory allocated for them by the small allocator drops below this value.
+ * Zero disables compaction.
+ */
+static double memtx_compaction_threshold = 0;
+TWEAK_DOUBLE(memtx_compaction_threshold);
+
+enum {
+	/** Max number of tuples relocated without yielding. */
+	MEMTX_COMPACTION_BATCH = 100,
+};
+
+/** How often the compaction fiber checks the arena utilization, seconds. */
+static const double MEMTX_COMPACTION_CHECK_INTERVAL = 1;
+
+/**
+ * Max interval between compaction passes, seconds. If a pass doesn't
+ * release any memory (e.g. the arena is fragmented inside a size class,
+ * which relocation can't fix), the interval is doubled up to this value
+ * so that the fiber doesn't rescan all spaces every second in vain.
+ */
+static const double MEMTX_COMPACTION_CHECK_INTERVAL_MAX = 64;
+
+/** Returns true if tuples may be relocated now. */
+static bool
+memtx_engine_compaction_enabled(struct memtx_engine *memtx)
+{
+	/* Secondary indexes aren't built until the end of recovery. */
+	return memtx->state == MEMTX_OK && memtx_compaction_threshold > 0 &&
+	       memtx_tuple_relocate != NULL;
+}
+
+/**
+ * Returns true if the tuple arena is sparse enough to be compacted.
+ * The memory allocated for tuples is returned in @a total.
+ */
+static bool
+memtx_engine_needs_compaction(struct memtx_engine *memtx, size_t *total)
+{
+	*total = 0;
+	if (!memtx_engine_compaction_enabled(memtx))
+		return false;
+	struct allocator_stats stats;
+	memset(&stats, 0, sizeof(stats));
+	SmallAlloc::stats(&stats, stats_noop_cb, NULL);
+	*total = stats.small.total;
+	return stats.small.total > 0 &&
+	       (double)stats.small.used / stats.small.total <
+	       memtx_compaction_threshold;
+}
+
+/**
+ * Returns true if tuples of the space may be relocated. The space is walked
+ * in the primary key order across yields, so the primary key must be a tree.
+ * Functional index keys can't be recomputed without calling the function,
+ * and internal on_replace triggers (e.g. the one installed by a background
+ * index build) must see every change of the space, so such spaces are
+ * skipped. Compressed tuples are skipped, too, because the key can't be
+ * extracted from them without decompression.
+ */
+static bool
+memtx_space_is_compactable(struct space *space)
+{
+	struct index *pk = space_index(space, 0);
+	if (!space_is_memtx(space) || pk == NULL || pk->def->type != TREE ||
+	    space->upgrade != NULL || space->format->is_compressed ||
+	    !rlist_empty(&space->on_replace))
+		return false;
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		if (space->index[i]->def->key_def->for_func_index)
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Returns true if the tuple may be relocated. The tuple must be referenced
+ * only by the space and by the compaction fiber, and it must not be
+ * tracked by the transaction manager.
+ */
+static bool
+memtx_tuple_is_relocatable(struct tuple *tuple)
+{
+	return tuple->local_refs == 2 &&
+	       !tuple_has_flag(tuple, TUPLE_HAS_UPLOADED_REFS) &&
+	       !tuple_has_flag(tuple, TUPLE_IS_DIRTY);
+}
+
+/**
+ * Replaces a tuple with its relocated copy in all indexes of the space.
+ * On failure, the indexes are left unchanged.
+ */
+static int
+memtx_space_replace_relocated(struct space *space, struct tuple *old_tuple,
+			      struct tuple *new_tuple)
+{
+	uint32_t i;
+	for (i = 0; i < space->index_count; i++) {
+		struct tuple *unused;
+		struct tuple *successor;
+		if (index_replace(space->index[i], old_tuple, new_tuple,
+				  DUP_REPLACE, &unused, &successor) != 0)
+			goto rollback;
+	}
+	return 0;
+rollback:
+	for (; i > 0; i--) {
+		struct tuple *unused;
+		struct tuple *successor;
+		/* Rollback must not fail. */
+		if (index_replace(space->index[i - 1], new_tuple, old_tuple,
+				  DUP_REPLACE, &unused, &successor) != 0) {
+			diag_log();
+			unreachable();
+			panic("failed to rollback tuple relocation");
+		}
+	}
+	return -1;
+}
+
+/**
+ * Visits up to MEMTX_COMPACTION_BATCH tuples of the space following the
+ * given primary key (or from the beginning if the key is NULL) and
+ * relocates those of them that may be moved to lower addresses. On return
+ * the key is set to the key of the last visited tuple, or freed and set to
+ * NULL if the whole space has been visited.
+ */
+static int
+memtx_space_compact_batch(struct space *space, char **key)
+{
+	struct index *pk = space_index(space, 0);
+	struct key_def *key_def = pk->def->key_def;
+	struct tuple *batch[MEMTX_COMPACTION_BATCH];
+	int count = 0;
+	struct iterator *it = index_create_iterator(
+		pk, *key == NULL ? ITER_ALL : ITER_GT, *key,
+		*key == NULL ? 0 : key_def->part_count);
+	if (it == NULL)
+		return -1;
+	struct tuple *tuple;
+	while (count < MEMTX_COMPACTION_BATCH) {
+		if (iterator_next_internal(it, &tuple) != 0) {
+			iterator_delete(it);
+			goto fail;
+		}
+		if (tuple == NULL)
+			break;
+		tuple_ref(tuple);
+		batch[count++] = tuple;
+	}
+	iterator_delete(it);
+	if (count < MEMTX_COMPACTION_BATCH) {
+		free(*key);
+		*key = NULL;
+	} else {
+		uint32_t key_size;
+		size_t region_svp = region_used(&fiber()->gc);
+		const char *last_key = tuple_extract_key(
+			batch[count - 1], key_def, MULTIKEY_NONE, &key_size);
+		if (last_key == NULL)
+			goto fail;
+		*key = (char *)xrealloc(*key, key_size);
+		memcpy(*key, last_key, key_size);
+		region_truncate(&fiber()->gc, region_svp);
+	}
+	for (int i = 0; i < count; i++) {
+		struct tuple *old_tuple = batch[i];
+		if (!memtx_tuple_is_relocatable(old_tuple))
+			continue;
+		struct tuple *new_tuple = memtx_tuple_relocate(old_tuple);
+		if (new_tuple == NULL)
+			continue;
+		if (memtx_space_replace_relocated(space, old_tuple,
+						  new_tuple) != 0) {
+			tuple_delete(new_tuple);
+			goto fail;
+		}
+		/* Move the space's reference to the new tuple. */
+		tuple_ref(new_tuple);
+		tuple_unref(old_tuple);
+	}
+	for (int i = 0; i < count; i++)
+		tuple_unref(batch[i]);
+	return 0;
+fail:
+	for (int i = 0; i < count; i++)
+		tuple_unref(batch[i]);
+	free(*key);
+	*key = NULL;
+	return -1;
+}
+
+static int
+memtx_collect_space_id(struct space *space, void *arg)
+{
+	if (memtx_space_is_compactable(space))
+		*xregion_alloc_object((struct region *)arg, uint32_t) =
+			space_id(space);
+	return 0;
+}
+
+/**
+ * Walks over all memtx spaces and relocates their tuples to lower addresses
+ * so that sparse slabs located at higher addresses are emptied and released.
+ * Yields after each batch. Spaces dropped or altered in the meantime are
+ * skipped. The arena utilization isn't checked until the pass is over,
+ * because collecting the allocator stats is expensive.
+ */
+static void
+memtx_engine_compact(struct memtx_engine *memtx)
+{
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	if (space_foreach(memtx_collect_space_id, region) != 0)
+		unreachable();
+	uint32_t count = (region_used(region) - region_svp) / sizeof(uint32_t);
+	uint32_t *ids = (uint32_t *)xregion_join(region, count *
+						 sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !fiber_is_cancelled(); i++) {
+		char *key = NULL;
+		struct space *space;
+		do {
+			space = space_by_id(ids[i]);
+			if (space == NULL || !memtx_space_is_compactable(space))
+				break;
+			if (memtx_space_compact_batch(space, &key) != 0) {
+				diag_log();
+				diag_clear(diag_get());
+				break;
+			}
+			fiber_sleep(0);
+		} while (key != NULL && !fiber_is_cancelled() &&
+			 memtx_engine_compaction_enabled(memtx));
+		free(key);
+		if (!memtx_engine_compaction_enabled(memtx))
+			break;
+	}
+	region_truncate(region, region_svp);
+}
+
+static int
+memtx_engine_compaction_f(va_list va)
+{
+	struct memtx_engine *memtx = va_arg(va, struct memtx_engine *);
+	double interval = MEMTX_COMPACTION_CHECK_INTERVAL;
+	double next_pass = 0;
+	double threshold = memtx_compaction_threshold;
+	while (!fiber_is_cancelled()) {
+		FiberGCChecker gc_check;
+		/* Don't make the user wait for the backoff to expire. */
+		if (threshold != memtx_compaction_threshold) {
+			threshold = memtx_compaction_threshold;
+			interval = MEMTX_COMPACTION_CHECK_INTERVAL;
+			next_pass = 0;
+		}
+		size_t total;
+		if (fiber_clock() >= next_pass &&
+		    memtx_engine_needs_compaction(memtx, &total)) {
+			memtx_engine_compact(memtx);
+			size_t total_after;
+			memtx_engine_needs_compaction(memtx, &total_after);
+			/*
+			 * Back off if the pass didn't release any memory,
+			 * otherwise the next pass is likely to fail, too.
+			 */
+			if (total_after < total)
+				interval = MEMTX_COMPACTION_CHECK_INTERVAL;
+			else
+				interval = MIN(interval * 2,
+					       MEMTX_COMPACTION_CHECK_INTERVAL_MAX);
+			next_pass = fiber_clock() + interval;
+		}
+		fiber_sleep(MEMTX_COMPACTION_CHECK_INTERVAL);
+	}
+	return 0;
+}
+
+/* }}} */
+
 void
 memtx_set_tuple_format_vtab(const char *allocator_name)
 {
 	if (strncmp(allocator_name, "small", strlen("small")) == 0) {
 		memtx_alloc_init<SmallAlloc>();
+		memtx_tuple_relocate = memtx_tuple_relocate_small;
 		create_memtx_tuple_format_vtab<SmallAlloc>
 			(&memtx_tuple_format_vtab);
 	} else if (strncmp(allocator_name, "system", strlen("system")) == 0) {
 		memtx_alloc_init<SysAlloc>();
+		/* The system allocator doesn't use slabs. */
+		memtx_tuple_relocate = NULL;
 		create_memtx_tuple_format_vtab<SysAlloc>
 			(&memtx_tuple_format_vtab);
 	} else {
@@ -1886,19 +2189,197 @@ memtx_set_tuple_format_vtab(const char *allocator_name)
 int
 memtx_tuple_validate(struct tuple_format *format, struct tuple *tuple)
 {
-	tuple = memtx_tuple_decompress(tuple);
-	if (tuple == NULL)
-		return -1;
-	tuple_ref(tuple);
-	int rc = tuple_validate_raw(format, tuple_data(tuple));
-	tuple_unref(tuple);
+	uint32_t bsize;
+	const char *data = tuple_data_range(tuple, &bsize);
+	if (!tuple_format(tuple)->is_compressed)
+		return tuple_validate_raw(format, data);
+	/*
+	 * Decompress the data to the fiber region rather than allocate
+	 * a tuple that would be dropped right after the check.
+	 */
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	int rc = -1;
+	data = memtx_tuple_decompress_raw(data, data + bsize, &bsize);
+	if (data != NULL)
+		rc = tuple_validate_raw(format, data);
+	region_truncate(region, region_svp);
 	return rc;
 }
 
+const char *memtx_huge_pages_strs[] = {
+	/* [MEMTX_HUGE_PAGES_NONE]		= */ "none",
+	/* [MEMTX_HUGE_PAGES_EXPLICIT]		= */ "explicit",
+	/* [MEMTX_HUGE_PAGES_TRANSPARENT]	= */ "transparent",
+};
+
+static_assert(lengthof(memtx_huge_pages_strs) == memtx_huge_pages_MAX,
+	      "memtx_huge_pages_strs must match enum memtx_huge_pages");
+
+#if TARGET_OS_LINUX
+
+/** Returns the default size of explicit huge pages or 0 if unknown. */
+static size_t
+memtx_huge_page_size(void)
+{
+	FILE *f = fopen("/proc/meminfo", "r");
+	if (f == NULL)
+		return 0;
+	size_t size = 0;
+	char line[128];
+	while (fgets(line, sizeof(line), f) != NULL) {
+		unsigned long kb;
+		if (sscanf(line, "Hugepagesize: %lu kB", &kb) == 1) {
+			size = kb * 1024;
+			break;
+		}
+	}
+	fclose(f);
+	return size;
+}
+
+/**
+ * Replaces the preallocated arena mapping with a mapping backed by
+ * explicit huge pages. The pages are reserved by mmap() so it fails
+ * if the system pool doesn't have enough free huge pages rather than
+ * crashing on a page fault later.
+ */
+static int
+memtx_arena_map_huge_pages(struct slab_arena *arena)
+{
+#ifdef MAP_HUGETLB
+	size_t page_size = memtx_huge_page_size();
+	if (page_size == 0 || arena->slab_size % page_size != 0)
+		return -1;
+	size_t size = arena->prealloc;
+	size_t align = arena->slab_size;
+	char *map = (char *)mmap(NULL, size + align, PROT_READ | PROT_WRITE,
+				 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+				 -1, 0);
+	if (map == MAP_FAILED)
+		return -1;
+	/* Slab caches expect slabs aligned by the slab size. */
+	char *start = (char *)small_align((uintptr_t)map, align);
+	if (start != map)
+		munmap(map, start - map);
+	if (start + size != map + size + align)
+		munmap(start + size, map + align - start);
+#ifdef MADV_DONTDUMP
+	if ((arena->flags & SLAB_ARENA_DONTDUMP) != 0)
+		madvise(start, size, MADV_DONTDUMP);
+#endif
+	munmap(arena->arena, arena->prealloc);
+	arena->arena = start;
+	return 0;
+#else /* !defined(MAP_HUGETLB) */
+	(void)arena;
+	return -1;
+#endif /* !defined(MAP_HUGETLB) */
+}
+
+/**
+ * Requests transparent huge pages for the arena. Fails if they are
+ * disabled in the system.
+ */
+static int
+memtx_arena_advise_huge_pages(struct slab_arena *arena)
+{
+#ifdef MADV_HUGEPAGE
+	FILE *f = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+	if (f == NULL)
+		return -1;
+	char line[128];
+	bool is_enabled = fgets(line, sizeof(line), f) != NULL &&
+			  strstr(line, "[never]") == NULL;
+	fclose(f);
+	if (!is_enabled)
+		return -1;
+	return madvise(arena->arena, arena->prealloc, MADV_HUGEPAGE);
+#else /* !defined(MADV_HUGEPAGE) */
+	(void)arena;
+	return -1;
+#endif /* !defined(MADV_HUGEPAGE) */
+}
+
+/**
+ * Returns the size of the arena memory backed by transparent huge
+ * pages according to /proc/self/smaps.
+ */
+static size_t
+memtx_arena_transparent_huge_pages_size(struct slab_arena *arena)
+{
+	FILE *f = fopen("/proc/self/smaps", "r");
+	if (f == NULL)
+		return 0;
+	uintptr_t arena_begin = (uintptr_t)arena->arena;
+	uintptr_t arena_end = arena_begin + arena->prealloc;
+	bool is_arena = false;
+	size_t size = 0;
+	char line[256];
+	while (fgets(line, sizeof(line), f) != NULL) {
+		unsigned long begin, end, kb;
+		if (sscanf(line, "%lx-%lx ", &begin, &end) == 2)
+			is_arena = begin < arena_end && end > arena_begin;
+		else if (is_arena &&
+			 sscanf(line, "AnonHugePages: %lu kB", &kb) == 1)
+			size += kb * 1024;
+	}
+	fclose(f);
+	return MIN(size, arena->prealloc);
+}
+
+#endif /* TARGET_OS_LINUX */
+
+/**
+ * Maps the arena with huge pages to reduce TLB misses on random access
+ * to tuples and index extents. Explicit huge pages are tried first,
+ * then transparent huge pages. Returns the kind of pages backing the
+ * arena. Must be called before any slab is allocated from the arena.
+ */
+static enum memtx_huge_pages
+memtx_arena_use_huge_pages(struct slab_arena *arena)
+{
+	assert(arena->used == 0);
+#if TARGET_OS_LINUX
+	if (memtx_arena_map_huge_pages(arena) == 0) {
+		say_info("memtx arena is mapped with explicit huge pages");
+		return MEMTX_HUGE_PAGES_EXPLICIT;
+	}
+	if (memtx_arena_advise_huge_pages(arena) == 0) {
+		say_info("memtx arena is mapped with transparent huge pages");
+		return MEMTX_HUGE_PAGES_TRANSPARENT;
+	}
+	say_warn("memtx_use_huge_pages is set but huge pages are "
+		 "not available, using regular pages");
+#else /* !TARGET_OS_LINUX */
+	(void)arena;
+	say_warn("memtx_use_huge_pages is set but unsupported on this "
+		 "platform, using regular pages");
+#endif /* !TARGET_OS_LINUX */
+	return MEMTX_HUGE_PAGES_NONE;
+}
+
+/** Returns the size of the memtx arena backed by huge pages. */
+static size_t
+memtx_engine_huge_pages_size(struct memtx_engine *memtx)
+{
+	switch (memtx->huge_pages) {
+	case MEMTX_HUGE_PAGES_EXPLICIT:
+		/* Slabs mapped past the preallocated area use regular pages. */
+		return MIN(memtx->arena.used, memtx->arena.prealloc);
+#if TARGET_OS_LINUX
+	case MEMTX_HUGE_PAGES_TRANSPARENT:
+		return memtx_arena_transparent_huge_pages_size(&memtx->arena);
+#endif
+	default:
+		return 0;
+	}
+}
+
 struct memtx_engine *
 memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		 uint64_t tuple_arena_max_size, uint32_t objsize_min,
-		 bool dontdump, unsigned granularity,
+		 bool dontdump, bool use_huge_pages, unsigned granularity,
 		 const char *allocator, float alloc_factor, int sort_threads,
 		 memtx_on_indexes_built_cb on_indexes_built)
 {
@@ -1962,6 +2443,12 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		goto fail;
 	fiber_set_joinable(memtx->gc_fiber, true);
 
+	memtx->compaction_fiber = fiber_new_system("memtx.compaction",
+						   memtx_engine_compaction_f);
+	if (memtx->compaction_fiber == NULL)
+		goto fail;
+	fiber_set_joinable(memtx->compaction_fiber, true);
+
 	/*
 	 * Currently we have two quota consumers: tuple and index allocators.
 	 * The first one uses either SystemAlloc or memtx->slab_cache (in case
@@ -2005,6 +2492,9 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	quota_init(&memtx->quota, tuple_arena_max_size);
 	tuple_arena_create(&memtx->arena, &memtx->quota, tuple_arena_max_size,
 			   SLAB_SIZE, dontdump, "memtx");
+	memtx->huge_pages = MEMTX_HUGE_PAGES_NONE;
+	if (use_huge_pages)
+		memtx->huge_pages = memtx_arena_use_huge_pages(&memtx->arena);
 	slab_cache_create(&memtx->slab_cache, &memtx->arena);
 	float actual_alloc_factor;
 	allocator_settings alloc_settings;
@@ -2080,6 +2570,7 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	memtx->use_sort_data = false;
 
 	fiber_start(memtx->gc_fiber, memtx);
+	fiber_start(memtx->compaction_fiber, memtx);
 	return memtx;
 fail:
 	xdir_destroy(&memtx->snap_dir);
@@ -2180,12 +2671,24 @@ memtx_engine_stat_index(struct memtx_engine *memtx, struct info_handler *h)
 	info_table_end(h); /* index */
 }
 
+/** Appends memtx huge pages stats to info. */
+static void
+memtx_engine_stat_huge_pages(struct memtx_engine *memtx,
+			     struct info_handler *h)
+{
+	info_table_begin(h, "huge_pages");
+	info_append_str(h, "mode", memtx_huge_pages_strs[memtx->huge_pages]);
+	info_append_int(h, "total", memtx_engine_huge_pages_size(memtx));
+	info_table_end(h); /* huge_pages */
+}
+
 void
 memtx_engine_stat(struct memtx_engine *memtx, struct info_handler *h)
 {
 	info_begin(h);
 	memtx_engine_stat_data(memtx, h);
 	memtx_engine_stat_index(memtx, h);
+	memtx_engine_stat_huge_pages(memtx, h);
 	memtx_engine_stat_tx(memtx, h);
 	info_end(h);
 }
@@ -2326,6 +2829,42 @@ memtx_tuple_delete(struct tuple_format *format, struct tuple *tuple)
 	tuple_format_unref(format);
 }
 
+static struct tuple *
+memtx_tuple_relocate_small(struct tuple *tuple)
+{
+	struct memtx_block *block = memtx_block_from_tuple(tuple);
+	bool is_temporary = tuple_has_flag(tuple, TUPLE_IS_TEMPORARY);
+	/*
+	 * A block visible from a read view isn't freed until the read view
+	 * is closed, so relocating it would only increase memory usage.
+	 */
+	if (MemtxAllocator<SmallAlloc>::in_read_view(block, is_temporary))
+		return NULL;
+	struct small_alloc_info alloc_info;
+	SmallAlloc::get_alloc_info(block, memtx_block_size(block), &alloc_info);
+	if (alloc_info.is_large)
+		return NULL;
+	struct memtx_block *new_block = MemtxAllocator<SmallAlloc>::alloc(
+		tuple_bsize(tuple), tuple_data_offset(tuple),
+		tuple_is_compact(tuple));
+	if (new_block == NULL)
+		return NULL;
+	/*
+	 * The small allocator allocates from the slab with the lowest address
+	 * first, so moving tuples down gradually empties the slabs located
+	 * at higher addresses.
+	 */
+	if (new_block > block) {
+		MemtxAllocator<SmallAlloc>::free(new_block, is_temporary);
+		return NULL;
+	}
+	struct tuple *new_tuple = memtx_block_to_tuple(new_block);
+	memcpy(new_tuple, tuple, tuple_size(tuple));
+	tuple_ref_init(new_tuple, 0);
+	tuple_format_ref(tuple_format(tuple));
+	return new_tuple;
+}
+
 /** Fill `info' with the information about the `tuple'. */
 template<class ALLOC>
 static inline void
@@ -2460,6 +2999,10 @@ memtx_index_def_change_requires_rebuild(struct index *index,
 		return true;
 	if (old_def->opts.hint != new_def->opts.hint)
 		return true;
+	if (old_def->opts.fingerprint != new_def->opts.fingerprint)
+		return true;
+	if (old_def->opts.prefix_hint != new_def->opts.prefix_hint)
+		return true;
 
 	const struct key_def *old_cmp_def, *new_cmp_def;
 	if (index_depends_on_pk(index)) {
@@ -2493,6 +3036,15 @@ memtx_index_def_change_requires_rebuild(struct index *index,
 			return true;
 		if (old_part->sort_order != new_part->sort_order)
 			return true;
+		/*
+		 * Prefix hints depend on the types of all key parts,
+		 * see key_hint_prefix().
+		 */
+		if (new_def->opts.prefix_hint &&
+		    (old_part->type != new_part->type ||
+		     key_part_is_nullable(old_part) !=
+		     key_part_is_nullable(new_part)))
+			return true;
 	}
 	assert(old_cmp_def->is_multikey == new_cmp_def->is_multikey);
 	return false;
@@ -2502,6 +3054,12 @@ int
 memtx_prepare_result_tuple(struct space *space, struct tuple **result)
 {
 	if (*result != NULL) {
+		/*
+		 * Compressed fields are decompressed all at once, because
+		 * users of a tuple read its MsgPack data directly rather
+		 * than via tuple_field() and the field map describes the
+		 * stored layout. Copying is cheap next to decompression.
+		 */
 		*result = memtx_tuple_decompress(*result);
 		if (*result == NULL)
 			return -1;
@@ -2531,7 +3089,8 @@ memtx_prepare_read_view_tuple(struct tuple *tuple,
 					index->space->upgrade, tuple);
 	result->data = tuple_data_range(tuple, &result->size);
 	result->ptr = tuple;
-	if (!index->space->rv->disable_decompression) {
+	if (!index->space->rv->disable_decompression &&
+	    tuple_format(tuple)->is_compressed) {
 		result->data = memtx_tuple_decompress_raw(
 				result->data, result->data + result->size,
 				&result->size);
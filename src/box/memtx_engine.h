@@ -103,6 +103,20 @@ enum memtx_recovery_state {
 typedef void
 (*memtx_on_indexes_built_cb)(void);
 
+/** Kind of pages backing the memtx arena. */
+enum memtx_huge_pages {
+	/** Regular pages. */
+	MEMTX_HUGE_PAGES_NONE,
+	/** Explicit huge pages reserved in the system pool (hugetlbfs). */
+	MEMTX_HUGE_PAGES_EXPLICIT,
+	/** Transparent huge pages requested with madvise(). */
+	MEMTX_HUGE_PAGES_TRANSPARENT,
+	memtx_huge_pages_MAX,
+};
+
+/** String names of enum memtx_huge_pages values. */
+extern const char *memtx_huge_pages_strs[];
+
 struct memtx_engine {
 	struct engine base;
 	/** Engine recovery state, see enum memtx_recovery_state description. */
@@ -131,6 +145,8 @@ struct memtx_engine {
 	 * is reflected in box.slab.info(), @sa lua/slab.c.
 	 */
 	struct slab_arena arena;
+	/** Kind of pages backing the arena, set on engine creation. */
+	enum memtx_huge_pages huge_pages;
 	/** Slab cache for allocating tuples. */
 	struct slab_cache slab_cache;
 	/** Slab cache for allocating index extents. */
@@ -161,6 +177,12 @@ struct memtx_engine {
 	 * memtx_gc_task::link.
 	 */
 	struct stailq gc_queue;
+	/**
+	 * Tuple arena compaction fiber. Relocates live tuples to
+	 * lower addresses so that sparse slabs can be released,
+	 * see memtx_compaction_threshold.
+	 */
+	struct fiber *compaction_fiber;
 	/**
 	 * Format used for allocating functional index keys.
 	 */
@@ -213,7 +235,7 @@ memtx_engine_schedule_gc(struct memtx_engine *memtx,
 struct memtx_engine *
 memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		 uint64_t tuple_arena_max_size, uint32_t objsize_min,
-		 bool dontdump, unsigned granularity,
+		 bool dontdump, bool use_huge_pages, unsigned granularity,
 		 const char *allocator, float alloc_factor, int threads_num,
 		 memtx_on_indexes_built_cb on_indexes_built);
 
@@ -360,7 +382,7 @@ memtx_tuple_validate(struct tuple_format *format, struct tuple *tuple);
 static inline struct memtx_engine *
 memtx_engine_new_xc(const char *snap_dirname, bool force_recovery,
 		    uint64_t tuple_arena_max_size, uint32_t objsize_min,
-		    bool dontdump, unsigned granularity,
+		    bool dontdump, bool use_huge_pages, unsigned granularity,
 		    const char *allocator, float alloc_factor,
 		    int sort_threads,
 		    memtx_on_indexes_built_cb on_indexes_built)
@@ -368,8 +390,8 @@ memtx_engine_new_xc(const char *snap_dirname, bool force_recovery,
 	struct memtx_engine *memtx;
 	memtx = memtx_engine_new(snap_dirname, force_recovery,
 				 tuple_arena_max_size, objsize_min, dontdump,
-				 granularity, allocator, alloc_factor,
-				 sort_threads, on_indexes_built);
+				 use_huge_pages, granularity, allocator,
+				 alloc_factor, sort_threads, on_indexes_built);
 	if (memtx == NULL)
 		diag_raise();
 	return memtx;
@@ -60,12 +60,21 @@ memtx_hash_equal_key(struct tuple *tuple, const char *key,
 				      HINT_NONE, key_def) == 0;
 }
 
+/**
+ * The highest bit of a hash stored in a memtx hash index is set if the
+ * hash doesn't identify the key. Otherwise the hash is the key itself,
+ * see the fingerprint index option, and tuples with equal hashes don't
+ * need to be compared.
+ */
+enum { MEMTX_HASH_INEXACT = 1u << 31 };
+
 #define LIGHT_NAME _index
 #define LIGHT_DATA_TYPE struct tuple *
 #define LIGHT_KEY_TYPE const char *
 #define LIGHT_CMP_ARG_TYPE struct key_def *
 #define LIGHT_EQUAL(a, b, c) memtx_hash_equal(a, b, c)
 #define LIGHT_EQUAL_KEY(a, b, c) memtx_hash_equal_key(a, b, c)
+#define LIGHT_EQUAL_HASH(h, c) (((h) & MEMTX_HASH_INEXACT) == 0)
 
 #include "salad/light.h"
 
@@ -75,6 +84,7 @@ memtx_hash_equal_key(struct tuple *tuple, const char *key,
 #undef LIGHT_CMP_ARG_TYPE
 #undef LIGHT_EQUAL
 #undef LIGHT_EQUAL_KEY
+#undef LIGHT_EQUAL_HASH
 
 struct memtx_hash_index {
 	struct index base;
@@ -83,6 +93,50 @@ struct memtx_hash_index {
 	struct light_index_iterator gc_iterator;
 };
 
+/**
+ * Checks if a key field of an index with the fingerprint option is an
+ * unsigned integer that fits in the hash and returns it in `hash' if so.
+ */
+static inline bool
+memtx_hash_field_is_exact(const char *field, uint32_t *hash)
+{
+	if (mp_typeof(*field) != MP_UINT)
+		return false;
+	uint64_t value = mp_decode_uint(&field);
+	if (value >= MEMTX_HASH_INEXACT)
+		return false;
+	*hash = value;
+	return true;
+}
+
+/** Calculates the hash of a tuple stored in a memtx hash index. */
+static inline uint32_t
+memtx_hash_tuple(struct index *base, struct tuple *tuple)
+{
+	struct key_def *key_def = base->def->key_def;
+	uint32_t hash;
+	if (base->def->opts.fingerprint) {
+		assert(key_def->part_count == 1);
+		const char *field = tuple_field_by_part(
+			tuple, &key_def->parts[0], MULTIKEY_NONE);
+		assert(field != NULL);
+		if (memtx_hash_field_is_exact(field, &hash))
+			return hash;
+	}
+	return tuple_hash(tuple, key_def) | MEMTX_HASH_INEXACT;
+}
+
+/** Calculates the hash of a key looked up in a memtx hash index. */
+static inline uint32_t
+memtx_hash_key(struct index *base, const char *key)
+{
+	uint32_t hash;
+	if (base->def->opts.fingerprint &&
+	    memtx_hash_field_is_exact(key, &hash))
+		return hash;
+	return key_hash(key, base->def->key_def) | MEMTX_HASH_INEXACT;
+}
+
 /* {{{ MemtxHash Iterators ****************************************/
 
 struct hash_iterator {
@@ -332,7 +386,7 @@ memtx_hash_index_get_internal(struct index *base, const char *key,
 	struct space *space = space_by_id(base->def->space_id);
 	struct txn *txn = in_txn();
 	*result = NULL;
-	uint32_t h = key_hash(key, base->def->key_def);
+	uint32_t h = memtx_hash_key(base, key);
 	uint32_t k = light_index_find_key(&index->hash_table, h, key);
 	if (k != light_index_end) {
 		struct tuple *tuple = light_index_get(&index->hash_table, k);
@@ -357,7 +411,7 @@ memtx_hash_index_replace_impl(struct memtx_hash_index *index,
 			      struct tuple *new_tuple, struct tuple **dup_tuple,
 			      uint32_t *pos)
 {
-	uint32_t h = tuple_hash(new_tuple, index->base.def->key_def);
+	uint32_t h = memtx_hash_tuple(&index->base, new_tuple);
 	if (index_inject_oom() != 0)
 		goto fail;
 	*pos = light_index_replace(&index->hash_table, h, new_tuple,
@@ -388,7 +442,7 @@ static int
 memtx_hash_index_insert_impl(struct memtx_hash_index *index,
 			     struct tuple *new_tuple)
 {
-	uint32_t h = tuple_hash(new_tuple, index->base.def->key_def);
+	uint32_t h = memtx_hash_tuple(&index->base, new_tuple);
 	if (index_inject_oom() != 0)
 		goto fail;
 	if (light_index_insert(&index->hash_table,
@@ -429,7 +483,7 @@ static int
 memtx_hash_index_delete_value_impl(struct memtx_hash_index *index,
 				   struct tuple *tuple)
 {
-	uint32_t h = tuple_hash(tuple, index->base.def->key_def);
+	uint32_t h = memtx_hash_tuple(&index->base, tuple);
 	if (index_inject_oom() != 0)
 		goto fail;
 	if (light_index_delete_value(&index->hash_table, h, tuple) != 0)
@@ -524,7 +578,7 @@ memtx_hash_index_create_iterator(struct index *base, enum iterator_type type,
 
 		if (part_count != 0) {
 			light_index_iterator_key(&index->hash_table, &it->iterator,
-					key_hash(key, base->def->key_def), key);
+					memtx_hash_key(base, key), key);
 			it->base.next_internal = hash_iterator_gt;
 		} else {
 			light_index_iterator_begin(&index->hash_table, &it->iterator);
@@ -542,7 +596,7 @@ memtx_hash_index_create_iterator(struct index *base, enum iterator_type type,
 	case ITER_EQ:
 		assert(part_count > 0);
 		light_index_iterator_key(&index->hash_table, &it->iterator,
-				key_hash(key, base->def->key_def), key);
+				memtx_hash_key(base, key), key);
 		it->base.next_internal = hash_iterator_eq;
 		if (it->iterator.slotpos == light_index_end)
 			memtx_tx_track_point(in_txn(), space,
@@ -730,11 +784,13 @@ static const struct index_vtab memtx_hash_index_vtab = {
 	/* .count = */ memtx_hash_index_count,
 	/* .get_internal = */ memtx_hash_index_get_internal,
 	/* .get = */ memtx_index_get,
+	/* .get_many = */ generic_index_get_many,
 	/* .replace = */ memtx_hash_index_replace,
 	/* .create_iterator = */ memtx_hash_index_create_iterator,
 	/* .create_iterator_with_offset = */
 	generic_index_create_iterator_with_offset,
 	/* .create_arrow_stream = */ generic_index_create_arrow_stream,
+	/* .aggregate = */ generic_index_aggregate,
 	/* .create_read_view = */ memtx_hash_index_create_read_view,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
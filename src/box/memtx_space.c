@@ -48,6 +48,7 @@
 #include "memtx_tuple_compression.h"
 #include "memtx_sort_data.h"
 #include "schema.h"
+#include "tweaks.h"
 #include "small/region.h"
 
 /*
@@ -65,6 +66,13 @@ enum { MEMTX_DDL_YIELD_LOOPS = 1000 };
 enum { MEMTX_DDL_YIELD_LOOPS = 10 };
 #endif
 
+/**
+ * If set, a secondary tree index is built on a non-empty space by
+ * sorting all tuples at once, see memtx_space_build_index_in_bulk().
+ */
+static bool memtx_build_index_in_bulk = true;
+TWEAK_BOOL(memtx_build_index_in_bulk);
+
 static void
 memtx_space_destroy(struct space *space)
 {
@@ -984,6 +992,30 @@ memtx_space_check_index_def(struct space *space, struct index_def *index_def)
 			 "hint is only reasonable with memtx tree index");
 		return -1;
 	}
+	if (index_def->opts.fingerprint &&
+	    (index_def->type != HASH || index_def->key_def->part_count != 1 ||
+	     index_def->key_def->parts[0].type != FIELD_TYPE_UNSIGNED)) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name(space), "fingerprint is only reasonable "
+			 "with memtx hash index over one unsigned field");
+		return -1;
+	}
+	if (index_def->opts.prefix_hint &&
+	    (index_def->type != TREE ||
+	     index_def->opts.hint == INDEX_HINT_OFF)) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name(space), "prefix_hint is only reasonable "
+			 "with memtx tree index with hints");
+		return -1;
+	}
+	if (index_def->opts.prefix_hint &&
+	    (index_def->key_def->is_multikey ||
+	     index_def->key_def->for_func_index)) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name(space), "prefix_hint is not supported by "
+			 "multikey and functional indexes");
+		return -1;
+	}
 
 	/* Only HASH and TREE indexes check parts there. */
 	if (index_def_check_field_types(index_def, space_name(space)) != 0)
@@ -1113,7 +1145,10 @@ struct memtx_ddl_state {
 	struct index *index;
 	/* New format to be enforced. */
 	struct tuple_format *format;
-	/* Operation cursor. Marks the last processed tuple to date */
+	/*
+	 * Operation cursor. Marks the last processed tuple to date.
+	 * NULL once the whole primary key is processed.
+	 */
 	struct tuple *cursor;
 	/* Primary key key_def to compare new tuples with cursor. */
 	struct key_def *cmp_def;
@@ -1129,6 +1164,15 @@ struct memtx_ddl_state {
 	 * gone wrong.
 	 */
 	struct rlist stmt_triggers;
+	/*
+	 * Set if the index is built in bulk, see
+	 * memtx_space_build_index_in_bulk(). In this case concurrent
+	 * changes aren't applied to the index but are collected in
+	 * the changes list.
+	 */
+	bool is_bulk;
+	/* List of memtx_build_change, used only if is_bulk is set. */
+	struct rlist changes;
 	struct diag diag;
 	int rc;
 };
@@ -1188,8 +1232,10 @@ memtx_space_check_format(struct space *space, struct tuple_format *format)
 	state.format = format;
 	state.cmp_def = pk->def->key_def;
 	state.rc = 0;
+	state.is_bulk = false;
 	diag_create(&state.diag);
 	rlist_create(&state.stmt_triggers);
+	rlist_create(&state.changes);
 
 	struct trigger on_replace;
 	trigger_create(&on_replace, memtx_check_on_replace, &state, NULL);
@@ -1344,6 +1390,85 @@ memtx_build_on_replace_commit(struct trigger *base, void *event)
 	return 0;
 }
 
+/**
+ * A change done to the already scanned part of the primary key while
+ * an index is built in bulk.
+ */
+struct memtx_build_change {
+	/** Link in memtx_ddl_state::changes. */
+	struct rlist in_changes;
+	/** Tuple deleted by the change, referenced. */
+	struct tuple *old_tuple;
+	/** Tuple inserted by the change, referenced. */
+	struct tuple *new_tuple;
+	/** Removes the change if the statement is rolled back. */
+	struct trigger on_rollback;
+	/** Detaches the change from the statement on commit. */
+	struct trigger on_commit;
+	/** Set until the statement is committed or rolled back. */
+	bool is_pending;
+};
+
+static void
+memtx_build_change_delete(struct memtx_build_change *change)
+{
+	if (change->is_pending) {
+		trigger_clear(&change->on_rollback);
+		trigger_clear(&change->on_commit);
+	}
+	rlist_del_entry(change, in_changes);
+	if (change->old_tuple != NULL)
+		tuple_unref(change->old_tuple);
+	if (change->new_tuple != NULL)
+		tuple_unref(change->new_tuple);
+	free(change);
+}
+
+static int
+memtx_build_change_on_rollback(struct trigger *base, void *event)
+{
+	(void)event;
+	struct memtx_build_change *change =
+		container_of(base, struct memtx_build_change, on_rollback);
+	memtx_build_change_delete(change);
+	return 0;
+}
+
+static int
+memtx_build_change_on_commit(struct trigger *base, void *event)
+{
+	(void)event;
+	struct memtx_build_change *change =
+		container_of(base, struct memtx_build_change, on_commit);
+	trigger_clear(&change->on_rollback);
+	change->is_pending = false;
+	return 0;
+}
+
+/**
+ * Remembers a change done by a statement to be applied to the index
+ * once it's built.
+ */
+static void
+memtx_build_change_new(struct memtx_ddl_state *state, struct txn_stmt *stmt)
+{
+	struct memtx_build_change *change = xmalloc(sizeof(*change));
+	change->old_tuple = stmt->old_tuple;
+	if (change->old_tuple != NULL)
+		tuple_ref(change->old_tuple);
+	change->new_tuple = stmt->new_tuple;
+	if (change->new_tuple != NULL)
+		tuple_ref(change->new_tuple);
+	change->is_pending = true;
+	trigger_create(&change->on_rollback, memtx_build_change_on_rollback,
+		       NULL, NULL);
+	trigger_create(&change->on_commit, memtx_build_change_on_commit,
+		       NULL, NULL);
+	txn_stmt_on_rollback(stmt, &change->on_rollback);
+	txn_stmt_on_commit(stmt, &change->on_commit);
+	rlist_add_tail_entry(&state->changes, change, in_changes);
+}
+
 static int
 memtx_build_on_replace(struct trigger *trigger, void *event)
 {
@@ -1357,7 +1482,8 @@ memtx_build_on_replace(struct trigger *trigger, void *event)
 	 * Only update the already built part of an index. All the other
 	 * tuples will be inserted when build continues.
 	 */
-	if (tuple_compare(state->cursor, HINT_NONE, cmp_tuple, HINT_NONE,
+	if (state->cursor != NULL &&
+	    tuple_compare(state->cursor, HINT_NONE, cmp_tuple, HINT_NONE,
 			  state->cmp_def) < 0)
 		return 0;
 
@@ -1367,6 +1493,10 @@ memtx_build_on_replace(struct trigger *trigger, void *event)
 		diag_move(diag_get(), &state->diag);
 		return 0;
 	}
+	if (state->is_bulk) {
+		memtx_build_change_new(state, stmt);
+		return 0;
+	}
 
 	struct tuple *delete = NULL;
 	enum dup_replace_mode mode =
@@ -1410,6 +1540,117 @@ memtx_build_on_replace(struct trigger *trigger, void *event)
 	return 0;
 }
 
+/**
+ * Build a secondary tree index in bulk: collect all tuples of the primary
+ * key in the index build array, then sort it in memtx sort threads, like
+ * it's done on recovery, and check the unique constraint on the sorted
+ * array. Changes done to the space concurrently are collected by the
+ * on_replace trigger and applied to the index once it's built.
+ *
+ * Takes ownership of the primary key iterator.
+ */
+static int
+memtx_space_build_index_in_bulk(struct space *src_space, struct index *pk,
+				struct iterator *it, struct index *new_index,
+				struct tuple_format *new_format)
+{
+	assert(new_index->def->iid != 0);
+	assert(new_index->def->type == TREE);
+	assert(!memtx_tx_manager_use_mvcc_engine);
+	struct memtx_engine *memtx = (struct memtx_engine *)src_space->engine;
+	struct memtx_ddl_state state;
+	state.index = new_index;
+	state.format = new_format;
+	state.cursor = NULL;
+	state.cmp_def = pk->def->key_def;
+	state.rc = 0;
+	state.is_bulk = true;
+	diag_create(&state.diag);
+	rlist_create(&state.stmt_triggers);
+	rlist_create(&state.changes);
+	struct trigger on_replace;
+	trigger_create(&on_replace, memtx_build_on_replace, &state, NULL);
+	trigger_add(&src_space->on_replace, &on_replace);
+
+	index_begin_build(new_index);
+	int rc = index_reserve(new_index, index_size(pk));
+	struct key_def *key_def = new_index->def->key_def;
+	struct memtx_build_change *change, *next;
+	struct tuple *tuple;
+	size_t count = 0;
+	while (rc == 0 && (rc = iterator_next_internal(it, &tuple)) == 0 &&
+	       tuple != NULL) {
+		if (!tuple_format_is_compatible_with_key_def(tuple_format(tuple),
+							     key_def)) {
+			rc = -1;
+			break;
+		}
+		rc = memtx_tuple_validate(new_format, tuple);
+		if (rc != 0)
+			break;
+		rc = index_build_next(new_index, tuple);
+		if (rc != 0)
+			break;
+		/*
+		 * Changes done to tuples up to the cursor (inclusive)
+		 * are logged to be applied after the build.
+		 */
+		state.cursor = tuple;
+		tuple_ref(state.cursor);
+		if (++count % MEMTX_DDL_YIELD_LOOPS == 0 &&
+		    memtx->state == MEMTX_OK)
+			fiber_sleep(0);
+		ERROR_INJECT_YIELD(ERRINJ_BUILD_INDEX_DELAY);
+		tuple_unref(state.cursor);
+		if (fiber_is_cancelled()) {
+			diag_set(FiberIsCancelled);
+			rc = -1;
+			break;
+		}
+		if (state.rc != 0) {
+			rc = -1;
+			diag_move(&state.diag, diag_get());
+			break;
+		}
+	}
+	iterator_delete(it);
+	if (rc != 0) {
+		memtx_tree_index_abort_build(new_index);
+		goto out;
+	}
+	/*
+	 * The whole primary key is processed so all changes have to be
+	 * logged from now on, including the ones done while the sort
+	 * threads are working.
+	 */
+	state.cursor = NULL;
+	rc = memtx_tree_index_end_build_checked(new_index);
+	if (rc != 0)
+		goto out;
+	if (state.rc != 0) {
+		rc = -1;
+		diag_move(&state.diag, diag_get());
+		goto out;
+	}
+	enum dup_replace_mode mode = new_index->def->opts.is_unique ?
+				     DUP_INSERT : DUP_REPLACE_OR_INSERT;
+	rlist_foreach_entry(change, &state.changes, in_changes) {
+		struct tuple *unused;
+		struct tuple *successor;
+		rc = index_replace(new_index, change->old_tuple,
+				   change->new_tuple, mode, &unused,
+				   &successor);
+		if (rc != 0)
+			break;
+	}
+out:
+	rlist_foreach_entry_safe(change, &state.changes, in_changes, next)
+		memtx_build_change_delete(change);
+	diag_destroy(&state.diag);
+	trigger_clear(&on_replace);
+	return rc;
+}
+
 static int
 memtx_space_build_index(struct space *src_space, struct index *new_index,
 			struct tuple_format *new_format,
@@ -1461,6 +1702,17 @@ memtx_space_build_index(struct space *src_space, struct index *new_index,
 	if (inj != NULL && inj->bparam == true)
 		can_yield = false;
 
+	/*
+	 * Concurrent changes can be collected only if they are visible to
+	 * the on_replace trigger, i.e. if MVCC is disabled.
+	 */
+	if (can_yield && memtx_build_index_in_bulk &&
+	    new_index->def->iid != 0 && new_index->def->type == TREE &&
+	    !memtx_tx_manager_use_mvcc_engine) {
+		return memtx_space_build_index_in_bulk(src_space, pk, it,
+						       new_index, new_format);
+	}
+
 	struct memtx_engine *memtx = (struct memtx_engine *)src_space->engine;
 	struct memtx_ddl_state state;
 	struct trigger on_replace;
@@ -1473,8 +1725,10 @@ memtx_space_build_index(struct space *src_space, struct index *new_index,
 		state.format = new_format;
 		state.cmp_def = pk->def->key_def;
 		state.rc = 0;
+		state.is_bulk = false;
 		diag_create(&state.diag);
 		rlist_create(&state.stmt_triggers);
+		rlist_create(&state.changes);
 
 		trigger_create(&on_replace, memtx_build_on_replace, &state,
 			       NULL);
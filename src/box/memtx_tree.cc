@@ -32,6 +32,7 @@
 #include "memtx_engine.h"
 #include "memtx_sort_data.h"
 #include "memtx_tuple_compression.h"
+#include "hint_search.h"
 #include "space.h"
 #include "schema.h" /* space_by_id(), space_cache_find() */
 #include "errinj.h"
@@ -45,6 +46,7 @@
 #include "trivia/config.h"
 #include "trivia/util.h"
 #include "tt_sort.h"
+#include "tweaks.h"
 #include <small/mempool.h>
 
 /**
@@ -123,6 +125,43 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 	return a->tuple == b->tuple;
 }
 
+static_assert(sizeof(struct memtx_tree_data<true>) == HINT_SEARCH_ELEM_SIZE &&
+	      offsetof(struct memtx_tree_data<true>, hint) == sizeof(hint_t),
+	      "memtx_tree_data<true> must match the hint_search() layout");
+
+/**
+ * Don't bother vectorizing the search in short ranges: the binary
+ * search needs only a few comparisons there anyway.
+ */
+enum { MEMTX_TREE_NARROW_BY_HINT_MIN = 8 };
+
+/**
+ * Narrow the range of tree elements to search for the given hint to the
+ * elements having the same hint. Since hints are compared before tuples,
+ * all the elements with lesser hints are less than the searched key and
+ * all the elements with greater hints are greater than it.
+ */
+static inline void
+memtx_tree_narrow_by_hint(struct memtx_tree_data<true> **begin,
+			  struct memtx_tree_data<true> **end, hint_t hint,
+			  struct key_def *cmp_def)
+{
+	if (hint_search == NULL || hint == HINT_NONE ||
+	    *end - *begin < MEMTX_TREE_NARROW_BY_HINT_MIN)
+		return;
+	/*
+	 * Multikey and functional indexes store something else than
+	 * comparison hints in the hint field.
+	 */
+	if (cmp_def->is_multikey || cmp_def->for_func_index)
+		return;
+	size_t lt, le;
+	if (!hint_search(*begin, *end - *begin, hint, &lt, &le))
+		return;
+	*end = *begin + le;
+	*begin += lt;
+}
+
 #define BPS_INNER_CARD
 #define BPS_TREE_NAME memtx_tree
 #define BPS_TREE_BLOCK_SIZE (512)
@@ -147,12 +186,18 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 #undef bps_tree_key_t
 
 #define BPS_TREE_NAMESPACE NS_USE_HINT
+#define BPS_TREE_NARROW_KEY(begin, end, key, arg)\
+	memtx_tree_narrow_by_hint(begin, end, (key)->hint, arg)
+#define BPS_TREE_NARROW_ELEM(begin, end, elem, arg)\
+	memtx_tree_narrow_by_hint(begin, end, (elem).hint, arg)
 #define bps_tree_elem_t struct memtx_tree_data<true>
 #define bps_tree_key_t struct memtx_tree_key_data<true> *
 
 #include "salad/bps_tree.h"
 
 #undef BPS_TREE_NAMESPACE
+#undef BPS_TREE_NARROW_KEY
+#undef BPS_TREE_NARROW_ELEM
 #undef bps_tree_elem_t
 #undef bps_tree_key_t
 
@@ -208,6 +253,22 @@ struct memtx_tree_iterator_selector<true> {
 template <bool USE_HINT>
 using memtx_tree_iterator_t = typename memtx_tree_iterator_selector<USE_HINT>::type;
 
+template <bool USE_HINT>
+struct memtx_tree_builder_selector;
+
+template <>
+struct memtx_tree_builder_selector<false> {
+	using type = NS_NO_HINT::memtx_tree_builder;
+};
+
+template <>
+struct memtx_tree_builder_selector<true> {
+	using type = NS_USE_HINT::memtx_tree_builder;
+};
+
+template <bool USE_HINT>
+using memtx_tree_builder_t = typename memtx_tree_builder_selector<USE_HINT>::type;
+
 static void
 invalidate_tree_iterator(NS_NO_HINT::memtx_tree_iterator *itr)
 {
@@ -234,6 +295,33 @@ struct memtx_tree_index {
 
 /* {{{ Utilities. *************************************************/
 
+/**
+ * Fill factor of the tree blocks for indexes built from sorted data,
+ * see bps_tree_build_begin(). Values below 1 leave free space in the
+ * blocks, which makes insertions following the build cheaper at the
+ * cost of memory.
+ */
+static double memtx_tree_build_fill_factor = 1;
+TWEAK_DOUBLE(memtx_tree_build_fill_factor);
+
+/** Build an empty tree from the sorted array of unique elements. */
+template <bool USE_HINT>
+static int
+memtx_tree_build_sorted(memtx_tree_t<USE_HINT> *tree,
+			struct memtx_tree_data<USE_HINT> *sorted_array,
+			size_t array_size)
+{
+	memtx_tree_builder_t<USE_HINT> builder;
+	memtx_tree_build_begin(tree, &builder, array_size,
+			       memtx_tree_build_fill_factor);
+	for (size_t i = 0; i < array_size; i++) {
+		if (memtx_tree_build_next(&builder, sorted_array[i]) != 0)
+			return -1;
+	}
+	memtx_tree_build_end(&builder);
+	return 0;
+}
+
 /**
  * Canonicalizes the iterator type and key.
  */
@@ -1119,20 +1207,21 @@ memtx_tree_index_quantile(struct index *base, double level,
 		(struct memtx_tree_index<USE_HINT> *)base;
 	memtx_tree_t<USE_HINT> *tree = &index->tree;
 	struct key_def *key_def = base->def->key_def;
+	struct key_def *cmp_def = memtx_tree_cmp_def(tree);
 
 	struct memtx_tree_key_data<USE_HINT> begin_data;
 	begin_data.key = begin_key;
 	begin_data.part_count = begin_part_count;
 	if (USE_HINT)
 		begin_data.set_hint(
-			key_hint(begin_key, begin_part_count, key_def));
+			key_hint(begin_key, begin_part_count, cmp_def));
 
 	struct memtx_tree_key_data<USE_HINT> end_data;
 	end_data.key = end_key;
 	end_data.part_count = end_part_count;
 	if (USE_HINT)
 		end_data.set_hint(
-			key_hint(end_key, end_part_count, key_def));
+			key_hint(end_key, end_part_count, cmp_def));
 
 	size_t begin_offset;
 	memtx_tree_lower_bound_get_offset(tree, &begin_data, NULL,
@@ -2115,9 +2204,11 @@ memtx_tree_index_build_next(struct index *base, struct tuple *tuple)
 		return 0;
 	struct memtx_tree_index<USE_HINT> *index =
 		(struct memtx_tree_index<USE_HINT> *)base;
-	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
-	return memtx_tree_index_build_array_append(index, tuple,
-						   tuple_hint(tuple, cmp_def));
+	/*
+	 * Hints are calculated in bulk on end_build, possibly in
+	 * multiple threads, see memtx_tree_build_array_calc_hints().
+	 */
+	return memtx_tree_index_build_array_append(index, tuple, HINT_NONE);
 }
 
 static int
@@ -2220,14 +2311,156 @@ memtx_tree_index_build_array_deduplicate(
 	index->build_array_size = w_idx + 1;
 }
 
+/**
+ * If the size of the build array is less than this threshold, hints are
+ * calculated in the calling thread, because spawning threads would cost
+ * more than the calculation itself.
+ */
+static constexpr size_t MEMTX_TREE_HINT_NOSPAWN_SIZE_THRESHOLD = 64 * 1024;
+
+/** Build array hint calculation worker. */
+struct memtx_tree_hint_worker {
+	/** The worker cord. */
+	struct cord cord;
+	/** First element of the build array part processed by the worker. */
+	struct memtx_tree_data<true> *begin;
+	/** End of the build array part processed by the worker. */
+	struct memtx_tree_data<true> *end;
+	/** Index comparison key definition. */
+	struct key_def *cmp_def;
+};
+
+/** Calculate hints of the build array part assigned to a worker. */
+static int
+memtx_tree_hint_worker_f(va_list ap)
+{
+	struct memtx_tree_hint_worker *worker =
+		va_arg(ap, struct memtx_tree_hint_worker *);
+	for (struct memtx_tree_data<true> *elem = worker->begin;
+	     elem < worker->end; elem++)
+		elem->hint = tuple_hint(elem->tuple, worker->cmp_def);
+	return 0;
+}
+
+/**
+ * Calculate hints of all the build array elements. On large arrays
+ * the work is split between `thread_count` threads, so that snapshot
+ * recovery and secondary key build do not spend TX time on decoding
+ * the key parts of every tuple one by one. The calling fiber yields
+ * while waiting for the workers.
+ */
+static void
+memtx_tree_build_array_calc_hints(struct memtx_tree_data<true> *build_array,
+				  size_t build_array_size,
+				  struct key_def *cmp_def, int thread_count)
+{
+	if (build_array_size < MEMTX_TREE_HINT_NOSPAWN_SIZE_THRESHOLD ||
+	    thread_count <= 1) {
+		for (size_t i = 0; i < build_array_size; i++) {
+			build_array[i].hint = tuple_hint(build_array[i].tuple,
+							 cmp_def);
+		}
+		return;
+	}
+	struct memtx_tree_hint_worker *workers =
+		(struct memtx_tree_hint_worker *)
+			xcalloc(thread_count, sizeof(*workers));
+	size_t part_size = build_array_size / thread_count;
+	for (int i = 0; i < thread_count; i++) {
+		struct memtx_tree_hint_worker *worker = &workers[i];
+		worker->begin = build_array + i * part_size;
+		/* The last worker takes the remainder. */
+		worker->end = i == thread_count - 1 ?
+			      build_array + build_array_size :
+			      worker->begin + part_size;
+		worker->cmp_def = cmp_def;
+		char name[FIBER_NAME_MAX];
+		snprintf(name, sizeof(name), "hint.worker.%d", i);
+		if (cord_costart(&worker->cord, name, memtx_tree_hint_worker_f,
+				 worker) != 0) {
+			diag_log();
+			panic("cord_start failed");
+		}
+	}
+	for (int i = 0; i < thread_count; i++) {
+		if (cord_cojoin(&workers[i].cord) != 0) {
+			diag_log();
+			panic("cord_cojoin failed");
+		}
+	}
+	free(workers);
+}
+
+/**
+ * Check that the sorted build array of a unique index doesn't contain
+ * different tuples with equal keys. Sets ER_TUPLE_FOUND otherwise.
+ */
+template <bool USE_HINT>
+static int
+memtx_tree_index_build_array_check_unique(
+	struct memtx_tree_index<USE_HINT> *index)
+{
+	if (!index->base.def->opts.is_unique)
+		return 0;
+	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
+	for (size_t i = 1; i < index->build_array_size; i++) {
+		struct memtx_tree_data<USE_HINT> *prev =
+			&index->build_array[i - 1];
+		struct memtx_tree_data<USE_HINT> *next =
+			&index->build_array[i];
+		if (prev->tuple == next->tuple ||
+		    tuple_compare(prev->tuple, prev->hint,
+				  next->tuple, next->hint, cmp_def) != 0)
+			continue;
+		diag_set(ClientError, ER_TUPLE_FOUND,
+			 index->base.def->name, index->base.def->space_name,
+			 tuple_str(prev->tuple), tuple_str(next->tuple),
+			 prev->tuple, next->tuple);
+		return -1;
+	}
+	return 0;
+}
+
+/** Free the build array of an index that failed to build. */
 template <bool USE_HINT>
 static void
-memtx_tree_index_end_build(struct index *base)
+memtx_tree_index_build_array_discard(struct memtx_tree_index<USE_HINT> *index)
+{
+	if (index->is_func) {
+		for (size_t i = 0; i < index->build_array_size; i++) {
+			hint_t hint = index->build_array[i].hint;
+			tuple_unref((struct tuple *)hint);
+		}
+	}
+	free(index->build_array);
+	index->build_array = NULL;
+	index->build_array_size = 0;
+	index->build_array_alloc_size = 0;
+}
+
+/**
+ * Sort the build array and build the tree from it. If `check_unique'
+ * is set, the build fails if a unique index has duplicate keys, and
+ * the index is left empty.
+ */
+template <bool USE_HINT>
+static int
+memtx_tree_index_end_build_impl(struct index *base, bool check_unique)
 {
 	struct memtx_tree_index<USE_HINT> *index =
 		(struct memtx_tree_index<USE_HINT> *)base;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
+	/*
+	 * Multikey and functional indexes store the multikey index and
+	 * the functional key in the hint, it's already set on build_next.
+	 */
+	if (USE_HINT && !cmp_def->is_multikey && !cmp_def->for_func_index) {
+		memtx_tree_build_array_calc_hints(
+			(struct memtx_tree_data<true> *)index->build_array,
+			index->build_array_size, cmp_def,
+			memtx->sort_threads);
+	}
 	tt_sort(index->build_array, index->build_array_size,
 		sizeof(index->build_array[0]), memtx_tree_qcompare<USE_HINT>,
 		cmp_def, memtx->sort_threads);
@@ -2236,18 +2469,52 @@ memtx_tree_index_end_build(struct index *base)
 		 * Multikey index may have equal(in terms of
 		 * cmp_def) keys inserted by different multikey
 		 * offsets. We must deduplicate them because
-		 * the following memtx_tree_build assumes that
+		 * the following memtx_tree_build_sorted assumes that
 		 * all keys are unique.
 		 */
 		memtx_tree_index_build_array_deduplicate<USE_HINT>(index);
 	}
-	memtx_tree_build(&index->tree, index->build_array,
-			 index->build_array_size);
+	if (check_unique &&
+	    memtx_tree_index_build_array_check_unique<USE_HINT>(index) != 0) {
+		memtx_tree_index_build_array_discard<USE_HINT>(index);
+		return -1;
+	}
+	memtx_tree_build_sorted<USE_HINT>(&index->tree, index->build_array,
+					  index->build_array_size);
 
 	free(index->build_array);
 	index->build_array = NULL;
 	index->build_array_size = 0;
 	index->build_array_alloc_size = 0;
+	return 0;
+}
+
+template <bool USE_HINT>
+static void
+memtx_tree_index_end_build(struct index *base)
+{
+	VERIFY(memtx_tree_index_end_build_impl<USE_HINT>(base, false) == 0);
+}
+
+int
+memtx_tree_index_end_build_checked(struct index *base)
+{
+	if (memtx_tree_index_uses_hint(base->def))
+		return memtx_tree_index_end_build_impl<true>(base, true);
+	else
+		return memtx_tree_index_end_build_impl<false>(base, true);
+}
+
+void
+memtx_tree_index_abort_build(struct index *base)
+{
+	if (memtx_tree_index_uses_hint(base->def)) {
+		memtx_tree_index_build_array_discard<true>(
+			(struct memtx_tree_index<true> *)base);
+	} else {
+		memtx_tree_index_build_array_discard<false>(
+			(struct memtx_tree_index<false> *)base);
+	}
 }
 
 /**
@@ -2290,7 +2557,8 @@ memtx_tree_index_build_using_sort_data(
 	}
 
 	/* Build the index. */
-	memtx_tree_build(&index->tree, build_array, build_array_size);
+	memtx_tree_build_sorted<USE_HINT>(&index->tree, build_array,
+					  build_array_size);
 	return 0;
 }
 
@@ -2638,11 +2906,13 @@ static const struct index_vtab memtx_tree_disabled_index_vtab = {
 	/* .count = */ generic_index_count,
 	/* .get_internal = */ generic_index_get_internal,
 	/* .get = */ generic_index_get,
+	/* .get_many = */ generic_index_get_many,
 	/* .replace = */ disabled_index_replace,
 	/* .create_iterator = */ generic_index_create_iterator,
 	/* .create_iterator_with_offset = */
 	generic_index_create_iterator_with_offset,
 	/* .create_arrow_stream = */ generic_index_create_arrow_stream,
+	/* .aggregate = */ generic_index_aggregate,
 	/* .create_read_view = */ generic_index_create_read_view,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
@@ -2702,6 +2972,7 @@ get_memtx_tree_index_vtab(void)
 		/* .count = */ memtx_tree_index_count<USE_HINT>,
 		/* .get_internal */ memtx_tree_index_get_internal<USE_HINT>,
 		/* .get = */ memtx_index_get,
+		/* .get_many = */ generic_index_get_many,
 		/* .replace = */ is_mk ? memtx_tree_index_replace_multikey :
 				 is_func ? memtx_tree_func_index_replace :
 				 memtx_tree_index_replace<USE_HINT>,
@@ -2710,6 +2981,7 @@ get_memtx_tree_index_vtab(void)
 		/* .create_iterator_with_offset = */
 		memtx_tree_index_create_iterator_with_offset<USE_HINT>,
 		/* .create_arrow_stream = */ generic_index_create_arrow_stream,
+		/* .aggregate = */ generic_index_aggregate,
 		/* .create_read_view = */
 			memtx_tree_index_create_read_view<USE_HINT>,
 		/* .stat = */ generic_index_stat,
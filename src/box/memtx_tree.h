@@ -52,6 +52,21 @@ memtx_tree_index_read_view_dump_sort_data(
 	struct index_read_view *base, int tuple_count,
 	struct memtx_sort_data_writer *msd, bool *have_more);
 
+/**
+ * Finish building the index started with index_begin_build() like
+ * index_end_build() does, but check the unique constraint. On failure
+ * the diag is set and the index is left empty.
+ */
+int
+memtx_tree_index_end_build_checked(struct index *base);
+
+/**
+ * Discard the tuples added to the index with index_build_next() if the
+ * build can't be finished.
+ */
+void
+memtx_tree_index_abort_build(struct index *base);
+
 /**
  * Build the index using the O(n) sort algorithm with MemTX sort data.
  */
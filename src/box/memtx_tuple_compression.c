@@ -0,0 +1,201 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2025, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "memtx_tuple_compression.h"
+
+#include "diag.h"
+#include "errcode.h"
+#include "fiber.h"
+#include "memtx_engine.h"
+#include "mp_compression.h"
+#include "mp_extension_types.h"
+#include "msgpuck.h"
+#include "small/region.h"
+#include "tuple.h"
+#include "tuple_format.h"
+
+#if defined(ENABLE_TUPLE_COMPRESSION)
+# error unimplemented
+#endif
+
+enum {
+	/**
+	 * Field values encoded in fewer bytes aren't compressed, because
+	 * the compression header would eat up all the savings.
+	 */
+	MEMTX_TUPLE_COMPRESSION_MIN_SIZE = 64,
+};
+
+/** Returns true if the MsgPack value is a compressed field value. */
+static inline bool
+mp_field_is_compressed(const char *data)
+{
+	if (mp_typeof(*data) != MP_EXT)
+		return false;
+	int8_t type;
+	mp_decode_extl(&data, &type);
+	return type == MP_COMPRESSION;
+}
+
+/**
+ * Returns the compression context of the field with the given number
+ * or NULL if the field isn't compressed.
+ */
+static inline struct tt_compression_ctx *
+tuple_format_field_compression_ctx(struct tuple_format *format,
+				   uint32_t fieldno)
+{
+	if (fieldno >= tuple_format_field_count(format))
+		return NULL;
+	return tuple_format_field(format, fieldno)->compression_ctx;
+}
+
+struct tuple *
+memtx_tuple_compress(struct tuple *tuple)
+{
+	struct tuple_format *format = tuple_format(tuple);
+	assert(format->is_compressed);
+	uint32_t bsize;
+	const char *data = tuple_data_range(tuple, &bsize);
+	const char *pos = data;
+	uint32_t field_count = mp_decode_array(&pos);
+	/*
+	 * A field is stored compressed only if it shrinks so the result
+	 * fits in the original size plus the max compression overhead
+	 * of the largest field.
+	 */
+	size_t max_size = 0;
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		mp_next(&pos);
+		if (tuple_format_field_compression_ctx(format, i) != NULL)
+			max_size = MAX(max_size, (size_t)(pos - field));
+	}
+	if (max_size < MEMTX_TUPLE_COMPRESSION_MIN_SIZE)
+		return tuple;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	char *buf = xregion_alloc(region, bsize + mp_compress_bound(max_size));
+	char *buf_pos = mp_encode_array(buf, field_count);
+	bool is_compressed = false;
+	pos = data;
+	mp_decode_array(&pos);
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		mp_next(&pos);
+		size_t size = pos - field;
+		struct tt_compression_ctx *ctx =
+			tuple_format_field_compression_ctx(format, i);
+		if (ctx != NULL && size >= MEMTX_TUPLE_COMPRESSION_MIN_SIZE) {
+			char *end = mp_compress(buf_pos, field, size, ctx);
+			if (end == NULL) {
+				region_truncate(region, region_svp);
+				diag_set(ClientError, ER_COMPRESSION,
+					 "failed to compress field");
+				return NULL;
+			}
+			if ((size_t)(end - buf_pos) < size) {
+				buf_pos = end;
+				is_compressed = true;
+				continue;
+			}
+		}
+		memcpy(buf_pos, field, size);
+		buf_pos += size;
+	}
+	struct tuple *result = tuple;
+	if (is_compressed) {
+		/*
+		 * Compressed fields don't conform to the format field
+		 * types so the validation is skipped. The tuple was
+		 * validated by the caller.
+		 */
+		result = memtx_tuple_new_raw(format, buf, buf_pos,
+					     MEMTX_TUPLE_NEW_RAW_NO_VALIDATE);
+	}
+	region_truncate(region, region_svp);
+	return result;
+}
+
+struct tuple *
+memtx_tuple_decompress(struct tuple *tuple)
+{
+	struct tuple_format *format = tuple_format(tuple);
+	if (!format->is_compressed)
+		return tuple;
+	uint32_t bsize;
+	const char *data = tuple_data_range(tuple, &bsize);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t size;
+	const char *raw = memtx_tuple_decompress_raw(data, data + bsize,
+						     &size);
+	struct tuple *result = tuple;
+	if (raw == NULL) {
+		result = NULL;
+	} else if (raw != data) {
+		result = memtx_tuple_new_raw(
+			format, raw, raw + size,
+			MEMTX_TUPLE_NEW_RAW_NO_VALIDATE |
+			MEMTX_TUPLE_NEW_RAW_NO_TUPLE_MAX_SIZE);
+	}
+	region_truncate(region, region_svp);
+	return result;
+}
+
+const char *
+memtx_tuple_decompress_raw(const char *tuple, const char *tuple_end,
+			   uint32_t *p_size)
+{
+	const char *pos = tuple;
+	uint32_t field_count = mp_decode_array(&pos);
+	size_t size = mp_sizeof_array(field_count);
+	bool is_compressed = false;
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		mp_next(&pos);
+		if (!mp_field_is_compressed(field)) {
+			size += pos - field;
+			continue;
+		}
+		size_t raw_size = mp_sizeof_decompressed(field);
+		if (raw_size == 0) {
+			diag_set(ClientError, ER_DECOMPRESSION,
+				 "invalid compressed data");
+			return NULL;
+		}
+		size += raw_size;
+		is_compressed = true;
+	}
+	assert(pos == tuple_end);
+	if (!is_compressed) {
+		*p_size = tuple_end - tuple;
+		return tuple;
+	}
+	char *buf = xregion_alloc(&fiber()->gc, size);
+	char *buf_pos = mp_encode_array(buf, field_count);
+	pos = tuple;
+	mp_decode_array(&pos);
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		if (!mp_field_is_compressed(field)) {
+			mp_next(&pos);
+			memcpy(buf_pos, field, pos - field);
+			buf_pos += pos - field;
+			continue;
+		}
+		size_t raw_size = mp_decompress(&pos, buf_pos,
+						buf + size - buf_pos);
+		if (raw_size == 0) {
+			diag_set(ClientError, ER_DECOMPRESSION,
+				 "invalid compressed data");
+			return NULL;
+		}
+		buf_pos += raw_size;
+	}
+	assert(buf_pos == buf + size);
+	*p_size = size;
+	return buf;
+}
@@ -17,28 +17,30 @@
 extern "C" {
 #endif
 
-static inline struct tuple *
-memtx_tuple_compress(struct tuple *tuple)
-{
-        (void)tuple;
-        unreachable();
-        return NULL;
-}
-
-static inline struct tuple *
-memtx_tuple_decompress(struct tuple *tuple)
-{
-	assert(!tuple_is_compressed(tuple));
-	return tuple;
-}
-
-static inline const char *
+/**
+ * Compresses the fields of a tuple according to its format. Returns
+ * the tuple itself if no field was compressed, because the values are
+ * too small or don't shrink. Returns NULL and sets diag on error.
+ */
+struct tuple *
+memtx_tuple_compress(struct tuple *tuple);
+
+/**
+ * Decompresses the fields of a tuple stored in a memtx space. Returns
+ * the tuple itself if it has no compressed fields. Returns NULL and
+ * sets diag on error.
+ */
+struct tuple *
+memtx_tuple_decompress(struct tuple *tuple);
+
+/**
+ * Decompresses the fields of a raw tuple to the fiber region. Returns
+ * the data as is if it has no compressed fields. Returns NULL and sets
+ * diag on error.
+ */
+const char *
 memtx_tuple_decompress_raw(const char *tuple, const char *tuple_end,
-			   uint32_t *p_size)
-{
-	*p_size = tuple_end - tuple;
-	return tuple;
-}
+			   uint32_t *p_size);
 
 #if defined(__cplusplus)
 } /* extern "C" */
@@ -880,6 +880,20 @@ memtx_tx_clear_func_key(struct tuple *tuple, uint32_t index_id)
 	tuple_unref(fkey);
 }
 
+/**
+ * Return the key definition used by a tree index to compare tuples and
+ * calculate their hints, see memtx_tree_index_new(). Hints stored in the
+ * index may be compared only with hints calculated by the same definition,
+ * because with the prefix_hint option a hint depends on all key parts.
+ */
+static inline struct key_def *
+memtx_tx_index_cmp_def(struct index *index)
+{
+	struct index_def *def = index->def;
+	return def->opts.is_unique && !def->key_def->is_nullable ?
+	       def->key_def : def->cmp_def;
+}
+
 /**
  * A helper to calculate tuple hint. Encapsulates functional indexes.
  *
@@ -2034,10 +2048,11 @@ memtx_tx_handle_counted_write(struct space *space, struct memtx_story *story,
 		struct count_gap_item *item =
 			(struct count_gap_item *)item_base;
 
+		struct key_def *cmp_def = memtx_tx_index_cmp_def(index);
 		hint_t hint = memtx_tx_tuple_hint(story->tuple, index,
-						  index->def->cmp_def);
+						  cmp_def);
 		bool tuple_matches = memtx_tx_tuple_matches_until(
-			index->def->cmp_def, story->tuple, hint, item->type,
+			cmp_def, story->tuple, hint, item->type,
 			item->key, item->part_count, item->until,
 			item->until_hint);
 
@@ -3266,7 +3281,7 @@ memtx_tx_index_invisible_count_matching_until_slow(
 	enum iterator_type type, const char *key, uint32_t part_count,
 	struct tuple *until, hint_t until_hint)
 {
-	struct key_def *cmp_def = index->def->cmp_def;
+	struct key_def *cmp_def = memtx_tx_index_cmp_def(index);
 
 	/*
 	 * The border is only valid if it's located at or after the first
@@ -3897,7 +3912,7 @@ memtx_tx_track_count_until_slow(struct txn *txn, struct space *space,
 				const char *key, uint32_t part_count,
 				struct tuple *until, hint_t until_hint)
 {
-	struct key_def *cmp_def = index->def->cmp_def;
+	struct key_def *cmp_def = memtx_tx_index_cmp_def(index);
 
 	/*
 	 * The border is only valid if it's located at or after the first
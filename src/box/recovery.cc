@@ -177,6 +177,7 @@ recovery_open_log(struct recovery *r, const struct vclock *vclock)
 	recovery_close_log(r);
 
 	xdir_open_cursor_xc(&r->wal_dir, vclock_sum(vclock), &r->cursor);
+	r->cursor.use_tx_cache = (r->flags & RECOVERY_USE_TX_CACHE) != 0;
 
 	if (state == XLOG_CURSOR_NEW &&
 	    vclock_compare(vclock, &r->vclock) > 0) {
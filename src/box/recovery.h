@@ -54,6 +54,11 @@ enum recovery_flag {
 	 * Do not print informational log messages.
 	 */
 	RECOVERY_SUPPRESS_LOGGING = 1 << 1,
+	/**
+	 * Share decoded transactions with other recoveries reading the
+	 * same files, see xlog_cursor::use_tx_cache. Used by relays.
+	 */
+	RECOVERY_USE_TX_CACHE = 1 << 2,
 };
 
 struct recovery {
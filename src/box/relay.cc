@@ -152,6 +152,11 @@ struct relay {
 	 * is passed by the replica on subscribe.
 	 */
 	uint32_t id_filter;
+	/**
+	 * Set if the replica asked to compress the replication stream
+	 * on subscribe, see IPROTO_FEATURE_REPLICATION_COMPRESSION.
+	 */
+	bool is_compressed;
 	/**
 	 * Local vclock at the moment of subscribe, used to check
 	 * dataset on the other side and send missing data rows if any.
@@ -343,6 +348,7 @@ relay_start(struct relay *relay, struct iostream *io, uint64_t sync,
 	relay->last_heartbeat_time = relay->last_row_time;
 	/* Never send rows for REPLICA_ID_NIL to anyone */
 	relay->id_filter = 1 << REPLICA_ID_NIL;
+	relay->is_compressed = false;
 	memset(&relay->status_msg, 0, sizeof(relay->status_msg));
 }
 
@@ -596,7 +602,8 @@ relay_final_join(struct replica *replica, struct iostream *io, uint64_t sync,
 	 * Save the first vclock as 'received'. Because it was really received.
 	 */
 	vclock_copy_ignore0(&relay->last_recv_ack.vclock, start_vclock);
-	relay->r = recovery_new(wal_dir(), 0, start_vclock);
+	relay->r = recovery_new(wal_dir(), RECOVERY_USE_TX_CACHE,
+				start_vclock);
 	vclock_copy(&relay->stop_vclock, stop_vclock);
 
 	struct cord cord;
@@ -1048,6 +1055,15 @@ relay_subscribe_f(va_list ap)
 	struct relay *relay = va_arg(ap, struct relay *);
 
 	relay_cord_init(relay);
+	/*
+	 * The replica handles both plain and compressed packets, so it's
+	 * fine to fall back to the plain stream on failure.
+	 */
+	if (relay->is_compressed &&
+	    xrow_stream_compress(&relay->xrow_stream) != 0) {
+		diag_log();
+		say_warn("failed to enable replication stream compression");
+	}
 
 	cbus_endpoint_create(&relay->tx_endpoint,
 			     tt_sprintf("relay_tx_%p", relay),
@@ -1150,7 +1166,8 @@ relay_subscribe_f(va_list ap)
 void
 relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 		const struct vclock *start_vclock, uint32_t replica_version_id,
-		uint32_t replica_id_filter, uint64_t sent_raft_term)
+		uint32_t replica_id_filter, uint64_t sent_raft_term,
+		bool is_compressed)
 {
 	assert(replica->anon || replica->id != REPLICA_ID_NIL);
 	struct relay *relay = replica->relay;
@@ -1170,11 +1187,13 @@ relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 	 * Save the first vclock as 'received'. Because it was really received.
 	 */
 	vclock_copy_ignore0(&relay->last_recv_ack.vclock, start_vclock);
-	relay->r = recovery_new(wal_dir(), RECOVERY_SUPPRESS_LOGGING,
+	relay->r = recovery_new(wal_dir(), RECOVERY_SUPPRESS_LOGGING |
+				RECOVERY_USE_TX_CACHE,
 				start_vclock);
 	vclock_copy_ignore0(&relay->tx.vclock, start_vclock);
 	relay->version_id = replica_version_id;
 	relay->id_filter |= replica_id_filter;
+	relay->is_compressed = is_compressed;
 	relay->subscribe_fiber = fiber();
 
 	struct cord cord;
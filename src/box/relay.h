@@ -157,11 +157,14 @@ relay_final_join(struct replica *replica, struct iostream *io, uint64_t sync,
 /**
  * Subscribe a replica to updates.
  *
+ * @param is_compressed  send the rows in IPROTO_COMPRESSED_ROWS packets
+ *
  * @return none.
  */
 void
 relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 		const struct vclock *start_vclock, uint32_t replica_version_id,
-		uint32_t replica_id_filter, uint64_t sent_raft_term);
+		uint32_t replica_id_filter, uint64_t sent_raft_term,
+		bool is_compressed);
 
 #endif /* TARANTOOL_REPLICATION_RELAY_H_INCLUDED */
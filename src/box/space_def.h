@@ -112,6 +112,14 @@ struct space_opts {
 	 * which should speed up writes, but may also slow down reads.
 	 */
 	bool defer_deletes;
+	/**
+	 * If set for a Vinyl space, string and binary fields that aren't
+	 * indexed and take at least this many bytes are stored in value
+	 * logs rather than in primary index runs so that compaction
+	 * doesn't have to rewrite them. 0 means disabled. The option
+	 * can't be changed after space creation.
+	 */
+	uint32_t value_log_threshold;
 	/** SQL statement that produced this space. */
 	char *sql;
 	/** Array of constraints. Can be NULL if constraints_count == 0. */
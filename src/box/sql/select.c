@@ -4492,6 +4492,342 @@ is_simple_count(struct Select *select, struct AggInfo *agg_info)
 	return space;
 }
 
+/** Class of values a field of a simple aggregate query is compared with. */
+enum simple_aggregate_class {
+	SIMPLE_AGGREGATE_NONE,
+	SIMPLE_AGGREGATE_NUMBER,
+	SIMPLE_AGGREGATE_STRING,
+	SIMPLE_AGGREGATE_BOOLEAN,
+};
+
+/**
+ * Return the class of the given field of the space or
+ * SIMPLE_AGGREGATE_NONE if the field can't be used in a simple
+ * aggregate query.
+ */
+static enum simple_aggregate_class
+simple_aggregate_field_class(const struct space *space, int fieldno)
+{
+	if (fieldno < 0 || (uint32_t)fieldno >= space->def->field_count)
+		return SIMPLE_AGGREGATE_NONE;
+	const struct field_def *field = &space->def->fields[fieldno];
+	switch (field->type) {
+	case FIELD_TYPE_UNSIGNED:
+	case FIELD_TYPE_INTEGER:
+	case FIELD_TYPE_DOUBLE:
+	case FIELD_TYPE_NUMBER:
+		return SIMPLE_AGGREGATE_NUMBER;
+	case FIELD_TYPE_STRING:
+		return field->coll_id == COLL_NONE ?
+		       SIMPLE_AGGREGATE_STRING : SIMPLE_AGGREGATE_NONE;
+	case FIELD_TYPE_BOOLEAN:
+		return SIMPLE_AGGREGATE_BOOLEAN;
+	default:
+		return SIMPLE_AGGREGATE_NONE;
+	}
+}
+
+/**
+ * Return true if the field is the first part of an index of the space.
+ * Queries filtering by or computing MIN/MAX of such a field are left to
+ * the planner, which can use the index to avoid the full scan.
+ */
+static bool
+simple_aggregate_field_is_indexed(const struct space *space, int fieldno)
+{
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		const struct key_def *key_def = space->index[i]->def->key_def;
+		if (key_def->parts[0].fieldno == (uint32_t)fieldno)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Return the class of the literal or SIMPLE_AGGREGATE_NONE if the
+ * expression is not a literal supported by a simple aggregate query.
+ */
+static enum simple_aggregate_class
+simple_aggregate_literal_class(const struct Expr *expr)
+{
+	switch (expr->op) {
+	case TK_INTEGER:
+	case TK_FLOAT:
+		return SIMPLE_AGGREGATE_NUMBER;
+	case TK_UMINUS:
+		if (expr->pLeft->op == TK_INTEGER ||
+		    expr->pLeft->op == TK_FLOAT)
+			return SIMPLE_AGGREGATE_NUMBER;
+		return SIMPLE_AGGREGATE_NONE;
+	case TK_STRING:
+		return SIMPLE_AGGREGATE_STRING;
+	case TK_TRUE:
+	case TK_FALSE:
+		return SIMPLE_AGGREGATE_BOOLEAN;
+	default:
+		return SIMPLE_AGGREGATE_NONE;
+	}
+}
+
+/** Return the index filter operator name for the comparison operator. */
+static const char *
+simple_aggregate_filter_op(int op)
+{
+	switch (op) {
+	case TK_EQ:
+		return "==";
+	case TK_NE:
+		return "~=";
+	case TK_LT:
+		return "<";
+	case TK_LE:
+		return "<=";
+	case TK_GT:
+		return ">";
+	case TK_GE:
+		return ">=";
+	default:
+		return NULL;
+	}
+}
+
+/**
+ * Return the comparison operator to use when the operands of the
+ * comparison are swapped.
+ */
+static int
+simple_aggregate_commute_op(int op)
+{
+	switch (op) {
+	case TK_LT:
+		return TK_GT;
+	case TK_LE:
+		return TK_GE;
+	case TK_GT:
+		return TK_LT;
+	case TK_GE:
+		return TK_LE;
+	default:
+		return op;
+	}
+}
+
+/**
+ * Check that the WHERE clause of a simple aggregate query is a
+ * conjunction of comparisons of a column with a literal and return
+ * the number of the comparisons or -1 if it's not.
+ */
+static int
+simple_aggregate_where_check(const struct Expr *expr, int cursor,
+			     const struct space *space)
+{
+	if (expr == NULL)
+		return 0;
+	if (expr->op == TK_AND) {
+		int left = simple_aggregate_where_check(expr->pLeft, cursor,
+							space);
+		if (left < 0)
+			return -1;
+		int right = simple_aggregate_where_check(expr->pRight, cursor,
+							 space);
+		if (right < 0)
+			return -1;
+		return left + right;
+	}
+	if (simple_aggregate_filter_op(expr->op) == NULL)
+		return -1;
+	const struct Expr *column = expr->pLeft;
+	const struct Expr *literal = expr->pRight;
+	if (column->op != TK_COLUMN_REF)
+		SWAP(column, literal);
+	if (column->op != TK_COLUMN_REF || column->iTable != cursor ||
+	    simple_aggregate_field_is_indexed(space, column->iColumn))
+		return -1;
+	enum simple_aggregate_class field_class =
+		simple_aggregate_field_class(space, column->iColumn);
+	if (field_class == SIMPLE_AGGREGATE_NONE ||
+	    field_class != simple_aggregate_literal_class(literal))
+		return -1;
+	return 1;
+}
+
+/**
+ * This function tests if the SELECT is of the form:
+ *
+ *   SELECT <agg>, ... FROM <tbl> [WHERE <col> <op> <literal> AND ...]
+ *
+ * where each <agg> is COUNT(*) or COUNT, SUM, MIN or MAX of a column,
+ * the compared columns are not indexed and the table is not a sub-select
+ * or view. Such a query can be executed by the index aggregate pushdown
+ * without fetching the tuples to VDBE.
+ *
+ * @param parse Current parsing context.
+ * @param select The select statement in form of aggregate query.
+ * @param agg_info The associated aggregate-info object.
+ * @param[out] filter_count Number of comparisons in the WHERE clause.
+ * @retval Pointer to space representing the table,
+ *         if the query matches this pattern. NULL otherwise.
+ */
+static struct space *
+is_simple_aggregate(struct Parse *parse, struct Select *select,
+		    struct AggInfo *agg_info, int *filter_count)
+{
+	assert(select->pGroupBy == NULL);
+	if (select->pHaving != NULL || select->pSrc->nSrc != 1 ||
+	    select->pSrc->a[0].pSelect != NULL)
+		return NULL;
+	struct SrcList_item *src = &select->pSrc->a[0];
+	if (src->fg.isIndexedBy || src->fg.notIndexed)
+		return NULL;
+	/* Let the planner raise the error if scanning is not allowed. */
+	if (src->fg.disallow_scan && (parse->sql_flags & SQL_SeqScan) == 0)
+		return NULL;
+	struct space *space = src->space;
+	assert(space != NULL && !space->def->opts.is_view);
+	if (space->def->id == 0 || space_index(space, 0) == NULL)
+		return NULL;
+	struct ExprList *list = select->pEList;
+	for (int i = 0; i < list->nExpr; i++) {
+		struct Expr *expr = list->a[i].pExpr;
+		if (expr->op != TK_AGG_FUNCTION || (expr->flags & EP_Distinct))
+			return NULL;
+	}
+	if (agg_info->nFunc == 0)
+		return NULL;
+	for (int i = 0; i < agg_info->nFunc; i++) {
+		struct AggInfo_func *func = &agg_info->aFunc[i];
+		const char *name = func->func->def->name;
+		struct ExprList *args = func->pExpr->x.pList;
+		if (args == NULL || args->nExpr == 0) {
+			if (strcmp(name, "COUNT") != 0)
+				return NULL;
+			continue;
+		}
+		if (args->nExpr != 1)
+			return NULL;
+		struct Expr *arg = args->a[0].pExpr;
+		if (arg->op != TK_AGG_COLUMN || arg->iTable != src->iCursor)
+			return NULL;
+		enum simple_aggregate_class field_class =
+			simple_aggregate_field_class(space, arg->iColumn);
+		if (field_class == SIMPLE_AGGREGATE_NONE)
+			return NULL;
+		if (strcmp(name, "SUM") == 0) {
+			enum field_type type =
+				space->def->fields[arg->iColumn].type;
+			if (type != FIELD_TYPE_UNSIGNED &&
+			    type != FIELD_TYPE_INTEGER &&
+			    type != FIELD_TYPE_DOUBLE)
+				return NULL;
+		} else if (strcmp(name, "MIN") == 0 ||
+			   strcmp(name, "MAX") == 0) {
+			if (simple_aggregate_field_is_indexed(space,
+							      arg->iColumn))
+				return NULL;
+		} else if (strcmp(name, "COUNT") != 0) {
+			return NULL;
+		}
+	}
+	*filter_count = simple_aggregate_where_check(select->pWhere,
+						     src->iCursor, space);
+	if (*filter_count < 0)
+		return NULL;
+	return space;
+}
+
+/**
+ * Emit code to build the array of index filters from the WHERE
+ * clause of a simple aggregate query, checked by is_simple_aggregate().
+ * Each filter is stored to the next register starting from *reg.
+ */
+static void
+simple_aggregate_code_filters(struct Parse *parse, struct Expr *expr,
+			      int *reg)
+{
+	if (expr == NULL)
+		return;
+	if (expr->op == TK_AND) {
+		simple_aggregate_code_filters(parse, expr->pLeft, reg);
+		simple_aggregate_code_filters(parse, expr->pRight, reg);
+		return;
+	}
+	struct Vdbe *v = parse->pVdbe;
+	int op = expr->op;
+	struct Expr *column = expr->pLeft;
+	struct Expr *literal = expr->pRight;
+	if (column->op != TK_COLUMN_REF) {
+		SWAP(column, literal);
+		op = simple_aggregate_commute_op(op);
+	}
+	int filter_reg = sqlGetTempRange(parse, 3);
+	sqlVdbeAddOp2(v, OP_Integer, column->iColumn, filter_reg);
+	sqlVdbeAddOp4(v, OP_String8, 0, filter_reg + 1, 0,
+		      simple_aggregate_filter_op(op), P4_STATIC);
+	sqlExprCode(parse, literal, filter_reg + 2);
+	sqlVdbeAddOp3(v, OP_Array, 3, *reg, filter_reg);
+	sqlReleaseTempRange(parse, filter_reg, 3);
+	++*reg;
+}
+
+/**
+ * Emit code computing the aggregates of a simple aggregate query,
+ * checked by is_simple_aggregate(), with the index aggregate pushdown
+ * and storing the results to the aggregate accumulators.
+ */
+static void
+simple_aggregate_code(struct Parse *parse, struct Select *select,
+		      struct AggInfo *agg_info, struct space *space,
+		      int filter_count)
+{
+	struct Vdbe *v = parse->pVdbe;
+	int input_reg = sqlGetTempRange(parse, 3);
+	/* The key is empty: the whole primary index is scanned. */
+	sqlVdbeAddOp3(v, OP_Array, 0, input_reg, 0);
+
+	int filters_reg = sqlGetTempRange(parse, MAX(filter_count, 1));
+	int reg = filters_reg;
+	simple_aggregate_code_filters(parse, select->pWhere, &reg);
+	assert(reg == filters_reg + filter_count);
+	sqlVdbeAddOp3(v, OP_Array, filter_count, input_reg + 1, filters_reg);
+	sqlReleaseTempRange(parse, filters_reg, MAX(filter_count, 1));
+
+	int count = agg_info->nFunc;
+	int aggregates_reg = sqlGetTempRange(parse, count);
+	int aggregate_reg = sqlGetTempRange(parse, 2);
+	for (int i = 0; i < count; i++) {
+		struct AggInfo_func *func = &agg_info->aFunc[i];
+		const char *name = func->func->def->name;
+		const char *func_name = strcmp(name, "COUNT") == 0 ? "count" :
+					strcmp(name, "SUM") == 0 ? "sum" :
+					strcmp(name, "MIN") == 0 ? "min" : "max";
+		sqlVdbeAddOp4(v, OP_String8, 0, aggregate_reg, 0, func_name,
+			      P4_STATIC);
+		struct ExprList *args = func->pExpr->x.pList;
+		if (args == NULL || args->nExpr == 0) {
+			sqlVdbeAddOp2(v, OP_Null, 0, aggregate_reg + 1);
+		} else {
+			sqlVdbeAddOp2(v, OP_Integer, args->a[0].pExpr->iColumn,
+				      aggregate_reg + 1);
+		}
+		sqlVdbeAddOp3(v, OP_Array, 2, aggregates_reg + i,
+			      aggregate_reg);
+	}
+	sqlReleaseTempRange(parse, aggregate_reg, 2);
+	sqlVdbeAddOp3(v, OP_Array, count, input_reg + 2, aggregates_reg);
+	sqlReleaseTempRange(parse, aggregates_reg, count);
+
+	int output_reg = sqlGetTempRange(parse, count);
+	sqlVdbeAddOp3(v, OP_IndexAggregate, space->def->id, output_reg,
+		      input_reg);
+	sqlVdbeChangeP5(v, ITER_ALL);
+	for (int i = 0; i < count; i++) {
+		sqlVdbeAddOp2(v, OP_Copy, output_reg + i,
+			      agg_info->aFunc[i].iMem);
+	}
+	sqlReleaseTempRange(parse, output_reg, count);
+	sqlReleaseTempRange(parse, input_reg, 3);
+}
+
 /*
  * If the source-list item passed as an argument was augmented with an
  * INDEXED BY clause, then try to locate the specified index. If there
@@ -5483,6 +5819,24 @@ explain_simple_count(struct Parse *parse_context, const char *table_name)
 	}
 }
 
+/**
+ * Add a single OP_Explain instruction to the VDBE to explain
+ * a simple aggregate query computed by the index aggregate pushdown.
+ *
+ * @param parse_context Current parsing context.
+ * @param table_name Name of table being queried.
+ */
+static void
+explain_simple_aggregate(struct Parse *parse_context, const char *table_name)
+{
+	if (parse_context->explain == 2) {
+		char *zEqp = sqlMPrintf("INDEX AGGREGATE %s", table_name);
+		sqlVdbeAddOp4(parse_context->pVdbe, OP_Explain,
+				  parse_context->iSelectId, 0, 0, zEqp,
+				  P4_DYNAMIC);
+	}
+}
+
 /**
  * Generate VDBE code that HALT program when subselect returned
  * more than one row (determined as LIMIT 1 overflow).
@@ -6331,6 +6685,7 @@ sqlSelect(Parse * pParse,		/* The parser context */
 
 		} /* endif pGroupBy.  Begin aggregate queries without GROUP BY: */
 		else {
+			int filter_count;
 			struct space *space = is_simple_count(p, &sAggInfo);
 			if (space != NULL) {
 				/*
@@ -6365,6 +6720,23 @@ sqlSelect(Parse * pParse,		/* The parser context */
 						  sAggInfo.aFunc[0].iMem);
 				sqlVdbeAddOp1(v, OP_Close, cursor);
 				explain_simple_count(pParse, space->def->name);
+			} else if ((space = is_simple_aggregate(
+					pParse, p, &sAggInfo,
+					&filter_count)) != NULL) {
+				/*
+				 * The query is of the form:
+				 *
+				 *   SELECT <agg>, ... FROM <tbl>
+				 *   WHERE <col> <op> <literal> AND ...
+				 *
+				 * Filters and aggregates are evaluated
+				 * by the index in batches, so the tuples
+				 * are never fetched to VDBE.
+				 */
+				simple_aggregate_code(pParse, p, &sAggInfo,
+						      space, filter_count);
+				explain_simple_aggregate(pParse,
+							 space->def->name);
 			} else
 			{
 				/* Check if the query is of one of the following forms:
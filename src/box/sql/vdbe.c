@@ -41,6 +41,7 @@
  */
 #include "box/box.h"
 #include "box/error.h"
+#include "box/index.h"
 #include "box/txn.h"
 #include "box/tuple.h"
 #include "box/port.h"
@@ -2139,6 +2140,56 @@ case OP_Count: {         /* out2 */
 	break;
 }
 
+/**
+ * Opcode: IndexAggregate P1 P2 P3 * P5
+ * Synopsis: r[P2@n]=aggregate(space P1, r[P3@3])
+ *
+ * Compute aggregates over the primary index of the space with ID P1
+ * without fetching the tuples to VDBE. Register P3 contains the key,
+ * register P3 + 1 contains the array of filters and register P3 + 2
+ * contains the array of aggregates. P5 is the iterator type. The
+ * results are stored to registers starting from P2, one per aggregate.
+ */
+case OP_IndexAggregate: {
+	if (box_schema_version() != p->schema_ver) {
+		p->expired = 1;
+		diag_set(ClientError, ER_SQL_EXECUTE, "schema version has "\
+			 "changed: need to re-compile SQL statement");
+		goto abort_due_to_error;
+	}
+	struct Mem *key = &aMem[pOp->p3];
+	assert(mem_is_array(key));
+	assert(mem_is_array(&aMem[pOp->p3 + 1]));
+	assert(mem_is_array(&aMem[pOp->p3 + 2]));
+	struct region *region = &fiber()->gc;
+	size_t svp = region_used(region);
+	const char *result, *result_end;
+	if (box_index_aggregate(pOp->p1, 0, pOp->p5, key->z, key->z + key->n,
+				aMem[pOp->p3 + 1].z, aMem[pOp->p3 + 2].z,
+				&result, &result_end) != 0) {
+		region_truncate(region, svp);
+		struct error *e = diag_last_error(diag_get());
+		if (box_error_code(e) == ER_UPDATE_INTEGER_OVERFLOW) {
+			diag_set(ClientError, ER_SQL_EXECUTE,
+				 "integer is overflowed");
+		}
+		goto abort_due_to_error;
+	}
+	uint32_t count = mp_decode_array(&result);
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t len;
+		pOut = vdbe_prepare_null_out(p, pOp->p2 + i);
+		if (mem_from_mp(pOut, result, &len) != 0) {
+			region_truncate(region, svp);
+			goto abort_due_to_error;
+		}
+		result += len;
+	}
+	assert(result == result_end);
+	region_truncate(region, svp);
+	break;
+}
+
 /**
  * Opcode: CreateForeignKey P1 * * P4 *
  *
@@ -2085,6 +2085,227 @@ tuple_hint_stub(struct tuple *tuple, struct key_def *key_def)
 	return HINT_NONE;
 }
 
+/**
+ * A prefix hint is used instead of a regular hint if the key definition
+ * has the has_prefix_hint flag set. It is built from all key parts, not
+ * only the first one, as follows. Each key part is converted to a byte
+ * string so that comparing the strings with memcmp() is equivalent to
+ * comparing the key parts and no string is a prefix of another one.
+ * The strings are concatenated, and the first HINT_PREFIX_BYTES bytes of
+ * the result (padded with zeros) make up the hint. Since truncation
+ * doesn't break the lexicographical order, the hint property holds for
+ * the whole key so most comparisons of keys that share the first part
+ * don't need to access tuple data.
+ *
+ * Only ascending non-nullable unsigned, integer, string and varbinary
+ * parts without collation are encoded. Any other part terminates the
+ * encoding: it and all the following parts don't contribute to the
+ * hint.
+ *
+ * Integers are encoded as a tag byte followed by the significant bytes
+ * of the value (big-endian). The tag is 0x80 + the number of the bytes
+ * for a non-negative value. For a negative value, the bytes of ~value
+ * are inverted, and the tag is 0x7f - the number of the bytes. Strings
+ * are encoded with zero bytes escaped as 0x00 0xff and terminated with
+ * 0x00 0x00.
+ *
+ * The highest bit of the hint is always cleared so that it never
+ * equals HINT_NONE.
+ */
+enum { HINT_PREFIX_BYTES = sizeof(hint_t) };
+
+/** Buffer used for building a prefix hint. */
+struct hint_prefix {
+	/** Bytes of the hint. */
+	uint8_t data[HINT_PREFIX_BYTES];
+	/** Number of bytes written to the buffer. */
+	uint32_t len;
+	/** Set if a key part that terminates the encoding was met. */
+	bool is_terminated;
+};
+
+/** Appends a byte to a prefix hint. Returns false if it's full. */
+static inline bool
+hint_prefix_put(struct hint_prefix *prefix, uint8_t byte)
+{
+	if (prefix->len == HINT_PREFIX_BYTES)
+		return false;
+	prefix->data[prefix->len++] = byte;
+	return true;
+}
+
+/** Returns the number of significant bytes in an integer. */
+static inline uint32_t
+hint_prefix_uint_len(uint64_t val)
+{
+	return val == 0 ? 0 : 8 - __builtin_clzll(val) / CHAR_BIT;
+}
+
+static inline bool
+hint_prefix_put_uint(struct hint_prefix *prefix, uint64_t val)
+{
+	uint32_t len = hint_prefix_uint_len(val);
+	if (!hint_prefix_put(prefix, 0x80 + len))
+		return false;
+	for (uint32_t i = len; i > 0; i--) {
+		if (!hint_prefix_put(prefix, val >> ((i - 1) * CHAR_BIT)))
+			return false;
+	}
+	return true;
+}
+
+static inline bool
+hint_prefix_put_int(struct hint_prefix *prefix, int64_t val)
+{
+	if (val >= 0)
+		return hint_prefix_put_uint(prefix, val);
+	uint64_t inv = ~(uint64_t)val;
+	uint32_t len = hint_prefix_uint_len(inv);
+	if (!hint_prefix_put(prefix, 0x7f - len))
+		return false;
+	for (uint32_t i = len; i > 0; i--) {
+		if (!hint_prefix_put(prefix, ~(inv >> ((i - 1) * CHAR_BIT))))
+			return false;
+	}
+	return true;
+}
+
+static inline bool
+hint_prefix_put_str(struct hint_prefix *prefix, const char *s, uint32_t len)
+{
+	for (uint32_t i = 0; i < len; i++) {
+		if (!hint_prefix_put(prefix, s[i]))
+			return false;
+		if (s[i] == 0 && !hint_prefix_put(prefix, 0xff))
+			return false;
+	}
+	return hint_prefix_put(prefix, 0) && hint_prefix_put(prefix, 0);
+}
+
+/** Checks if a key part contributes to a prefix hint. */
+static inline bool
+hint_prefix_part_is_encoded(struct key_part *part)
+{
+	if (part->sort_order == SORT_ORDER_DESC || part->coll != NULL ||
+	    key_part_is_nullable(part))
+		return false;
+	switch (part->type) {
+	case FIELD_TYPE_UNSIGNED:
+	case FIELD_TYPE_INTEGER:
+	case FIELD_TYPE_STRING:
+	case FIELD_TYPE_VARBINARY:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * Appends a key part to a prefix hint. Returns false if the hint is
+ * full or terminated. Sets `is_valid' to false if the field type
+ * doesn't match the key part type.
+ */
+static inline bool
+hint_prefix_put_field(struct hint_prefix *prefix, struct key_part *part,
+		      const char *field, bool *is_valid)
+{
+	if (!hint_prefix_part_is_encoded(part)) {
+		prefix->is_terminated = true;
+		return false;
+	}
+	uint32_t len;
+	const char *s;
+	switch (part->type) {
+	case FIELD_TYPE_UNSIGNED:
+	case FIELD_TYPE_INTEGER:
+		if (mp_typeof(*field) == MP_UINT)
+			return hint_prefix_put_uint(prefix,
+						    mp_decode_uint(&field));
+		if (mp_typeof(*field) == MP_INT)
+			return hint_prefix_put_int(prefix,
+						   mp_decode_int(&field));
+		break;
+	case FIELD_TYPE_STRING:
+		if (mp_typeof(*field) == MP_STR) {
+			s = mp_decode_str(&field, &len);
+			return hint_prefix_put_str(prefix, s, len);
+		}
+		break;
+	case FIELD_TYPE_VARBINARY:
+		if (mp_typeof(*field) == MP_BIN) {
+			s = mp_decode_bin(&field, &len);
+			return hint_prefix_put_str(prefix, s, len);
+		}
+		break;
+	default:
+		unreachable();
+	}
+	*is_valid = false;
+	return false;
+}
+
+/** Converts a prefix hint buffer to a comparison hint. */
+static inline hint_t
+hint_prefix_value(const struct hint_prefix *prefix)
+{
+	uint64_t val = 0;
+	for (uint32_t i = 0; i < HINT_PREFIX_BYTES; i++) {
+		val <<= CHAR_BIT;
+		if (i < prefix->len)
+			val |= prefix->data[i];
+	}
+	return val >> 1;
+}
+
+static hint_t
+key_hint_prefix(const char *key, uint32_t part_count, struct key_def *key_def)
+{
+	assert(key_def->has_prefix_hint);
+	if (part_count == 0)
+		return HINT_NONE;
+	struct hint_prefix prefix;
+	prefix.len = 0;
+	prefix.is_terminated = false;
+	bool is_valid = true;
+	for (uint32_t i = 0; i < part_count; i++) {
+		if (!hint_prefix_put_field(&prefix, &key_def->parts[i], key,
+					   &is_valid))
+			break;
+		mp_next(&key);
+	}
+	if (!is_valid)
+		return HINT_NONE;
+	/*
+	 * A partial key matches tuples that have different values of
+	 * the omitted parts hence different hints unless the omitted
+	 * parts don't contribute to the hint.
+	 */
+	if (part_count < key_def->part_count &&
+	    prefix.len < HINT_PREFIX_BYTES && !prefix.is_terminated &&
+	    hint_prefix_part_is_encoded(&key_def->parts[part_count]))
+		return HINT_NONE;
+	return hint_prefix_value(&prefix);
+}
+
+static hint_t
+tuple_hint_prefix(struct tuple *tuple, struct key_def *key_def)
+{
+	assert(key_def->has_prefix_hint);
+	struct hint_prefix prefix;
+	prefix.len = 0;
+	prefix.is_terminated = false;
+	bool is_valid = true;
+	for (uint32_t i = 0; i < key_def->part_count; i++) {
+		struct key_part *part = &key_def->parts[i];
+		const char *field = tuple_field_by_part(tuple, part,
+							MULTIKEY_NONE);
+		if (field == NULL ||
+		    !hint_prefix_put_field(&prefix, part, field, &is_valid))
+			break;
+	}
+	return is_valid ? hint_prefix_value(&prefix) : HINT_NONE;
+}
+
 template<enum field_type type, bool is_nullable, bool has_desc_parts>
 static void
 key_def_set_hint_func(struct key_def *def)
@@ -2121,6 +2342,11 @@ key_def_set_hint_func(struct key_def *def)
 		def->tuple_hint = tuple_hint_stub;
 		return;
 	}
+	if (def->has_prefix_hint) {
+		def->key_hint = key_hint_prefix;
+		def->tuple_hint = tuple_hint_prefix;
+		return;
+	}
 	switch (def->parts->type) {
 	case FIELD_TYPE_BOOLEAN:
 		key_def_set_hint_func<FIELD_TYPE_BOOLEAN>(def);
@@ -224,6 +224,8 @@ tuple_field_delete(struct tuple_field *field)
 	free(field->constraint);
 	field_default_func_destroy(&field->default_value.func);
 	free(field->default_value.data);
+	if (field->compression_ctx != NULL)
+		tt_compression_ctx_delete(field->compression_ctx);
 	free(field);
 }
 
@@ -531,8 +533,11 @@ tuple_format_create(struct tuple_format *format, struct key_def *const *keys,
 		field->coll = coll;
 		field->coll_id = cid;
 		field->compression_type = fields[i].compression_type;
-		if (field->compression_type != COMPRESSION_TYPE_NONE)
+		if (field->compression_type != COMPRESSION_TYPE_NONE) {
+			field->compression_ctx = tt_compression_ctx_new(
+				field->compression_type);
 			format->is_compressed = true;
+		}
 
 		field->constraint =
 			tuple_constraint_array_new(fields[i].constraint_def,
@@ -945,6 +950,15 @@ tuple_format_is_compatible_with_key_def(struct tuple_format *format,
 			return false;
 		}
         }
+	/*
+	 * Functional index keys are extracted from the stored tuples,
+	 * which may contain compressed fields.
+	 */
+	if (key_def->for_func_index && format->is_compressed) {
+		diag_set(ClientError, ER_UNSUPPORTED,
+			 "Functional index", "compression");
+		return false;
+	}
         return true;
 }
 
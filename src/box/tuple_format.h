@@ -149,6 +149,11 @@ struct tuple_field {
 	uint32_t coll_id;
 	/** Type of compression for this field. */
 	enum compression_type compression_type;
+	/**
+	 * Context used to compress the field values, NULL if the
+	 * field isn't compressed.
+	 */
+	struct tt_compression_ctx *compression_ctx;
 	/**
 	 * Bitmap of fields that must be present in a tuple
 	 * conforming to the multikey subtree. Not NULL only
@@ -298,11 +298,23 @@ vy_info_append_memory(struct vy_env *env, struct info_handler *h)
 	info_append_int(h, "level0", lsregion_used(&env->mem_env.allocator));
 	info_append_int(h, "tuple", env->stmt_env.sum_tuple_size);
 	info_append_int(h, "tuple_cache", env->cache_env.mem_used);
+	info_append_int(h, "page_cache", env->run_env.page_cache.mem_used);
 	info_append_int(h, "page_index", env->lsm_env.page_index_size);
 	info_append_int(h, "bloom_filter", env->lsm_env.bloom_size);
 	info_table_end(h); /* memory */
 }
 
+static void
+vy_info_append_page_cache(struct vy_env *env, struct info_handler *h)
+{
+	struct vy_page_cache_stat *stat = &env->run_env.page_cache.stat;
+	info_table_begin(h, "page_cache");
+	info_append_int(h, "hit", stat->hit);
+	info_append_int(h, "miss", stat->miss);
+	info_append_int(h, "evict", stat->evict);
+	info_table_end(h); /* page_cache */
+}
+
 static void
 vy_info_append_disk(struct vy_env *env, struct info_handler *h)
 {
@@ -321,6 +333,7 @@ vinyl_engine_stat(struct engine *engine, struct info_handler *h)
 	info_begin(h);
 	vy_info_append_tx(env, h);
 	vy_info_append_memory(env, h);
+	vy_info_append_page_cache(env, h);
 	vy_info_append_disk(env, h);
 	vy_info_append_scheduler(env, h);
 	vy_info_append_regulator(env, h);
@@ -522,6 +535,8 @@ vinyl_engine_reset_stat(struct engine *engine)
 
 	struct vy_tx_manager *xm = env->xm;
 	memset(&xm->stat, 0, sizeof(xm->stat));
+	memset(&env->run_env.page_cache.stat, 0,
+	       sizeof(env->run_env.page_cache.stat));
 
 	vy_scheduler_reset_stat(&env->scheduler);
 	vy_regulator_reset_stat(&env->regulator);
@@ -683,6 +698,18 @@ vinyl_space_check_index_def(struct space *space, struct index_def *index_def)
 			 "hint is only reasonable with memtx tree index");
 		return -1;
 	}
+	if (index_def->opts.fingerprint) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name(space), "fingerprint is only reasonable "
+			 "with memtx hash index over one unsigned field");
+		return -1;
+	}
+	if (index_def->opts.prefix_hint) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name(space), "prefix_hint is only reasonable "
+			 "with memtx tree index with hints");
+		return -1;
+	}
 
 	struct key_def *key_def = index_def->key_def;
 
@@ -732,6 +759,8 @@ vinyl_space_create_index(struct space *space, struct index_def *index_def)
 					pk, space_group_id(space));
 	if (lsm == NULL)
 		return NULL;
+	if (index_def->iid == 0)
+		lsm->value_log_threshold = space->def->opts.value_log_threshold;
 
 	index_create(&lsm->base, &env->base, &vinyl_index_vtab, index_def);
 	return &lsm->base;
@@ -1032,11 +1061,20 @@ vinyl_index_def_change_requires_rebuild(struct index *index,
 static int
 vinyl_space_prepare_alter(struct space *old_space, struct space *new_space)
 {
-	(void)new_space;
 	struct vy_env *env = vy_env(old_space->engine);
 
 	if (vinyl_check_wal(env, "DDL") != 0)
 		return -1;
+	/*
+	 * Runs written before the change may reference value logs
+	 * so the option can't be changed.
+	 */
+	if (old_space->def->opts.value_log_threshold !=
+	    new_space->def->opts.value_log_threshold) {
+		diag_set(ClientError, ER_ALTER_SPACE, space_name(old_space),
+			 "value_log_threshold is immutable");
+		return -1;
+	}
 
 	return 0;
 }
@@ -1779,13 +1817,16 @@ vy_check_is_unique(struct vy_env *env, struct vy_tx *tx,
  * Returns true if the deferred DELETE optimization should be enabled for the
  * given space. It is regulated by a per-space knob, but we also disable it if
  * the space has UPSERT statements, because the deferred DELETE optimization
- * doesn't handle them properly, see vy_write_iterator_deferred_delete().
+ * doesn't handle them properly, see vy_write_iterator_deferred_delete(),
+ * and if the space stores big fields in value logs, because overwritten
+ * statements read by compaction may contain references to values.
  */
 static inline bool
 vy_defer_deletes(struct space *space, struct vy_lsm *pk)
 {
 	return space->def->opts.defer_deletes &&
-		pk->stat.disk.stmt.upserts == 0;
+		pk->stat.disk.stmt.upserts == 0 &&
+		pk->value_log_threshold == 0;
 }
 
 /**
@@ -2219,8 +2260,14 @@ vy_upsert(struct vy_env *env, struct vy_tx *tx, struct txn_stmt *stmt,
 	if (tuple_validate_raw(pk->mem_format, tuple))
 		return -1;
 
+	/*
+	 * UPSERT statements aren't stored in spaces that use value logs,
+	 * because compaction can't apply them to statements that contain
+	 * references to values, see vy_value_log.h.
+	 */
 	if (space->index_count == 1 && !space_has_on_replace_triggers(space) &&
-	    !space->has_foreign_keys && space->wal_ext == NULL)
+	    !space->has_foreign_keys && space->wal_ext == NULL &&
+	    pk->value_log_threshold == 0)
 		return vy_lsm_upsert(tx, pk, tuple, tuple_end, ops, ops_end);
 
 	const char *old_tuple, *old_tuple_end;
@@ -2877,6 +2924,13 @@ vinyl_engine_set_cache(struct engine *engine, size_t quota)
 	vy_cache_env_set_quota(&env->cache_env, quota);
 }
 
+void
+vinyl_engine_set_page_cache(struct engine *engine, size_t quota)
+{
+	struct vy_env *env = vy_env(engine);
+	vy_page_cache_set_quota(&env->run_env.page_cache, quota);
+}
+
 int
 vinyl_engine_set_memory(struct engine *engine, size_t size)
 {
@@ -2904,6 +2958,14 @@ vinyl_engine_set_timeout(struct engine *engine, double timeout)
 	env->timeout = timeout;
 }
 
+void
+vinyl_engine_set_max_subcompactions(struct engine *engine,
+				    int max_subcompactions)
+{
+	struct vy_env *env = vy_env(engine);
+	env->scheduler.max_subcompactions = max_subcompactions;
+}
+
 void
 vinyl_engine_set_too_long_threshold(struct engine *engine,
 				    double too_long_threshold)
@@ -3292,20 +3354,64 @@ vinyl_engine_complete_join(struct engine *engine, struct engine_join_ctx *arg)
 
 /* {{{ Garbage collection */
 
+/**
+ * Return true if the files of a run can be deleted by garbage
+ * collection, see vy_gc() for the description of the arguments.
+ */
+static bool
+vy_gc_run_is_garbage(struct vy_lsm_recovery_info *lsm_info,
+		     struct vy_run_recovery_info *run_info,
+		     unsigned int gc_mask, int64_t gc_lsn)
+{
+	return (run_info->is_dropped && run_info->gc_lsn < gc_lsn &&
+		(gc_mask & VY_GC_DROPPED) != 0) ||
+	       ((run_info->is_incomplete || lsm_info->create_lsn < 0) &&
+		(gc_mask & VY_GC_INCOMPLETE) != 0);
+}
+
+/**
+ * Return true if the value log created for a run may be referenced
+ * by another run of the same LSM tree that isn't deleted by garbage
+ * collection, see vy_value_log.h.
+ */
+static bool
+vy_gc_run_value_log_is_used(struct vy_lsm_recovery_info *lsm_info,
+			    struct vy_run_recovery_info *run_info,
+			    unsigned int gc_mask, int64_t gc_lsn)
+{
+	struct vy_run_recovery_info *other;
+	rlist_foreach_entry(other, &lsm_info->runs, in_lsm) {
+		if (other != run_info && other->vlog_min_id > 0 &&
+		    other->vlog_min_id <= run_info->id &&
+		    other->id > run_info->id &&
+		    !vy_gc_run_is_garbage(lsm_info, other, gc_mask, gc_lsn))
+			return true;
+	}
+	return false;
+}
+
 /**
  * Given a record encoding information about a vinyl run, try to
  * delete the corresponding files. On success, write a "forget" record
  * to the log so that all information about the run is deleted on the
  * next log rotation.
+ *
+ * If the value log created for the run may still be referenced by
+ * other runs, it isn't deleted and the run isn't forgotten so that
+ * we retry to delete the value log next time.
  */
 static void
 vy_gc_run(struct vy_env *env,
 	  struct vy_lsm_recovery_info *lsm_info,
-	  struct vy_run_recovery_info *run_info)
+	  struct vy_run_recovery_info *run_info,
+	  unsigned int gc_mask, int64_t gc_lsn)
 {
+	bool keep_value_log = vy_gc_run_value_log_is_used(lsm_info, run_info,
+							  gc_mask, gc_lsn);
 	/* Try to delete files. */
 	if (vy_run_remove_files(env->path, lsm_info->space_id,
-				lsm_info->index_id, run_info->id) != 0)
+				lsm_info->index_id, run_info->id,
+				keep_value_log) != 0 || keep_value_log)
 		return;
 
 	/* Forget the run on success. */
@@ -3385,13 +3491,10 @@ vy_gc(struct vy_env *env, struct vy_recovery *recovery,
 
 		struct vy_run_recovery_info *run_info;
 		rlist_foreach_entry(run_info, &lsm_info->runs, in_lsm) {
-			if ((run_info->is_dropped &&
-			     run_info->gc_lsn < gc_lsn &&
-			     (gc_mask & VY_GC_DROPPED) != 0) ||
-			    ((run_info->is_incomplete ||
-			      lsm_info->create_lsn < 0) &&
-			     (gc_mask & VY_GC_INCOMPLETE) != 0)) {
-				vy_gc_run(env, lsm_info, run_info);
+			if (vy_gc_run_is_garbage(lsm_info, run_info,
+						 gc_mask, gc_lsn)) {
+				vy_gc_run(env, lsm_info, run_info,
+					  gc_mask, gc_lsn);
 			}
 			if (loops % VY_YIELD_LOOPS == 0)
 				fiber_sleep(0);
@@ -3421,6 +3524,25 @@ vinyl_engine_collect_garbage(struct engine *engine, const struct vclock *vclock)
 
 /* {{{ Backup */
 
+/**
+ * Return true if the value log created for a dropped run is
+ * referenced by a live run of the same LSM tree.
+ */
+static bool
+vy_backup_run_value_log_is_used(struct vy_lsm_recovery_info *lsm_info,
+				struct vy_run_recovery_info *run_info)
+{
+	struct vy_run_recovery_info *other;
+	rlist_foreach_entry(other, &lsm_info->runs, in_lsm) {
+		if (!other->is_dropped && !other->is_incomplete &&
+		    other->vlog_min_id > 0 &&
+		    other->vlog_min_id <= run_info->id &&
+		    other->id > run_info->id)
+			return true;
+	}
+	return false;
+}
+
 static int
 vinyl_engine_backup(struct engine *engine, const struct vclock *vclock,
 		    engine_backup_cb cb, void *cb_arg)
@@ -3452,12 +3574,27 @@ vinyl_engine_backup(struct engine *engine, const struct vclock *vclock,
 		}
 		struct vy_run_recovery_info *run_info;
 		rlist_foreach_entry(run_info, &lsm_info->runs, in_lsm) {
-			if (run_info->is_dropped || run_info->is_incomplete)
+			if (run_info->is_incomplete)
+				continue;
+			/*
+			 * A dropped run may still have a value log that
+			 * is referenced by live runs.
+			 */
+			bool vlog_only = run_info->is_dropped;
+			bool has_vlog = vlog_only ?
+				vy_backup_run_value_log_is_used(lsm_info,
+								run_info) :
+				run_info->vlog_min_id > 0;
+			if (vlog_only && !has_vlog)
 				continue;
 			char path[PATH_MAX];
 			for (int type = 0; type < vy_file_MAX; type++) {
 				if (type == VY_FILE_RUN_INPROGRESS ||
-				    type == VY_FILE_INDEX_INPROGRESS)
+				    type == VY_FILE_INDEX_INPROGRESS ||
+				    type == VY_FILE_VLOG_INPROGRESS)
+					continue;
+				if (type == VY_FILE_VLOG ? !has_vlog :
+							   vlog_only)
 					continue;
 				vy_run_snprint_path(path, sizeof(path),
 						    env->path,
@@ -4075,6 +4212,138 @@ vinyl_index_get(struct index *index, const char *key,
 	return 0;
 }
 
+/**
+ * Max number of fibers looking up keys concurrently in
+ * vinyl_index_get_many(), per reader thread. While one fiber
+ * waits for a page read, others may look up keys in memory or
+ * submit reads to other reader threads.
+ */
+enum { VY_GET_MANY_FIBERS_PER_READER = 2 };
+
+/** State shared by fibers looking up keys in vinyl_index_get_many(). */
+struct vy_get_many_ctx {
+	/** LSM tree to look up the keys in. */
+	struct vy_lsm *lsm;
+	/** Transaction to read in. */
+	struct vy_tx *tx;
+	/** Keys to look up, MsgPack arrays. */
+	const char **keys;
+	/** Number of keys. */
+	uint32_t key_count;
+	/** Index of the next key to look up. */
+	uint32_t next_key;
+	/** Set if a lookup failed. Stops the other fibers. */
+	bool is_failed;
+	/** Found tuples, one per key. */
+	struct tuple **result;
+};
+
+/** Look up keys from a shared context until there's none left. */
+static int
+vy_get_many_run(struct vy_get_many_ctx *ctx)
+{
+	while (!ctx->is_failed && ctx->next_key < ctx->key_count) {
+		uint32_t i = ctx->next_key++;
+		const char *key = ctx->keys[i];
+		uint32_t part_count = mp_decode_array(&key);
+		if (vy_get_by_raw_key(ctx->lsm, ctx->tx,
+				      vy_tx_read_view(ctx->tx),
+				      key, part_count, &ctx->result[i]) != 0) {
+			ctx->is_failed = true;
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static int
+vy_get_many_f(va_list ap)
+{
+	struct vy_get_many_ctx *ctx = va_arg(ap, struct vy_get_many_ctx *);
+	return vy_get_many_run(ctx);
+}
+
+static int
+vinyl_index_get_many(struct index *index, const char *keys,
+		     uint32_t key_count, struct tuple **result)
+{
+	assert(index->def->opts.is_unique);
+
+	struct vy_lsm *lsm = vy_lsm(index);
+	struct vy_env *env = vy_env(index->engine);
+	struct vy_tx *tx = in_txn() ?
+			   in_txn()->engines_tx[index->engine->id] : NULL;
+	if (tx != NULL && tx->state == VINYL_TX_ABORT) {
+		diag_set(ClientError, ER_TRANSACTION_CONFLICT);
+		return -1;
+	}
+	struct vy_tx tx_autocommit;
+	if (tx == NULL) {
+		tx = &tx_autocommit;
+		vy_tx_create(env->xm, tx);
+	}
+	if (vy_tx_check_can_yield(tx) != 0)
+		return -1;
+
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct vy_get_many_ctx ctx;
+	ctx.lsm = lsm;
+	ctx.tx = tx;
+	ctx.keys = xregion_alloc_array(region, const char *,
+				       MAX(key_count, 1));
+	ctx.key_count = key_count;
+	ctx.next_key = 0;
+	ctx.is_failed = false;
+	ctx.result = result;
+	for (uint32_t i = 0; i < key_count; i++) {
+		ctx.keys[i] = keys;
+		result[i] = NULL;
+		mp_next(&keys);
+	}
+	/*
+	 * Page reads are executed by reader threads, and the fiber
+	 * that issued a read yields until it completes. Look up keys
+	 * in several fibers so that reads for different keys proceed
+	 * in parallel. The current fiber is one of them.
+	 */
+	uint32_t fiber_count = MIN(key_count, (uint32_t)
+				   env->run_env.reader_pool_size *
+				   VY_GET_MANY_FIBERS_PER_READER);
+	struct fiber **fibers = xregion_alloc_array(region, struct fiber *,
+						    MAX(fiber_count, 1));
+	uint32_t started = 0;
+	int rc = 0;
+	while (started + 1 < fiber_count && ctx.next_key < key_count) {
+		struct fiber *f = fiber_new("vinyl.get_many", vy_get_many_f);
+		if (f == NULL) {
+			ctx.is_failed = true;
+			rc = -1;
+			break;
+		}
+		fiber_set_joinable(f, true);
+		fibers[started++] = f;
+		fiber_start(f, &ctx);
+	}
+	if (rc == 0 && vy_get_many_run(&ctx) != 0)
+		rc = -1;
+	for (uint32_t i = 0; i < started; i++) {
+		if (fiber_join(fibers[i]) != 0)
+			rc = -1;
+	}
+	region_truncate(region, region_svp);
+	if (tx == &tx_autocommit)
+		vy_tx_destroy(tx);
+	if (rc != 0) {
+		for (uint32_t i = 0; i < key_count; i++) {
+			if (result[i] != NULL)
+				tuple_unref(result[i]);
+		}
+		return -1;
+	}
+	return 0;
+}
+
 /*** }}} Cursor */
 
 /* {{{ Index build */
@@ -4853,11 +5122,13 @@ static const struct index_vtab vinyl_index_vtab = {
 	/* .count = */ generic_index_count,
 	/* .get_internal = */ generic_index_get_internal,
 	/* .get = */ vinyl_index_get,
+	/* .get_many = */ vinyl_index_get_many,
 	/* .replace = */ generic_index_replace,
 	/* .create_iterator = */ vinyl_index_create_iterator,
 	/* .create_iterator_with_offset = */
 	generic_index_create_iterator_with_offset,
 	/* .create_arrow_stream = */ generic_index_create_arrow_stream,
+	/* .aggregate = */ generic_index_aggregate,
 	/* .create_read_view = */ generic_index_create_read_view,
 	/* .stat = */ vinyl_index_stat,
 	/* .compact = */ vinyl_index_compact,
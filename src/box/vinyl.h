@@ -57,6 +57,12 @@ vinyl_engine_stat(struct engine *engine, struct info_handler *handler);
 void
 vinyl_engine_set_cache(struct engine *engine, size_t quota);
 
+/**
+ * Update vinyl page cache size.
+ */
+void
+vinyl_engine_set_page_cache(struct engine *engine, size_t quota);
+
 /**
  * Update vinyl memory size.
  */
@@ -75,6 +81,14 @@ vinyl_engine_set_max_tuple_size(struct engine *engine, size_t max_size);
 void
 vinyl_engine_set_timeout(struct engine *engine, double timeout);
 
+/**
+ * Update the max number of parts compaction of a range can be
+ * split into.
+ */
+void
+vinyl_engine_set_max_subcompactions(struct engine *engine,
+				    int max_subcompactions);
+
 /**
  * Update too_long_threshold.
  */
@@ -86,6 +86,7 @@ enum vy_log_key {
 	VY_LOG_KEY_DROP_LSN		= 14,
 	VY_LOG_KEY_GROUP_ID		= 15,
 	VY_LOG_KEY_DUMP_COUNT		= 16,
+	VY_LOG_KEY_VLOG_MIN_ID		= 17,
 };
 
 /** vy_log_key -> human readable name. */
@@ -107,6 +108,7 @@ static const char *vy_log_key_name[] = {
 	[VY_LOG_KEY_DROP_LSN]		= "drop_lsn",
 	[VY_LOG_KEY_GROUP_ID]		= "group_id",
 	[VY_LOG_KEY_DUMP_COUNT]		= "dump_count",
+	[VY_LOG_KEY_VLOG_MIN_ID]	= "vlog_min_id",
 };
 
 /** vy_log_type -> human readable name. */
@@ -304,6 +306,10 @@ vy_log_record_snprint(char *buf, int size, const struct vy_log_record *record)
 		SNPRINT(total, snprintf, buf, size, "%s=%"PRIu32", ",
 			vy_log_key_name[VY_LOG_KEY_DUMP_COUNT],
 			record->dump_count);
+	if (record->vlog_min_id > 0)
+		SNPRINT(total, snprintf, buf, size, "%s=%"PRIi64", ",
+			vy_log_key_name[VY_LOG_KEY_VLOG_MIN_ID],
+			record->vlog_min_id);
 	SNPRINT(total, snprintf, buf, size, "}");
 	return total;
 }
@@ -434,6 +440,11 @@ vy_log_record_encode(const struct vy_log_record *record,
 		size += mp_sizeof_uint(record->dump_count);
 		n_keys++;
 	}
+	if (record->vlog_min_id > 0) {
+		size += mp_sizeof_uint(VY_LOG_KEY_VLOG_MIN_ID);
+		size += mp_sizeof_uint(record->vlog_min_id);
+		n_keys++;
+	}
 	size += mp_sizeof_map(n_keys);
 
 	/*
@@ -516,6 +527,10 @@ vy_log_record_encode(const struct vy_log_record *record,
 		pos = mp_encode_uint(pos, VY_LOG_KEY_DUMP_COUNT);
 		pos = mp_encode_uint(pos, record->dump_count);
 	}
+	if (record->vlog_min_id > 0) {
+		pos = mp_encode_uint(pos, VY_LOG_KEY_VLOG_MIN_ID);
+		pos = mp_encode_uint(pos, record->vlog_min_id);
+	}
 	assert(pos == tuple + size);
 
 	/*
@@ -640,6 +655,9 @@ vy_log_record_decode(struct vy_log_record *record,
 		case VY_LOG_KEY_DUMP_COUNT:
 			record->dump_count = mp_decode_uint(&pos);
 			break;
+		case VY_LOG_KEY_VLOG_MIN_ID:
+			record->vlog_min_id = mp_decode_uint(&pos);
+			break;
 		default:
 			mp_next(&pos); /* unknown key, ignore */
 			break;
@@ -1707,6 +1725,7 @@ vy_recovery_do_create_run(struct vy_recovery *recovery, int64_t run_id)
 	run->dump_lsn = -1;
 	run->gc_lsn = -1;
 	run->dump_count = 0;
+	run->vlog_min_id = 0;
 	run->is_incomplete = false;
 	run->is_dropped = false;
 	run->data = NULL;
@@ -1758,7 +1777,8 @@ vy_recovery_prepare_run(struct vy_recovery *recovery, int64_t lsm_id,
  */
 static int
 vy_recovery_create_run(struct vy_recovery *recovery, int64_t lsm_id,
-		       int64_t run_id, int64_t dump_lsn, uint32_t dump_count)
+		       int64_t run_id, int64_t dump_lsn, uint32_t dump_count,
+		       int64_t vlog_min_id)
 {
 	struct vy_lsm_recovery_info *lsm;
 	lsm = vy_recovery_lookup_lsm(recovery, lsm_id);
@@ -1781,6 +1801,7 @@ vy_recovery_create_run(struct vy_recovery *recovery, int64_t lsm_id,
 		run = vy_recovery_do_create_run(recovery, run_id);
 	run->dump_lsn = dump_lsn;
 	run->dump_count = dump_count;
+	run->vlog_min_id = vlog_min_id;
 	run->is_incomplete = false;
 	rlist_move_entry(&lsm->runs, run, in_lsm);
 	return 0;
@@ -2125,7 +2146,8 @@ vy_recovery_process_record(struct vy_recovery *recovery,
 	case VY_LOG_CREATE_RUN:
 		rc = vy_recovery_create_run(recovery, record->lsm_id,
 					    record->run_id, record->dump_lsn,
-					    record->dump_count);
+					    record->dump_count,
+					    record->vlog_min_id);
 		break;
 	case VY_LOG_DROP_RUN:
 		rc = vy_recovery_drop_run(recovery, record->run_id,
@@ -2481,6 +2503,7 @@ vy_log_append_lsm(struct xlog *xlog, struct vy_lsm_recovery_info *lsm)
 			record.type = VY_LOG_CREATE_RUN;
 			record.dump_lsn = run->dump_lsn;
 			record.dump_count = run->dump_count;
+			record.vlog_min_id = run->vlog_min_id;
 		}
 		record.lsm_id = lsm->id;
 		record.run_id = run->id;
@@ -97,6 +97,7 @@ enum vy_log_record_type {
 	/**
 	 * Commit a vinyl run file creation.
 	 * Requires vy_log_record::lsm_id, run_id, dump_lsn, dump_count.
+	 * Optionally may include vy_log_record::vlog_min_id.
 	 *
 	 * Written after a run file was successfully created.
 	 */
@@ -283,6 +284,11 @@ struct vy_log_record {
 	int64_t gc_lsn;
 	/** For runs: number of dumps it took to create the run. */
 	uint32_t dump_count;
+	/**
+	 * For runs: ID of the oldest value log referenced by the run
+	 * or 0 if the run doesn't have a value log.
+	 */
+	int64_t vlog_min_id;
 	/** Link in vy_log_tx::records. */
 	struct stailq_entry in_tx;
 };
@@ -408,6 +414,13 @@ struct vy_run_recovery_info {
 	int64_t gc_lsn;
 	/** Number of dumps it took to create the run. */
 	uint32_t dump_count;
+	/**
+	 * ID of the oldest value log referenced by the run or 0 if
+	 * the run doesn't have a value log. A run that has a value
+	 * log may reference values stored in value logs with IDs
+	 * in range [vlog_min_id, id].
+	 */
+	int64_t vlog_min_id;
 	/**
 	 * True if the run was not committed (there's
 	 * VY_LOG_PREPARE_RUN, but no VY_LOG_CREATE_RUN).
@@ -748,8 +761,8 @@ vy_log_prepare_run(int64_t lsm_id, int64_t run_id)
 
 /** Helper to log a vinyl run creation. */
 static inline void
-vy_log_create_run(int64_t lsm_id, int64_t run_id,
-		  int64_t dump_lsn, uint32_t dump_count)
+vy_log_create_run(int64_t lsm_id, int64_t run_id, int64_t dump_lsn,
+		  uint32_t dump_count, int64_t vlog_min_id)
 {
 	struct vy_log_record record;
 	vy_log_record_init(&record);
@@ -758,6 +771,7 @@ vy_log_create_run(int64_t lsm_id, int64_t run_id,
 	record.run_id = run_id;
 	record.dump_lsn = dump_lsn;
 	record.dump_count = dump_count;
+	record.vlog_min_id = vlog_min_id;
 	vy_log_write(&record);
 }
 
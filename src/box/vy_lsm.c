@@ -355,6 +355,12 @@ vy_lsm_recover_run(struct vy_lsm *lsm, struct vy_run_recovery_info *run_info,
 
 	run->dump_lsn = run_info->dump_lsn;
 	run->dump_count = run_info->dump_count;
+	if (run_info->vlog_min_id > 0 &&
+	    vy_run_set_value_log(run, run_info->vlog_min_id, lsm->env->path,
+				 lsm->space_id, lsm->index_id) != 0) {
+		vy_run_unref(run);
+		return NULL;
+	}
 	if (vy_run_recover(run, lsm->env->path, lsm->space_id, lsm->index_id,
 			   lsm->cmp_def) != 0 &&
 	    (!force_recovery ||
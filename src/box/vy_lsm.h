@@ -192,6 +192,12 @@ struct vy_lsm {
 	uint32_t group_id;
 	/** Index options. */
 	struct index_opts opts;
+	/**
+	 * Min size of a field to store in a value log rather than
+	 * in a run file or 0 if value logs aren't used. Set only for
+	 * the primary index, see the value_log_threshold space option.
+	 */
+	uint32_t value_log_threshold;
 	/** Key definition used to compare tuples. */
 	struct key_def *cmp_def;
 	/** Key definition passed by the user. */
@@ -0,0 +1,224 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2025, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "vy_page_cache.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "vy_run.h"
+
+/** Key used for looking up a page in the cache. */
+struct vy_page_cache_key {
+	/** ID of the run the page belongs to. */
+	int64_t run_id;
+	/** Page number in the run. */
+	uint32_t page_no;
+};
+
+static inline uint32_t
+vy_page_cache_hash(int64_t run_id, uint32_t page_no)
+{
+	uint64_t h = (uint64_t)run_id * 0x9E3779B97F4A7C15ULL + page_no;
+	return (uint32_t)(h ^ (h >> 32));
+}
+
+#define mh_name _vy_page_cache
+#define mh_key_t struct vy_page_cache_key *
+#define mh_node_t struct vy_page *
+#define mh_arg_t void *
+#define mh_hash(a, arg) vy_page_cache_hash((*(a))->run_id, (*(a))->page_no)
+#define mh_hash_key(a, arg) vy_page_cache_hash((a)->run_id, (a)->page_no)
+#define mh_cmp(a, b, arg) ((*(a))->run_id != (*(b))->run_id || \
+			   (*(a))->page_no != (*(b))->page_no)
+#define mh_cmp_key(a, b, arg) ((a)->run_id != (*(b))->run_id || \
+			       (a)->page_no != (*(b))->page_no)
+#define MH_SOURCE
+#include "salad/mhash.h"
+
+/** Returns the size of memory used by a page. */
+static inline size_t
+vy_page_cache_page_size(struct vy_page *page)
+{
+	return sizeof(*page) + page->unpacked_size +
+	       page->row_count * sizeof(*page->row_index);
+}
+
+/**
+ * Returns the max size of memory that can be used by the pages in
+ * the protected list. The rest of the quota is reserved for the pages
+ * in the probation list so that newly read pages have a chance to be
+ * accessed again before they are evicted.
+ */
+static inline size_t
+vy_page_cache_protected_quota(struct vy_page_cache *cache)
+{
+	return cache->mem_quota / 4 * 3;
+}
+
+void
+vy_page_cache_create(struct vy_page_cache *cache)
+{
+	cache->hash = mh_vy_page_cache_new();
+	rlist_create(&cache->probation);
+	rlist_create(&cache->protected);
+	cache->mem_used = 0;
+	cache->protected_size = 0;
+	cache->mem_quota = 0;
+	memset(&cache->stat, 0, sizeof(cache->stat));
+}
+
+/** Remove a page from the cache and drop the cache's reference to it. */
+static void
+vy_page_cache_remove(struct vy_page_cache *cache, struct vy_page *page)
+{
+	assert(page->is_cached);
+	struct vy_page_cache_key key = {
+		.run_id = page->run_id,
+		.page_no = page->page_no,
+	};
+	mh_int_t pos = mh_vy_page_cache_find(cache->hash, &key, NULL);
+	assert(pos != mh_end(cache->hash));
+	mh_vy_page_cache_del(cache->hash, pos, NULL);
+	size_t size = vy_page_cache_page_size(page);
+	assert(cache->mem_used >= size);
+	cache->mem_used -= size;
+	if (page->is_protected) {
+		assert(cache->protected_size >= size);
+		cache->protected_size -= size;
+		page->is_protected = false;
+	}
+	rlist_del_entry(page, in_lru);
+	rlist_del_entry(page, in_run);
+	page->is_cached = false;
+	vy_page_unref(page);
+}
+
+void
+vy_page_cache_destroy(struct vy_page_cache *cache)
+{
+	struct vy_page *page, *tmp;
+	rlist_foreach_entry_safe(page, &cache->probation, in_lru, tmp)
+		vy_page_cache_remove(cache, page);
+	rlist_foreach_entry_safe(page, &cache->protected, in_lru, tmp)
+		vy_page_cache_remove(cache, page);
+	assert(cache->mem_used == 0);
+	mh_vy_page_cache_delete(cache->hash);
+}
+
+/**
+ * Move the least recently used pages from the protected list to
+ * the probation list until the protected list fits in its quota.
+ */
+static void
+vy_page_cache_demote(struct vy_page_cache *cache)
+{
+	size_t quota = vy_page_cache_protected_quota(cache);
+	while (cache->protected_size > quota) {
+		assert(!rlist_empty(&cache->protected));
+		struct vy_page *page = rlist_last_entry(&cache->protected,
+							struct vy_page, in_lru);
+		assert(page->is_protected);
+		cache->protected_size -= vy_page_cache_page_size(page);
+		page->is_protected = false;
+		rlist_move_entry(&cache->probation, page, in_lru);
+	}
+}
+
+/**
+ * Evict the least recently used pages until the cache fits in its
+ * quota. Pages from the probation list are evicted first.
+ */
+static void
+vy_page_cache_evict(struct vy_page_cache *cache)
+{
+	while (cache->mem_used > cache->mem_quota) {
+		struct vy_page *page;
+		if (!rlist_empty(&cache->probation)) {
+			page = rlist_last_entry(&cache->probation,
+						struct vy_page, in_lru);
+		} else {
+			assert(!rlist_empty(&cache->protected));
+			page = rlist_last_entry(&cache->protected,
+						struct vy_page, in_lru);
+		}
+		vy_page_cache_remove(cache, page);
+		cache->stat.evict++;
+	}
+}
+
+void
+vy_page_cache_set_quota(struct vy_page_cache *cache, size_t quota)
+{
+	cache->mem_quota = quota;
+	vy_page_cache_demote(cache);
+	vy_page_cache_evict(cache);
+}
+
+struct vy_page *
+vy_page_cache_get(struct vy_page_cache *cache, int64_t run_id,
+		  uint32_t page_no)
+{
+	if (cache->mem_quota == 0)
+		return NULL;
+	struct vy_page_cache_key key = {
+		.run_id = run_id,
+		.page_no = page_no,
+	};
+	mh_int_t pos = mh_vy_page_cache_find(cache->hash, &key, NULL);
+	if (pos == mh_end(cache->hash)) {
+		cache->stat.miss++;
+		return NULL;
+	}
+	cache->stat.hit++;
+	struct vy_page *page = *mh_vy_page_cache_node(cache->hash, pos);
+	rlist_move_entry(&cache->protected, page, in_lru);
+	if (!page->is_protected) {
+		page->is_protected = true;
+		cache->protected_size += vy_page_cache_page_size(page);
+		vy_page_cache_demote(cache);
+	}
+	return page;
+}
+
+void
+vy_page_cache_put(struct vy_page_cache *cache, int64_t run_id,
+		  struct rlist *run_pages, struct vy_page *page)
+{
+	assert(!page->is_cached);
+	size_t size = vy_page_cache_page_size(page);
+	if (size > cache->mem_quota)
+		return;
+	struct vy_page_cache_key key = {
+		.run_id = run_id,
+		.page_no = page->page_no,
+	};
+	/*
+	 * The same page may be read by two fibers concurrently, in
+	 * which case the page read last isn't cached.
+	 */
+	if (mh_vy_page_cache_find(cache->hash, &key, NULL) !=
+	    mh_end(cache->hash))
+		return;
+	page->run_id = run_id;
+	page->is_cached = true;
+	page->is_protected = false;
+	vy_page_ref(page);
+	mh_vy_page_cache_put(cache->hash, &page, NULL, NULL);
+	rlist_add_entry(&cache->probation, page, in_lru);
+	rlist_add_tail_entry(run_pages, page, in_run);
+	cache->mem_used += size;
+	vy_page_cache_evict(cache);
+}
+
+void
+vy_page_cache_invalidate_run(struct vy_page_cache *cache,
+			     struct rlist *run_pages)
+{
+	struct vy_page *page, *tmp;
+	rlist_foreach_entry_safe(page, run_pages, in_run, tmp)
+		vy_page_cache_remove(cache, page);
+}
@@ -0,0 +1,96 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2025, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <small/rlist.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct vy_page;
+struct mh_vy_page_cache_t;
+
+/** Page cache statistics. */
+struct vy_page_cache_stat {
+	/** Number of pages found in the cache. */
+	int64_t hit;
+	/** Number of pages not found in the cache. */
+	int64_t miss;
+	/** Number of pages evicted from the cache. */
+	int64_t evict;
+};
+
+/**
+ * Cache of decompressed run pages shared by all vinyl indexes.
+ *
+ * Pages are indexed by run ID and page number. The eviction policy is
+ * segmented LRU: a page read from disk is added to the probation list
+ * and moved to the protected list only when it's accessed again, so
+ * a long scan can't wipe out frequently accessed pages. Pages evicted
+ * from the protected list go back to the probation list.
+ *
+ * Pages are reference counted: an evicted page is freed only when it's
+ * released by all the run iterators that use it.
+ */
+struct vy_page_cache {
+	/** Cached pages indexed by run ID and page number. */
+	struct mh_vy_page_cache_t *hash;
+	/** Pages accessed once, the first element is the newest. */
+	struct rlist probation;
+	/** Pages accessed more than once, the first element is the newest. */
+	struct rlist protected;
+	/** Size of memory used by the cached pages. */
+	size_t mem_used;
+	/** Size of memory used by the pages in the protected list. */
+	size_t protected_size;
+	/** Max size of memory that can be used by the cached pages. */
+	size_t mem_quota;
+	/** Cache statistics. */
+	struct vy_page_cache_stat stat;
+};
+
+/** Initialize a page cache. The cache is disabled until a quota is set. */
+void
+vy_page_cache_create(struct vy_page_cache *cache);
+
+/** Destroy a page cache and release all the cached pages. */
+void
+vy_page_cache_destroy(struct vy_page_cache *cache);
+
+/** Set the page cache memory limit. Evicts pages if necessary. */
+void
+vy_page_cache_set_quota(struct vy_page_cache *cache, size_t quota);
+
+/**
+ * Look up a page in the cache. Returns NULL if not found. The page
+ * isn't referenced by this function.
+ */
+struct vy_page *
+vy_page_cache_get(struct vy_page_cache *cache, int64_t run_id,
+		  uint32_t page_no);
+
+/**
+ * Add a page read from the given run to the cache. The page is linked
+ * to the run page list so that it can be invalidated when the run is
+ * deleted. Does nothing if the cache is disabled or the page is too
+ * big or a page with the same number is already cached.
+ */
+void
+vy_page_cache_put(struct vy_page_cache *cache, int64_t run_id,
+		  struct rlist *run_pages, struct vy_page *page);
+
+/** Remove all pages of a deleted run from the cache. */
+void
+vy_page_cache_invalidate_run(struct vy_page_cache *cache,
+			     struct rlist *run_pages);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
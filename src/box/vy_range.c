@@ -316,6 +316,14 @@ vy_range_update_compaction_priority(struct vy_range *range,
 	uint64_t est_new_run_size = 0;
 	/* The number of runs at the current level. */
 	uint32_t level_run_count = 0;
+	/* Set if the current level is the first (newest) one. */
+	bool is_first_level = true;
+	/*
+	 * With the leveled strategy, set if the compaction scheduled
+	 * for upper levels must take in the first run of the next level.
+	 */
+	bool merge_into_next_level = false;
+	bool is_leveled = opts->compaction_strategy == INDEX_COMPACTION_LEVELED;
 	/*
 	 * The target (perfect) size of a run at the current level.
 	 * Calculated recurrently: the size of the next level equals
@@ -356,6 +364,7 @@ vy_range_update_compaction_priority(struct vy_range *range,
 		level_run_count++;
 		total_run_count++;
 		vy_disk_stmt_counter_add(&total_stmt_count, &slice->count);
+		bool is_new_level = false;
 		while (size > target_run_size) {
 			/*
 			 * The run size exceeds the threshold
@@ -380,11 +389,24 @@ vy_range_update_compaction_priority(struct vy_range *range,
 			 * level.
 			 */
 			target_run_size *= opts->run_size_ratio;
+			is_new_level = true;
+			is_first_level = false;
 			/*
 			 * Keep pushing the run down until
 			 * we find an appropriate level for it.
 			 */
 		}
+		if (is_new_level && merge_into_next_level) {
+			/*
+			 * The leveled strategy doesn't let compacted
+			 * runs pile up at the next level. Instead, they
+			 * are merged with the run stored there.
+			 */
+			merge_into_next_level = false;
+			range->compaction_priority = total_run_count;
+			range->compaction_queue = total_stmt_count;
+			est_new_run_size = total_stmt_count.bytes;
+		}
 		/*
 		 * Since all ranges constituting an LSM tree have
 		 * the same configuration, they tend to get compacted
@@ -403,6 +425,13 @@ vy_range_update_compaction_priority(struct vy_range *range,
 		uint32_t max_run_count = opts->run_count_per_level;
 		if (slice->seed < RAND_MAX / 10)
 			max_run_count++;
+		/*
+		 * With the leveled strategy, only the first level,
+		 * which receives dumped runs, may store more than
+		 * one run.
+		 */
+		if (is_leveled && !is_first_level)
+			max_run_count = 1;
 		if (level_run_count > max_run_count) {
 			/*
 			 * The number of runs at the current level
@@ -413,6 +442,7 @@ vy_range_update_compaction_priority(struct vy_range *range,
 			range->compaction_priority = total_run_count;
 			range->compaction_queue = total_stmt_count;
 			est_new_run_size = total_stmt_count.bytes;
+			merge_into_next_level = is_leveled;
 		}
 	}
 
@@ -516,6 +546,48 @@ vy_range_needs_split(struct vy_range *range, int64_t range_size,
 	return true;
 }
 
+int
+vy_range_compaction_split_keys(struct vy_range *range, struct vy_slice *slice,
+			       int n_parts, const char **split_keys)
+{
+	assert(n_parts > 1);
+	if (slice->run->info.page_count == 0)
+		return 1;
+	uint32_t page_count = slice->last_page_no - slice->first_page_no + 1;
+	/*
+	 * A split key must be greater than the min key of the first page
+	 * of the slice and the previous split key, otherwise a part would
+	 * be empty.
+	 */
+	struct vy_page_info *prev_page = vy_run_page_info(slice->run,
+							  slice->first_page_no);
+	int key_count = 0;
+	for (int i = 1; i < n_parts; i++) {
+		uint32_t page_no = slice->first_page_no +
+				   (uint64_t)page_count * i / n_parts;
+		struct vy_page_info *page = vy_run_page_info(slice->run,
+							     page_no);
+		if (vy_key_compare(prev_page->min_key, prev_page->min_key_hint,
+				   page->min_key, page->min_key_hint,
+				   range->cmp_def) >= 0)
+			continue;
+		/* See the comment in vy_range_needs_split(). */
+		if (range->begin.stmt != NULL &&
+		    vy_entry_compare_with_raw_key(range->begin, page->min_key,
+						  page->min_key_hint,
+						  range->cmp_def) >= 0)
+			continue;
+		if (range->end.stmt != NULL &&
+		    vy_entry_compare_with_raw_key(range->end, page->min_key,
+						  page->min_key_hint,
+						  range->cmp_def) <= 0)
+			continue;
+		split_keys[key_count++] = page->min_key;
+		prev_page = page;
+	}
+	return key_count + 1;
+}
+
 /**
  * Check if a range should be coalesced with one or more its neighbors.
  * If it should, return true and set @p_first and @p_last to the first
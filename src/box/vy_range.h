@@ -96,6 +96,10 @@ struct vy_range {
 	 * compacting L2, and both L1 and L2 are always included
 	 * when compacting L3.
 	 *
+	 * With the leveled compaction strategy, all levels but
+	 * the first one may store only one run, and compaction of
+	 * a level also takes in the run stored at the next level.
+	 *
 	 * This variable contains the number of runs the next
 	 * compaction of this range will include. If it is 0,
 	 * the range doesn't need to be compacted.
@@ -266,6 +270,26 @@ bool
 vy_range_needs_split(struct vy_range *range, int64_t range_size,
 		     const char **p_split_key);
 
+/**
+ * Find keys to split compaction of a range into parts that can be
+ * executed in parallel. The keys are taken from the page index of
+ * the given slice so that the parts are roughly equal in size.
+ *
+ * @param range             The range.
+ * @param slice             Slice of the range to take keys from.
+ * @param n_parts           Desired number of parts.
+ * @param[out] split_keys   Array of at least n_parts - 1 elements
+ *                          that receives the split keys in the
+ *                          ascending order.
+ *
+ * @retval                  Number of parts the range can be split
+ *                          into (the number of keys + 1), which may
+ *                          be less than n_parts.
+ */
+int
+vy_range_compaction_split_keys(struct vy_range *range, struct vy_slice *slice,
+			       int n_parts, const char **split_keys);
+
 /**
  * Check if a range needs to be coalesced with adjacent
  * ranges in a range tree.
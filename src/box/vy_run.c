@@ -44,6 +44,7 @@
 #include "xlog.h"
 #include "xrow.h"
 #include "vy_history.h"
+#include "vy_value_log.h"
 
 static const uint64_t vy_page_info_key_map = (1 << VY_PAGE_INFO_OFFSET) |
 					     (1 << VY_PAGE_INFO_SIZE) |
@@ -69,6 +70,8 @@ const char *vy_file_suffix[] = {
 	"index" inprogress_suffix, 	/* VY_FILE_INDEX_INPROGRESS */
 	"run",				/* VY_FILE_RUN */
 	"run" inprogress_suffix, 	/* VY_FILE_RUN_INPROGRESS */
+	"vlog",				/* VY_FILE_VLOG */
+	"vlog" inprogress_suffix, 	/* VY_FILE_VLOG_INPROGRESS */
 };
 
 /* sync run and index files very 16 MB */
@@ -189,6 +192,7 @@ vy_run_env_create(struct vy_run_env *env, int read_threads)
 	mempool_create(&env->read_task_pool, cord_slab_cache(),
 		       sizeof(struct vy_page_read_task));
 	env->initial_join = false;
+	vy_page_cache_create(&env->page_cache);
 }
 
 /**
@@ -199,6 +203,7 @@ vy_run_env_destroy(struct vy_run_env *env)
 {
 	if (env->reader_pool != NULL)
 		vy_run_env_stop_readers(env);
+	vy_page_cache_destroy(&env->page_cache);
 	mempool_destroy(&env->read_task_pool);
 	tt_pthread_key_delete(env->zdctx_key);
 }
@@ -282,6 +287,7 @@ vy_run_new(struct vy_run_env *env, int64_t id)
 	run->refs = 1;
 	rlist_create(&run->in_lsm);
 	rlist_create(&run->in_unused);
+	rlist_create(&run->cached_pages);
 	return run;
 }
 
@@ -311,13 +317,42 @@ void
 vy_run_delete(struct vy_run *run)
 {
 	assert(run->refs == 0);
+	if (!rlist_empty(&run->cached_pages)) {
+		vy_page_cache_invalidate_run(&run->env->page_cache,
+					     &run->cached_pages);
+	}
 	if (run->fd >= 0 && close(run->fd) < 0)
 		say_syserror("close failed");
 	vy_run_clear(run);
+	if (run->vlog_min_id > 0)
+		vy_value_log_reader_destroy(&run->vlog_reader);
+	free(run->vlog_dir);
 	TRASH(run);
 	free(run);
 }
 
+int
+vy_run_set_value_log(struct vy_run *run, int64_t vlog_min_id,
+		     const char *dir, uint32_t space_id, uint32_t iid)
+{
+	assert(vlog_min_id > 0);
+	char path[PATH_MAX];
+	vy_lsm_snprint_path(path, sizeof(path), dir, space_id, iid);
+	char *vlog_dir = strdup(path);
+	if (vlog_dir == NULL) {
+		diag_set(OutOfMemory, strlen(path) + 1, "malloc",
+			 "value log dir");
+		return -1;
+	}
+	if (run->vlog_min_id > 0)
+		vy_value_log_reader_destroy(&run->vlog_reader);
+	free(run->vlog_dir);
+	run->vlog_dir = vlog_dir;
+	run->vlog_min_id = vlog_min_id;
+	vy_value_log_reader_create(&run->vlog_reader, vlog_dir);
+	return 0;
+}
+
 size_t
 vy_run_bloom_size(struct vy_run *run)
 {
@@ -733,6 +768,12 @@ vy_page_new(const struct vy_page_info *page_info)
 	}
 	page->unpacked_size = page_info->unpacked_size;
 	page->row_count = page_info->row_count;
+	page->refs = 1;
+	page->run_id = -1;
+	rlist_create(&page->in_lru);
+	rlist_create(&page->in_run);
+	page->is_cached = false;
+	page->is_protected = false;
 	page->row_index = calloc(page_info->row_count, sizeof(uint32_t));
 	if (page->row_index == NULL) {
 		diag_set(OutOfMemory, page_info->row_count * sizeof(uint32_t),
@@ -752,9 +793,10 @@ vy_page_new(const struct vy_page_info *page_info)
 	return page;
 }
 
-static void
+void
 vy_page_delete(struct vy_page *page)
 {
+	assert(!page->is_cached);
 	uint32_t *row_index = page->row_index;
 	char *data = page->data;
 #if !defined(NDEBUG)
@@ -854,9 +896,9 @@ vy_run_iterator_stop(struct vy_run_iterator *itr)
 		itr->curr = vy_entry_none();
 	}
 	if (itr->curr_page != NULL) {
-		vy_page_delete(itr->curr_page);
+		vy_page_unref(itr->curr_page);
 		if (itr->prev_page != NULL)
-			vy_page_delete(itr->prev_page);
+			vy_page_unref(itr->prev_page);
 		itr->curr_page = itr->prev_page = NULL;
 	}
 }
@@ -1015,6 +1057,20 @@ vy_page_read_cb(struct cbus_call_msg *base)
 	return 0;
 }
 
+/**
+ * Make a page the current page of a run iterator. The page read before
+ * the current one is kept as the previous page. The iterator takes over
+ * the page reference.
+ */
+static void
+vy_run_iterator_cache_page(struct vy_run_iterator *itr, struct vy_page *page)
+{
+	if (itr->prev_page != NULL)
+		vy_page_unref(itr->prev_page);
+	itr->prev_page = itr->curr_page;
+	itr->curr_page = page;
+}
+
 /**
  * Read a page from disk given its number.
  * The function caches two most recently read pages.
@@ -1051,6 +1107,20 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 		return 0;
 	}
 
+	/* Check the page cache shared by all run iterators. */
+	page = vy_page_cache_get(&env->page_cache, slice->run->id, page_no);
+	if (page != NULL) {
+		if (key.stmt != NULL &&
+		    vy_page_find_key(page, key, itr->cmp_def,
+				     itr->format, iterator_type,
+				     pos_in_page, equal_found) != 0)
+			return -1;
+		vy_page_ref(page);
+		vy_run_iterator_cache_page(itr, page);
+		*result = page;
+		return 0;
+	}
+
 	/* Allocate buffers */
 	struct vy_page_info *page_info = vy_run_page_info(slice->run, page_no);
 	page = vy_page_new(page_info);
@@ -1087,11 +1157,10 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 	}
 
 	/* Update cache */
-	if (itr->prev_page != NULL)
-		vy_page_delete(itr->prev_page);
-	itr->prev_page = itr->curr_page;
-	itr->curr_page = page;
 	page->page_no = page_no;
+	vy_run_iterator_cache_page(itr, page);
+	vy_page_cache_put(&env->page_cache, slice->run->id,
+			  &slice->run->cached_pages, page);
 
 	/* Update read statistics. */
 	itr->stat->read.rows += page_info->row_count;
@@ -1103,6 +1172,86 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 	return 0;
 }
 
+/** Cbus task reading values referenced by a statement. */
+struct vy_value_read_task {
+	/** Parent. */
+	struct cbus_call_msg base;
+	/** Run the statement was read from. */
+	struct vy_run *run;
+	/** Statement with references to values. */
+	struct tuple *stmt;
+	/** [out] Statement data with the values. */
+	char *buf;
+	/** Size of the buffer. */
+	size_t size;
+};
+
+/** Value read task callback, runs in a reader thread. */
+static int
+vy_value_read_cb(struct cbus_call_msg *base)
+{
+	struct vy_value_read_task *task = (struct vy_value_read_task *)base;
+	return vy_value_log_reader_resolve(&task->run->vlog_reader,
+					   task->stmt, task->buf, task->size);
+}
+
+/**
+ * Append a statement returned by a run iterator to a history. If the
+ * statement has references to values stored in value logs, they are
+ * resolved first, see vy_value_log.h. Resolving references only for
+ * the returned statements rather than for whole pages makes sure that
+ * we don't read values that aren't needed.
+ *
+ * Only the values are read in a reader thread. The new statement is
+ * allocated in tx, because a statement allocated in another thread
+ * doesn't reference its format and isn't accounted in the memory
+ * statistics.
+ */
+static NODISCARD int
+vy_run_iterator_append_stmt(struct vy_run_iterator *itr,
+			    struct vy_history *history, struct vy_entry entry)
+{
+	if ((vy_stmt_flags(entry.stmt) & VY_STMT_VALUE_REFS) == 0)
+		return vy_history_append_stmt(history, entry);
+	struct vy_run *run = itr->slice->run;
+	assert(run->vlog_min_id > 0);
+	size_t size, read_size;
+	if (vy_value_log_resolved_size(entry.stmt, &size, &read_size) != 0)
+		return -1;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct vy_value_read_task task;
+	task.run = run;
+	task.stmt = entry.stmt;
+	task.size = size;
+	task.buf = region_alloc(region, size);
+	if (task.buf == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc", "tuple");
+		return -1;
+	}
+	/*
+	 * The call doesn't return until the task is complete even if
+	 * the fiber is cancelled so the buffer may be freed on error.
+	 */
+	if (vy_run_env_coio_call(run->env, &task.base,
+				 vy_value_read_cb) != 0) {
+		region_truncate(region, region_svp);
+		return -1;
+	}
+	/* Values are stored uncompressed. */
+	itr->stat->read.bytes += read_size;
+	itr->stat->read.bytes_compressed += read_size;
+	struct tuple *stmt = vy_value_log_stmt_new_resolved(
+		entry.stmt, task.buf, task.buf + size);
+	region_truncate(region, region_svp);
+	if (stmt == NULL)
+		return -1;
+	entry.stmt = stmt;
+	int rc = vy_history_append_stmt(history, entry);
+	tuple_unref(stmt);
+	return rc;
+}
+
 /**
  * Read key and lsn by a given wide position.
  * For the first record in a page reads the result from the page
@@ -1608,7 +1757,7 @@ vy_run_iterator_next(struct vy_run_iterator *itr,
 	if (vy_run_iterator_next_key(itr, &entry) != 0)
 		return -1;
 	while (entry.stmt != NULL) {
-		if (vy_history_append_stmt(history, entry) != 0)
+		if (vy_run_iterator_append_stmt(itr, history, entry) != 0)
 			return -1;
 		if (vy_history_is_terminal(history))
 			break;
@@ -1640,7 +1789,7 @@ vy_run_iterator_skip(struct vy_run_iterator *itr, struct vy_entry last,
 		return -1;
 
 	while (entry.stmt != NULL) {
-		if (vy_history_append_stmt(history, entry) != 0)
+		if (vy_run_iterator_append_stmt(itr, history, entry) != 0)
 			return -1;
 		if (vy_history_is_terminal(history))
 			break;
@@ -2198,6 +2347,36 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 	return 0;
 }
 
+int
+vy_run_writer_enable_value_log(struct vy_run_writer *writer,
+			       uint32_t threshold, int64_t relocate_below)
+{
+	assert(writer->value_log == NULL);
+	assert(writer->iid == 0);
+	char dir[PATH_MAX];
+	vy_lsm_snprint_path(dir, sizeof(dir), writer->dirpath,
+			    writer->space_id, writer->iid);
+	struct vy_value_log_writer *value_log = malloc(sizeof(*value_log) +
+						       strlen(dir) + 1);
+	if (value_log == NULL) {
+		diag_set(OutOfMemory, sizeof(*value_log), "malloc",
+			 "struct vy_value_log_writer");
+		return -1;
+	}
+	/* The directory path is stored right after the writer. */
+	char *value_log_dir = (char *)(value_log + 1);
+	strcpy(value_log_dir, dir);
+	if (vy_value_log_writer_create(value_log, value_log_dir,
+				       writer->run->id, threshold,
+				       relocate_below) != 0) {
+		vy_value_log_writer_abort(value_log);
+		free(value_log);
+		return -1;
+	}
+	writer->value_log = value_log;
+	return 0;
+}
+
 /**
  * Create an xlog to write run.
  * @param writer Run writer.
@@ -2288,8 +2467,20 @@ vy_run_writer_write_to_page(struct vy_run_writer *writer, struct vy_entry entry)
 		return -1;
 	}
 	*offset = page->unpacked_size;
-	if (vy_run_dump_stmt(entry, &writer->data_xlog, page,
-			     writer->cmp_def, writer->iid == 0) != 0)
+	struct vy_entry dump_entry = entry;
+	if (writer->value_log != NULL) {
+		struct tuple *stmt;
+		if (vy_value_log_writer_process(writer->value_log,
+						entry.stmt, &stmt) != 0)
+			return -1;
+		if (stmt != NULL)
+			dump_entry.stmt = stmt;
+	}
+	int rc = vy_run_dump_stmt(dump_entry, &writer->data_xlog, page,
+				  writer->cmp_def, writer->iid == 0);
+	if (dump_entry.stmt != entry.stmt)
+		tuple_unref(dump_entry.stmt);
+	if (rc != 0)
 		return -1;
 	int64_t lsn = vy_stmt_lsn(entry.stmt);
 	run->info.min_lsn = MIN(run->info.min_lsn, lsn);
@@ -2372,6 +2563,10 @@ vy_run_writer_destroy(struct vy_run_writer *writer)
 	if (writer->bloom != NULL)
 		tuple_bloom_builder_delete(writer->bloom);
 	ibuf_destroy(&writer->row_index_buf);
+	if (writer->value_log != NULL) {
+		vy_value_log_writer_abort(writer->value_log);
+		free(writer->value_log);
+	}
 }
 
 int
@@ -2416,6 +2611,19 @@ vy_run_writer_commit(struct vy_run_writer *writer)
 		goto out;
 	}
 
+	if (writer->value_log != NULL) {
+		struct vy_value_log_writer *value_log = writer->value_log;
+		if (vy_value_log_writer_commit(value_log) != 0)
+			goto out;
+		/* The value log writer is destroyed on commit. */
+		writer->value_log = NULL;
+		int64_t vlog_min_id = value_log->min_id;
+		free(value_log);
+		if (vy_run_set_value_log(run, vlog_min_id, writer->dirpath,
+					 writer->space_id, writer->iid) != 0)
+			goto out;
+	}
+
 	if (writer->bloom != NULL) {
 		run->info.bloom = tuple_bloom_new(writer->bloom,
 						  writer->bloom_fpr);
@@ -2611,6 +2819,7 @@ vy_run_remove_files_f(va_list ap)
 	uint32_t space_id = va_arg(ap, typeof(space_id));
 	uint32_t iid = va_arg(ap, typeof(iid));
 	int64_t run_id = va_arg(ap, typeof(run_id));
+	bool keep_value_log = va_arg(ap, int);
 
 	ERROR_INJECT(ERRINJ_VY_GC,
 		     {say_error("error injection: vinyl run %lld not deleted",
@@ -2618,6 +2827,8 @@ vy_run_remove_files_f(va_list ap)
 	int ret = 0;
 	char path[PATH_MAX];
 	for (int type = 0; type < vy_file_MAX; type++) {
+		if (keep_value_log && type == VY_FILE_VLOG)
+			continue;
 		vy_run_snprint_path(path, sizeof(path), dir,
 				    space_id, iid, run_id, type);
 		if (!xlog_remove_file(path, XLOG_RM_VERBOSE))
@@ -2634,9 +2845,10 @@ vy_run_remove_files_f(va_list ap)
 
 int
 vy_run_remove_files(const char *dir, uint32_t space_id,
-		    uint32_t iid, int64_t run_id)
+		    uint32_t iid, int64_t run_id, bool keep_value_log)
 {
-	return coio_call(vy_run_remove_files_f, dir, space_id, iid, run_id);
+	return coio_call(vy_run_remove_files_f, dir, space_id, iid, run_id,
+			 (int)keep_value_log);
 }
 
 /**
@@ -31,6 +31,7 @@
  * SUCH DAMAGE.
  */
 
+#include <pthread.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -40,6 +41,8 @@
 #include "vy_stmt_stream.h"
 #include "vy_read_view.h"
 #include "vy_stat.h"
+#include "vy_page_cache.h"
+#include "vy_value_log.h"
 #include "index_def.h"
 #include "xlog.h"
 
@@ -51,6 +54,7 @@ extern "C" {
 
 struct vy_history;
 struct vy_run_reader;
+struct vy_value_log_writer;
 
 /** Part of vinyl environment for run read/write */
 struct vy_run_env {
@@ -74,6 +78,8 @@ struct vy_run_env {
 	 * unconditionally remove unused runs' files in-place.
 	 */
 	bool initial_join;
+	/** Cache of decompressed pages read by run iterators. */
+	struct vy_page_cache page_cache;
 };
 
 /**
@@ -151,6 +157,23 @@ struct vy_run {
 	 * it last time.
 	 */
 	uint32_t dump_count;
+	/**
+	 * Min ID of a value log referenced by this run or 0 if the run
+	 * doesn't have a value log, see vy_value_log.h.
+	 */
+	int64_t vlog_min_id;
+	/**
+	 * Path to the directory storing value logs referenced by this
+	 * run. Set only if vlog_min_id > 0.
+	 */
+	char *vlog_dir;
+	/**
+	 * Reader of values referenced by statements of this run. It's
+	 * shared by all reader threads so that value log files are
+	 * opened once per run rather than once per read. Valid only if
+	 * vlog_min_id > 0.
+	 */
+	struct vy_value_log_reader vlog_reader;
 	/**
 	 * Run reference counter, the run is deleted once it hits 0.
 	 * A new run is created with the reference counter set to 1.
@@ -173,6 +196,8 @@ struct vy_run {
 	struct rlist in_unused;
 	/** Link in vy_lsm::runs list. */
 	struct rlist in_lsm;
+	/** List of pages of this run stored in the page cache. */
+	struct rlist cached_pages;
 };
 
 /**
@@ -302,8 +327,42 @@ struct vy_page {
 	uint32_t *row_index;
 	/** Pointer to the page data. */
 	char *data;
+	/**
+	 * Page reference counter. A page is referenced by each run
+	 * iterator using it and by the page cache.
+	 */
+	int refs;
+	/** ID of the run the page belongs to, set if the page is cached. */
+	int64_t run_id;
+	/** Link in the page cache probation or protected list. */
+	struct rlist in_lru;
+	/** Link in vy_run::cached_pages. */
+	struct rlist in_run;
+	/** Set if the page is stored in the page cache. */
+	bool is_cached;
+	/** Set if the page is stored in the page cache protected list. */
+	bool is_protected;
 };
 
+/** Free a page. Must not be called directly for referenced pages. */
+void
+vy_page_delete(struct vy_page *page);
+
+static inline void
+vy_page_ref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	page->refs++;
+}
+
+static inline void
+vy_page_unref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	if (--page->refs == 0)
+		vy_page_delete(page);
+}
+
 /**
  * Initialize vinyl run environment
  *
@@ -430,6 +489,8 @@ enum vy_file_type {
 	VY_FILE_INDEX_INPROGRESS,
 	VY_FILE_RUN,
 	VY_FILE_RUN_INPROGRESS,
+	VY_FILE_VLOG,
+	VY_FILE_VLOG_INPROGRESS,
 	vy_file_MAX,
 };
 
@@ -475,13 +536,23 @@ vy_run_snprint_path(char *buf, int size, const char *dir,
 }
 
 /**
- * Remove all files (data, index) corresponding to a run
- * with the given id. Return 0 on success, -1 if unlink()
- * failed.
+ * Set the min ID of a value log referenced by a run and the path to
+ * the directory storing value logs (the LSM tree directory).
+ * Returns -1 on memory allocation error.
+ */
+int
+vy_run_set_value_log(struct vy_run *run, int64_t vlog_min_id,
+		     const char *dir, uint32_t space_id, uint32_t iid);
+
+/**
+ * Remove all files (data, index, value log) corresponding to a run
+ * with the given id. If @keep_value_log is set, the value log isn't
+ * removed, because it may still be referenced by other runs.
+ * Return 0 on success, -1 if unlink() failed.
  */
 int
 vy_run_remove_files(const char *dir, uint32_t space_id,
-		    uint32_t iid, int64_t run_id);
+		    uint32_t iid, int64_t run_id, bool keep_value_log);
 
 /**
  * Allocate a new run slice.
@@ -660,6 +731,11 @@ struct vy_run_writer {
 	 * of max key of a finished run.
 	 */
 	struct vy_entry last;
+	/**
+	 * Writer of the value log created for the run or NULL if
+	 * big fields aren't stored out of the run.
+	 */
+	struct vy_value_log_writer *value_log;
 };
 
 /** Create a run writer to fill a run with statements. */
@@ -669,6 +745,20 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		     struct key_def *cmp_def, struct key_def *key_def,
 		     uint64_t page_size, double bloom_fpr, bool no_compression);
 
+/**
+ * Make a run writer store big fields in a value log created for
+ * the run, see vy_value_log.h.
+ * @param writer          Run writer.
+ * @param threshold       Min size of a field to store in the value log.
+ * @param relocate_below  Values stored in value logs with lesser IDs
+ *                        are copied to the new value log.
+ * @retval -1 Memory or IO error.
+ * @retval  0 Success.
+ */
+int
+vy_run_writer_enable_value_log(struct vy_run_writer *writer,
+			       uint32_t threshold, int64_t relocate_below);
+
 /**
  * Write a specified statement into a run.
  * @param writer Writer to write a statement.
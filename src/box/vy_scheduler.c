@@ -104,6 +104,9 @@ struct vy_worker {
 /** Max number of statements in a batch of deferred DELETEs. */
 enum { VY_DEFERRED_DELETE_BATCH_MAX = 100 };
 
+/** Max number of parts compaction of a range can be split into. */
+enum { VY_COMPACTION_PARTS_MAX = 16 };
+
 /** Deferred DELETE statement. */
 struct vy_deferred_delete_stmt {
 	/** Overwritten tuple. */
@@ -205,6 +208,16 @@ struct vy_task {
 	 */
 	double bloom_fpr;
 	int64_t page_size;
+	/**
+	 * Min size of a field to store in the value log or 0 if
+	 * the run doesn't need a value log, see vy_value_log.h.
+	 */
+	uint32_t value_log_threshold;
+	/**
+	 * Values stored in value logs with IDs less than this one
+	 * are copied to the value log of the new run.
+	 */
+	int64_t vlog_relocate_below;
 	/**
 	 * Deferred DELETE handler passed to the write iterator.
 	 * It sends deferred DELETE statements generated during
@@ -218,6 +231,37 @@ struct vy_task {
 	 * and not yet processed.
 	 */
 	int deferred_delete_in_progress;
+	/**
+	 * Compaction of a big range may be split by key into parts
+	 * that are written to separate runs by different worker
+	 * threads in parallel. In this case the task compacts the
+	 * first part while the rest are compacted by subtasks stored
+	 * in this list. The task completes only when all subtasks
+	 * have been executed. Upon completion, the range is replaced
+	 * with new ranges, one per each part.
+	 */
+	struct rlist subtasks;
+	/** Link in vy_task::subtasks of the parent task. */
+	struct rlist in_subtasks;
+	/** Task this subtask belongs to or NULL. */
+	struct vy_task *parent;
+	/**
+	 * Number of the task and its subtasks that are still
+	 * being executed by worker threads.
+	 */
+	int pending_count;
+	/**
+	 * Key range of a compaction part, set only if compaction
+	 * is split into parts.
+	 */
+	struct vy_entry begin;
+	struct vy_entry end;
+	/**
+	 * Slices of the compacted runs cut by the part key range
+	 * and read by the write iterator of a compaction part.
+	 * Linked by vy_slice::in_range.
+	 */
+	struct rlist slices;
 	/** Link in vy_scheduler::processed_tasks. */
 	struct stailq_entry in_processed;
 };
@@ -253,15 +297,30 @@ vy_task_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	vy_lsm_ref(lsm);
 	diag_create(&task->diag);
 	task->deferred_delete_handler.iface = &vy_task_deferred_delete_iface;
+	rlist_create(&task->subtasks);
+	rlist_create(&task->in_subtasks);
+	task->pending_count = 1;
+	task->begin = vy_entry_none();
+	task->end = vy_entry_none();
+	rlist_create(&task->slices);
 	return task;
 }
 
-/** Free a task allocated with vy_task_new(). */
+/** Free a task allocated with vy_task_new() and all its subtasks. */
 static void
 vy_task_delete(struct vy_task *task)
 {
 	assert(task->deferred_delete_batch == NULL);
 	assert(task->deferred_delete_in_progress == 0);
+	assert(rlist_empty(&task->slices));
+	struct vy_task *subtask, *next_subtask;
+	rlist_foreach_entry_safe(subtask, &task->subtasks, in_subtasks,
+				 next_subtask)
+		vy_task_delete(subtask);
+	if (task->begin.stmt != NULL)
+		tuple_unref(task->begin.stmt);
+	if (task->end.stmt != NULL)
+		tuple_unref(task->end.stmt);
 	key_def_delete(task->cmp_def);
 	key_def_delete(task->key_def);
 	vy_lsm_unref(task->lsm);
@@ -408,6 +467,19 @@ vy_worker_pool_put(struct vy_worker *worker)
 	stailq_add_entry(&pool->idle_workers, worker, in_idle);
 }
 
+/**
+ * Put the workers assigned to a task and its subtasks back to
+ * the pool.
+ */
+static void
+vy_task_put_workers(struct vy_task *task)
+{
+	vy_worker_pool_put(task->worker);
+	struct vy_task *subtask;
+	rlist_foreach_entry(subtask, &task->subtasks, in_subtasks)
+		vy_worker_pool_put(subtask->worker);
+}
+
 void
 vy_scheduler_create(struct vy_scheduler *scheduler, int write_threads,
 		    vy_scheduler_dump_complete_f dump_complete_cb,
@@ -420,6 +492,7 @@ vy_scheduler_create(struct vy_scheduler *scheduler, int write_threads,
 	scheduler->read_views = read_views;
 	scheduler->run_env = run_env;
 	scheduler->quota = quota;
+	scheduler->max_subcompactions = 1;
 
 	scheduler->scheduler_fiber = fiber_new_system("vinyl.scheduler",
 						      vy_scheduler_f);
@@ -1119,6 +1192,10 @@ vy_task_write_run(struct vy_task *task, bool no_compression)
 				 task->page_size, task->bloom_fpr,
 				 no_compression) != 0)
 		goto fail;
+	if (task->value_log_threshold > 0 && lsm->index_id == 0 &&
+	    vy_run_writer_enable_value_log(&writer, task->value_log_threshold,
+					   task->vlog_relocate_below) != 0)
+		goto fail_abort_writer;
 
 	if (wi->iface->start(wi) != 0)
 		goto fail_abort_writer;
@@ -1247,7 +1324,8 @@ vy_task_dump_complete(struct vy_task *task)
 	 * Log change in metadata.
 	 */
 	vy_log_tx_begin();
-	vy_log_create_run(lsm->id, new_run->id, dump_lsn, new_run->dump_count);
+	vy_log_create_run(lsm->id, new_run->id, dump_lsn, new_run->dump_count,
+			  new_run->vlog_min_id);
 	for (range = begin_range, i = 0; range != end_range;
 	     range = vy_range_tree_next(&lsm->range_tree, range), i++) {
 		assert(i < lsm->range_count);
@@ -1457,6 +1535,7 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	task->wi = wi;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
 	task->page_size = lsm->opts.page_size;
+	task->value_log_threshold = lsm->value_log_threshold;
 
 	lsm->is_dumping = true;
 	vy_scheduler_update_lsm(scheduler, lsm);
@@ -1498,9 +1577,240 @@ vy_task_compaction_execute(struct vy_task *task)
 	return vy_task_write_run(task, false);
 }
 
+/**
+ * Close the write iterator of a compaction task and delete the
+ * slices cut for it. The iterator has been stopped in worker.
+ */
+static void
+vy_task_compaction_release(struct vy_task *task)
+{
+	if (task->wi != NULL) {
+		task->wi->iface->close(task->wi);
+		task->wi = NULL;
+	}
+	struct vy_slice *slice, *next_slice;
+	rlist_foreach_entry_safe(slice, &task->slices, in_range, next_slice)
+		vy_slice_delete(slice);
+	rlist_create(&task->slices);
+}
+
+/**
+ * Complete compaction of a range that was split into parts.
+ * The range is replaced with new ranges, one per part. Each new
+ * range stores the slice of the run written for its part and
+ * the slices of the range runs that weren't compacted.
+ */
+static int
+vy_task_compaction_complete_split(struct vy_task *task)
+{
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_lsm *lsm = task->lsm;
+	struct vy_range *range = task->range;
+	double compaction_time = ev_monotonic_now(loop()) - task->start_time;
+	struct vy_disk_stmt_counter compaction_input;
+	struct vy_disk_stmt_counter compaction_output;
+	struct vy_slice *first_slice = task->first_slice;
+	struct vy_slice *last_slice = task->last_slice;
+	struct vy_slice *slice, *new_slice;
+	struct vy_run *run;
+
+	struct vy_task *parts[VY_COMPACTION_PARTS_MAX];
+	struct vy_range *new_ranges[VY_COMPACTION_PARTS_MAX];
+	int n_parts = 0;
+	parts[n_parts++] = task;
+	struct vy_task *subtask;
+	rlist_foreach_entry(subtask, &task->subtasks, in_subtasks)
+		parts[n_parts++] = subtask;
+	assert(n_parts > 1 && n_parts <= VY_COMPACTION_PARTS_MAX);
+	memset(new_ranges, 0, sizeof(new_ranges));
+
+	for (int i = 0; i < n_parts; i++)
+		vy_task_compaction_release(parts[i]);
+
+	/* See the comment in vy_task_compaction_complete(). */
+	if (lsm->is_dropped) {
+		for (int i = 0; i < n_parts; i++) {
+			vy_run_discard(parts[i]->new_run);
+			parts[i]->new_run = NULL;
+		}
+		vy_range_heap_insert(&lsm->range_heap, range);
+		vy_scheduler_update_lsm(scheduler, lsm);
+		return 0;
+	}
+
+	/*
+	 * Allocate the new ranges. Slices are added to the list head
+	 * so to preserve the order of the slices list, we have to
+	 * iterate backward. The slice of the new run replaces the
+	 * compacted slices.
+	 */
+	vy_disk_stmt_counter_reset(&compaction_output);
+	for (int i = 0; i < n_parts; i++) {
+		struct vy_task *part = parts[i];
+		struct vy_range *new_range = vy_range_new(vy_log_next_id(),
+							  part->begin,
+							  part->end,
+							  lsm->cmp_def);
+		if (new_range == NULL)
+			goto fail;
+		new_ranges[i] = new_range;
+		bool is_compacted = false;
+		rlist_foreach_entry_reverse(slice, &range->slices, in_range) {
+			if (slice == last_slice) {
+				is_compacted = true;
+				if (!vy_run_is_empty(part->new_run)) {
+					new_slice = vy_slice_new(
+						vy_log_next_id(), part->new_run,
+						vy_entry_none(), vy_entry_none(),
+						lsm->cmp_def);
+					if (new_slice == NULL)
+						goto fail;
+					vy_range_add_slice(new_range, new_slice);
+				}
+			}
+			if (is_compacted) {
+				if (slice == first_slice)
+					is_compacted = false;
+				continue;
+			}
+			if (vy_slice_cut(slice, vy_log_next_id(),
+					 new_range->begin, new_range->end,
+					 lsm->cmp_def, &new_slice) != 0)
+				goto fail;
+			if (new_slice != NULL)
+				vy_range_add_slice(new_range, new_slice);
+		}
+		vy_disk_stmt_counter_add(&compaction_output,
+					 &part->new_run->count);
+	}
+
+	/*
+	 * Build the list of runs that became unused
+	 * as a result of compaction.
+	 */
+	RLIST_HEAD(unused_runs);
+	vy_disk_stmt_counter_reset(&compaction_input);
+	for (slice = first_slice; ; slice = rlist_next_entry(slice, in_range)) {
+		slice->run->compacted_slice_count++;
+		vy_disk_stmt_counter_add(&compaction_input, &slice->count);
+		if (slice == last_slice)
+			break;
+	}
+	for (slice = first_slice; ; slice = rlist_next_entry(slice, in_range)) {
+		run = slice->run;
+		if (run->compacted_slice_count == run->slice_count)
+			rlist_add_entry(&unused_runs, run, in_unused);
+		slice->run->compacted_slice_count = 0;
+		if (slice == last_slice)
+			break;
+	}
+
+	/*
+	 * Log change in metadata.
+	 */
+	vy_log_tx_begin();
+	rlist_foreach_entry(slice, &range->slices, in_range)
+		vy_log_delete_slice(slice->id);
+	vy_log_delete_range(range->id);
+	rlist_foreach_entry(run, &unused_runs, in_unused)
+		vy_log_drop_run(run->id, VY_LOG_GC_LSN_CURRENT);
+	for (int i = 0; i < n_parts; i++) {
+		run = parts[i]->new_run;
+		if (!vy_run_is_empty(run))
+			vy_log_create_run(lsm->id, run->id, run->dump_lsn,
+					  run->dump_count, run->vlog_min_id);
+	}
+	for (int i = 0; i < n_parts; i++) {
+		struct vy_range *new_range = new_ranges[i];
+		vy_log_insert_range(lsm->id, new_range->id,
+				    tuple_data_or_null(new_range->begin.stmt),
+				    tuple_data_or_null(new_range->end.stmt));
+		rlist_foreach_entry(slice, &new_range->slices, in_range)
+			vy_log_insert_slice(new_range->id, slice->run->id,
+					    slice->id,
+					    tuple_data_or_null(slice->begin.stmt),
+					    tuple_data_or_null(slice->end.stmt));
+	}
+	if (vy_log_tx_commit() < 0)
+		goto fail;
+
+	/* See the comment in vy_task_compaction_complete(). */
+	rlist_foreach_entry(run, &unused_runs, in_unused) {
+		if (run->dump_lsn > vy_log_signature() ||
+		    scheduler->run_env->initial_join)
+			vy_run_remove_files(lsm->env->path, lsm->space_id,
+					    lsm->index_id, run->id, true);
+	}
+
+	/*
+	 * Account the new runs that are not empty,
+	 * discard the empty ones.
+	 */
+	for (int i = 0; i < n_parts; i++) {
+		run = parts[i]->new_run;
+		parts[i]->new_run = NULL;
+		if (!vy_run_is_empty(run)) {
+			vy_lsm_add_run(lsm, run);
+			/* Drop the reference held by the task. */
+			vy_run_unref(run);
+		} else {
+			vy_run_discard(run);
+		}
+	}
+
+	/*
+	 * Replace the compacted range with the new ranges. The range
+	 * was removed from the heap when the task was scheduled so
+	 * put it back before removing it from the LSM tree.
+	 */
+	vy_lsm_unacct_range(lsm, range);
+	vy_range_heap_insert(&lsm->range_heap, range);
+	vy_lsm_remove_range(lsm, range);
+	for (int i = 0; i < n_parts; i++) {
+		struct vy_range *new_range = new_ranges[i];
+		new_range->n_compactions = range->n_compactions + 1;
+		new_range->needs_compaction = range->needs_compaction;
+		vy_range_update_compaction_priority(new_range, &lsm->opts);
+		vy_range_update_dumps_per_compaction(new_range);
+		vy_lsm_add_range(lsm, new_range);
+		vy_lsm_acct_range(lsm, new_range);
+	}
+	lsm->range_tree_version++;
+	vy_lsm_acct_compaction(lsm, compaction_time,
+			       &compaction_input, &compaction_output);
+	scheduler->stat.compaction_input += compaction_input.bytes;
+	scheduler->stat.compaction_output += compaction_output.bytes;
+	scheduler->stat.compaction_time += compaction_time;
+
+	/*
+	 * Unaccount unused runs and delete the compacted range.
+	 */
+	rlist_foreach_entry(run, &unused_runs, in_unused)
+		vy_lsm_remove_run(lsm, run);
+	vy_scheduler_update_lsm(scheduler, lsm);
+
+	say_verbose("%s: completed compacting range %s in %d parts",
+		    vy_lsm_name(lsm), vy_range_str(range), n_parts);
+
+	rlist_foreach_entry(slice, &range->slices, in_range)
+		vy_slice_wait_pinned(slice);
+	vy_range_delete(range);
+	task->range = NULL;
+	return 0;
+fail:
+	for (int i = 0; i < n_parts; i++) {
+		if (new_ranges[i] != NULL)
+			vy_range_delete(new_ranges[i]);
+	}
+	return -1;
+}
+
 static int
 vy_task_compaction_complete(struct vy_task *task)
 {
+	if (!rlist_empty(&task->subtasks))
+		return vy_task_compaction_complete_split(task);
+
 	struct vy_scheduler *scheduler = task->scheduler;
 	struct vy_lsm *lsm = task->lsm;
 	struct vy_range *range = task->range;
@@ -1571,7 +1881,7 @@ vy_task_compaction_complete(struct vy_task *task)
 		vy_log_drop_run(run->id, VY_LOG_GC_LSN_CURRENT);
 	if (new_slice != NULL) {
 		vy_log_create_run(lsm->id, new_run->id, new_run->dump_lsn,
-				  new_run->dump_count);
+				  new_run->dump_count, new_run->vlog_min_id);
 		vy_log_insert_slice(range->id, new_run->id, new_slice->id,
 				    tuple_data_or_null(new_slice->begin.stmt),
 				    tuple_data_or_null(new_slice->end.stmt));
@@ -1596,7 +1906,7 @@ vy_task_compaction_complete(struct vy_task *task)
 		if (run->dump_lsn > vy_log_signature() ||
 		    scheduler->run_env->initial_join)
 			vy_run_remove_files(lsm->env->path, lsm->space_id,
-					    lsm->index_id, run->id);
+					    lsm->index_id, run->id, true);
 	}
 
 	/*
@@ -1672,8 +1982,7 @@ vy_task_compaction_abort(struct vy_task *task)
 	struct vy_lsm *lsm = task->lsm;
 	struct vy_range *range = task->range;
 
-	/* The iterator has been cleaned up in worker. */
-	task->wi->iface->close(task->wi);
+	vy_task_compaction_release(task);
 
 	struct error *e = diag_last_error(&task->diag);
 	error_log(e);
@@ -1681,12 +1990,184 @@ vy_task_compaction_abort(struct vy_task *task)
 		  vy_lsm_name(lsm), vy_range_str(range));
 
 	vy_run_discard(task->new_run);
+	struct vy_task *subtask;
+	rlist_foreach_entry(subtask, &task->subtasks, in_subtasks) {
+		vy_task_compaction_release(subtask);
+		vy_run_discard(subtask->new_run);
+	}
 
 	assert(heap_node_is_stray(&range->heap_node));
 	vy_range_heap_insert(&lsm->range_heap, range);
 	vy_scheduler_update_lsm(scheduler, lsm);
 }
 
+/**
+ * Split compaction of a range into parts that will be executed in
+ * parallel by idle compaction workers if the range is big enough.
+ * A subtask is allocated for each part but the first one, which is
+ * compacted by the task itself. On success, the key range of each
+ * part is stored in vy_task::begin and vy_task::end.
+ */
+static int
+vy_task_compaction_split(struct vy_task *task)
+{
+	static struct vy_task_ops compaction_subtask_ops = {
+		.execute = vy_task_compaction_execute,
+		.complete = NULL,
+		.abort = NULL,
+	};
+
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_lsm *lsm = task->lsm;
+	struct vy_range *range = task->range;
+
+	if (scheduler->max_subcompactions <= 1)
+		return 0;
+	/*
+	 * Every part should be at least as big as the target range
+	 * size, otherwise the new ranges would be coalesced back.
+	 * Split keys are taken from the biggest compacted slice.
+	 */
+	int64_t input_size = 0;
+	struct vy_slice *slice, *biggest_slice = NULL;
+	for (slice = task->first_slice; ;
+	     slice = rlist_next_entry(slice, in_range)) {
+		input_size += slice->count.bytes;
+		if (biggest_slice == NULL ||
+		    slice->count.bytes > biggest_slice->count.bytes)
+			biggest_slice = slice;
+		if (slice == task->last_slice)
+			break;
+	}
+	int64_t n_parts = input_size / vy_lsm_range_size(lsm);
+	n_parts = MIN(n_parts, scheduler->max_subcompactions);
+	n_parts = MIN(n_parts, VY_COMPACTION_PARTS_MAX);
+	if (n_parts <= 1)
+		return 0;
+
+	/* Use only the workers that are currently idle. */
+	struct vy_worker *workers[VY_COMPACTION_PARTS_MAX - 1];
+	int n_workers = 0;
+	while (n_workers < n_parts - 1) {
+		struct vy_worker *worker =
+			vy_worker_pool_get(&scheduler->compaction_pool);
+		if (worker == NULL)
+			break;
+		workers[n_workers++] = worker;
+	}
+	const char *split_keys[VY_COMPACTION_PARTS_MAX - 1];
+	if (n_workers > 0) {
+		n_parts = vy_range_compaction_split_keys(range, biggest_slice,
+							 n_workers + 1,
+							 split_keys);
+	} else {
+		n_parts = 1;
+	}
+	while (n_workers > n_parts - 1)
+		vy_worker_pool_put(workers[--n_workers]);
+	if (n_parts <= 1)
+		return 0;
+
+	int rc = -1;
+	int n_keys = 0;
+	struct vy_entry keys[VY_COMPACTION_PARTS_MAX + 1];
+	keys[0] = range->begin;
+	keys[n_parts] = range->end;
+	for (int i = 1; i < n_parts; i++) {
+		keys[i] = vy_entry_key_from_msgpack(lsm->env->key_format,
+						    lsm->cmp_def,
+						    split_keys[i - 1]);
+		if (keys[i].stmt == NULL)
+			goto out;
+		n_keys++;
+	}
+	for (int i = 0; i < n_parts; i++) {
+		struct vy_task *part = task;
+		if (i > 0) {
+			part = vy_task_new(scheduler, workers[i - 1], lsm,
+					   &compaction_subtask_ops);
+			if (part == NULL)
+				goto out;
+			workers[i - 1] = NULL;
+			part->parent = task;
+			part->range = range;
+			part->first_slice = task->first_slice;
+			part->last_slice = task->last_slice;
+			part->bloom_fpr = task->bloom_fpr;
+			part->page_size = task->page_size;
+			part->value_log_threshold = task->value_log_threshold;
+			part->vlog_relocate_below = task->vlog_relocate_below;
+			rlist_add_tail_entry(&task->subtasks, part,
+					     in_subtasks);
+			task->pending_count++;
+		}
+		part->begin = keys[i];
+		if (part->begin.stmt != NULL)
+			tuple_ref(part->begin.stmt);
+		part->end = keys[i + 1];
+		if (part->end.stmt != NULL)
+			tuple_ref(part->end.stmt);
+	}
+	rc = 0;
+out:
+	for (int i = 1; i <= n_keys; i++)
+		tuple_unref(keys[i].stmt);
+	/* Return the workers that weren't assigned to subtasks. */
+	for (int i = 0; i < n_workers; i++) {
+		if (workers[i] != NULL)
+			vy_worker_pool_put(workers[i]);
+	}
+	return rc;
+}
+
+/**
+ * Create the run written by a compaction task and the write iterator
+ * over the compacted slices. If compaction is split into parts, the
+ * iterator reads only the slices cut by the part key range.
+ */
+static int
+vy_task_compaction_prepare(struct vy_task *task, bool is_split,
+			   bool is_last_level, int64_t dump_lsn,
+			   uint32_t dump_count)
+{
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_lsm *lsm = task->lsm;
+
+	task->new_run = vy_run_prepare(scheduler->run_env, lsm);
+	if (task->new_run == NULL)
+		return -1;
+	task->new_run->dump_lsn = dump_lsn;
+	task->new_run->dump_count = dump_count;
+
+	task->wi = vy_write_iterator_new(task->cmp_def, lsm->index_id == 0,
+					 is_last_level, scheduler->read_views,
+					 lsm->index_id > 0 ? NULL :
+					 &task->deferred_delete_handler);
+	if (task->wi == NULL)
+		return -1;
+
+	struct vy_slice *slice;
+	for (slice = task->first_slice; ;
+	     slice = rlist_next_entry(slice, in_range)) {
+		struct vy_slice *src = slice;
+		if (is_split) {
+			if (vy_slice_cut(slice, vy_log_next_id(), task->begin,
+					 task->end, lsm->cmp_def, &src) != 0)
+				return -1;
+			if (src != NULL)
+				rlist_add_tail_entry(&task->slices, src,
+						     in_range);
+		}
+		if (src != NULL &&
+		    vy_write_iterator_new_slice(task->wi, src,
+						lsm->disk_format) != 0)
+			return -1;
+		if (slice == task->last_slice)
+			break;
+	}
+	return 0;
+}
+
 static int
 vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 		       struct vy_lsm *lsm, struct vy_task **p_task)
@@ -1712,28 +2193,12 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	if (task == NULL)
 		goto err_task;
 
-	struct vy_run *new_run = vy_run_prepare(scheduler->run_env, lsm);
-	if (new_run == NULL)
-		goto err_run;
-
-	struct vy_stmt_stream *wi;
-	bool is_last_level = (range->compaction_priority == range->slice_count);
-	wi = vy_write_iterator_new(task->cmp_def, lsm->index_id == 0,
-				   is_last_level, scheduler->read_views,
-				   lsm->index_id > 0 ? NULL :
-				   &task->deferred_delete_handler);
-	if (wi == NULL)
-		goto err_wi;
-
 	struct vy_slice *slice;
+	int64_t dump_lsn = -1;
 	int32_t dump_count = 0;
 	int n = range->compaction_priority;
 	rlist_foreach_entry(slice, &range->slices, in_range) {
-		if (vy_write_iterator_new_slice(wi, slice,
-						lsm->disk_format) != 0)
-			goto err_wi_sub;
-		new_run->dump_lsn = MAX(new_run->dump_lsn,
-					slice->run->dump_lsn);
+		dump_lsn = MAX(dump_lsn, slice->run->dump_lsn);
 		dump_count += slice->run->dump_count;
 		/* Remember the slices we are compacting. */
 		if (task->first_slice == NULL)
@@ -1744,7 +2209,7 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 			break;
 	}
 	assert(n == 0);
-	assert(new_run->dump_lsn >= 0);
+	assert(dump_lsn >= 0);
 	if (range->compaction_priority == range->slice_count)
 		dump_count -= slice->run->dump_count;
 	/*
@@ -1753,17 +2218,36 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	 * such as splitting/coalescing ranges for no good reason.
 	 */
 	if (range->needs_compaction)
-		new_run->dump_count = slice->run->dump_count;
-	else
-		new_run->dump_count = dump_count;
-
-	range->needs_compaction = false;
+		dump_count = slice->run->dump_count;
 
 	task->range = range;
-	task->new_run = new_run;
-	task->wi = wi;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
 	task->page_size = lsm->opts.page_size;
+	task->value_log_threshold = lsm->value_log_threshold;
+	/*
+	 * Major compaction copies values stored in value logs older
+	 * than the oldest compacted run so that they can be deleted.
+	 */
+	if (range->compaction_priority == range->slice_count)
+		task->vlog_relocate_below = task->last_slice->run->id;
+
+	struct vy_task *subtask;
+	if (vy_task_compaction_split(task) != 0)
+		goto err;
+
+	bool is_split = !rlist_empty(&task->subtasks);
+	bool is_last_level = (range->compaction_priority == range->slice_count);
+	if (vy_task_compaction_prepare(task, is_split, is_last_level,
+				       dump_lsn, dump_count) != 0)
+		goto err;
+	rlist_foreach_entry(subtask, &task->subtasks, in_subtasks) {
+		if (vy_task_compaction_prepare(subtask, is_split,
+					       is_last_level, dump_lsn,
+					       dump_count) != 0)
+			goto err;
+	}
+
+	range->needs_compaction = false;
 
 	/*
 	 * Remove the range we are going to compact from the heap
@@ -1772,17 +2256,29 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	vy_range_heap_delete(&lsm->range_heap, range);
 	vy_scheduler_update_lsm(scheduler, lsm);
 
-	say_verbose("%s: started compacting range %s, runs %d/%d",
-		    vy_lsm_name(lsm), vy_range_str(range),
-		    range->compaction_priority, range->slice_count);
+	if (is_split) {
+		say_verbose("%s: started compacting range %s, runs %d/%d, "
+			    "parts %d", vy_lsm_name(lsm), vy_range_str(range),
+			    range->compaction_priority, range->slice_count,
+			    task->pending_count);
+	} else {
+		say_verbose("%s: started compacting range %s, runs %d/%d",
+			    vy_lsm_name(lsm), vy_range_str(range),
+			    range->compaction_priority, range->slice_count);
+	}
 	*p_task = task;
 	return 0;
 
-err_wi_sub:
-	task->wi->iface->close(wi);
-err_wi:
-	vy_run_discard(new_run);
-err_run:
+err:
+	rlist_foreach_entry(subtask, &task->subtasks, in_subtasks) {
+		vy_task_compaction_release(subtask);
+		if (subtask->new_run != NULL)
+			vy_run_discard(subtask->new_run);
+		vy_worker_pool_put(subtask->worker);
+	}
+	vy_task_compaction_release(task);
+	if (task->new_run != NULL)
+		vy_run_discard(task->new_run);
 	vy_task_delete(task);
 err_task:
 	diag_log();
@@ -1855,11 +2351,32 @@ static void
 vy_task_complete_f(struct cmsg *cmsg)
 {
 	struct vy_task *task = container_of(cmsg, struct vy_task, cmsg);
+	if (task->parent != NULL)
+		task = task->parent;
+	/* Wait for all subtasks before completing the task. */
+	if (--task->pending_count > 0)
+		return;
 	stailq_add_tail_entry(&task->scheduler->processed_tasks,
 			      task, in_processed);
 	fiber_cond_signal(&task->scheduler->scheduler_cond);
 }
 
+/**
+ * Send a task and all its subtasks to the assigned worker threads
+ * for execution.
+ */
+static void
+vy_task_submit(struct vy_task *task)
+{
+	cmsg_init(&task->cmsg, vy_task_execute_route);
+	cpipe_push(&task->worker->worker_pipe, &task->cmsg);
+	struct vy_task *subtask;
+	rlist_foreach_entry(subtask, &task->subtasks, in_subtasks) {
+		cmsg_init(&subtask->cmsg, vy_task_execute_route);
+		cpipe_push(&subtask->worker->worker_pipe, &subtask->cmsg);
+	}
+}
+
 /**
  * Create a task for dumping an LSM tree. The new task is returned
  * in @ptask. If there's no LSM tree that needs to be dumped or all
@@ -2041,6 +2558,14 @@ vy_task_complete(struct vy_task *task)
 	scheduler->stat.tasks_inprogress--;
 
 	struct diag *diag = &task->diag;
+	struct vy_task *subtask;
+	rlist_foreach_entry(subtask, &task->subtasks, in_subtasks) {
+		if (subtask->is_failed && !task->is_failed) {
+			assert(!diag_is_empty(&subtask->diag));
+			diag_move(&subtask->diag, diag);
+			task->is_failed = true;
+		}
+	}
 	if (task->is_failed) {
 		assert(!diag_is_empty(diag));
 		goto fail; /* ->execute fialed */
@@ -2086,7 +2611,7 @@ vy_scheduler_complete_tasks(struct vy_scheduler *scheduler, int *tasks_done,
 				(*tasks_done)++;
 			else
 				(*tasks_failed)++;
-			vy_worker_pool_put(task->worker);
+			vy_task_put_workers(task);
 			vy_task_delete(task);
 		}
 	}
@@ -2130,8 +2655,7 @@ vy_scheduler_f(va_list va)
 		}
 
 		/* Queue the task for execution. */
-		cmsg_init(&task->cmsg, vy_task_execute_route);
-		cpipe_push(&task->worker->worker_pipe, &task->cmsg);
+		vy_task_submit(task);
 
 		fiber_reschedule();
 		continue;
@@ -143,6 +143,11 @@ struct vy_scheduler {
 	struct fiber_cond dump_cond;
 	/** Scheduler statistics. */
 	struct vy_scheduler_stat stat;
+	/**
+	 * Max number of parts compaction of a range can be split
+	 * into to be executed by worker threads in parallel.
+	 */
+	int max_subcompactions;
 	/**
 	 * Function called by the scheduler upon dump round
 	 * completion. It is supposed to free memory released
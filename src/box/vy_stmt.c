@@ -75,8 +75,10 @@ vy_stmt_persistent_flags(struct tuple *stmt, bool is_primary)
 		 * Do not store VY_STMT_DEFERRED_DELETE flag in
 		 * secondary index runs as deferred DELETEs may
 		 * only be generated by primary index compaction.
+		 * Values are never moved out of secondary index
+		 * statements either.
 		 */
-		mask &= ~VY_STMT_DEFERRED_DELETE;
+		mask &= ~(VY_STMT_DEFERRED_DELETE | VY_STMT_VALUE_REFS);
 	}
 	return vy_stmt_flags(stmt) & mask;
 }
@@ -141,11 +141,19 @@ enum {
 	 * compaction. It is never written to disk.
 	 */
 	VY_STMT_UPDATE			= 1 << 2,
+	/**
+	 * This flag is set for REPLACE and INSERT statements stored
+	 * in primary index runs in which some fields were replaced
+	 * with references to values stored in value logs, see
+	 * vy_value_log.h. It's cleared when the references are
+	 * resolved on read.
+	 */
+	VY_STMT_VALUE_REFS		= 1 << 3,
 	/**
 	 * Bit mask of all statement flags.
 	 */
 	VY_STMT_FLAGS_ALL = (VY_STMT_DEFERRED_DELETE | VY_STMT_SKIP_READ |
-			     VY_STMT_UPDATE),
+			     VY_STMT_UPDATE | VY_STMT_VALUE_REFS),
 };
 
 /**
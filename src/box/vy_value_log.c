@@ -0,0 +1,547 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2025, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "vy_value_log.h"
+
+#include <assert.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <msgpuck.h>
+#include <small/region.h>
+
+#include "crc32.h"
+#include "diag.h"
+#include "error.h"
+#include "fiber.h"
+#include "fio.h"
+#include "mp_extension_types.h"
+#include "trivia/util.h"
+#include "tt_pthread.h"
+#include "tt_static.h"
+#include "tuple.h"
+#include "tuple_format.h"
+#include "vy_run.h"
+#include "vy_stmt.h"
+
+/** Reference to a value stored in a value log. */
+struct vy_value_ref {
+	/** ID of the value log. */
+	int64_t vlog_id;
+	/** Offset of the value in the value log file. */
+	uint64_t offset;
+	/** Size of the value. */
+	uint32_t size;
+	/** Checksum of the value. */
+	uint32_t crc32;
+};
+
+enum {
+	/** Number of members in an encoded value reference. */
+	VY_VALUE_REF_MEMBER_COUNT = 4,
+	/** Max size of an encoded value reference. */
+	VY_VALUE_REF_SIZE_MAX = 6 + 1 + 9 + 9 + 5 + 5,
+};
+
+/** Return true if the given MsgPack value is a value reference. */
+static inline bool
+vy_value_ref_check(const char *data)
+{
+	if (mp_typeof(*data) != MP_EXT)
+		return false;
+	int8_t type;
+	mp_decode_extl(&data, &type);
+	return type == MP_VALUE_REF;
+}
+
+/**
+ * Decode a value reference. The reference is encoded as MP_EXT of type
+ * MP_VALUE_REF with a MsgPack array [vlog_id, offset, size, crc32].
+ */
+static int
+vy_value_ref_decode(const char **data, struct vy_value_ref *ref)
+{
+	int8_t type;
+	uint32_t len = mp_decode_extl(data, &type);
+	assert(type == MP_VALUE_REF);
+	const char *pos = *data;
+	const char *end = pos + len;
+	*data = end;
+	const char *tmp = pos;
+	if (mp_check(&tmp, end) != 0 || tmp != end ||
+	    mp_typeof(*pos) != MP_ARRAY ||
+	    mp_decode_array(&pos) != VY_VALUE_REF_MEMBER_COUNT)
+		goto invalid;
+	uint64_t members[VY_VALUE_REF_MEMBER_COUNT];
+	for (int i = 0; i < VY_VALUE_REF_MEMBER_COUNT; i++) {
+		if (mp_typeof(*pos) != MP_UINT)
+			goto invalid;
+		members[i] = mp_decode_uint(&pos);
+	}
+	if (members[0] > INT64_MAX || members[2] > UINT32_MAX ||
+	    members[3] > UINT32_MAX)
+		goto invalid;
+	ref->vlog_id = members[0];
+	ref->offset = members[1];
+	ref->size = members[2];
+	ref->crc32 = members[3];
+	return 0;
+invalid:
+	diag_set(ClientError, ER_INVALID_RUN_FILE, "Invalid value reference");
+	return -1;
+}
+
+/** Encode a value reference. */
+static char *
+vy_value_ref_encode(char *data, const struct vy_value_ref *ref)
+{
+	uint32_t len = mp_sizeof_array(VY_VALUE_REF_MEMBER_COUNT) +
+		       mp_sizeof_uint(ref->vlog_id) +
+		       mp_sizeof_uint(ref->offset) +
+		       mp_sizeof_uint(ref->size) +
+		       mp_sizeof_uint(ref->crc32);
+	assert(mp_sizeof_ext(len) <= VY_VALUE_REF_SIZE_MAX);
+	data = mp_encode_extl(data, MP_VALUE_REF, len);
+	data = mp_encode_array(data, VY_VALUE_REF_MEMBER_COUNT);
+	data = mp_encode_uint(data, ref->vlog_id);
+	data = mp_encode_uint(data, ref->offset);
+	data = mp_encode_uint(data, ref->size);
+	data = mp_encode_uint(data, ref->crc32);
+	return data;
+}
+
+/** Format the path to a value log file. */
+static int
+vy_value_log_snprint_path(char *buf, int size, const char *dir, int64_t id,
+			  enum vy_file_type type)
+{
+	int total = 0;
+	SNPRINT(total, snprintf, buf, size, "%s/", dir);
+	SNPRINT(total, vy_run_snprint_filename, buf, size, id, type);
+	return total;
+}
+
+void
+vy_value_log_reader_create(struct vy_value_log_reader *reader,
+			   const char *dir)
+{
+	reader->dir = dir;
+	reader->file_count = 0;
+	reader->next_victim = 0;
+	tt_pthread_mutex_init(&reader->mutex, NULL);
+}
+
+/** Close all files opened by a value log reader. */
+static void
+vy_value_log_reader_close(struct vy_value_log_reader *reader)
+{
+	for (int i = 0; i < reader->file_count; i++) {
+		assert(reader->files[i].refs == 0);
+		close(reader->files[i].fd);
+	}
+	reader->file_count = 0;
+	reader->next_victim = 0;
+}
+
+void
+vy_value_log_reader_destroy(struct vy_value_log_reader *reader)
+{
+	vy_value_log_reader_close(reader);
+	tt_pthread_mutex_destroy(&reader->mutex);
+}
+
+/**
+ * Return the descriptor of the value log file with the given ID,
+ * opening the file if necessary, and pin it so that it isn't closed
+ * until vy_value_log_reader_unpin() is called. The index of the file
+ * in the reader is returned in @a slot. If all files are pinned, the
+ * new file isn't cached and @a slot is set to -1. Returns -1 on error.
+ */
+static int
+vy_value_log_reader_pin(struct vy_value_log_reader *reader, int64_t id,
+			int *slot)
+{
+	int fd = -1;
+	tt_pthread_mutex_lock(&reader->mutex);
+	for (int i = 0; i < reader->file_count; i++) {
+		if (reader->files[i].id == id) {
+			reader->files[i].refs++;
+			*slot = i;
+			fd = reader->files[i].fd;
+			goto out;
+		}
+	}
+	char path[PATH_MAX];
+	vy_value_log_snprint_path(path, sizeof(path), reader->dir, id,
+				  VY_FILE_VLOG);
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		diag_set(SystemError, "failed to open value log file '%s'",
+			 path);
+		goto out;
+	}
+	*slot = -1;
+	if (reader->file_count < VY_VALUE_LOG_READER_FILES_MAX) {
+		*slot = reader->file_count++;
+	} else {
+		for (int i = 0; i < VY_VALUE_LOG_READER_FILES_MAX; i++) {
+			int victim = (reader->next_victim + i) %
+				     VY_VALUE_LOG_READER_FILES_MAX;
+			if (reader->files[victim].refs == 0) {
+				*slot = victim;
+				break;
+			}
+		}
+		if (*slot < 0)
+			goto out;
+		reader->next_victim = (*slot + 1) %
+				      VY_VALUE_LOG_READER_FILES_MAX;
+		close(reader->files[*slot].fd);
+	}
+	reader->files[*slot].id = id;
+	reader->files[*slot].fd = fd;
+	reader->files[*slot].refs = 1;
+out:
+	tt_pthread_mutex_unlock(&reader->mutex);
+	return fd;
+}
+
+/** Unpin a file descriptor returned by vy_value_log_reader_pin(). */
+static void
+vy_value_log_reader_unpin(struct vy_value_log_reader *reader, int slot,
+			  int fd)
+{
+	if (slot < 0) {
+		close(fd);
+		return;
+	}
+	tt_pthread_mutex_lock(&reader->mutex);
+	assert(reader->files[slot].fd == fd);
+	assert(reader->files[slot].refs > 0);
+	reader->files[slot].refs--;
+	tt_pthread_mutex_unlock(&reader->mutex);
+}
+
+/** Read a value given a reference to it and check its checksum. */
+static int
+vy_value_log_reader_read(struct vy_value_log_reader *reader,
+			 const struct vy_value_ref *ref, char *buf)
+{
+	int slot;
+	int fd = vy_value_log_reader_pin(reader, ref->vlog_id, &slot);
+	if (fd < 0)
+		return -1;
+	ssize_t size = fio_pread(fd, buf, ref->size, ref->offset);
+	vy_value_log_reader_unpin(reader, slot, fd);
+	if (size < 0) {
+		diag_set(SystemError, "failed to read from value log file");
+		return -1;
+	}
+	if (size != (ssize_t)ref->size ||
+	    crc32_calc(0, buf, ref->size) != ref->crc32) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 tt_sprintf("Invalid value log %lld: checksum "
+				    "mismatch at offset %llu",
+				    (long long)ref->vlog_id,
+				    (unsigned long long)ref->offset));
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Allocate a new statement with the given data and the type, LSN and
+ * flags of the given statement.
+ */
+static struct tuple *
+vy_value_log_stmt_new(struct tuple *stmt, const char *data,
+		      const char *data_end, uint8_t flags)
+{
+	struct tuple *result;
+	if (vy_stmt_type(stmt) == IPROTO_INSERT) {
+		result = vy_stmt_new_insert(tuple_format(stmt),
+					    data, data_end);
+	} else {
+		assert(vy_stmt_type(stmt) == IPROTO_REPLACE);
+		result = vy_stmt_new_replace(tuple_format(stmt),
+					     data, data_end);
+	}
+	if (result == NULL)
+		return NULL;
+	vy_stmt_set_lsn(result, vy_stmt_lsn(stmt));
+	vy_stmt_set_flags(result, flags);
+	return result;
+}
+
+int
+vy_value_log_resolved_size(struct tuple *stmt, size_t *size,
+			   size_t *read_size)
+{
+	assert((vy_stmt_flags(stmt) & VY_STMT_VALUE_REFS) != 0);
+	uint32_t bsize;
+	const char *data = tuple_data_range(stmt, &bsize);
+	struct vy_value_ref ref;
+	*size = bsize;
+	*read_size = 0;
+	const char *pos = data;
+	uint32_t field_count = mp_decode_array(&pos);
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		if (!vy_value_ref_check(field)) {
+			mp_next(&pos);
+			continue;
+		}
+		if (vy_value_ref_decode(&pos, &ref) != 0)
+			return -1;
+		*size += ref.size;
+		*size -= pos - field;
+		*read_size += ref.size;
+	}
+	return 0;
+}
+
+int
+vy_value_log_reader_resolve(struct vy_value_log_reader *reader,
+			    struct tuple *stmt, char *buf, size_t size)
+{
+	assert((vy_stmt_flags(stmt) & VY_STMT_VALUE_REFS) != 0);
+	const char *pos = tuple_data(stmt);
+	struct vy_value_ref ref;
+	uint32_t field_count = mp_decode_array(&pos);
+	char *buf_pos = mp_encode_array(buf, field_count);
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		if (!vy_value_ref_check(field)) {
+			mp_next(&pos);
+			memcpy(buf_pos, field, pos - field);
+			buf_pos += pos - field;
+			continue;
+		}
+		if (vy_value_ref_decode(&pos, &ref) != 0 ||
+		    vy_value_log_reader_read(reader, &ref, buf_pos) != 0)
+			return -1;
+		buf_pos += ref.size;
+	}
+	assert(buf_pos == buf + size);
+	(void)size;
+	return 0;
+}
+
+struct tuple *
+vy_value_log_stmt_new_resolved(struct tuple *stmt, const char *data,
+			       const char *data_end)
+{
+	assert((vy_stmt_flags(stmt) & VY_STMT_VALUE_REFS) != 0);
+	return vy_value_log_stmt_new(stmt, data, data_end,
+				     vy_stmt_flags(stmt) & ~VY_STMT_VALUE_REFS);
+}
+
+int
+vy_value_log_writer_create(struct vy_value_log_writer *writer,
+			   const char *dir, int64_t id, uint32_t threshold,
+			   int64_t relocate_below)
+{
+	assert(threshold > 0);
+	vy_value_log_reader_create(&writer->reader, dir);
+	writer->id = id;
+	writer->offset = 0;
+	writer->threshold = threshold;
+	writer->relocate_below = relocate_below;
+	writer->min_id = id;
+	char path[PATH_MAX];
+	vy_value_log_snprint_path(path, sizeof(path), dir, id,
+				  VY_FILE_VLOG_INPROGRESS);
+	writer->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (writer->fd < 0) {
+		diag_set(SystemError, "failed to create value log file '%s'",
+			 path);
+		return -1;
+	}
+	return 0;
+}
+
+/** Append a value to the value log and fill a reference to it. */
+static int
+vy_value_log_writer_append(struct vy_value_log_writer *writer,
+			   const char *value, uint32_t size,
+			   struct vy_value_ref *ref)
+{
+	if (fio_writen(writer->fd, value, size) != 0) {
+		diag_set(SystemError, "failed to write value log file");
+		return -1;
+	}
+	ref->vlog_id = writer->id;
+	ref->offset = writer->offset;
+	ref->size = size;
+	ref->crc32 = crc32_calc(0, value, size);
+	writer->offset += size;
+	return 0;
+}
+
+/**
+ * Return true if the given field of a statement should be stored in
+ * the value log.
+ */
+static inline bool
+vy_value_log_writer_needs_field(struct vy_value_log_writer *writer,
+				struct tuple_format *format, uint32_t fieldno,
+				const char *field, const char *field_end)
+{
+	enum mp_type type = mp_typeof(*field);
+	if (type != MP_STR && type != MP_BIN)
+		return false;
+	uint32_t size = field_end - field;
+	if (size < writer->threshold || size <= VY_VALUE_REF_SIZE_MAX)
+		return false;
+	return fieldno >= tuple_format_field_count(format) ||
+	       !tuple_format_field(format, fieldno)->is_key_part;
+}
+
+int
+vy_value_log_writer_process(struct vy_value_log_writer *writer,
+			    struct tuple *stmt, struct tuple **result)
+{
+	*result = NULL;
+	enum iproto_type type = vy_stmt_type(stmt);
+	if (type != IPROTO_REPLACE && type != IPROTO_INSERT)
+		return 0;
+	struct tuple_format *format = tuple_format(stmt);
+	bool has_refs = (vy_stmt_flags(stmt) & VY_STMT_VALUE_REFS) != 0;
+	uint32_t bsize;
+	const char *data = tuple_data_range(stmt, &bsize);
+	struct vy_value_ref ref;
+
+	/*
+	 * Check if the statement needs to be rewritten and account
+	 * the value logs referenced by it.
+	 */
+	bool needs_rewrite = false;
+	int64_t min_id = writer->min_id;
+	const char *pos = data;
+	uint32_t field_count = mp_decode_array(&pos);
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		if (vy_value_ref_check(field)) {
+			/*
+			 * A user value that looks like a reference.
+			 * Leave the statement as is so as not to
+			 * confuse it with a reference on read.
+			 */
+			if (!has_refs)
+				return 0;
+			if (vy_value_ref_decode(&pos, &ref) != 0)
+				return -1;
+			if (ref.vlog_id < writer->relocate_below)
+				needs_rewrite = true;
+			else
+				min_id = MIN(min_id, ref.vlog_id);
+			continue;
+		}
+		mp_next(&pos);
+		if (vy_value_log_writer_needs_field(writer, format, i,
+						    field, pos))
+			needs_rewrite = true;
+	}
+	writer->min_id = min_id;
+	if (!needs_rewrite)
+		return 0;
+
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	size_t size = bsize + (size_t)field_count * VY_VALUE_REF_SIZE_MAX;
+	char *buf = region_alloc(region, size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc", "tuple");
+		return -1;
+	}
+	char *buf_pos = mp_encode_array(buf, field_count);
+	pos = data;
+	mp_decode_array(&pos);
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		if (vy_value_ref_check(field)) {
+			if (vy_value_ref_decode(&pos, &ref) != 0)
+				goto fail;
+			if (ref.vlog_id < writer->relocate_below) {
+				/* Copy the value to the new value log. */
+				char *value = region_alloc(region, ref.size);
+				if (value == NULL) {
+					diag_set(OutOfMemory, ref.size,
+						 "region_alloc", "value");
+					goto fail;
+				}
+				if (vy_value_log_reader_read(&writer->reader,
+							     &ref, value) != 0 ||
+				    vy_value_log_writer_append(writer, value,
+							       ref.size,
+							       &ref) != 0)
+					goto fail;
+			}
+			buf_pos = vy_value_ref_encode(buf_pos, &ref);
+			continue;
+		}
+		mp_next(&pos);
+		if (vy_value_log_writer_needs_field(writer, format, i,
+						    field, pos)) {
+			if (vy_value_log_writer_append(writer, field,
+						       pos - field, &ref) != 0)
+				goto fail;
+			buf_pos = vy_value_ref_encode(buf_pos, &ref);
+			continue;
+		}
+		memcpy(buf_pos, field, pos - field);
+		buf_pos += pos - field;
+	}
+	assert(buf_pos <= buf + size);
+	*result = vy_value_log_stmt_new(stmt, buf, buf_pos,
+					vy_stmt_flags(stmt) | VY_STMT_VALUE_REFS);
+	region_truncate(region, region_svp);
+	return *result != NULL ? 0 : -1;
+fail:
+	region_truncate(region, region_svp);
+	return -1;
+}
+
+int
+vy_value_log_writer_commit(struct vy_value_log_writer *writer)
+{
+	char path[PATH_MAX];
+	char new_path[PATH_MAX];
+	vy_value_log_snprint_path(path, sizeof(path), writer->reader.dir,
+				  writer->id, VY_FILE_VLOG_INPROGRESS);
+	vy_value_log_snprint_path(new_path, sizeof(new_path),
+				  writer->reader.dir, writer->id,
+				  VY_FILE_VLOG);
+	if (fsync(writer->fd) != 0) {
+		diag_set(SystemError, "failed to sync value log file '%s'",
+			 path);
+		return -1;
+	}
+	if (rename(path, new_path) != 0) {
+		diag_set(SystemError, "failed to rename value log file '%s'",
+			 path);
+		return -1;
+	}
+	close(writer->fd);
+	writer->fd = -1;
+	vy_value_log_reader_destroy(&writer->reader);
+	return 0;
+}
+
+void
+vy_value_log_writer_abort(struct vy_value_log_writer *writer)
+{
+	char path[PATH_MAX];
+	vy_value_log_snprint_path(path, sizeof(path), writer->reader.dir,
+				  writer->id, VY_FILE_VLOG_INPROGRESS);
+	if (writer->fd >= 0) {
+		close(writer->fd);
+		writer->fd = -1;
+		unlink(path);
+	}
+	vy_value_log_reader_destroy(&writer->reader);
+}
@@ -0,0 +1,207 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2025, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct tuple;
+
+/**
+ * Value logs are used for storing big fields of tuples out of
+ * primary index runs of vinyl spaces that have the value_log_threshold
+ * option set so that compaction doesn't have to rewrite them.
+ *
+ * When a primary index run is written, each string or binary field
+ * that isn't indexed and takes at least value_log_threshold bytes is
+ * appended to the value log file created for the run (the file has the
+ * same ID as the run) and replaced in the statement with a reference
+ * to the value (MP_EXT of type MP_VALUE_REF). Statements with references
+ * are marked with VY_STMT_VALUE_REFS.
+ *
+ * Compaction passes references through as is so a run may reference
+ * values stored in value logs of older runs. The only exception is
+ * major compaction, which copies values stored in value logs older than
+ * the oldest compacted run to the value log of the new run. This way
+ * garbage accumulated in old value logs is eventually reclaimed while
+ * a value is copied at most once per two major compactions.
+ *
+ * References are resolved by a run iterator only for statements it
+ * returns, not for whole pages, so the page cache stores statements
+ * with references and a lookup reads only the values it needs. Values
+ * are read in a reader thread using the file descriptors cached in the
+ * run, see vy_run::vlog_reader, while the statement with the values is
+ * allocated in the tx thread.
+ *
+ * A run that has a value log may reference only value logs with IDs in
+ * range [vlog_min_id, run_id] where vlog_min_id is stored in the vylog.
+ * A value log is deleted by garbage collection when the run it was
+ * created for is deleted and no other run may reference it.
+ *
+ * Live bytes aren't tracked per value log, so the space taken by value
+ * logs is bounded only by the compaction schedule: a value log is
+ * deleted after each range containing statements written along with it
+ * has been compacted by major compaction twice (the first one replaces
+ * the runs referencing the value log with a run that may still reference
+ * it, the second one copies the values that are still alive). Until then
+ * it keeps all the values written to it, including overwritten and
+ * deleted ones.
+ */
+
+/** Value log files opened by a reader. */
+enum { VY_VALUE_LOG_READER_FILES_MAX = 8 };
+
+/**
+ * Reader of values stored in value logs of an LSM tree. The reader may
+ * be used by a few threads concurrently. The mutex is taken only to
+ * look up or open a file while values are read without it.
+ */
+struct vy_value_log_reader {
+	/** Path to the directory storing value logs. */
+	const char *dir;
+	/** Value log files opened by the reader. */
+	struct {
+		/** ID of the value log. */
+		int64_t id;
+		/** File descriptor. */
+		int fd;
+		/**
+		 * Number of reads using the file descriptor. A file
+		 * can't be closed while it's being read.
+		 */
+		int refs;
+	} files[VY_VALUE_LOG_READER_FILES_MAX];
+	/** Number of opened files. */
+	int file_count;
+	/** Index of the file to close when the next one is opened. */
+	int next_victim;
+	/** Mutex protecting the opened files. */
+	pthread_mutex_t mutex;
+};
+
+/**
+ * Initialize a value log reader. The directory path isn't copied so
+ * it must stay valid while the reader is used.
+ */
+void
+vy_value_log_reader_create(struct vy_value_log_reader *reader,
+			   const char *dir);
+
+/** Close all files opened by a value log reader. */
+void
+vy_value_log_reader_destroy(struct vy_value_log_reader *reader);
+
+/**
+ * Given a statement with the VY_STMT_VALUE_REFS flag set, calculate
+ * the size of its data with all references replaced with the values
+ * they point to. The number of bytes to read from the value logs is
+ * returned in @a read_size.
+ *
+ * @retval  0 Success.
+ * @retval -1 Invalid value reference.
+ */
+int
+vy_value_log_resolved_size(struct tuple *stmt, size_t *size,
+			   size_t *read_size);
+
+/**
+ * Copy the data of a statement with the VY_STMT_VALUE_REFS flag set to
+ * the given buffer replacing all references with the values read from
+ * the value logs. The buffer size must be calculated with
+ * vy_value_log_resolved_size(). The function doesn't allocate memory
+ * so it may be called from any thread.
+ *
+ * @retval  0 Success.
+ * @retval -1 IO error or checksum mismatch.
+ */
+int
+vy_value_log_reader_resolve(struct vy_value_log_reader *reader,
+			    struct tuple *stmt, char *buf, size_t size);
+
+/**
+ * Allocate a statement with the given data filled by
+ * vy_value_log_reader_resolve() and the type, LSN and flags of the
+ * statement with references. Must be called from the tx thread.
+ * Returns NULL on memory allocation error.
+ */
+struct tuple *
+vy_value_log_stmt_new_resolved(struct tuple *stmt, const char *data,
+			       const char *data_end);
+
+/** Writer of a value log created for a new run. */
+struct vy_value_log_writer {
+	/** Reader used for copying values from older value logs. */
+	struct vy_value_log_reader reader;
+	/** ID of the value log (same as the run ID). */
+	int64_t id;
+	/** Value log file descriptor or -1 if not open. */
+	int fd;
+	/** Size of data written to the value log file. */
+	uint64_t offset;
+	/** Min size of a field to store in the value log. */
+	uint32_t threshold;
+	/**
+	 * Values stored in value logs with IDs less than this one are
+	 * copied to the new value log.
+	 */
+	int64_t relocate_below;
+	/** Min ID of a value log referenced by written statements. */
+	int64_t min_id;
+};
+
+/**
+ * Create a value log writer and the value log file. The file is
+ * created with the '.inprogress' suffix, which is removed when the
+ * writer is committed.
+ *
+ * @param writer          Writer to initialize.
+ * @param dir             Path to the LSM tree directory.
+ * @param id              ID of the value log (same as the run ID).
+ * @param threshold       Min size of a field to store in the value log.
+ * @param relocate_below  Values stored in older value logs are copied.
+ *
+ * @retval  0 Success.
+ * @retval -1 IO error.
+ */
+int
+vy_value_log_writer_create(struct vy_value_log_writer *writer,
+			   const char *dir, int64_t id, uint32_t threshold,
+			   int64_t relocate_below);
+
+/**
+ * Prepare a statement for writing to a run: store big fields in the
+ * value log and copy values from old value logs if needed. On success,
+ * @a result is set to the new statement to write instead of the given
+ * one, which must be unreferenced by the caller, or NULL if the given
+ * statement should be written as is.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory or IO error.
+ */
+int
+vy_value_log_writer_process(struct vy_value_log_writer *writer,
+			    struct tuple *stmt, struct tuple **result);
+
+/**
+ * Sync the value log file to disk and rename it to the final name.
+ * The writer is destroyed on success.
+ */
+int
+vy_value_log_writer_commit(struct vy_value_log_writer *writer);
+
+/** Destroy a value log writer and delete the incomplete file. */
+void
+vy_value_log_writer_abort(struct vy_value_log_writer *writer);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
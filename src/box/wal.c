@@ -55,6 +55,11 @@ enum {
 	 * latency. 1 MB seems to be a well balanced choice.
 	 */
 	WAL_FALLOCATE_LEN = 1024 * 1024,
+	/**
+	 * Weight of the accumulated value in the moving average of
+	 * the WAL write time, see wal_writer::write_time.
+	 */
+	WAL_WRITE_TIME_WEIGHT = 8,
 };
 
 const char *wal_mode_STRS[WAL_MODE_MAX] = {
@@ -135,6 +140,28 @@ struct wal_writer
 	 * rolled back too.
 	 */
 	struct journal_entry *last_entry;
+	/**
+	 * A setting from instance configuration - wal_commit_delay.
+	 * Max time a batch waits in TX for more entries before it's
+	 * sent to WAL.
+	 */
+	double commit_delay;
+	/**
+	 * Moving average of the time it takes WAL to write a batch,
+	 * measured in the WAL thread. Waiting for more entries longer
+	 * than a write takes doesn't pay off, so it bounds the commit
+	 * delay.
+	 */
+	double write_time;
+	/**
+	 * The batch collecting entries during the commit delay or NULL.
+	 * It isn't pushed to the WAL pipe until the delay expires.
+	 */
+	struct wal_msg *pending_batch;
+	/** Pipe input accounted for the pending batch. */
+	int pending_n_input;
+	/** Timer sending the pending batch to WAL. */
+	struct ev_timer commit_timer;
 	/* ----------------- wal ------------------- */
 	/** A setting from instance configuration - wal_max_size */
 	int64_t wal_max_size;
@@ -213,6 +240,8 @@ struct wal_msg {
 	struct stailq rollback;
 	/** vclock after the batch processed. */
 	struct vclock vclock;
+	/** Time it took WAL to write the batch, in seconds. */
+	double write_time;
 };
 
 /**
@@ -257,6 +286,7 @@ wal_msg_create(struct wal_msg *batch)
 	stailq_create(&batch->commit);
 	stailq_create(&batch->rollback);
 	vclock_create(&batch->vclock);
+	batch->write_time = 0;
 }
 
 static struct wal_msg *
@@ -402,6 +432,8 @@ tx_complete_batch(struct cmsg *msg)
 	}
 	/* Update the tx vclock to the latest written by wal. */
 	vclock_copy(writer->instance_vclock, &batch->vclock);
+	writer->write_time = (writer->write_time * (WAL_WRITE_TIME_WEIGHT - 1) +
+			      batch->write_time) / WAL_WRITE_TIME_WEIGHT;
 	tx_schedule_queue(&batch->commit);
 	trigger_run(&wal_on_write, NULL);
 	mempool_free(&writer->msg_pool, container_of(msg, struct wal_msg, base));
@@ -445,6 +477,34 @@ wal_sync_none(struct journal *journal, struct vclock *out)
 	return 0;
 }
 
+/**
+ * Send the batch collected during the commit delay, if any, to WAL.
+ * Must be called before sending any message to WAL that has to be
+ * processed after all the entries submitted so far.
+ */
+static void
+wal_submit_pending_batch(struct wal_writer *writer)
+{
+	struct wal_msg *batch = writer->pending_batch;
+	if (batch == NULL)
+		return;
+	ev_timer_stop(loop(), &writer->commit_timer);
+	writer->pending_batch = NULL;
+	cpipe_push(&writer->wal_pipe, &batch->base);
+	writer->wal_pipe.n_input += writer->pending_n_input;
+	writer->pending_n_input = 0;
+	cpipe_submit_flush(&writer->wal_pipe);
+}
+
+static void
+wal_commit_timer_cb(struct ev_loop *loop, struct ev_timer *timer, int events)
+{
+	(void)loop;
+	(void)timer;
+	(void)events;
+	wal_submit_pending_batch(&wal_writer_singleton);
+}
+
 /**
  * Initialize WAL writer context. Even though it's a singleton,
  * encapsulate the details just in case we may use
@@ -475,6 +535,8 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 
 	struct xlog_opts opts = xlog_opts_default;
 	opts.sync_is_async = true;
+	/* Keep the WAL tail in memory for relays, see xlog_tx_cache_size. */
+	opts.fill_tx_cache = true;
 	xdir_create(&writer->wal_dir, wal_dirname, "XLOG", instance_uuid,
 		    &opts);
 	writer->wal_dir.force_recovery = true;
@@ -484,9 +546,12 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 	 * Otherwise files which must be preserved can be deleted.
 	 */
 	xdir_set_retention_period(&writer->wal_dir, wal_retention_period);
+	/*
+	 * Note that WAL files aren't opened with O_SYNC in the fsync mode.
+	 * Instead, each batch is synced with a single fdatasync(2) after
+	 * all its rows are written, see wal_write_to_disk().
+	 */
 	xlog_clear(&writer->current_wal);
-	if (wal_mode == WAL_FSYNC)
-		writer->wal_dir.open_wflags |= O_SYNC;
 
 	stailq_create(&writer->rollback);
 	writer->is_in_rollback = false;
@@ -504,6 +569,11 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 	writer->on_garbage_collection = on_garbage_collection;
 	writer->on_checkpoint_threshold = on_checkpoint_threshold;
 
+	writer->write_time = 0;
+	writer->pending_batch = NULL;
+	writer->pending_n_input = 0;
+	ev_timer_init(&writer->commit_timer, wal_commit_timer_cb, 0, 0);
+
 	mempool_create(&writer->msg_pool, &cord()->slabc,
 		       sizeof(struct wal_msg));
 }
@@ -662,6 +732,7 @@ wal_free(void)
 {
 	struct wal_writer *writer = &wal_writer_singleton;
 
+	wal_submit_pending_batch(writer);
 	cbus_stop_loop(&writer->wal_pipe);
 	cpipe_destroy(&writer->wal_pipe);
 
@@ -711,6 +782,7 @@ wal_sync(struct journal *journal, struct vclock *vclock)
 	}
 	if (journal_queue_flush() != 0)
 		return -1;
+	wal_submit_pending_batch(writer);
 	struct wal_vclock_msg msg;
 	int rc = cbus_call(&writer->wal_pipe, &writer->tx_prio_pipe, &msg.base,
 			   wal_sync_f);
@@ -804,6 +876,7 @@ wal_begin_checkpoint(struct journal *j, struct journal_checkpoint *out)
 	}
 	if (journal_queue_flush() != 0)
 		return -1;
+	wal_submit_pending_batch(writer);
 	struct wal_begin_checkpoint_msg msg;
 	msg.out = out;
 	return cbus_call(&writer->wal_pipe, &writer->tx_prio_pipe,
@@ -895,6 +968,15 @@ wal_set_queue_max_size(int64_t size)
 	journal_queue_set_max_size(size);
 }
 
+void
+wal_set_commit_delay(double delay)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	writer->commit_delay = delay;
+	if (delay == 0)
+		wal_submit_pending_batch(writer);
+}
+
 /** Retention delay configuration message. */
 struct wal_set_retention_period_msg {
 	/* The state of a synchronous cross-thread call. */
@@ -1226,6 +1308,14 @@ wal_write_to_disk(struct cmsg *msg)
 	struct vclock vclock_diff;
 	vclock_create(&vclock_diff);
 
+	double start_time = ev_monotonic_time();
+
+	/* WAL state at the batch start, see below. */
+	off_t batch_offset = 0;
+	int64_t batch_wal_size = 0;
+	struct vclock batch_vclock;
+	vclock_create(&batch_vclock);
+
 	ERROR_INJECT_SLEEP(ERRINJ_WAL_DELAY);
 
 	ERROR_INJECT_COUNTDOWN(ERRINJ_WAL_DELAY_COUNTDOWN, {
@@ -1274,6 +1364,13 @@ wal_write_to_disk(struct cmsg *msg)
 	 */
 
 	struct xlog *l = &writer->current_wal;
+	/*
+	 * Remember the WAL state at the batch start so that the whole
+	 * batch can be discarded if we fail to sync it.
+	 */
+	batch_offset = l->offset;
+	batch_wal_size = writer->checkpoint_wal_size;
+	vclock_copy(&batch_vclock, &writer->vclock);
 	ERROR_INJECT_SLEEP_FOR(ERRINJ_WAL_DELAY_DURATION);
 	/*
 	 * Iterate over requests (transactions)
@@ -1327,6 +1424,20 @@ wal_write_to_disk(struct cmsg *msg)
 	}
 
 done:
+	/*
+	 * In the fsync mode none of the written entries is committed
+	 * until the batch is synced. Syncing once per batch rather than
+	 * on every write lets a batch that spans several xlog
+	 * transactions pay for a single disk flush.
+	 */
+	if (writer->wal_mode == WAL_FSYNC && last_committed != NULL &&
+	    xlog_datasync(&writer->current_wal, batch_offset) != 0) {
+		err_code = JOURNAL_ENTRY_ERR_IO;
+		last_committed = NULL;
+		writer->checkpoint_wal_size = batch_wal_size;
+		vclock_copy(&writer->vclock, &batch_vclock);
+	}
+	wal_msg->write_time = ev_monotonic_time() - start_time;
 	error = diag_last_error(diag_get());
 	if (error) {
 		/* Until we can pass the error to tx, log it and clear. */
@@ -1447,7 +1558,10 @@ wal_write_async(struct journal *journal, struct journal_entry *entry)
 	}
 
 	struct wal_msg *batch;
-	if (!stailq_empty(&writer->wal_pipe.input) &&
+	if (writer->pending_batch != NULL) {
+		batch = writer->pending_batch;
+		stailq_add_tail_entry(&batch->commit, entry, fifo);
+	} else if (!stailq_empty(&writer->wal_pipe.input) &&
 	    (batch = wal_msg(stailq_first_entry(&writer->wal_pipe.input,
 						struct cmsg, fifo)))) {
 
@@ -1466,7 +1580,22 @@ wal_write_async(struct journal *journal, struct journal_entry *entry)
 		 * thread right away.
 		 */
 		stailq_add_tail_entry(&batch->commit, entry, fifo);
-		cpipe_push(&writer->wal_pipe, &batch->base);
+		/*
+		 * Group commit: hold the batch in TX for a while to
+		 * collect more entries, so that they are written and
+		 * synced together. The delay is bounded by the average
+		 * WAL write time, because waiting longer doesn't let
+		 * more entries join the batch than would be queued
+		 * behind a write in progress anyway.
+		 */
+		double delay = MIN(writer->commit_delay, writer->write_time);
+		if (delay > 0) {
+			writer->pending_batch = batch;
+			ev_timer_set(&writer->commit_timer, delay, 0);
+			ev_timer_start(loop(), &writer->commit_timer);
+		} else {
+			cpipe_push(&writer->wal_pipe, &batch->base);
+		}
 	}
 	/*
 	 * Remember last entry sent to WAL. In case of rollback
@@ -1475,10 +1604,17 @@ wal_write_async(struct journal *journal, struct journal_entry *entry)
 	 */
 	writer->last_entry = entry;
 	batch->approx_len += entry->approx_len;
-	writer->wal_pipe.n_input += entry->n_rows * XROW_IOVMAX;
 #ifndef NDEBUG
 	++errinj(ERRINJ_WAL_WRITE_COUNT, ERRINJ_INT)->iparam;
 #endif
+	if (batch == writer->pending_batch) {
+		/* Don't wait if the batch is already big enough. */
+		writer->pending_n_input += entry->n_rows * XROW_IOVMAX;
+		if (writer->pending_n_input >= writer->wal_pipe.max_input)
+			wal_submit_pending_batch(writer);
+		return 0;
+	}
+	writer->wal_pipe.n_input += entry->n_rows * XROW_IOVMAX;
 	cpipe_submit_flush(&writer->wal_pipe);
 	return 0;
 
@@ -225,6 +225,14 @@ wal_set_checkpoint_threshold(int64_t threshold);
 void
 wal_set_queue_max_size(int64_t size);
 
+/**
+ * Set the max time a batch of WAL writes may wait for more writes
+ * to join it before it is sent to the WAL thread (group commit).
+ * Zero disables the delay.
+ */
+void
+wal_set_commit_delay(double delay);
+
 /**
  * Set new value for wal_retention_period, update expiration time
  * of all xlog files.
@@ -49,6 +49,10 @@
 #include "salad/grp_alloc.h"
 #include "trivia/util.h"
 #include "retention_period.h"
+#include "tweaks.h"
+#include "tt_pthread.h"
+#include "assoc.h"
+#include "small/rlist.h"
 #include "iproto_constants.h"
 
 /*
@@ -99,6 +103,7 @@ const struct xlog_opts xlog_opts_default = {
 	.free_cache = false,
 	.sync_is_async = false,
 	.no_compression = false,
+	.fill_tx_cache = false,
 };
 
 /* {{{ struct xlog_meta */
@@ -1213,6 +1218,12 @@ xlog_tx_write_zstd(struct xlog *log)
 #define SYNC_ROUND_DOWN(size)	((size) & ~(4096 - 1))
 #define SYNC_ROUND_UP(size)	(SYNC_ROUND_DOWN(size + SYNC_MASK))
 
+static void
+xlog_tx_cache_put_written(struct xlog *log, size_t written);
+
+static void
+xlog_tx_cache_invalidate(int64_t signature, off_t offset);
+
 /**
  * Writes xlog batch to file
  */
@@ -1234,6 +1245,8 @@ xlog_tx_write(struct xlog *log)
 		written = -1;
 	});
 
+	if (written >= 0 && log->opts.fill_tx_cache)
+		xlog_tx_cache_put_written(log, written);
 	obuf_reset(&log->obuf);
 	/*
 	 * Simplify recovery after a temporary write failure:
@@ -1399,6 +1412,32 @@ xlog_flush(struct xlog *log)
 	return xlog_tx_write(log);
 }
 
+int
+xlog_datasync(struct xlog *log, off_t offset)
+{
+	assert(log->is_autocommit);
+	assert(obuf_size(&log->obuf) == 0);
+	assert(offset <= log->offset);
+	int rc = fdatasync(log->fd);
+	ERROR_INJECT(ERRINJ_WAL_DATASYNC, {
+		errno = EIO;
+		rc = -1;
+	});
+	if (rc == 0) {
+		log->synced_size = log->offset;
+		return 0;
+	}
+	diag_set(SystemError, "failed to sync file '%s'", log->filename);
+	if (lseek(log->fd, offset, SEEK_SET) < 0 ||
+	    ftruncate(log->fd, offset) != 0)
+		panic_syserror("failed to truncate xlog after sync error");
+	if (log->opts.fill_tx_cache)
+		xlog_tx_cache_invalidate(vclock_sum(&log->meta.vclock), offset);
+	log->allocated = 0;
+	log->offset = offset;
+	return -1;
+}
+
 static int
 sync_cb(eio_req *req)
 {
@@ -1888,6 +1927,297 @@ xlog_cursor_next_tx_impl(struct xlog_cursor *i, struct ibuf *buf)
 	return 1;
 }
 
+/**
+ * A cache of decoded xlog transactions shared by all threads.
+ *
+ * Relays of replicas subscribed at about the same vclock read the same
+ * transactions from the same WAL files. The first cursor that reads a
+ * transaction stores its decompressed rows in the cache, and the other
+ * cursors copy the rows from there instead of checking the checksum and
+ * decompressing the transaction again. A transaction is identified by
+ * the file signature, its offset in the file, and its fixheader.
+ *
+ * The WAL writer also stores every transaction it writes in the cache
+ * (see xlog_opts::fill_tx_cache), so the cache keeps the WAL tail in
+ * memory. Relays of caught-up replicas find their next transaction
+ * there by its offset alone and don't read the file at all.
+ */
+struct xlog_tx_cache_entry {
+	/** Link in xlog_tx_cache::lru. */
+	struct rlist in_lru;
+	/** Signature of the file the transaction was read from. */
+	int64_t signature;
+	/** Offset of the transaction fixheader in the file. */
+	off_t offset;
+	/** Checksum of the transaction from the fixheader. */
+	uint32_t crc32c;
+	/** Length of the transaction from the fixheader. */
+	uint32_t len;
+	/**
+	 * Set if the entry was stored by the writer of the file.
+	 * Such an entry is known to match the file contents, so
+	 * it may be looked up without reading the fixheader.
+	 */
+	bool is_written;
+	/** Size of the decoded rows. */
+	size_t size;
+	/** The decoded rows. */
+	char data[0];
+};
+
+static struct {
+	/** Protects the cache, which is accessed by relay threads. */
+	pthread_mutex_t mutex;
+	/** Hash key -> struct xlog_tx_cache_entry, created on demand. */
+	struct mh_i64ptr_t *hash;
+	/** All entries, the least recently used first. */
+	struct rlist lru;
+	/** Total size of all entries. */
+	size_t used;
+} xlog_tx_cache = {
+	.mutex = PTHREAD_MUTEX_INITIALIZER,
+	.hash = NULL,
+	.lru = RLIST_HEAD_INITIALIZER(xlog_tx_cache.lru),
+	.used = 0,
+};
+
+/**
+ * Max size of the shared transaction cache. Zero disables the cache.
+ * Only cursors with xlog_cursor::use_tx_cache set use the cache.
+ */
+static uint64_t xlog_tx_cache_size = 0;
+TWEAK_UINT(xlog_tx_cache_size);
+
+static inline uint64_t
+xlog_tx_cache_key(int64_t signature, off_t offset)
+{
+	return (uint64_t)signature * 11400714819323198485ULL ^ offset;
+}
+
+/** Delete a cache entry. Must be called under the mutex. */
+static void
+xlog_tx_cache_delete_locked(struct xlog_tx_cache_entry *e)
+{
+	struct mh_i64ptr_t *h = xlog_tx_cache.hash;
+	mh_int_t k = mh_i64ptr_find(h, xlog_tx_cache_key(e->signature,
+							 e->offset), NULL);
+	if (k != mh_end(h) && mh_i64ptr_node(h, k)->val == e)
+		mh_i64ptr_del(h, k, NULL);
+	rlist_del_entry(e, in_lru);
+	xlog_tx_cache.used -= sizeof(*e) + e->size;
+	free(e);
+}
+
+/**
+ * Look up a transaction in the cache and copy its rows to @a buf.
+ * If @a fixheader is NULL, only entries stored by the writer of
+ * the file match. The transaction length is returned in @a len.
+ * Returns true if found.
+ */
+static bool
+xlog_tx_cache_get(int64_t signature, off_t offset,
+		  const struct xlog_fixheader *fixheader, struct ibuf *buf,
+		  uint32_t *len)
+{
+	bool found = false;
+	tt_pthread_mutex_lock(&xlog_tx_cache.mutex);
+	struct mh_i64ptr_t *h = xlog_tx_cache.hash;
+	mh_int_t k = h == NULL ? 0 :
+		mh_i64ptr_find(h, xlog_tx_cache_key(signature, offset), NULL);
+	if (h != NULL && k != mh_end(h)) {
+		struct xlog_tx_cache_entry *e = mh_i64ptr_node(h, k)->val;
+		if (e->signature == signature && e->offset == offset &&
+		    (fixheader == NULL ? e->is_written :
+		     (e->is_written || e->crc32c == fixheader->crc32c) &&
+		     e->len == fixheader->len)) {
+			ibuf_create(buf, &cord()->slabc,
+				    XLOG_TX_AUTOCOMMIT_THRESHOLD);
+			memcpy(xibuf_alloc(buf, e->size), e->data, e->size);
+			rlist_move_tail_entry(&xlog_tx_cache.lru, e, in_lru);
+			*len = e->len;
+			found = true;
+		}
+	}
+	tt_pthread_mutex_unlock(&xlog_tx_cache.mutex);
+	return found;
+}
+
+/**
+ * Allocate a cache entry for @a size bytes of rows.
+ * Returns NULL if the entry doesn't fit in the cache.
+ */
+static struct xlog_tx_cache_entry *
+xlog_tx_cache_entry_new(int64_t signature, off_t offset, size_t size)
+{
+	struct xlog_tx_cache_entry *e;
+	if (sizeof(*e) + size > xlog_tx_cache_size)
+		return NULL;
+	e = malloc(sizeof(*e) + size);
+	if (e == NULL)
+		return NULL;
+	e->signature = signature;
+	e->offset = offset;
+	e->crc32c = 0;
+	e->len = 0;
+	e->is_written = false;
+	e->size = size;
+	return e;
+}
+
+/** Add a new entry to the cache, evicting old entries if needed. */
+static void
+xlog_tx_cache_add(struct xlog_tx_cache_entry *e)
+{
+	int64_t signature = e->signature;
+	off_t offset = e->offset;
+	size_t size = e->size;
+	tt_pthread_mutex_lock(&xlog_tx_cache.mutex);
+	if (xlog_tx_cache.hash == NULL)
+		xlog_tx_cache.hash = mh_i64ptr_new();
+	struct mh_i64ptr_node_t node = {xlog_tx_cache_key(signature, offset), e};
+	struct mh_i64ptr_node_t old_node;
+	struct mh_i64ptr_node_t *old_node_ptr = &old_node;
+	mh_i64ptr_put(xlog_tx_cache.hash, &node, &old_node_ptr, NULL);
+	if (old_node_ptr != NULL) {
+		/* Lost a race with another thread or a key collision. */
+		struct xlog_tx_cache_entry *old = old_node_ptr->val;
+		rlist_del_entry(old, in_lru);
+		xlog_tx_cache.used -= sizeof(*old) + old->size;
+		free(old);
+	}
+	rlist_add_tail_entry(&xlog_tx_cache.lru, e, in_lru);
+	xlog_tx_cache.used += sizeof(*e) + size;
+	while (xlog_tx_cache.used > xlog_tx_cache_size) {
+		struct xlog_tx_cache_entry *victim = rlist_first_entry(
+			&xlog_tx_cache.lru, struct xlog_tx_cache_entry, in_lru);
+		xlog_tx_cache_delete_locked(victim);
+	}
+	tt_pthread_mutex_unlock(&xlog_tx_cache.mutex);
+}
+
+/** Store the decoded rows of a transaction read from a file. */
+static void
+xlog_tx_cache_put(int64_t signature, off_t offset,
+		  const struct xlog_fixheader *fixheader,
+		  const struct ibuf *rows)
+{
+	struct xlog_tx_cache_entry *e =
+		xlog_tx_cache_entry_new(signature, offset, ibuf_used(rows));
+	if (e == NULL)
+		return;
+	e->crc32c = fixheader->crc32c;
+	e->len = fixheader->len;
+	memcpy(e->data, rows->rpos, e->size);
+	xlog_tx_cache_add(e);
+}
+
+/**
+ * Store the rows of a transaction that has just been written to
+ * @a log. The rows are still in the output buffer, right after the
+ * fixheader, and @a written bytes were written at xlog::offset.
+ */
+static void
+xlog_tx_cache_put_written(struct xlog *log, size_t written)
+{
+	assert(written > XLOG_FIXHEADER_SIZE);
+	struct xlog_tx_cache_entry *e = xlog_tx_cache_entry_new(
+		vclock_sum(&log->meta.vclock), log->offset,
+		obuf_size(&log->obuf) - XLOG_FIXHEADER_SIZE);
+	if (e == NULL)
+		return;
+	e->len = written - XLOG_FIXHEADER_SIZE;
+	e->is_written = true;
+	char *data = e->data;
+	size_t offset = XLOG_FIXHEADER_SIZE;
+	for (struct iovec *iov = log->obuf.iov; iov->iov_len; ++iov) {
+		memcpy(data, (char *)iov->iov_base + offset,
+		       iov->iov_len - offset);
+		data += iov->iov_len - offset;
+		offset = 0;
+	}
+	assert(data == e->data + e->size);
+	xlog_tx_cache_add(e);
+}
+
+/**
+ * Drop all cached transactions of the file with the given signature
+ * stored at or after @a offset. Called when the file is truncated.
+ */
+static void
+xlog_tx_cache_invalidate(int64_t signature, off_t offset)
+{
+	tt_pthread_mutex_lock(&xlog_tx_cache.mutex);
+	struct xlog_tx_cache_entry *e, *tmp;
+	rlist_foreach_entry_safe(e, &xlog_tx_cache.lru, in_lru, tmp) {
+		if (e->signature == signature && e->offset >= offset)
+			xlog_tx_cache_delete_locked(e);
+	}
+	tt_pthread_mutex_unlock(&xlog_tx_cache.mutex);
+}
+
+/**
+ * Look up the next transaction of a cursor in the shared tx cache by
+ * its fixheader. On a miss, read the transaction from the file and
+ * store it in the cache. Returns the same as xlog_cursor_next_tx_impl()
+ * on a miss. On a hit, returns 0 and sets @a hit.
+ */
+static int
+xlog_cursor_read_tx_cached(struct xlog_cursor *i, uint32_t *len, bool *hit)
+{
+	*hit = false;
+	int rc = xlog_cursor_ensure(i, XLOG_FIXHEADER_SIZE);
+	if (rc < 0)
+		return -1;
+	struct xlog_fixheader fixheader;
+	const char *pos = i->rbuf.rpos;
+	if (rc > 0 || load_u32(pos) == eof_marker ||
+	    xlog_fixheader_decode(&fixheader, &pos, i->rbuf.wpos) != 0) {
+		/* Let the generic code handle EOF and errors. */
+		diag_clear(diag_get());
+		return xlog_cursor_next_tx_impl(i, &i->tx_cursor);
+	}
+	int64_t signature = vclock_sum(&i->meta.vclock);
+	off_t offset = xlog_cursor_pos(i);
+	if (xlog_tx_cache_get(signature, offset, &fixheader,
+			      &i->tx_cursor, len)) {
+		*hit = true;
+		return 0;
+	}
+	rc = xlog_cursor_next_tx_impl(i, &i->tx_cursor);
+	if (rc == 0)
+		xlog_tx_cache_put(signature, offset, &fixheader,
+				  &i->tx_cursor);
+	return rc;
+}
+
+/** Same as xlog_cursor_next_tx_impl(), but uses the shared tx cache. */
+static int
+xlog_cursor_next_tx_cached(struct xlog_cursor *i)
+{
+	int64_t signature = vclock_sum(&i->meta.vclock);
+	off_t offset = xlog_cursor_pos(i);
+	uint32_t len;
+	/*
+	 * The WAL tail stored by the writer is looked up by the offset
+	 * alone, without reading the file.
+	 */
+	if (!xlog_tx_cache_get(signature, offset, NULL, &i->tx_cursor, &len)) {
+		bool hit;
+		int rc = xlog_cursor_read_tx_cached(i, &len, &hit);
+		if (!hit)
+			return rc;
+	}
+	/* Skip the transaction in the file. */
+	size_t skip = XLOG_FIXHEADER_SIZE + len;
+	if (ibuf_used(&i->rbuf) >= skip) {
+		i->rbuf.rpos += skip;
+	} else {
+		i->read_offset = offset + skip;
+		ibuf_reset(&i->rbuf);
+	}
+	return 0;
+}
+
 int
 xlog_cursor_next_tx(struct xlog_cursor *cursor)
 {
@@ -1895,7 +2225,9 @@ xlog_cursor_next_tx(struct xlog_cursor *cursor)
 		cursor->state = XLOG_CURSOR_ACTIVE;
 		ibuf_destroy(&cursor->tx_cursor);
 	}
-	int rc = xlog_cursor_next_tx_impl(cursor, &cursor->tx_cursor);
+	int rc = cursor->use_tx_cache ?
+		 xlog_cursor_next_tx_cached(cursor) :
+		 xlog_cursor_next_tx_impl(cursor, &cursor->tx_cursor);
 	if (rc != 0)
 		return rc;
 	cursor->state = XLOG_CURSOR_TX;
@@ -83,6 +83,16 @@ struct xlog_opts {
 	 * to be read frequently, e.g. L1 run files in Vinyl.
 	 */
 	bool no_compression;
+	/**
+	 * If this flag is set, the xlog writer stores each written
+	 * transaction in the shared transaction cache, see
+	 * xlog_cursor::use_tx_cache.
+	 *
+	 * This option is useful for WAL files, because relays of
+	 * caught-up replicas read the WAL tail right after it is
+	 * written, so they can get it from memory.
+	 */
+	bool fill_tx_cache;
 };
 
 extern const struct xlog_opts xlog_opts_default;
@@ -578,6 +588,21 @@ xlog_tx_rollback(struct xlog *log);
 ssize_t
 xlog_flush(struct xlog *log);
 
+/**
+ * Make all data written to the xlog file durable with fdatasync(2).
+ * Used by the WAL writer to sync a whole batch of writes at once
+ * instead of opening the file with O_SYNC, which makes every write
+ * synchronous.
+ *
+ * If sync fails, it's unknown what part of the data written after
+ * `offset` reached the disk, so the file is truncated to `offset`
+ * and the caller must discard all rows written since then.
+ *
+ * Returns 0 on success. On failure, sets diag and returns -1.
+ */
+int
+xlog_datasync(struct xlog *log, off_t offset);
+
 /**
  * Closes an xlog object.
  *
@@ -746,6 +771,11 @@ struct xlog_cursor {
 	bool search_magic;
 	/** Set if last batch was partially read. */
 	struct error *error;
+	/**
+	 * Set if decoded transactions are shared with other cursors
+	 * reading the same file via a process-wide cache.
+	 */
+	bool use_tx_cache;
 };
 
 /**
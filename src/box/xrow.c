@@ -2137,6 +2137,8 @@ struct replication_request {
 	struct vclock *checkpoint_vclock;
 	/** IPROTO_CHECKPOINT_LSN. */
 	uint64_t *checkpoint_lsn;
+	/** IPROTO_IS_COMPRESSED. */
+	bool *is_compressed;
 };
 
 /** Encode a replication request template. */
@@ -2211,6 +2213,12 @@ xrow_encode_replication_request(struct xrow_header *row,
 			data = mp_encode_uint(data, id);
 		}
 	}
+	/* Omitted if not set, so that old masters see the same request. */
+	if (req->is_compressed != NULL && *req->is_compressed) {
+		++map_size;
+		data = mp_encode_uint(data, IPROTO_IS_COMPRESSED);
+		data = mp_encode_bool(data, true);
+	}
 	assert(data <= buf + size);
 	assert(map_size <= 15);
 	char *map_header_end = mp_encode_map(buf, map_size);
@@ -2362,6 +2370,16 @@ id_filter_decode_err:		xrow_on_decode_err(row, ER_INVALID_MSGPACK,
 			}
 			*req->checkpoint_lsn = mp_decode_uint(&d);
 			break;
+		case IPROTO_IS_COMPRESSED:
+			if (req->is_compressed == NULL)
+				goto skip;
+			if (mp_typeof(*d) != MP_BOOL) {
+				xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid IS_COMPRESSED");
+				return -1;
+			}
+			*req->is_compressed = mp_decode_bool(&d);
+			break;
 		default: skip:
 			mp_next(&d); /* value */
 		}
@@ -2409,6 +2427,7 @@ xrow_encode_subscribe(struct xrow_header *row,
 		.is_anon = &cast->is_anon,
 		.id_filter = &cast->id_filter,
 		.version_id = &cast->version_id,
+		.is_compressed = &cast->is_compressed,
 	};
 	xrow_encode_replication_request(row, &base_req, IPROTO_SUBSCRIBE);
 }
@@ -2427,6 +2446,7 @@ xrow_decode_subscribe(const struct xrow_header *row,
 		.version_id = &req->version_id,
 		.is_anon = &req->is_anon,
 		.id_filter = &req->id_filter,
+		.is_compressed = &req->is_compressed,
 	};
 	return xrow_decode_replication_request(row, &base_req);
 }
@@ -663,6 +663,8 @@ struct subscribe_request {
 	uint32_t version_id;
 	/** Flag whether the replica is anon. */
 	bool is_anon;
+	/** Flag whether the replica wants a compressed stream. */
+	bool is_compressed;
 };
 
 /** Encode SUBSCRIBE request. */
@@ -132,6 +132,101 @@ xrow_stream_write(struct xrow_stream *stream, const struct xrow_header *row)
 	xlsregion_alloc(&stream->lsregion, data_len, ++stream->lsr_id);
 }
 
+enum {
+	/**
+	 * The zstd compression level used for the replication stream.
+	 * The lowest one, because relay must keep up with the WAL.
+	 */
+	XROW_STREAM_COMPRESSION_LEVEL = 1,
+	/**
+	 * Size of the IPROTO_COMPRESSED_ROWS packet prefix: the fixheader,
+	 * the header map {IPROTO_REQUEST_TYPE: IPROTO_COMPRESSED_ROWS}, and
+	 * the MP_BIN32 header of the body.
+	 */
+	XROW_COMPRESSED_ROWS_PREFIX_LEN = 5 + 3 + 5,
+};
+
+int
+xrow_stream_compress(struct xrow_stream *stream)
+{
+	assert(stream->zctx == NULL);
+	stream->zctx = ZSTD_createCCtx();
+	if (stream->zctx == NULL) {
+		diag_set(OutOfMemory, 0, "ZSTD_createCCtx", "zctx");
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Compress a chunk of the stream into an IPROTO_COMPRESSED_ROWS packet
+ * allocated on the fiber region.
+ */
+static int
+xrow_stream_encode_compressed(struct xrow_stream *stream,
+			      const struct iovec *iov, int iovcnt,
+			      struct iovec *packet)
+{
+	assert(iovcnt > 0);
+	size_t bound = 0;
+	for (int i = 0; i < iovcnt; i++)
+		bound += ZSTD_compressBound(iov[i].iov_len);
+	char *buf = (char *)xregion_alloc(&fiber()->gc,
+					  XROW_COMPRESSED_ROWS_PREFIX_LEN +
+					  bound);
+	char *data = buf + XROW_COMPRESSED_ROWS_PREFIX_LEN;
+	char *data_end = data + bound;
+	size_t rc = ZSTD_compressBegin(stream->zctx,
+				       XROW_STREAM_COMPRESSION_LEVEL);
+	for (int i = 0; i < iovcnt && !ZSTD_isError(rc); i++) {
+		size_t (*fcompress)(ZSTD_CCtx *, void *, size_t,
+				    const void *, size_t);
+		fcompress = i == iovcnt - 1 ? ZSTD_compressEnd :
+					      ZSTD_compressContinue;
+		rc = fcompress(stream->zctx, data, data_end - data,
+			       iov[i].iov_base, iov[i].iov_len);
+		if (!ZSTD_isError(rc))
+			data += rc;
+	}
+	if (ZSTD_isError(rc)) {
+		diag_set(ClientError, ER_COMPRESSION, ZSTD_getErrorName(rc));
+		return -1;
+	}
+	uint32_t zsize = data - buf - XROW_COMPRESSED_ROWS_PREFIX_LEN;
+	char *d = buf;
+	*d = 0xce; /* MP_UINT32 */
+	store_u32(d + 1, mp_bswap_u32(zsize +
+				      XROW_COMPRESSED_ROWS_PREFIX_LEN - 5));
+	d += 5;
+	d = mp_encode_map(d, 1);
+	d = mp_encode_uint(d, IPROTO_REQUEST_TYPE);
+	d = mp_encode_uint(d, IPROTO_COMPRESSED_ROWS);
+	*d = 0xc6; /* MP_BIN32 */
+	store_u32(d + 1, mp_bswap_u32(zsize));
+	d += 5;
+	assert(d == buf + XROW_COMPRESSED_ROWS_PREFIX_LEN);
+	packet->iov_base = buf;
+	packet->iov_len = data - buf;
+	return 0;
+}
+
+/** Write a chunk of the stream compressed. Returns the chunk size. */
+static ssize_t
+xrow_stream_write_compressed(struct xrow_stream *stream, struct iostream *io,
+			     const struct iovec *iov, int iovcnt)
+{
+	RegionGuard region_guard(&fiber()->gc);
+	struct iovec packet;
+	if (xrow_stream_encode_compressed(stream, iov, iovcnt, &packet) != 0)
+		return -1;
+	if (coio_writev(io, &packet, 1, 0) < 0)
+		return -1;
+	ssize_t size = 0;
+	for (int i = 0; i < iovcnt; i++)
+		size += iov[i].iov_len;
+	return size;
+}
+
 int
 xrow_stream_flush(struct xrow_stream *stream, struct iostream *io)
 {
@@ -152,7 +247,9 @@ xrow_stream_flush(struct xrow_stream *stream, struct iostream *io)
 		int iovcnt = lengthof(iov);
 		int64_t gc_id = lsregion_to_iovec(&stream->lsregion, iov,
 						  &iovcnt, &stream->flush_pos);
-		ssize_t written = coio_writev(io, iov, iovcnt, 0);
+		ssize_t written = stream->zctx != NULL ?
+			xrow_stream_write_compressed(stream, io, iov, iovcnt) :
+			coio_writev(io, iov, iovcnt, 0);
 		if (written < 0)
 			return -1;
 		to_flush -= written;
@@ -160,3 +257,93 @@ xrow_stream_flush(struct xrow_stream *stream, struct iostream *io)
 	}
 	return 0;
 }
+
+void
+xrow_unpack_buf_create(struct xrow_unpack_buf *buf)
+{
+	ibuf_create(&buf->ibuf, &cord()->slabc, 16384);
+	buf->zdctx = NULL;
+}
+
+int
+xrow_unpack_buf_put(struct xrow_unpack_buf *buf, const struct xrow_header *row)
+{
+	assert(row->type == IPROTO_COMPRESSED_ROWS);
+	assert(ibuf_used(&buf->ibuf) == 0);
+	const char *data = NULL;
+	uint32_t size = 0;
+	if (row->bodycnt == 1) {
+		data = (const char *)row->body[0].iov_base;
+		if (mp_typeof(*data) == MP_BIN)
+			data = mp_decode_bin(&data, &size);
+		else
+			data = NULL;
+	}
+	if (data == NULL) {
+		diag_set(ClientError, ER_INVALID_MSGPACK, "compressed rows");
+		return -1;
+	}
+	if (buf->zdctx == NULL) {
+		buf->zdctx = ZSTD_createDStream();
+		if (buf->zdctx == NULL) {
+			diag_set(OutOfMemory, 0, "ZSTD_createDStream",
+				 "zdctx");
+			return -1;
+		}
+	}
+	ibuf_reset(&buf->ibuf);
+	ZSTD_initDStream(buf->zdctx);
+	ZSTD_inBuffer input = {data, size, 0};
+	while (true) {
+		/* Compressed rows are typically several times smaller. */
+		if (ibuf_reserve(&buf->ibuf, 4 * (size_t)size) == NULL) {
+			diag_set(OutOfMemory, 4 * (size_t)size, "ibuf_reserve",
+				 "rows");
+			return -1;
+		}
+		ZSTD_outBuffer output = {buf->ibuf.wpos,
+					 ibuf_unused(&buf->ibuf), 0};
+		size_t rc = ZSTD_decompressStream(buf->zdctx, &output, &input);
+		if (ZSTD_isError(rc)) {
+			diag_set(ClientError, ER_DECOMPRESSION,
+				 ZSTD_getErrorName(rc));
+			return -1;
+		}
+		buf->ibuf.wpos += output.pos;
+		if (rc == 0)
+			break;
+		if (input.pos == input.size && output.pos < output.size) {
+			diag_set(ClientError, ER_DECOMPRESSION,
+				 "truncated frame");
+			return -1;
+		}
+	}
+	if (input.pos != input.size) {
+		diag_set(ClientError, ER_INVALID_MSGPACK, "compressed rows");
+		return -1;
+	}
+	return 0;
+}
+
+int
+xrow_unpack_buf_get(struct xrow_unpack_buf *buf, struct xrow_header *row)
+{
+	struct ibuf *in = &buf->ibuf;
+	if (ibuf_used(in) == 0)
+		return 1;
+	const char *pos = in->rpos;
+	const char *end = in->wpos;
+	if (mp_typeof(*pos) != MP_UINT || mp_check_uint(pos, end) > 0) {
+		diag_set(ClientError, ER_INVALID_MSGPACK, "packet length");
+		return -1;
+	}
+	uint64_t len = mp_decode_uint(&pos);
+	if (len > (uint64_t)(end - pos)) {
+		diag_set(ClientError, ER_INVALID_MSGPACK, "packet length");
+		return -1;
+	}
+	if (xrow_decode(row, &pos, pos + len, true) != 0)
+		return -1;
+	in->rpos = (char *)pos;
+	return 0;
+}
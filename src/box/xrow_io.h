@@ -31,8 +31,10 @@
  * SUCH DAMAGE.
  */
 
+#include "small/ibuf.h"
 #include "small/lsregion.h"
 #include "memory.h"
+#include "zstd.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -68,6 +70,11 @@ struct xrow_stream {
 	int64_t lsr_id;
 	/** A savepoint used between flushes. */
 	struct lsregion_svp flush_pos;
+	/**
+	 * zstd context used to compress the rows on flush or NULL if
+	 * the stream isn't compressed, see xrow_stream_compress().
+	 */
+	ZSTD_CCtx *zctx;
 #ifndef NDEBUG
 	/** A fiber which's currently using the stream. */
 	struct fiber *owner;
@@ -81,6 +88,7 @@ xrow_stream_create(struct xrow_stream *stream)
 	lsregion_create(&stream->lsregion, &runtime);
 	stream->lsr_id = 0;
 	lsregion_svp_create(&stream->flush_pos);
+	stream->zctx = NULL;
 }
 
 static inline void
@@ -88,8 +96,16 @@ xrow_stream_destroy(struct xrow_stream *stream)
 {
 	assert(stream->owner == NULL);
 	lsregion_destroy(&stream->lsregion);
+	ZSTD_freeCCtx(stream->zctx);
 }
 
+/**
+ * Make the stream send the rows written to it compressed with zstd in
+ * IPROTO_COMPRESSED_ROWS packets, one packet per flushed chunk.
+ */
+int
+xrow_stream_compress(struct xrow_stream *stream);
+
 /** Write a row to the stream. */
 void
 xrow_stream_write(struct xrow_stream *stream, const struct xrow_header *row);
@@ -107,6 +123,43 @@ xrow_stream_check_flush(struct xrow_stream *stream, struct iostream *io)
 	return 0;
 }
 
+/**
+ * A buffer for rows unpacked from IPROTO_COMPRESSED_ROWS packets.
+ * The rows are read from the buffer until it's empty, then the next
+ * packet is read from the network.
+ */
+struct xrow_unpack_buf {
+	/** Decompressed rows, each prefixed with its length. */
+	struct ibuf ibuf;
+	/** zstd decompression context, created on demand. */
+	ZSTD_DStream *zdctx;
+};
+
+void
+xrow_unpack_buf_create(struct xrow_unpack_buf *buf);
+
+static inline void
+xrow_unpack_buf_destroy(struct xrow_unpack_buf *buf)
+{
+	ibuf_destroy(&buf->ibuf);
+	ZSTD_freeDStream(buf->zdctx);
+}
+
+/**
+ * Decompress the rows of an IPROTO_COMPRESSED_ROWS packet into the
+ * buffer, which must be empty. Returns 0 on success, -1 on error.
+ */
+int
+xrow_unpack_buf_put(struct xrow_unpack_buf *buf, const struct xrow_header *row);
+
+/**
+ * Decode the next row stored in the buffer. Returns 1 if the buffer
+ * is empty, 0 on success, -1 on error. The row points to the buffer
+ * memory, which is valid until the next xrow_unpack_buf_put().
+ */
+int
+xrow_unpack_buf_get(struct xrow_unpack_buf *buf, struct xrow_header *row);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif
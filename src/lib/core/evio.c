@@ -56,6 +56,12 @@ struct evio_service_entry {
 	struct iostream_ctx io_ctx;
 	/** libev io object for the acceptor socket. */
 	struct ev_io ev;
+	/**
+	 * Acceptor sockets bound with SO_REUSEPORT for the services
+	 * attached to this one, see evio_service::acceptor_count.
+	 * NULL if the entry doesn't use them.
+	 */
+	int *acceptor_fds;
 	/** Pointer to the root evio_service, which contains this object */
 	struct evio_service *service;
 	/** Link to other entries */
@@ -158,6 +164,23 @@ evio_setsockopt_server(int fd, int family, int type)
 	return 0;
 }
 
+/**
+ * Allow binding several acceptor sockets to the same address, so that
+ * the kernel balances incoming connections between them.
+ */
+static int
+evio_setsockopt_reuseport(int fd)
+{
+#ifdef SO_REUSEPORT
+	int on = 1;
+	return sio_setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+#else
+	errno = ENOPROTOOPT;
+	diag_set(SocketError, sio_socketname(fd), "setsockopt(SO_REUSEPORT)");
+	return -1;
+#endif
+}
+
 static inline const char *
 evio_service_name(struct evio_service *service)
 {
@@ -292,6 +315,65 @@ evio_service_entry_bind_addr(struct evio_service_entry *entry)
 	return -1;
 }
 
+/** Close the acceptor sockets bound for attached services. */
+static void
+evio_service_entry_close_acceptors(struct evio_service_entry *entry)
+{
+	if (entry->acceptor_fds == NULL)
+		return;
+	for (int i = 0; i < entry->service->acceptor_count; i++) {
+		int fd = entry->acceptor_fds[i];
+		if (fd >= 0 && close(fd) < 0) {
+			say_error("Failed to close socket: %s",
+				  tt_strerror(errno));
+		}
+	}
+	free(entry->acceptor_fds);
+	entry->acceptor_fds = NULL;
+}
+
+/**
+ * Replace the socket bound by evio_service_entry_bind_addr() with
+ * evio_service::acceptor_count sockets bound to the same address with
+ * SO_REUSEPORT, one for each attached service.
+ *
+ * The first socket is bound without SO_REUSEPORT so that we fail if
+ * the address is already in use, including by a SO_REUSEPORT group of
+ * another process. It's closed right before the acceptor sockets are
+ * bound, because a socket without SO_REUSEPORT can't share the address
+ * with them.
+ */
+static int
+evio_service_entry_bind_acceptors(struct evio_service_entry *entry)
+{
+	int count = entry->service->acceptor_count;
+	assert(count > 0);
+	assert(entry->acceptor_fds == NULL);
+	assert(entry->addr.sa_family != AF_UNIX);
+	entry->acceptor_fds = xmalloc(count * sizeof(int));
+	for (int i = 0; i < count; i++)
+		entry->acceptor_fds[i] = -1;
+	if (close(entry->ev.fd) < 0)
+		say_error("Failed to close socket: %s", tt_strerror(errno));
+	ev_io_set(&entry->ev, -1, 0);
+	for (int i = 0; i < count; i++) {
+		int fd = sio_socket(entry->addr.sa_family,
+				    SOCK_STREAM, IPPROTO_TCP);
+		if (fd < 0)
+			return -1;
+		entry->acceptor_fds[i] = fd;
+		if (evio_setsockopt_server(fd, entry->addr.sa_family,
+					   SOCK_STREAM) != 0 ||
+		    evio_setsockopt_reuseport(fd) != 0 ||
+		    sio_bind(fd, &entry->addr, entry->addr_len) != 0)
+			return -1;
+	}
+	say_debug("%s: bound %d SO_REUSEPORT acceptor sockets to %s",
+		  evio_service_name(entry->service), count,
+		  sio_strfaddr(&entry->addr, entry->addr_len));
+	return 0;
+}
+
 /**
  * Listen on bounded port.
  *
@@ -304,6 +386,13 @@ evio_service_entry_listen(struct evio_service_entry *entry)
 		  evio_service_name(entry->service),
 		  sio_strfaddr(&entry->addr, entry->addr_len));
 
+	if (entry->acceptor_fds != NULL) {
+		for (int i = 0; i < entry->service->acceptor_count; i++) {
+			if (sio_listen(entry->acceptor_fds[i]) != 0)
+				return -1;
+		}
+		return 0;
+	}
 	int fd = entry->ev.fd;
 	if (sio_listen(fd))
 		return -1;
@@ -327,6 +416,7 @@ evio_service_entry_create(struct evio_service_entry *entry,
 	ev_init(&entry->ev, evio_service_entry_accept_cb);
 	ev_io_set(&entry->ev, -1, 0);
 	entry->ev.data = entry;
+	entry->acceptor_fds = NULL;
 	entry->service = service;
 	rlist_create(&entry->link);
 }
@@ -429,7 +519,9 @@ evio_service_bind_uri(struct evio_service *service, const struct uri *u)
 		uri_copy(&entry->uri, u);
 		memcpy(&entry->addr, ai->ai_addr, ai->ai_addrlen);
 		entry->addr_len = ai->ai_addrlen;
-		if (evio_service_entry_bind_addr(entry) != 0) {
+		if (evio_service_entry_bind_addr(entry) != 0 ||
+		    (service->acceptor_count > 0 &&
+		     evio_service_entry_bind_acceptors(entry) != 0)) {
 			say_error("%s: failed to bind on %s: %s",
 				  evio_service_name(entry->service),
 				  sio_strfaddr(ai->ai_addr, ai->ai_addrlen),
@@ -467,6 +559,7 @@ static void
 evio_service_entry_stop(struct evio_service_entry *entry)
 {
 	int service_fd = entry->ev.fd;
+	evio_service_entry_close_acceptors(entry);
 	evio_service_entry_detach(entry);
 	if (service_fd < 0)
 		return;
@@ -496,7 +589,13 @@ evio_service_entry_attach(struct evio_service_entry *dst,
 	dst->addrstorage = src->addrstorage;
 	dst->addr_len = src->addr_len;
 	iostream_ctx_copy(&dst->io_ctx, &src->io_ctx);
-	ev_io_set(&dst->ev, src->ev.fd, EV_READ);
+	int fd = src->ev.fd;
+	if (src->acceptor_fds != NULL) {
+		int idx = dst->service->acceptor_idx;
+		assert(idx >= 0 && idx < src->service->acceptor_count);
+		fd = src->acceptor_fds[idx];
+	}
+	ev_io_set(&dst->ev, fd, EV_READ);
 	ev_io_start(dst->service->loop, &dst->ev);
 }
 
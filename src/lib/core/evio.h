@@ -89,6 +89,21 @@ struct evio_service {
 	evio_accept_f on_accept;
 	/**  The iproto_thread used in the callback above */
 	void *on_accept_param;
+	/**
+	 * If > 0, for each TCP address the service binds this many
+	 * acceptor sockets with SO_REUSEPORT instead of one socket, so
+	 * that each service attached to this one accepts connections on
+	 * its own socket and the kernel balances incoming connections
+	 * between them. The service doesn't keep a socket of its own in
+	 * this case.
+	 */
+	int acceptor_count;
+	/**
+	 * Index of the acceptor socket of the source service to use on
+	 * attach if the source service binds acceptor sockets for each
+	 * attached service, see acceptor_count.
+	 */
+	int acceptor_idx;
 	/** Event loop */
 	ev_loop *loop;
 };
@@ -126,6 +141,8 @@ evio_service_stop(struct evio_service *service);
 
 /**
  * Updates @a dst evio_service socket settings according @a src evio service.
+ * If @a src binds acceptor sockets for each attached service, @a dst
+ * uses the acceptor sockets with index @a dst->acceptor_idx.
  */
 void
 evio_service_attach(struct evio_service *dst, const struct evio_service *src);
@@ -0,0 +1,188 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2025, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "trivia/config.h"
+
+#if defined(ENABLE_TUPLE_COMPRESSION)
+# error unimplemented
+#endif
+
+#include "mp_compression.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "msgpuck.h"
+#include "mp_extension_types.h"
+
+/*
+ * The MP_COMPRESSION extension data is encoded as follows:
+ *
+ *   <compression type: uint> <dictionary ID: uint> <raw size: uint>
+ *   <compressed frame>
+ *
+ * where the dictionary ID is 0 if the frame was compressed without
+ * a dictionary and the raw size is the size of the original MsgPack
+ * value (including its header).
+ */
+
+enum {
+	/**
+	 * Max size of the extension header and the header of its data:
+	 * ext32 header + compression type + dictionary ID + raw size.
+	 */
+	MP_COMPRESSION_HEADER_SIZE_MAX = 6 + 1 + 5 + 5,
+};
+
+/**
+ * Decodes the header of the MP_COMPRESSION extension data, advances
+ * data to the compressed frame and returns the raw size. Returns 0
+ * if the data is malformed.
+ */
+static uint32_t
+compression_decode_header(const char **data, const char *end,
+			  uint32_t *dict_id)
+{
+	uint64_t fields[3];
+	for (int i = 0; i < (int)lengthof(fields); i++) {
+		if (*data >= end || mp_typeof(**data) != MP_UINT ||
+		    mp_check_uint(*data, end) > 0)
+			return 0;
+		fields[i] = mp_decode_uint(data);
+	}
+	if (fields[0] == COMPRESSION_TYPE_NONE ||
+	    fields[0] >= compression_type_MAX ||
+	    fields[1] > UINT32_MAX || fields[2] > UINT32_MAX)
+		return 0;
+	*dict_id = fields[1];
+	return fields[2];
+}
+
+/**
+ * Decompresses the MP_COMPRESSION extension data of the given length
+ * into dst and advances data. Returns the raw size or 0 on error.
+ */
+static size_t
+compression_decode(const char **data, uint32_t len, char *dst, size_t dst_size)
+{
+	const char *end = *data + len;
+	uint32_t dict_id;
+	uint32_t raw_size = compression_decode_header(data, end, &dict_id);
+	if (raw_size == 0 || raw_size > dst_size)
+		return 0;
+	size_t size = tt_decompress(dict_id, *data, end - *data,
+				    dst, raw_size);
+	if (size != raw_size)
+		return 0;
+	*data = end;
+	return size;
+}
+
+size_t
+mp_compress_bound(size_t src_size)
+{
+	return MP_COMPRESSION_HEADER_SIZE_MAX + tt_compress_bound(src_size);
+}
+
+char *
+mp_compress(char *dst, const char *src, size_t src_size,
+	    struct tt_compression_ctx *ctx)
+{
+	assert(src_size > 0 && src_size <= UINT32_MAX);
+	/*
+	 * The size of the extension header depends on the size of
+	 * the compressed frame so compress the data past the max
+	 * header size and then move it right after the header.
+	 */
+	char *frame = dst + MP_COMPRESSION_HEADER_SIZE_MAX;
+	uint32_t dict_id;
+	size_t frame_size = tt_compress(ctx, src, src_size, frame,
+					tt_compress_bound(src_size), &dict_id);
+	if (frame_size == 0)
+		return NULL;
+	uint32_t len = mp_sizeof_uint(ctx->type) + mp_sizeof_uint(dict_id) +
+		       mp_sizeof_uint(src_size) + frame_size;
+	char *data = mp_encode_extl(dst, MP_COMPRESSION, len);
+	data = mp_encode_uint(data, ctx->type);
+	data = mp_encode_uint(data, dict_id);
+	data = mp_encode_uint(data, src_size);
+	assert(data <= frame);
+	memmove(data, frame, frame_size);
+	return data + frame_size;
+}
+
+size_t
+mp_sizeof_decompressed(const char *src)
+{
+	assert(mp_typeof(*src) == MP_EXT);
+	int8_t type;
+	uint32_t len = mp_decode_extl(&src, &type);
+	if (type != MP_COMPRESSION)
+		return 0;
+	uint32_t dict_id;
+	return compression_decode_header(&src, src + len, &dict_id);
+}
+
+size_t
+mp_decompress(const char **src, char *dst, size_t dst_size)
+{
+	assert(mp_typeof(**src) == MP_EXT);
+	const char *data = *src;
+	int8_t type;
+	uint32_t len = mp_decode_extl(&data, &type);
+	if (type != MP_COMPRESSION)
+		return 0;
+	size_t size = compression_decode(&data, len, dst, dst_size);
+	if (size == 0)
+		return 0;
+	*src = data;
+	return size;
+}
+
+/**
+ * Decompresses the MP_COMPRESSION extension data to a newly allocated
+ * buffer. Returns NULL on error. The buffer must be freed by the caller.
+ */
+static char *
+compression_decode_alloc(const char **data, uint32_t len)
+{
+	const char *header = *data;
+	uint32_t dict_id;
+	uint32_t raw_size = compression_decode_header(&header, *data + len,
+						      &dict_id);
+	if (raw_size == 0)
+		return NULL;
+	char *raw = malloc(raw_size);
+	if (raw == NULL)
+		return NULL;
+	if (compression_decode(data, len, raw, raw_size) == 0) {
+		free(raw);
+		return NULL;
+	}
+	return raw;
+}
+
+int
+mp_snprint_compression(char *buf, int size, const char **data, uint32_t len)
+{
+	char *raw = compression_decode_alloc(data, len);
+	if (raw == NULL)
+		return -1;
+	int rc = mp_snprint(buf, size, raw);
+	free(raw);
+	return rc;
+}
+
+int
+mp_fprint_compression(FILE *file, const char **data, uint32_t len)
+{
+	char *raw = compression_decode_alloc(data, len);
+	if (raw == NULL)
+		return -1;
+	int rc = mp_fprint(file, raw);
+	free(raw);
+	return rc;
+}
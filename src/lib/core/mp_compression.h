@@ -20,48 +20,44 @@
 extern "C" {
 #endif
 
-static inline char *
+/**
+ * Returns the max size of a MsgPack value of the given size compressed
+ * with mp_compress().
+ */
+size_t
+mp_compress_bound(size_t src_size);
+
+/**
+ * Compresses a MsgPack value of the given size into the MP_COMPRESSION
+ * extension written to dst, which must have mp_compress_bound() bytes.
+ * Returns a pointer to the end of the written data or NULL on error.
+ */
+char *
 mp_compress(char *dst, const char *src, size_t src_size,
-	    enum compression_type type)
-{
-        (void)dst;
-        (void)src;
-        (void)src_size;
-        (void)type;
-        unreachable();
-        return NULL;
-}
+	    struct tt_compression_ctx *ctx);
 
-static inline size_t
-mp_decompress(const char **src, char *dst, size_t dst_size)
-{
-        (void)src;
-        (void)dst;
-        (void)dst_size;
-        unreachable();
-        return 0;
-}
+/**
+ * Returns the size of the MsgPack value stored in the MP_COMPRESSION
+ * extension or 0 if the extension is malformed.
+ */
+size_t
+mp_sizeof_decompressed(const char *src);
+
+/**
+ * Decompresses the MP_COMPRESSION extension into dst, which must have
+ * at least mp_sizeof_decompressed() bytes, and advances src. Returns
+ * the size of the decompressed MsgPack value or 0 on error.
+ */
+size_t
+mp_decompress(const char **src, char *dst, size_t dst_size);
 
-static inline int
-mp_snprint_compression(char *buf, int size, const char **data, uint32_t len)
-{
-        (void)buf;
-        (void)size;
-        (void)data;
-        (void)len;
-        unreachable();
-        return -1;
-}
+/** Prints the MP_COMPRESSION extension data as the decompressed value. */
+int
+mp_snprint_compression(char *buf, int size, const char **data, uint32_t len);
 
-static inline int
-mp_fprint_compression(FILE *file, const char **data, uint32_t len)
-{
-        (void)file;
-        (void)data;
-        (void)len;
-        unreachable();
-        return -1;
-}
+/** See mp_snprint_compression(). */
+int
+mp_fprint_compression(FILE *file, const char **data, uint32_t len);
 
 #if defined(__cplusplus)
 } /* extern "C" */
@@ -9,6 +9,377 @@
 # error unimplemented
 #endif
 
+#include "tt_compression.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zstd.h"
+#include "zdict.h"
+
+#include "coio_task.h"
+#include "trivia/util.h"
+
 const char *compression_type_strs[] = {
-        "none",
+	"none",
+	"zstd",
+	"zstd_dict",
+};
+
+enum {
+	/** Compression level used for all the values. */
+	TT_COMPRESSION_LEVEL = 3,
+	/** Max size of a trained dictionary. */
+	TT_COMPRESSION_DICT_SIZE = 8 * 1024,
+	/** Total size of the samples used to train a dictionary. */
+	TT_COMPRESSION_DICT_SAMPLES_SIZE = 256 * 1024,
+	/** Max number of the samples used to train a dictionary. */
+	TT_COMPRESSION_DICT_SAMPLE_COUNT = 2048,
+	/** Max size of a value used as a sample. */
+	TT_COMPRESSION_DICT_SAMPLE_SIZE_MAX = 8 * 1024,
+};
+
+/** Shared compression dictionary. */
+struct tt_compression_dict {
+	/** ID stored along with the compressed data, starts from 1. */
+	uint32_t id;
+	/** Number of compression contexts using the dictionary. */
+	int refs;
+	/** Digested dictionary for compression. */
+	ZSTD_CDict *cdict;
+	/** Digested dictionary for decompression. */
+	ZSTD_DDict *ddict;
+};
+
+enum {
+	/** Number of dictionary slots in a chunk. */
+	TT_COMPRESSION_DICT_CHUNK_SIZE = 1024,
+	/** Max number of dictionary chunks. */
+	TT_COMPRESSION_DICT_CHUNK_COUNT = 1024,
 };
+
+/**
+ * Dictionaries indexed by ID - 1, split in chunks so that the array never
+ * has to be reallocated. Dictionaries are looked up by threads writing
+ * checkpoints, so a new dictionary is published with a release store and
+ * looked up without locks. IDs are never reused, so a dictionary can't be
+ * replaced under a reader. A dictionary is freed only when no compression
+ * context uses it, which means there are no values compressed with it
+ * left: a compressed tuple references its format, which owns the context.
+ * Dictionaries are only created and freed in the TX thread.
+ */
+static struct tt_compression_dict **dict_chunks[
+	TT_COMPRESSION_DICT_CHUNK_COUNT];
+/** ID of the last created dictionary. */
+static uint32_t dict_last_id;
+
+/** Compression context of the current thread, created on demand. */
+static __thread ZSTD_CCtx *zcctx;
+/** Decompression context of the current thread, created on demand. */
+static __thread ZSTD_DCtx *zdctx;
+
+/** Returns the slot of a dictionary with the given ID. */
+static struct tt_compression_dict **
+tt_compression_dict_slot(struct tt_compression_dict **chunk, uint32_t id)
+{
+	return &chunk[(id - 1) % TT_COMPRESSION_DICT_CHUNK_SIZE];
+}
+
+/**
+ * Digests a dictionary trained from samples. Returns NULL on error.
+ * May be called from any thread.
+ */
+static struct tt_compression_dict *
+tt_compression_dict_new(const char *data, size_t size)
+{
+	struct tt_compression_dict *dict = xmalloc(sizeof(*dict));
+	dict->id = 0;
+	dict->refs = 0;
+	dict->cdict = ZSTD_createCDict(data, size, TT_COMPRESSION_LEVEL);
+	dict->ddict = ZSTD_createDDict(data, size);
+	if (dict->cdict == NULL || dict->ddict == NULL) {
+		ZSTD_freeCDict(dict->cdict);
+		ZSTD_freeDDict(dict->ddict);
+		free(dict);
+		return NULL;
+	}
+	return dict;
+}
+
+/** Frees a dictionary that isn't registered. */
+static void
+tt_compression_dict_delete(struct tt_compression_dict *dict)
+{
+	ZSTD_freeCDict(dict->cdict);
+	ZSTD_freeDDict(dict->ddict);
+	free(dict);
+}
+
+/**
+ * Assigns an ID to a dictionary and publishes it for lookups. Returns -1
+ * if IDs are exhausted.
+ */
+static int
+tt_compression_dict_register(struct tt_compression_dict *dict)
+{
+	if (dict_last_id == (uint32_t)TT_COMPRESSION_DICT_CHUNK_SIZE *
+			    TT_COMPRESSION_DICT_CHUNK_COUNT)
+		return -1;
+	uint32_t id = dict_last_id + 1;
+	uint32_t chunk_no = (id - 1) / TT_COMPRESSION_DICT_CHUNK_SIZE;
+	struct tt_compression_dict **chunk = dict_chunks[chunk_no];
+	if (chunk == NULL) {
+		chunk = xcalloc(TT_COMPRESSION_DICT_CHUNK_SIZE,
+				sizeof(*chunk));
+		__atomic_store_n(&dict_chunks[chunk_no], chunk,
+				 __ATOMIC_RELEASE);
+	}
+	dict->id = id;
+	__atomic_store_n(tt_compression_dict_slot(chunk, id), dict,
+			 __ATOMIC_RELEASE);
+	dict_last_id = id;
+	return 0;
+}
+
+static inline void
+tt_compression_dict_ref(struct tt_compression_dict *dict)
+{
+	dict->refs++;
+}
+
+/** Unregisters and frees the dictionary when the last reference is gone. */
+static void
+tt_compression_dict_unref(struct tt_compression_dict *dict)
+{
+	assert(dict->refs > 0);
+	if (--dict->refs > 0)
+		return;
+	uint32_t chunk_no = (dict->id - 1) / TT_COMPRESSION_DICT_CHUNK_SIZE;
+	struct tt_compression_dict **slot =
+		tt_compression_dict_slot(dict_chunks[chunk_no], dict->id);
+	__atomic_store_n(slot, NULL, __ATOMIC_RELAXED);
+	tt_compression_dict_delete(dict);
+}
+
+/** Looks up a dictionary by ID. Returns NULL if not found. */
+static struct tt_compression_dict *
+tt_compression_dict_by_id(uint32_t id)
+{
+	if (id == 0 || id > (uint32_t)TT_COMPRESSION_DICT_CHUNK_SIZE *
+			    TT_COMPRESSION_DICT_CHUNK_COUNT)
+		return NULL;
+	struct tt_compression_dict **chunk = __atomic_load_n(
+		&dict_chunks[(id - 1) / TT_COMPRESSION_DICT_CHUNK_SIZE],
+		__ATOMIC_ACQUIRE);
+	if (chunk == NULL)
+		return NULL;
+	return __atomic_load_n(tt_compression_dict_slot(chunk, id),
+			       __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Task training a dictionary in a coio thread. The samples are moved from
+ * the compression context to the task so that the context may go on
+ * compressing values without a dictionary until the training is over.
+ */
+struct tt_compression_train_task {
+	/** Base class. */
+	struct coio_task base;
+	/** Context to set the dictionary for, NULL if it was deleted. */
+	struct tt_compression_ctx *ctx;
+	/** Buffer with the concatenated samples. */
+	char *samples;
+	/** Array of the sample sizes. */
+	size_t *sample_sizes;
+	/** Number of samples. */
+	uint32_t sample_count;
+	/** Trained dictionary, NULL if training failed. */
+	struct tt_compression_dict *dict;
+};
+
+/** Trains a dictionary on the samples. Runs in a coio thread. */
+static int
+tt_compression_train_task_f(struct coio_task *base)
+{
+	struct tt_compression_train_task *task =
+		(struct tt_compression_train_task *)base;
+	char *dict_data = xmalloc(TT_COMPRESSION_DICT_SIZE);
+	size_t size = ZDICT_trainFromBuffer(
+		dict_data, TT_COMPRESSION_DICT_SIZE, task->samples,
+		task->sample_sizes, task->sample_count);
+	if (!ZDICT_isError(size))
+		task->dict = tt_compression_dict_new(dict_data, size);
+	free(dict_data);
+	return 0;
+}
+
+/**
+ * Sets the trained dictionary for the context unless it was deleted.
+ * Runs in the TX thread.
+ */
+static int
+tt_compression_train_task_done_f(struct coio_task *base)
+{
+	struct tt_compression_train_task *task =
+		(struct tt_compression_train_task *)base;
+	struct tt_compression_ctx *ctx = task->ctx;
+	struct tt_compression_dict *dict = task->dict;
+	if (dict != NULL &&
+	    (ctx == NULL || tt_compression_dict_register(dict) != 0)) {
+		tt_compression_dict_delete(dict);
+		dict = NULL;
+	}
+	if (ctx != NULL) {
+		assert(ctx->train_task == task);
+		ctx->train_task = NULL;
+		if (dict != NULL) {
+			tt_compression_dict_ref(dict);
+			ctx->dict = dict;
+		}
+	}
+	free(task->samples);
+	free(task->sample_sizes);
+	coio_task_destroy(&task->base);
+	TRASH(task);
+	free(task);
+	return 0;
+}
+
+/** Frees the samples collected to train a dictionary. */
+static void
+tt_compression_ctx_free_samples(struct tt_compression_ctx *ctx)
+{
+	free(ctx->samples);
+	free(ctx->sample_sizes);
+	ctx->samples = NULL;
+	ctx->sample_sizes = NULL;
+	ctx->samples_size = 0;
+	ctx->sample_count = 0;
+}
+
+/**
+ * Starts training the dictionary on the collected samples in a coio
+ * thread. Until the training is over or if it fails, the values are
+ * compressed without a dictionary.
+ */
+static void
+tt_compression_ctx_train_dict(struct tt_compression_ctx *ctx)
+{
+	assert(ctx->train_task == NULL);
+	struct tt_compression_train_task *task = xmalloc(sizeof(*task));
+	coio_task_create(&task->base, tt_compression_train_task_f,
+			 tt_compression_train_task_done_f);
+	task->ctx = ctx;
+	task->samples = ctx->samples;
+	task->sample_sizes = ctx->sample_sizes;
+	task->sample_count = ctx->sample_count;
+	task->dict = NULL;
+	ctx->samples = NULL;
+	ctx->sample_sizes = NULL;
+	ctx->samples_size = 0;
+	ctx->sample_count = 0;
+	ctx->train_task = task;
+	ctx->is_dict_done = true;
+	coio_task_post(&task->base);
+}
+
+/** Adds a sample to train the dictionary on. */
+static void
+tt_compression_ctx_add_sample(struct tt_compression_ctx *ctx,
+			      const char *data, size_t size)
+{
+	if (size > TT_COMPRESSION_DICT_SAMPLE_SIZE_MAX)
+		return;
+	if (ctx->samples == NULL) {
+		ctx->samples = xmalloc(TT_COMPRESSION_DICT_SAMPLES_SIZE);
+		ctx->sample_sizes = xmalloc(TT_COMPRESSION_DICT_SAMPLE_COUNT *
+					    sizeof(*ctx->sample_sizes));
+	}
+	if (ctx->samples_size + size > TT_COMPRESSION_DICT_SAMPLES_SIZE) {
+		tt_compression_ctx_train_dict(ctx);
+		return;
+	}
+	memcpy(ctx->samples + ctx->samples_size, data, size);
+	ctx->samples_size += size;
+	ctx->sample_sizes[ctx->sample_count++] = size;
+	if (ctx->sample_count == TT_COMPRESSION_DICT_SAMPLE_COUNT)
+		tt_compression_ctx_train_dict(ctx);
+}
+
+struct tt_compression_ctx *
+tt_compression_ctx_new(enum compression_type type)
+{
+	assert(type != COMPRESSION_TYPE_NONE && type < compression_type_MAX);
+	struct tt_compression_ctx *ctx = xcalloc(1, sizeof(*ctx));
+	ctx->type = type;
+	ctx->is_dict_done = type != COMPRESSION_TYPE_ZSTD_DICT;
+	return ctx;
+}
+
+void
+tt_compression_ctx_delete(struct tt_compression_ctx *ctx)
+{
+	/* The training task will free the dictionary on completion. */
+	if (ctx->train_task != NULL)
+		ctx->train_task->ctx = NULL;
+	if (ctx->dict != NULL)
+		tt_compression_dict_unref(ctx->dict);
+	tt_compression_ctx_free_samples(ctx);
+	free(ctx);
+}
+
+size_t
+tt_compress_bound(size_t size)
+{
+	return ZSTD_compressBound(size);
+}
+
+size_t
+tt_compress(struct tt_compression_ctx *ctx, const char *src, size_t src_size,
+	    char *dst, size_t dst_size, uint32_t *dict_id)
+{
+	if (zcctx == NULL) {
+		zcctx = ZSTD_createCCtx();
+		if (zcctx == NULL)
+			return 0;
+	}
+	if (!ctx->is_dict_done)
+		tt_compression_ctx_add_sample(ctx, src, src_size);
+	size_t size;
+	if (ctx->dict != NULL) {
+		size = ZSTD_compress_usingCDict(zcctx, dst, dst_size,
+						src, src_size,
+						ctx->dict->cdict);
+		*dict_id = ctx->dict->id;
+	} else {
+		size = ZSTD_compressCCtx(zcctx, dst, dst_size, src, src_size,
+					 TT_COMPRESSION_LEVEL);
+		*dict_id = 0;
+	}
+	return ZSTD_isError(size) ? 0 : size;
+}
+
+size_t
+tt_decompress(uint32_t dict_id, const char *src, size_t src_size,
+	      char *dst, size_t dst_size)
+{
+	if (zdctx == NULL) {
+		zdctx = ZSTD_createDCtx();
+		if (zdctx == NULL)
+			return 0;
+	}
+	size_t size;
+	if (dict_id != 0) {
+		struct tt_compression_dict *dict =
+			tt_compression_dict_by_id(dict_id);
+		if (dict == NULL)
+			return 0;
+		size = ZSTD_decompress_usingDDict(zdctx, dst, dst_size,
+						  src, src_size, dict->ddict);
+	} else {
+		size = ZSTD_decompressDCtx(zdctx, dst, dst_size,
+					   src, src_size);
+	}
+	return ZSTD_isError(size) ? 0 : size;
+}
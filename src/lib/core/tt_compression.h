@@ -20,12 +20,82 @@ extern "C" {
 #endif
 
 enum compression_type {
-        COMPRESSION_TYPE_NONE = 0,
-        compression_type_MAX
+	COMPRESSION_TYPE_NONE = 0,
+	/** Zstandard, each value is compressed independently. */
+	COMPRESSION_TYPE_ZSTD,
+	/**
+	 * Zstandard with a dictionary trained on the first values
+	 * compressed in the context and shared by all the values.
+	 */
+	COMPRESSION_TYPE_ZSTD_DICT,
+	compression_type_MAX
 };
 
 extern const char *compression_type_strs[];
 
+struct tt_compression_dict;
+struct tt_compression_train_task;
+
+/**
+ * Compression context of a field: the compression type and the state
+ * of the shared dictionary training.
+ */
+struct tt_compression_ctx {
+	/** Compression type. */
+	enum compression_type type;
+	/** Dictionary used for compression, NULL if not trained. */
+	struct tt_compression_dict *dict;
+	/** Task training the dictionary in a coio thread or NULL. */
+	struct tt_compression_train_task *train_task;
+	/** Set if no more samples are collected to train the dictionary. */
+	bool is_dict_done;
+	/** Buffer with the concatenated samples. */
+	char *samples;
+	/** Size of the samples buffer. */
+	size_t samples_size;
+	/** Array of the sample sizes. */
+	size_t *sample_sizes;
+	/** Number of samples. */
+	uint32_t sample_count;
+};
+
+/** Allocates a compression context. Never fails. */
+struct tt_compression_ctx *
+tt_compression_ctx_new(enum compression_type type);
+
+/**
+ * Frees a compression context and the trained dictionary unless it's
+ * used by other contexts. Values compressed with the context must not
+ * outlive it (a compressed tuple references its format, which owns the
+ * context).
+ */
+void
+tt_compression_ctx_delete(struct tt_compression_ctx *ctx);
+
+/** Returns the max size of data of the given size after compression. */
+size_t
+tt_compress_bound(size_t size);
+
+/**
+ * Compresses data. If the context trains a dictionary, the data is
+ * used as a sample. The dictionary is trained in a coio thread, the
+ * data is compressed without a dictionary until it's ready. Returns
+ * the compressed size and sets dict_id to the ID of the used dictionary
+ * or 0. Returns 0 on error. Must be called from the TX thread.
+ */
+size_t
+tt_compress(struct tt_compression_ctx *ctx, const char *src, size_t src_size,
+	    char *dst, size_t dst_size, uint32_t *dict_id);
+
+/**
+ * Decompresses data compressed with the dictionary with the given ID
+ * or without a dictionary if dict_id is 0. May be called from any
+ * thread. Returns the decompressed size or 0 on error.
+ */
+size_t
+tt_decompress(uint32_t dict_id, const char *src, size_t src_size,
+	      char *dst, size_t dst_size);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
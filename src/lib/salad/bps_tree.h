@@ -136,6 +136,9 @@
  *                      alloc_ctx, alloc_stat);
  * void bps_tree_destroy(tree);
  * int bps_tree_build(tree, sorted_array, array_size);
+ * void bps_tree_build_begin(tree, builder, size, fill_factor);
+ * int bps_tree_build_next(builder, elem);
+ * void bps_tree_build_end(builder);
  * void bps_tree_view_create(view, tree);
  * void bps_tree_view_destroy(view);
  * bps_tree_elem_t *bps_tree_find(tree, key);
@@ -316,6 +319,30 @@
  * #define BPS_BLOCK_LINEAR_SEARCH
  */
 
+/**
+ * Optional hooks to narrow the range of block elements that is searched
+ * for the insertion point of a key or an element. Parameters: pointers to
+ * the pointers to the first and the past-the-end elements of the range,
+ * the key (the element) and the additional argument specified for the
+ * tree instance. A hook may shrink the range as long as all the elements
+ * cut off at its beginning are less than the key and all the elements
+ * cut off at its end are greater than the key. It's useful if a part of
+ * an element can be compared much faster than the whole element, e.g.
+ * with SIMD instructions.
+ * Example:
+ * #define BPS_TREE_NARROW_KEY(begin, end, key, arg)\
+ *	my_narrow(begin, end, (key)->hint, arg)
+ */
+#ifndef BPS_TREE_NARROW_KEY
+#define BPS_TREE_NARROW_KEY(begin, end, key, arg) ((void)0)
+#define BPS_TREE_NARROW_KEY_DEFAULT
+#endif
+
+#ifndef BPS_TREE_NARROW_ELEM
+#define BPS_TREE_NARROW_ELEM(begin, end, elem, arg) ((void)0)
+#define BPS_TREE_NARROW_ELEM_DEFAULT
+#endif
+
 /**
  * A switch to make the tree store the cardinality of each of its
  * child blocks in an array. A block cardinality is the amount of
@@ -400,11 +427,15 @@ typedef int64_t bps_tree_block_card_t;
 #define bps_inner _bps(inner)
 #define bps_garbage _bps(garbage)
 #define bps_tree_iterator _api_name(iterator)
+#define bps_tree_builder _api_name(builder)
 #define bps_inner_path_elem _bps(inner_path_elem)
 #define bps_leaf_path_elem _bps(leaf_path_elem)
 
 #define bps_tree_create _api_name(create)
 #define bps_tree_build _api_name(build)
+#define bps_tree_build_begin _api_name(build_begin)
+#define bps_tree_build_next _api_name(build_next)
+#define bps_tree_build_end _api_name(build_end)
 #define bps_tree_destroy _api_name(destroy)
 #define bps_tree_view_create _api_name(view_create)
 #define bps_tree_view_destroy _api_name(view_destroy)
@@ -493,6 +524,9 @@ typedef int64_t bps_tree_block_card_t;
 #define BPS_TREE_BT_INNER _BPS_TREE(BT_INNER)
 #define BPS_TREE_BT_LEAF _BPS_TREE(BT_LEAF)
 
+#define bps_tree_build_fill_size _bps_tree(build_fill_size)
+#define bps_tree_build_block_count _bps_tree(build_block_count)
+#define bps_tree_build_flush_leaf _bps_tree(build_flush_leaf)
 #define bps_tree_restore_block _bps_tree(restore_block)
 #define bps_tree_root _bps_tree(root)
 #define bps_tree_touch_block _bps_tree(touch_block)
@@ -713,6 +747,46 @@ static inline int
 bps_tree_build(struct bps_tree *tree, bps_tree_elem_t *sorted_array,
 	       size_t array_size);
 
+/**
+ * Bulk tree builder, see bps_tree_build_begin(). Defined below.
+ */
+struct bps_tree_builder;
+
+/**
+ * @brief Starts filling a new (asserted) tree with a sorted sequence
+ *  of elements of the known size. The elements are passed one by one
+ *  with bps_tree_build_next(), then bps_tree_build_end() must be called.
+ *  The tree is built in linear time, without any comparisons.
+ * @param tree - pointer to a tree
+ * @param builder - pointer to a builder to initialize
+ * @param size - exact count of elements that will be passed
+ * @param fill_factor - how full the tree blocks should be, from 0 to 1.
+ *  Blocks are filled at least by 2/3 regardless of the value. Free
+ *  space left in blocks makes following insertions cheaper.
+ */
+static inline void
+bps_tree_build_begin(struct bps_tree *tree, struct bps_tree_builder *builder,
+		     size_t size, double fill_factor);
+
+/**
+ * @brief Appends the next element to a tree being built.
+ *  The element must be greater than the previous one, it's not checked!
+ *  On failure the tree is left empty and the builder must not be used.
+ * @param builder - pointer to the builder
+ * @param elem - the element to append
+ * @return 0 on success, -1 on memory error
+ */
+static inline int
+bps_tree_build_next(struct bps_tree_builder *builder, bps_tree_elem_t elem);
+
+/**
+ * @brief Finishes building a tree. All the elements declared in
+ *  bps_tree_build_begin() must have been passed to the builder.
+ * @param builder - pointer to the builder
+ */
+static inline void
+bps_tree_build_end(struct bps_tree_builder *builder);
+
 /**
  * @brief Tree destruction. Frees allocated memory.
  * @param tree - pointer to a tree
@@ -1497,6 +1571,49 @@ struct bps_garbage {
  */
 CT_ASSERT_G(sizeof(struct bps_garbage) <= BPS_TREE_BLOCK_SIZE);
 
+/**
+ * Bulk tree builder. Blocks are filled from left to right; inner
+ * blocks are created on demand and linked to their parents once full.
+ */
+struct bps_tree_builder {
+	/* The tree being built */
+	struct bps_tree_common *tree;
+	/* Total count of elements in the tree */
+	size_t size;
+	/* Count of elements that are still to be appended */
+	size_t elems_left;
+	/* Depth of the resulting tree */
+	bps_tree_block_id_t depth;
+	/* Count of leaves in the resulting tree */
+	bps_tree_block_id_t leaf_count;
+	/* Count of leaves that are still to be filled */
+	bps_tree_block_id_t leaf_left;
+	/* Count of inner blocks created so far */
+	bps_tree_block_id_t inner_count;
+	/* The leaf being filled or NULL */
+	struct bps_leaf *leaf;
+	/* ID of the leaf being filled */
+	bps_tree_block_id_t leaf_id;
+	/* Count of elements the leaf being filled must contain */
+	bps_tree_pos_t leaf_target_size;
+	/* The last filled leaf or NULL */
+	struct bps_leaf *last_leaf;
+	/* IDs of the first and the last filled leaves */
+	bps_tree_block_id_t first_leaf_id, last_leaf_id;
+	/* ID of the root block if it's an inner block */
+	bps_tree_block_id_t root_if_inner_id;
+	/* Count of blocks that are still to be filled on each level */
+	bps_tree_block_id_t level_block_count[BPS_TREE_MAX_DEPTH];
+	/* Count of children that are still to be added on each level */
+	bps_tree_block_id_t level_child_count[BPS_TREE_MAX_DEPTH];
+#if defined(BPS_INNER_CHILD_CARDS) || defined(BPS_INNER_CARD)
+	/* Cardinality of the inner block being filled on each level */
+	bps_tree_block_card_t level_card[BPS_TREE_MAX_DEPTH];
+#endif
+	/* Inner blocks being filled on each level */
+	struct bps_inner *parents[BPS_TREE_MAX_DEPTH];
+};
+
 /**
  * Struct for collecting path in tree, corresponds to one inner block
  */
@@ -1611,168 +1728,236 @@ bps_tree_create(struct bps_tree *t, bps_tree_arg_t arg,
 }
 
 /**
- * @brief Fills a new (asserted) tree with values from sorted array.
- *  Elements are copied from the array. Array is not checked to be sorted!
- * @param t - pointer to a tree
- * @param sorted_array - pointer to the sorted array
- * @param array_size - size of the array (count of elements)
- * @return 0 on success, -1 on memory error
+ * Count of elements (children) in a block that is filled with the given
+ * fill factor. Never less than 2/3 of the block capacity.
  */
-static inline int
-bps_tree_build(struct bps_tree *t, bps_tree_elem_t *sorted_array,
-	       size_t array_size)
+static inline bps_tree_pos_t
+bps_tree_build_fill_size(bps_tree_pos_t max_size, double fill_factor)
+{
+	bps_tree_pos_t min_size = max_size * 2 / 3;
+	if (fill_factor >= 1)
+		return max_size;
+	bps_tree_pos_t fill_size = (bps_tree_pos_t)(max_size * fill_factor);
+	return fill_size > min_size ? fill_size : min_size;
+}
+
+/**
+ * Count of blocks needed to store the given count of elements (children)
+ * if blocks are filled with fill_size elements (children) on average.
+ */
+static inline bps_tree_block_id_t
+bps_tree_build_block_count(size_t count, bps_tree_pos_t max_size,
+			   bps_tree_pos_t fill_size)
+{
+	size_t min_count = (count + max_size - 1) / max_size;
+	size_t fill_count = count / fill_size;
+	return fill_count > min_count ? fill_count : min_count;
+}
+
+static inline void
+bps_tree_build_begin(struct bps_tree *t, struct bps_tree_builder *builder,
+		     size_t size, double fill_factor)
 {
 	struct bps_tree_common *tree = &t->common;
 	assert(tree->size == 0);
 	assert(tree->root_id == (bps_tree_block_id_t)(-1));
 	assert(tree->garbage_head_id == (bps_tree_block_id_t)(-1));
 	assert(tree->matras->head.block_count == 0);
-	if (array_size == 0)
-		return 0;
-	bps_tree_block_id_t leaf_count = (array_size +
-		BPS_TREE_MAX_COUNT_IN_LEAF - 1) / BPS_TREE_MAX_COUNT_IN_LEAF;
+	memset(builder, 0, sizeof(*builder));
+	builder->tree = tree;
+	builder->size = size;
+	builder->elems_left = size;
+	builder->leaf_id = (bps_tree_block_id_t)-1;
+	builder->first_leaf_id = (bps_tree_block_id_t)-1;
+	builder->last_leaf_id = (bps_tree_block_id_t)-1;
+	builder->root_if_inner_id = (bps_tree_block_id_t)-1;
+	if (size == 0)
+		return;
 
-	bps_tree_block_id_t depth = 1;
-	bps_tree_block_id_t level_count = leaf_count;
+	bps_tree_pos_t leaf_fill_size = bps_tree_build_fill_size(
+		BPS_TREE_MAX_COUNT_IN_LEAF, fill_factor);
+	bps_tree_pos_t inner_fill_size = bps_tree_build_fill_size(
+		BPS_TREE_MAX_COUNT_IN_INNER, fill_factor);
+	builder->leaf_count = bps_tree_build_block_count(
+		size, BPS_TREE_MAX_COUNT_IN_LEAF, leaf_fill_size);
+	builder->leaf_left = builder->leaf_count;
+	builder->depth = 1;
+	bps_tree_block_id_t level_count = builder->leaf_count;
 	while (level_count > 1) {
-		level_count = (level_count + BPS_TREE_MAX_COUNT_IN_INNER - 1)
-			      / BPS_TREE_MAX_COUNT_IN_INNER;
-		depth++;
-	}
-
-	/* Initializing by {0} to suppress compile warnings (gh-1287) */
-	bps_tree_block_id_t level_block_count[BPS_TREE_MAX_DEPTH] = {0};
-	bps_tree_block_id_t level_child_count[BPS_TREE_MAX_DEPTH] = {0};
-#if defined(BPS_INNER_CHILD_CARDS) || defined(BPS_INNER_CARD)
-	bps_tree_block_card_t level_card[BPS_TREE_MAX_DEPTH] = {0};
-#endif
-	struct bps_inner *parents[BPS_TREE_MAX_DEPTH];
-	level_count = leaf_count;
-	for (bps_tree_block_id_t i = 0; i < depth - 1; i++) {
-		level_child_count[i] = level_count;
-		level_count = (level_count + BPS_TREE_MAX_COUNT_IN_INNER - 1)
-			      / BPS_TREE_MAX_COUNT_IN_INNER;
-		level_block_count[i] = level_count;
-		parents[i] = 0;
+		bps_tree_block_id_t i = builder->depth - 1;
+		assert(builder->depth < BPS_TREE_MAX_DEPTH);
+		builder->level_child_count[i] = level_count;
+		level_count = bps_tree_build_block_count(
+			level_count, BPS_TREE_MAX_COUNT_IN_INNER,
+			inner_fill_size);
+		builder->level_block_count[i] = level_count;
+		builder->depth++;
 	}
+}
 
-	bps_tree_block_id_t leaf_left = leaf_count;
-	size_t elems_left = array_size;
-	bps_tree_elem_t *current = sorted_array;
-	struct bps_leaf *leaf = 0;
-	bps_tree_block_id_t prev_leaf_id = (bps_tree_block_id_t)-1;
-	bps_tree_block_id_t first_leaf_id = (bps_tree_block_id_t)-1;
-	bps_tree_block_id_t last_leaf_id = (bps_tree_block_id_t)-1;
-	bps_tree_block_id_t inner_count = 0;
-	bps_tree_block_id_t root_if_inner_id = (bps_tree_block_id_t)-1;
-	do {
-		bps_tree_block_id_t id;
-		struct bps_leaf *new_leaf = (struct bps_leaf *)
-			matras_alloc(tree->matras, &id);
-		if (!new_leaf) {
-			matras_reset(tree->matras);
-			return -1;
-		}
-		if (first_leaf_id == (bps_tree_block_id_t)-1)
-			first_leaf_id = id;
-		last_leaf_id = id;
-		if (leaf)
-			leaf->next_id = id;
+/**
+ * Links the completely filled leaf to its parents, creating the parents
+ * if needed.
+ */
+static inline int
+bps_tree_build_flush_leaf(struct bps_tree_builder *builder)
+{
+	struct bps_tree_common *tree = builder->tree;
+	struct bps_leaf *leaf = builder->leaf;
+	bps_tree_block_id_t depth = builder->depth;
+	struct bps_inner **parents = builder->parents;
 
-		leaf = new_leaf;
-		leaf->header.type = BPS_TREE_BT_LEAF;
-		leaf->header.size = elems_left / leaf_left;
-		leaf->prev_id = prev_leaf_id;
-		prev_leaf_id = id;
-		memmove(leaf->elems, current,
-			leaf->header.size * sizeof(*current));
-
-		bps_tree_block_id_t insert_id = id;
-		for (bps_tree_block_id_t i = 0; i < depth - 1; i++) {
-			bps_tree_block_id_t new_id = (bps_tree_block_id_t)-1;
+	bps_tree_block_id_t insert_id = builder->leaf_id;
+	for (bps_tree_block_id_t i = 0; i < depth - 1; i++) {
+		bps_tree_block_id_t new_id = (bps_tree_block_id_t)-1;
+		if (!parents[i]) {
+			parents[i] = (struct bps_inner *)
+				matras_alloc(tree->matras, &new_id);
 			if (!parents[i]) {
-				parents[i] = (struct bps_inner *)
-					matras_alloc(tree->matras, &new_id);
-				if (!parents[i]) {
-					matras_reset(tree->matras);
-					return -1;
-				}
-				parents[i]->header.type = BPS_TREE_BT_INNER;
-				parents[i]->header.size = 0;
-				inner_count++;
-			}
-			parents[i]->child_ids[parents[i]->header.size] =
-				insert_id;
-			if (new_id == (bps_tree_block_id_t)-1)
-				break;
-			if (i == depth - 2) {
-				root_if_inner_id = new_id;
-			} else {
-				insert_id = new_id;
+				matras_reset(tree->matras);
+				return -1;
 			}
+			parents[i]->header.type = BPS_TREE_BT_INNER;
+			parents[i]->header.size = 0;
+			builder->inner_count++;
 		}
+		parents[i]->child_ids[parents[i]->header.size] = insert_id;
+		if (new_id == (bps_tree_block_id_t)-1)
+			break;
+		if (i == depth - 2) {
+			builder->root_if_inner_id = new_id;
+		} else {
+			insert_id = new_id;
+		}
+	}
 
-		bps_tree_elem_t insert_value = current[leaf->header.size - 1];
+	bps_tree_elem_t insert_value = leaf->elems[leaf->header.size - 1];
 #if defined(BPS_INNER_CHILD_CARDS) || defined(BPS_INNER_CARD)
-		bps_tree_block_card_t insert_card = leaf->header.size;
+	bps_tree_block_card_t insert_card = leaf->header.size;
 #endif
-		for (bps_tree_block_id_t i = 0; i < depth - 1; i++) {
+	for (bps_tree_block_id_t i = 0; i < depth - 1; i++) {
 #ifdef BPS_INNER_CHILD_CARDS
-			parents[i]->child_cards[parents[i]->header.size] =
-				insert_card;
+		parents[i]->child_cards[parents[i]->header.size] = insert_card;
 #endif
 #if defined(BPS_INNER_CHILD_CARDS) || defined(BPS_INNER_CARD)
-			level_card[i] += insert_card;
+		builder->level_card[i] += insert_card;
 #endif
-			parents[i]->header.size++;
-			bps_tree_block_id_t max_size = level_child_count[i] /
-						       level_block_count[i];
-			if ((uint32_t)parents[i]->header.size != max_size) {
-				parents[i]->elems[parents[i]->header.size - 1] =
-					insert_value;
-				break;
-			} else {
-				level_child_count[i] -= max_size;
-				level_block_count[i]--;
+		parents[i]->header.size++;
+		bps_tree_block_id_t max_size = builder->level_child_count[i] /
+					       builder->level_block_count[i];
+		if ((uint32_t)parents[i]->header.size != max_size) {
+			parents[i]->elems[parents[i]->header.size - 1] =
+				insert_value;
+			break;
+		} else {
+			builder->level_child_count[i] -= max_size;
+			builder->level_block_count[i]--;
 #ifdef BPS_INNER_CARD
-				parents[i]->card = level_card[i];
+			parents[i]->card = builder->level_card[i];
 #endif
 #if defined(BPS_INNER_CHILD_CARDS) || defined(BPS_INNER_CARD)
-				insert_card = level_card[i];
-				level_card[i] = 0;
+			insert_card = builder->level_card[i];
+			builder->level_card[i] = 0;
 #endif
-				parents[i] = 0;
-			}
+			parents[i] = 0;
 		}
+	}
 
-		leaf_left--;
-		elems_left -= leaf->header.size;
-		current += leaf->header.size;
-	} while (leaf_left);
-	leaf->next_id = (bps_tree_block_id_t)-1;
+	builder->leaf_left--;
+	builder->last_leaf = leaf;
+	builder->last_leaf_id = builder->leaf_id;
+	builder->leaf = NULL;
+	builder->leaf_id = (bps_tree_block_id_t)-1;
+	return 0;
+}
 
-	assert(elems_left == 0);
-	for (bps_tree_block_id_t i = 0; i < depth - 1; i++) {
-		assert(level_child_count[i] == 0);
-		assert(level_block_count[i] == 0);
+static inline int
+bps_tree_build_next(struct bps_tree_builder *builder, bps_tree_elem_t elem)
+{
+	assert(builder->elems_left > 0);
+	struct bps_leaf *leaf = builder->leaf;
+	if (leaf == NULL) {
+		struct bps_tree_common *tree = builder->tree;
+		bps_tree_block_id_t id;
+		leaf = (struct bps_leaf *)matras_alloc(tree->matras, &id);
+		if (!leaf) {
+			matras_reset(tree->matras);
+			return -1;
+		}
+		if (builder->first_leaf_id == (bps_tree_block_id_t)-1)
+			builder->first_leaf_id = id;
+		if (builder->last_leaf != NULL)
+			builder->last_leaf->next_id = id;
+		leaf->header.type = BPS_TREE_BT_LEAF;
+		leaf->header.size = 0;
+		leaf->prev_id = builder->last_leaf_id;
+		leaf->next_id = (bps_tree_block_id_t)-1;
+		builder->leaf = leaf;
+		builder->leaf_id = id;
+		builder->leaf_target_size =
+			builder->elems_left / builder->leaf_left;
+		assert(builder->leaf_target_size > 0);
+		assert(builder->leaf_target_size <= BPS_TREE_MAX_COUNT_IN_LEAF);
+	}
+	leaf->elems[leaf->header.size++] = elem;
+	builder->elems_left--;
+	if (leaf->header.size == builder->leaf_target_size)
+		return bps_tree_build_flush_leaf(builder);
+	return 0;
+}
+
+static inline void
+bps_tree_build_end(struct bps_tree_builder *builder)
+{
+	struct bps_tree_common *tree = builder->tree;
+	assert(builder->elems_left == 0);
+	assert(builder->leaf == NULL);
+	if (builder->size == 0)
+		return;
+	assert(builder->leaf_left == 0);
+	for (bps_tree_block_id_t i = 0; i < builder->depth - 1; i++) {
+		assert(builder->level_child_count[i] == 0);
+		assert(builder->level_block_count[i] == 0);
 #if defined(BPS_INNER_CHILD_CARDS) || defined(BPS_INNER_CARD)
-		assert(level_card[i] == 0);
+		assert(builder->level_card[i] == 0);
 #endif
-		assert(parents[i] == 0);
+		assert(builder->parents[i] == 0);
 	}
 
-	tree->first_id = first_leaf_id;
-	tree->last_id = last_leaf_id;
-	tree->leaf_count = leaf_count;
-	tree->inner_count = inner_count;
-	tree->depth = depth;
-	tree->size = array_size;
-	tree->max_elem = sorted_array[array_size - 1];
-	if (depth == 1) {
-		tree->root_id = first_leaf_id;
+	struct bps_leaf *last_leaf = builder->last_leaf;
+	tree->first_id = builder->first_leaf_id;
+	tree->last_id = builder->last_leaf_id;
+	tree->leaf_count = builder->leaf_count;
+	tree->inner_count = builder->inner_count;
+	tree->depth = builder->depth;
+	tree->size = builder->size;
+	tree->max_elem = last_leaf->elems[last_leaf->header.size - 1];
+	if (builder->depth == 1) {
+		tree->root_id = builder->first_leaf_id;
 	} else {
-		tree->root_id = root_if_inner_id;
+		tree->root_id = builder->root_if_inner_id;
+	}
+}
+
+/**
+ * @brief Fills a new (asserted) tree with values from sorted array.
+ *  Elements are copied from the array. Array is not checked to be sorted!
+ * @param t - pointer to a tree
+ * @param sorted_array - pointer to the sorted array
+ * @param array_size - size of the array (count of elements)
+ * @return 0 on success, -1 on memory error
+ */
+static inline int
+bps_tree_build(struct bps_tree *t, bps_tree_elem_t *sorted_array,
+	       size_t array_size)
+{
+	struct bps_tree_builder builder;
+	bps_tree_build_begin(t, &builder, array_size, 1);
+	for (size_t i = 0; i < array_size; i++) {
+		if (bps_tree_build_next(&builder, sorted_array[i]) != 0)
+			return -1;
 	}
+	bps_tree_build_end(&builder);
 	return 0;
 }
 
@@ -2032,6 +2217,7 @@ bps_tree_find_ins_point_key(const struct bps_tree_common *tree,
 	bps_tree_elem_t *begin = arr;
 	bps_tree_elem_t *end = arr + size;
 	*exact = false;
+	BPS_TREE_NARROW_KEY(&begin, &end, key, tree->arg);
 #ifdef BPS_BLOCK_LINEAR_SEARCH
 	while (begin != end) {
 		int res = BPS_TREE_COMPARE_KEY(*begin, key, tree->arg);
@@ -2077,6 +2263,7 @@ bps_tree_find_ins_point_elem(const struct bps_tree_common *tree,
 	bps_tree_elem_t *begin = arr;
 	bps_tree_elem_t *end = arr + size;
 	*exact = false;
+	BPS_TREE_NARROW_ELEM(&begin, &end, elem, tree->arg);
 #ifdef BPS_BLOCK_LINEAR_SEARCH
 	while (begin != end) {
 		int res = BPS_TREE_COMPARE(*begin, elem, tree->arg);
@@ -2164,6 +2351,7 @@ bps_tree_find_after_ins_point_key(const struct bps_tree_common *tree,
 	bps_tree_elem_t *begin = arr;
 	bps_tree_elem_t *end = arr + size;
 	*exact = false;
+	BPS_TREE_NARROW_KEY(&begin, &end, key, tree->arg);
 #ifdef BPS_BLOCK_LINEAR_SEARCH
 	while (begin != end) {
 		int res = BPS_TREE_COMPARE_KEY(*begin, key, tree->arg);
@@ -2209,6 +2397,7 @@ bps_tree_find_after_ins_point_elem(const struct bps_tree_common *tree,
 	bps_tree_elem_t *begin = arr;
 	bps_tree_elem_t *end = arr + size;
 	*exact = false;
+	BPS_TREE_NARROW_ELEM(&begin, &end, elem, tree->arg);
 #ifdef BPS_BLOCK_LINEAR_SEARCH
 	while (begin != end) {
 		int res = BPS_TREE_COMPARE(*begin, elem, tree->arg);
@@ -7657,11 +7846,15 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef bps_inner
 #undef bps_garbage
 #undef bps_tree_iterator
+#undef bps_tree_builder
 #undef bps_inner_path_elem
 #undef bps_leaf_path_elem
 
 #undef bps_tree_create
 #undef bps_tree_build
+#undef bps_tree_build_begin
+#undef bps_tree_build_next
+#undef bps_tree_build_end
 #undef bps_tree_destroy
 #undef bps_tree_view_create
 #undef bps_tree_view_destroy
@@ -7743,6 +7936,9 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef BPS_TREE_BT_INNER
 #undef BPS_TREE_BT_LEAF
 
+#undef bps_tree_build_fill_size
+#undef bps_tree_build_block_count
+#undef bps_tree_build_flush_leaf
 #undef bps_tree_restore_block
 #undef bps_tree_root
 #undef bps_tree_touch_block
@@ -7824,6 +8020,15 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef bps_tree_debug_check_insert_and_move_to_right_inner
 #undef bps_tree_debug_check_insert_and_move_to_left_inner
 
+#ifdef BPS_TREE_NARROW_KEY_DEFAULT
+#undef BPS_TREE_NARROW_KEY
+#undef BPS_TREE_NARROW_KEY_DEFAULT
+#endif
+#ifdef BPS_TREE_NARROW_ELEM_DEFAULT
+#undef BPS_TREE_NARROW_ELEM
+#undef BPS_TREE_NARROW_ELEM_DEFAULT
+#endif
+
 /* }}} */
 
 #ifdef BPS_TREE_NAMESPACE
@@ -91,6 +91,19 @@
 #error "LIGHT_EQUAL_KEY must be defined"
 #endif
 
+/**
+ * Optional hash checking function. Takes 2 parameters - hash and
+ * optional value that stored in hash table struct. Returns true if
+ * two records with the given hash are known to be equal, so that
+ * LIGHT_EQUAL and LIGHT_EQUAL_KEY may be skipped. Useful if the hash
+ * encodes the whole value for some records. By default the hash is
+ * never considered sufficient.
+ */
+#ifndef LIGHT_EQUAL_HASH
+#define LIGHT_EQUAL_HASH(hash, garb) false
+#define LIGHT_EQUAL_HASH_DEFAULT
+#endif
+
 /**
  * Tools for name substitution:
  */
@@ -571,7 +584,8 @@ LIGHT(find_impl)(const struct LIGHT(common) *ht, uint32_t hash,
 		return LIGHT(end);
 	while (1) {
 		if (record->hash == hash
-		    && LIGHT_EQUAL((record->value), (value), (ht->arg)))
+		    && (LIGHT_EQUAL_HASH((hash), (ht->arg))
+			|| LIGHT_EQUAL((record->value), (value), (ht->arg))))
 			return slot;
 		slot = record->next;
 		if (slot == LIGHT(end))
@@ -615,7 +629,8 @@ LIGHT(find_key_impl)(const struct LIGHT(common) *ht, uint32_t hash,
 		return LIGHT(end);
 	while (1) {
 		if (record->hash == hash &&
-		    LIGHT_EQUAL_KEY((record->value), (key), (ht->arg)))
+		    (LIGHT_EQUAL_HASH((hash), (ht->arg)) ||
+		     LIGHT_EQUAL_KEY((record->value), (key), (ht->arg))))
 			return slot;
 		slot = record->next;
 		if (slot == LIGHT(end))
@@ -660,7 +675,8 @@ LIGHT(replace)(struct LIGHT(core) *htab, uint32_t hash,
 		return LIGHT(end);
 	while (1) {
 		if (record->hash == hash
-		    && LIGHT_EQUAL((record->value), (value), (ht->arg))) {
+		    && (LIGHT_EQUAL_HASH((hash), (ht->arg))
+			|| LIGHT_EQUAL((record->value), (value), (ht->arg)))) {
 			record = LIGHT(touch_record)(ht, slot);
 			if (!record)
 				return LIGHT(end);
@@ -1100,7 +1116,8 @@ LIGHT(delete_value)(struct LIGHT(core) *htab, uint32_t hash,
 	struct LIGHT(record) *prev_record = 0;
 	while (1) {
 		if (record->hash == hash
-		    && LIGHT_EQUAL((record->value), (value), (ht->arg)))
+		    && (LIGHT_EQUAL_HASH((hash), (ht->arg))
+			|| LIGHT_EQUAL((record->value), (value), (ht->arg))))
 			break;
 		prev_slot = slot;
 		slot = record->next;
@@ -1364,3 +1381,7 @@ LIGHT(selfcheck)(const struct LIGHT(core) *htab)
 	return res;
 }
 
+#ifdef LIGHT_EQUAL_HASH_DEFAULT
+#undef LIGHT_EQUAL_HASH
+#undef LIGHT_EQUAL_HASH_DEFAULT
+#endif
@@ -78,6 +78,7 @@
 #include "box/lua/console.h"
 #include "box/session.h"
 #include "box/memtx_tx.h"
+#include "box/hint_search.h"
 #include "box/module_cache.h"
 #include "box/watcher.h"
 #include "systemd.h"
@@ -1004,6 +1005,7 @@ main(int argc, char **argv)
 	random_init();
 
 	crc32_init();
+	hint_search_init();
 	memory_init();
 
 	main_argc = argc;
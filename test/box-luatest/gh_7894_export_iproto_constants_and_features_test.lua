@@ -92,6 +92,7 @@ local reference_table = {
         IS_CHECKPOINT_JOIN = 0x62,
         CHECKPOINT_VCLOCK = 0x63,
         CHECKPOINT_LSN = 0x64,
+        IS_COMPRESSED = 0x65,
     },
 
     -- `iproto_metadata_key` enumeration.
@@ -157,6 +158,7 @@ local reference_table = {
         UNWATCH = 75,
         EVENT = 76,
         WATCH_ONCE = 77,
+        COMPRESSED_ROWS = 78,
         CHUNK = 128,
         TYPE_ERROR = bit.lshift(1, 15),
         UNKNOWN = -1,
@@ -173,7 +175,7 @@ local reference_table = {
     },
 
     -- `IPROTO_CURRENT_VERSION` constant
-    protocol_version = 10,
+    protocol_version = 11,
 
     -- `feature_id` enumeration
     protocol_features = {
@@ -190,6 +192,7 @@ local reference_table = {
         fetch_snapshot_cursor = is_enterprise and true or nil,
         is_sync = true,
         insert_arrow = true,
+        replication_compression = true,
     },
     feature = {
         streams = 0,
@@ -205,6 +208,7 @@ local reference_table = {
         fetch_snapshot_cursor = 10,
         is_sync = 11,
         insert_arrow = 12,
+        replication_compression = 13,
     },
 }
 
@@ -0,0 +1,172 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('index_aggregate', t.helpers.matrix({
+    engine = {'memtx', 'vinyl'},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.create_space('test', {
+            engine = engine,
+            format = {
+                {'id', 'unsigned'},
+                {'i', 'integer', is_nullable = true},
+                {'d', 'double', is_nullable = true},
+                {'s', 'string', is_nullable = true},
+                {'b', 'boolean', is_nullable = true},
+            },
+        })
+        s:create_index('pk')
+        for id = 1, 1000 do
+            local tuple = {id, id % 10 - 5, id + 0.5, 'v' .. id % 7,
+                           id % 2 == 0}
+            if id % 100 == 0 then
+                tuple = {id}
+            end
+            s:insert(tuple)
+        end
+    end, {cg.params.engine})
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_aggregate = function(cg)
+    cg.server:exec(function()
+        local pk = box.space.test.index.pk
+        local function check(key, opts)
+            local count, count_i, sum_i, sum_d = 0, 0, 0, 0
+            local min_s, max_i
+            for _, tuple in pk:pairs(key, {iterator = opts.iterator}) do
+                local match = true
+                for _, f in ipairs(opts.filter or {}) do
+                    local v = tuple[f[1]]
+                    if v == nil or not (
+                            (f[2] == '==' and v == f[3]) or
+                            (f[2] == '~=' and v ~= f[3]) or
+                            (f[2] == '<' and v < f[3]) or
+                            (f[2] == '>=' and v >= f[3])) then
+                        match = false
+                    end
+                end
+                if match then
+                    count = count + 1
+                    if tuple.i ~= nil then
+                        count_i = count_i + 1
+                        sum_i = sum_i + tuple.i
+                        max_i = math.max(max_i or tuple.i, tuple.i)
+                    end
+                    if tuple.d ~= nil then
+                        sum_d = sum_d + tuple.d
+                    end
+                    local v = tuple.s
+                    if v ~= nil and (min_s == nil or v < min_s) then
+                        min_s = v
+                    end
+                end
+            end
+            opts.aggregates = {
+                'count', {'count', 'i'}, {'sum', 2}, {'sum', 'd'},
+                {'min', 's'}, {'max', 'i'},
+            }
+            t.assert_equals({pk:aggregate(key, opts)}, {
+                count, count_i, count_i > 0 and sum_i or box.NULL,
+                count_i > 0 and sum_d or box.NULL, min_s or box.NULL,
+                max_i or box.NULL,
+            })
+        end
+        check(nil, {})
+        check(500, {iterator = 'ge'})
+        check(500, {iterator = 'lt'})
+        check(nil, {filter = {{'i', '>=', 0}}})
+        check(nil, {filter = {{2, '<', 0}, {'s', '==', 'v3'}}})
+        check(nil, {filter = {{'s', '~=', 'v1'}, {5, '==', true}}})
+        check(nil, {filter = {{'i', '==', 100}}})
+        check(2000, {iterator = 'ge'})
+
+        -- Filters and aggregates see the changes of the active
+        -- transaction.
+        box.begin()
+        box.space.test:replace({1001, 7, 0.5, 'a', true})
+        check(nil, {filter = {{'i', '>=', 2}}})
+        box.rollback()
+    end)
+end
+
+g.test_aggregate_sum = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local pk = s.index.pk
+        s:truncate()
+        s:insert({1, -9223372036854775807LL})
+        s:insert({2, 9223372036854775807LL})
+        s:insert({3, 9223372036854775807LL})
+        t.assert_equals(pk:aggregate(3, {iterator = 'le',
+                                         aggregates = {{'sum', 'i'}}}),
+                        9223372036854775807ULL)
+        t.assert_error_msg_equals(
+            "Integer overflow when performing '+' operation on field 2 (i)",
+            pk.aggregate, pk, 2, {iterator = 'ge',
+                                  aggregates = {{'sum', 'i'}}})
+        s:insert({4, box.NULL, 0.5})
+        t.assert_equals(pk:aggregate(3, {iterator = 'gt',
+                                         aggregates = {{'sum', 3}}}), 0.5)
+        -- Missing fields are skipped.
+        t.assert_equals(pk:aggregate(nil, {aggregates = {{'sum', 's'}},
+                                           filter = {{'id', '==', 1}}}),
+                        box.NULL)
+        s:replace({1, 1, 1.5, 'a'})
+        t.assert_error_msg_equals(
+            "Tuple field 4 (s) type does not match one required by " ..
+            "operation: expected integer or double, got string",
+            pk.aggregate, pk, nil, {aggregates = {{'sum', 's'}},
+                                    filter = {{'id', '==', 1}}})
+    end)
+end
+
+g.test_aggregate_errors = function(cg)
+    cg.server:exec(function()
+        local pk = box.space.test.index.pk
+        t.assert_error_msg_equals(
+            "options parameter 'aggregates' should be a table",
+            pk.aggregate, pk, nil, {})
+        t.assert_error_msg_equals(
+            "unknown aggregate function 'avg'",
+            pk.aggregate, pk, nil, {aggregates = {{'avg', 'i'}}})
+        t.assert_error_msg_equals(
+            "aggregate function 'sum' requires a field",
+            pk.aggregate, pk, nil, {aggregates = {'sum'}})
+        t.assert_error_msg_equals(
+            "Field 'x' was not found in space 'test' format",
+            pk.aggregate, pk, nil, {aggregates = {{'max', 'x'}}})
+        t.assert_error_msg_equals(
+            "unknown filter operator '=<'",
+            pk.aggregate, pk, nil, {aggregates = {'count'},
+                                    filter = {{'i', '=<', 1}}})
+        t.assert_error_msg_equals(
+            "filter value must be a scalar",
+            pk.aggregate, pk, nil, {aggregates = {'count'},
+                                    filter = {{'i', '==', {1}}}})
+        t.assert_error_msg_equals(
+            "Index 'pk' (TREE) of space 'test' (" ..
+            box.space.test.engine .. ") does not support " ..
+            "requested iterator type",
+            pk.aggregate, pk, nil, {aggregates = {'count'},
+                                    iterator = 'overlaps'})
+    end)
+end
@@ -0,0 +1,108 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('index_get_many', t.helpers.matrix({
+    engine = {'memtx', 'vinyl'},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {vinyl_read_threads = 4, vinyl_cache = 0},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{2, 'string'}}})
+        for i = 1, 1000 do
+            s:insert({i, tostring(i)})
+        end
+        box.snapshot()
+    end, {cg.params.engine})
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:drop()
+    end)
+end)
+
+g.test_get_many = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s:get_many({}), {})
+        t.assert_equals(s:get_many({1, {500}, 1000, 1001, 1}),
+                        {{1, '1'}, {500, '500'}, {1000, '1000'},
+                         box.NULL, {1, '1'}})
+        t.assert_equals(s.index.sk:get_many({'10', '0', '20'}),
+                        {{10, '10'}, box.NULL, {20, '20'}})
+        t.assert_equals(s:get_many({s:get(7)}), {{7, '7'}})
+
+        local keys = {}
+        for i = 1000, 1, -1 do
+            table.insert(keys, i)
+        end
+        local result = s:get_many(keys)
+        t.assert_equals(#result, 1000)
+        for i, tuple in ipairs(result) do
+            t.assert_equals(tuple, {1001 - i, tostring(1001 - i)})
+        end
+
+        -- Reads see the transaction changes.
+        box.begin()
+        s:delete(2)
+        s:replace({1001, '1001'})
+        t.assert_equals(s:get_many({1, 2, 1001}),
+                        {{1, '1'}, box.NULL, {1001, '1001'}})
+        box.rollback()
+    end)
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_error_msg_equals(
+            "Use index:get_many(...) instead of index.get_many(...)",
+            s.index.pk.get_many)
+        t.assert_error_msg_equals(
+            "keys should be a table", s.get_many, s, 1)
+        t.assert_error_msg_equals(
+            "Invalid key part count in an exact match (expected 1, got 2)",
+            s.get_many, s, {1, {2, 3}})
+        t.assert_error_msg_equals(
+            "Supplied key type of part 0 does not match index part type: " ..
+            "expected unsigned",
+            s.get_many, s, {1, 'x'})
+    end)
+end
+
+g.test_concurrent_reads = function(cg)
+    t.skip_if(cg.params.engine ~= 'vinyl')
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        local clock = require('clock')
+        local s = box.space.test
+        local keys = {}
+        for i = 1, 8 do
+            table.insert(keys, i * 100)
+        end
+        -- Every page read takes 0.1 seconds. With 4 reader threads,
+        -- 8 lookups should take about 0.2 seconds.
+        box.error.injection.set('ERRINJ_VY_READ_PAGE_TIMEOUT', 0.1)
+        local start = clock.monotonic()
+        local result = s:get_many(keys)
+        local elapsed = clock.monotonic() - start
+        box.error.injection.set('ERRINJ_VY_READ_PAGE_TIMEOUT', 0)
+        for i, tuple in ipairs(result) do
+            t.assert_equals(tuple, {i * 100, tostring(i * 100)})
+        end
+        t.assert_lt(elapsed, 0.6)
+    end)
+end
@@ -0,0 +1,80 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {iproto_threads = 4, iproto_reuseport = true},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Returns the TCP URI the server listens on.
+local function listen_tcp(server)
+    return server:exec(function(net_box_uri)
+        box.cfg{listen = {net_box_uri, 'localhost:0'}}
+        for _, uri in ipairs(box.info.listen) do
+            if not uri:startswith('unix/') then
+                return uri
+            end
+        end
+    end, {server.net_box_uri})
+end
+
+g.test_reuseport = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.iproto_reuseport, true)
+        t.assert_error_msg_content_equals(
+            "Can't set option 'iproto_reuseport' dynamically",
+            box.cfg, {iproto_reuseport = false})
+    end)
+    -- Rebind twice to check that the per-thread sockets are closed
+    -- on reconfiguration and can be bound again.
+    for _ = 1, 2 do
+        local uri = listen_tcp(cg.server)
+        local conns = {}
+        for _ = 1, 40 do
+            local c = net.connect(uri)
+            t.assert(c:ping())
+            table.insert(conns, c)
+        end
+        cg.server:exec(function()
+            local total = 0
+            local threads = 0
+            for i = 1, box.cfg.iproto_threads do
+                local count = box.stat.net.thread[i].CONNECTIONS.current
+                total = total + count
+                if count > 0 then
+                    threads = threads + 1
+                end
+            end
+            t.assert_ge(total, 40)
+            t.assert_gt(threads, 1)
+        end)
+        for _, c in ipairs(conns) do
+            c:close()
+        end
+    end
+end
+
+-- Another process must not be able to join the SO_REUSEPORT group of
+-- the acceptor sockets and steal connections.
+g.test_address_in_use = function(cg)
+    local uri = listen_tcp(cg.server)
+    local other = server:new({
+        alias = 'other',
+        box_cfg = {iproto_threads = 2, iproto_reuseport = true},
+    })
+    other:start()
+    other:exec(function(uri)
+        t.assert_error_msg_contains(
+            'Address already in use', box.cfg, {listen = uri})
+    end, {uri})
+    other:drop()
+end
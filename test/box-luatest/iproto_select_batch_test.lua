@@ -0,0 +1,81 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('iproto_select_batch', {
+    {iproto_threads = 1},
+    {iproto_threads = 2},
+})
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {iproto_threads = cg.params.iproto_threads},
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i, 'v' .. i})
+        end
+        box.schema.user.grant('guest', 'read,write', 'space', 'test')
+        box.schema.user.grant('guest', 'execute', 'universe')
+        require('internal.tweaks').iproto_select_batch_size = 16
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Pipelined requests are sent in one write and get into one batch.
+g.test_pipelined_select = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    local s = conn.space.test
+    local requests = {}
+    local function add(future, expected)
+        table.insert(requests, {future = future, expected = expected})
+    end
+    for i = 1, 100 do
+        add(s:select({i}, {is_async = true}), {{i, 'v' .. i}})
+        if i % 10 == 0 then
+            -- Mix batched requests with the ones that can't be batched.
+            add(s:replace({1000 + i}, {is_async = true}), {1000 + i})
+            add(conn:eval('return 1', {}, {is_async = true}), 1)
+        end
+        if i % 25 == 0 then
+            -- An error in the middle of a batch.
+            add(s:select({'bad'}, {is_async = true}), 'Supplied key type')
+        end
+    end
+    for _, r in ipairs(requests) do
+        local ok, res = pcall(r.future.wait_result, r.future, 10)
+        if type(r.expected) == 'string' then
+            t.assert_not(ok)
+            t.assert_str_contains(tostring(res), r.expected)
+        else
+            t.assert(ok, res)
+            t.assert_equals(res, r.expected)
+        end
+    end
+    conn:close()
+end
+
+-- Batching is disabled if the tweak value is less than 2.
+g.test_disabled = function(cg)
+    cg.server:exec(function()
+        require('internal.tweaks').iproto_select_batch_size = 1
+    end)
+    local conn = net.connect(cg.server.net_box_uri)
+    local futures = {}
+    for i = 1, 50 do
+        table.insert(futures, conn.space.test:get({i}, {is_async = true}))
+    end
+    for i, f in ipairs(futures) do
+        t.assert_equals(f:wait_result(10), {i, 'v' .. i})
+    end
+    conn:close()
+    cg.server:exec(function()
+        require('internal.tweaks').iproto_select_batch_size = 16
+    end)
+end
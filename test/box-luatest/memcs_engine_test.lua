@@ -0,0 +1,294 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        for _, name in ipairs({'test', 'test2'}) do
+            if box.space[name] ~= nil then
+                box.space[name]:drop()
+            end
+        end
+    end)
+end)
+
+-- MP_EXT of type MP_ARROW, column 'a', value 0.
+local mp_arrow_hex = [[
+    c8011008ffffffff70000000040000009effffff0400010004000000b6ffffff0c0000000400
+    0000000000000100000004000000daffffff140000000202000004000000f0ffffff40000000
+    01000000610000000600080004000c0010000400080009000c000c000c000000040000000800
+    0a000c00040006000800ffffffff88000000040000008affffff040003001000000008000000
+    0000000000000000acffffff0100000000000000340000000800000000000000020000000000
+    0000000000000000000000000000000000000000000008000000000000000000000001000000
+    010000000000000000000000000000000a00140004000c0010000c0014000400060008000c00
+    00000000000000000000
+]]
+
+local function create_test_space()
+    local s = box.schema.create_space('test', {
+        engine = 'memcs',
+        format = {
+            {'id', 'unsigned'},
+            {'i', 'integer', is_nullable = true},
+            {'d', 'double', is_nullable = true},
+            {'b', 'boolean', is_nullable = true},
+            {'s', 'string', is_nullable = true},
+        },
+    })
+    s:create_index('pk')
+    return s
+end
+
+g.test_ddl = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_equals(
+            "memcs does not support field type 'any'",
+            box.schema.create_space, 'test', {
+                engine = 'memcs',
+                format = {{'a', 'unsigned'}, {'b', 'any'}},
+            })
+        local s = box.schema.create_space('test', {
+            engine = 'memcs',
+            format = {{'a', 'unsigned'}, {'b', 'string', is_nullable = true}},
+        })
+        t.assert_error_msg_equals(
+            "Unsupported index type supplied for index 'pk' in space 'test'",
+            s.create_index, s, 'pk', {type = 'hash'})
+        s:create_index('pk')
+        t.assert_error_msg_equals(
+            "memcs does not support secondary indexes",
+            s.create_index, s, 'sk', {parts = {'b'}})
+        t.assert_equals(s.engine, 'memcs')
+    end)
+end
+
+g.test_dml = function(cg)
+    cg.server:exec(function()
+        local s = create_test_space()
+        s:insert({1, -1, 1.5, true, 'a'})
+        s:insert({3})
+        s:replace({2, 2, box.NULL, false})
+        t.assert_error_msg_equals(
+            "Duplicate key exists in unique index \"pk\" in space \"test\" " ..
+            "with old tuple - [1, -1, 1.5, true, \"a\"] and new tuple - " ..
+            "[1]", s.insert, s, {1})
+        t.assert_equals(s:select(), {
+            {1, -1, 1.5, true, 'a'}, {2, 2, box.NULL, false}, {3},
+        })
+        t.assert_equals(s:get(2), {2, 2, box.NULL, false})
+        t.assert_equals(s:select(2, {iterator = 'gt'}), {{3}})
+        t.assert_equals(s:select(2, {iterator = 'le'}),
+                        {{2, 2, box.NULL, false}, {1, -1, 1.5, true, 'a'}})
+        t.assert_equals(s:update(3, {{'=', 'i', 7}}), {3, 7})
+        s:upsert({4, 4}, {{'+', 'i', 1}})
+        s:upsert({4, 4}, {{'+', 'i', 1}})
+        t.assert_equals(s:get(4), {4, 5})
+        t.assert_equals(s:delete(1), {1, -1, 1.5, true, 'a'})
+        t.assert_equals(s:count(), 3)
+        t.assert_equals(s:len(), 3)
+        t.assert_equals(s:select(), {
+            {2, 2, box.NULL, false}, {3, 7}, {4, 5},
+        })
+        t.assert_error_msg_equals(
+            "Tuple field 2 (i) type does not match one required by " ..
+            "operation: expected integer, got string",
+            s.insert, s, {5, 'x'})
+        s:truncate()
+        t.assert_equals(s:select(), {})
+    end)
+end
+
+g.test_rollback = function(cg)
+    cg.server:exec(function()
+        local s = create_test_space()
+        s:insert({1, 1})
+        s:insert({2, 2})
+        box.begin()
+        s:replace({1, 10})
+        s:delete(2)
+        s:insert({3, 3})
+        box.rollback()
+        t.assert_equals(s:select(), {{1, 1}, {2, 2}})
+
+        box.begin()
+        s:replace({1, 10})
+        local svp = box.savepoint()
+        s:insert({4, 4})
+        box.rollback_to_savepoint(svp)
+        box.commit()
+        t.assert_equals(s:select(), {{1, 10}, {2, 2}})
+    end)
+end
+
+g.test_reclaim = function(cg)
+    cg.server:exec(function()
+        local s = create_test_space()
+        local function fill(c)
+            for i = 1, 1000 do
+                s:replace({i, i, i + 0.5, true, string.rep(c, 100)})
+            end
+        end
+        fill('a')
+        local bsize = s:bsize()
+        for _, c in ipairs({'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i'}) do
+            fill(c)
+        end
+        -- Slots and strings of replaced rows are reused.
+        t.assert_le(s:bsize(), bsize * 2)
+        t.assert_equals(s:get(500), {500, 500, 500.5, true,
+                                     string.rep('i', 100)})
+        for i = 1, 1000 do
+            s:delete(i)
+        end
+        fill('j')
+        t.assert_le(s:bsize(), bsize * 2)
+        t.assert_equals(s:count(), 1000)
+
+        -- An iterator keeps its position when the slot of the last
+        -- returned row is reused.
+        local ids = {}
+        for _, tuple in s:pairs() do
+            table.insert(ids, tuple[1])
+            s:replace({tuple[1], 0})
+        end
+        t.assert_equals(#ids, 1000)
+        for i = 1, 1000 do
+            t.assert_equals(ids[i], i)
+        end
+        t.assert_equals(s:get(1000), {1000, 0})
+    end)
+end
+
+g.test_oom = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        local s = create_test_space()
+        box.error.injection.set('ERRINJ_MEMCS_ALLOC', true)
+        t.assert_error_covers({
+            type = 'OutOfMemory',
+        }, s.insert, s, {1, 1})
+        box.error.injection.set('ERRINJ_MEMCS_ALLOC', false)
+        t.assert_equals(s:select(), {})
+        s:insert({1, 1})
+        t.assert_equals(s:select(), {{1, 1}})
+        box.error.injection.set('ERRINJ_MEMCS_UNDO_ALLOC', true)
+        t.assert_error_covers({
+            type = 'OutOfMemory',
+        }, s.insert, s, {2, 2})
+        t.assert_error_covers({
+            type = 'OutOfMemory',
+        }, s.delete, s, {1})
+        t.assert_error_covers({
+            type = 'OutOfMemory',
+        }, s.update, s, {1}, {{'=', 2, 2}})
+        box.error.injection.set('ERRINJ_MEMCS_UNDO_ALLOC', false)
+        t.assert_equals(s:select(), {{1, 1}})
+    end)
+end
+
+g.test_insert_arrow = function(cg)
+    cg.server:exec(function(mp_arrow_hex)
+        local msgpack = require('msgpack')
+        local s = box.schema.create_space('test', {
+            engine = 'memcs', format = {{'a', 'integer'}},
+        })
+        s:create_index('pk')
+        local mp_arrow = string.fromhex(mp_arrow_hex:gsub("%s+", ""))
+        local arrow = msgpack.decode(mp_arrow)
+        s:insert_arrow(arrow)
+        t.assert_equals(s:select(), {{0}})
+        -- The whole batch is rolled back on a duplicate.
+        t.assert_error_msg_contains(
+            "Duplicate key exists in unique index",
+            s.insert_arrow, s, arrow)
+        t.assert_equals(s:select(), {{0}})
+    end, {mp_arrow_hex})
+end
+
+g.test_select_arrow = function(cg)
+    cg.server:exec(function()
+        local s = create_test_space()
+        for i = 1, 10 do
+            local tuple = {i, -i, i + 0.5, i % 2 == 0}
+            if i % 3 == 0 then
+                table.insert(tuple, 'x' .. i)
+            end
+            s:insert(tuple)
+        end
+        local s2 = box.schema.create_space('test2', {
+            engine = 'memcs', format = s:format(),
+        })
+        s2:create_index('pk')
+
+        local batches = s.index.pk:select_arrow(nil, {batch_row_count = 4})
+        t.assert_equals(#batches, 3)
+        for _, batch in ipairs(batches) do
+            s2:insert_arrow(batch)
+        end
+        t.assert_equals(s2:select(), s:select())
+
+        s2:truncate()
+        batches = s.index.pk:select_arrow(5, {iterator = 'ge'})
+        t.assert_equals(#batches, 1)
+        s2:insert_arrow(batches[1])
+        t.assert_equals(s2:select(), s:select(5, {iterator = 'ge'}))
+
+        s2:truncate()
+        batches = s.index.pk:select_arrow(nil, {fields = {'id', 4}})
+        s2:insert_arrow(batches[1])
+        t.assert_equals(s2:get(2), {2, box.NULL, box.NULL, true})
+
+        t.assert_equals(s.index.pk:select_arrow(100), {})
+        t.assert_error_msg_equals(
+            "Field 6 was not found in the tuple",
+            s.index.pk.select_arrow, s.index.pk, nil, {fields = {6}})
+        t.assert_error_msg_equals(
+            "Field 'x' was not found in space 'test' format",
+            s.index.pk.select_arrow, s.index.pk, nil, {fields = {'x'}})
+        t.assert_error_msg_equals(
+            "options parameter 'batch_row_count' " ..
+            "should be a positive number",
+            s.index.pk.select_arrow, s.index.pk, nil, {batch_row_count = 0})
+        t.assert_error_msg_equals(
+            "Index 'pk' (TREE) of space 'test' (memcs) does not support " ..
+            "requested iterator type",
+            s.index.pk.select_arrow, s.index.pk, nil, {iterator = 'overlaps'})
+    end)
+end
+
+g.test_select_arrow_unsupported = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.create_space('test')
+        s:create_index('pk')
+        t.assert_error_msg_equals(
+            "Index 'pk' (TREE) of space 'test' (memtx) does not support " ..
+            "arrow stream",
+            s.index.pk.select_arrow, s.index.pk)
+    end)
+end
+
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local s = create_test_space()
+        s:insert({1, 1, 1.5, true, 'a'})
+        box.snapshot()
+        s:insert({2, 2})
+        s:delete(1)
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s.engine, 'memcs')
+        t.assert_equals(s:select(), {{2, 2}})
+    end)
+end
@@ -0,0 +1,133 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.error.injection.set('ERRINJ_BUILD_INDEX_DELAY', false)
+        require('internal.tweaks').memtx_build_index_in_bulk = true
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_build = function(cg)
+    cg.server:exec(function()
+        local key_def = require('key_def')
+        local tweaks = require('internal.tweaks')
+        t.assert_equals(tweaks.memtx_build_index_in_bulk, true)
+        local s = box.schema.create_space('test')
+        s:create_index('pk')
+        for i = 1, 1000 do
+            s:insert({i, (i * 7919) % 1000, tostring(i % 10)})
+        end
+        s:create_index('sk', {parts = {2, 'unsigned'}})
+        s:create_index('tk', {parts = {{3, 'string'}, {2, 'unsigned'}}})
+        s:create_index('mk', {parts = {{3, 'string'}}, unique = false})
+        for _, name in ipairs({'sk', 'tk', 'mk'}) do
+            local idx = s.index[name]
+            local kd = key_def.new(idx.parts)
+            t.assert_equals(idx:len(), 1000)
+            local prev
+            for _, tuple in idx:pairs() do
+                if prev ~= nil then
+                    t.assert_le(kd:compare(prev, tuple), 0)
+                end
+                prev = tuple
+            end
+        end
+        t.assert_equals(s.index.sk:get(919), {1, 919, '1'})
+        t.assert_equals(s.index.tk:get({'3', 757}), {3, 757, '3'})
+
+        s:replace({11, 919, '1'})
+        t.assert_error_covers({
+            type = 'ClientError',
+            code = box.error.TUPLE_FOUND,
+        }, s.create_index, s, 'i', {parts = {2, 'unsigned'}})
+        t.assert_equals(s.index.i, nil)
+    end)
+end
+
+g.test_concurrent_changes = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.schema.create_space('test')
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i, i * 10})
+        end
+        box.error.injection.set('ERRINJ_BUILD_INDEX_DELAY', true)
+        local f = fiber.new(s.create_index, s, 'sk',
+                            {parts = {2, 'unsigned'}})
+        f:set_joinable(true)
+        -- The build is stuck on the first tuple.
+        s:replace({1, 5})
+        s:delete(2)
+        s:update(50, {{'=', 2, 15}})
+        s:delete(60)
+        s:insert({101, 1010})
+        s:replace({0, 20})
+        box.begin()
+        s:replace({1, 2000})
+        box.rollback()
+        box.error.injection.set('ERRINJ_BUILD_INDEX_DELAY', false)
+        local ok, err = f:join()
+        t.assert(ok, err)
+        local expected = {}
+        for _, tuple in s:pairs() do
+            table.insert(expected, tuple)
+        end
+        table.sort(expected, function(a, b) return a[2] < b[2] end)
+        t.assert_equals(s.index.sk:select({}, {fullscan = true}), expected)
+        t.assert_equals(s.index.sk:get(5), {1, 5})
+        t.assert_equals(s.index.sk:get(2000), nil)
+    end)
+end
+
+g.test_concurrent_duplicate = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.schema.create_space('test')
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i, i * 10})
+        end
+        box.error.injection.set('ERRINJ_BUILD_INDEX_DELAY', true)
+        local f = fiber.new(s.create_index, s, 'sk',
+                            {parts = {2, 'unsigned'}})
+        f:set_joinable(true)
+        s:replace({1, 500})
+        box.error.injection.set('ERRINJ_BUILD_INDEX_DELAY', false)
+        local ok, err = f:join()
+        t.assert_not(ok)
+        t.assert_equals(err.code, box.error.TUPLE_FOUND)
+        t.assert_equals(s.index.sk, nil)
+    end)
+end
+
+g.test_disabled = function(cg)
+    cg.server:exec(function()
+        require('internal.tweaks').memtx_build_index_in_bulk = false
+        local s = box.schema.create_space('test')
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i, 100 - i})
+        end
+        s:create_index('sk', {parts = {2, 'unsigned'}})
+        t.assert_equals(s.index.sk:select({}, {limit = 2}),
+                        {{100, 0}, {99, 1}})
+    end)
+end
@@ -0,0 +1,114 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        require('internal.tweaks').memtx_compaction_threshold = 0
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+--
+-- Fills the test space and then deletes 9 of every 10 tuples so that
+-- the tuple arena becomes sparse.
+--
+local function fill_sparse()
+    local s = box.schema.create_space('test')
+    s:create_index('pk')
+    s:create_index('sk', {parts = {2, 'string'}, unique = false})
+    s:create_index('hash', {type = 'hash', parts = {3, 'unsigned'}})
+    local pad = string.rep('x', 100)
+    box.begin()
+    for i = 1, 100000 do
+        s:insert{i, pad .. i % 7, i * 2}
+        if i % 1000 == 0 then
+            box.commit()
+            box.begin()
+        end
+    end
+    box.commit()
+    box.begin()
+    for i = 1, 100000 do
+        if i % 10 ~= 0 then
+            s:delete(i)
+        end
+        if i % 1000 == 0 then
+            box.commit()
+            box.begin()
+        end
+    end
+    box.commit()
+    box.tuple.new() -- drop blessed tuple ref
+    collectgarbage('collect')
+end
+
+local function check_sparse()
+    local s = box.space.test
+    local pad = string.rep('x', 100)
+    t.assert_equals(s:count(), 10000)
+    t.assert_equals(s.index.sk:count(), 10000)
+    t.assert_equals(s.index.hash:count(), 10000)
+    for i = 10, 100000, 10 do
+        local tuple = {i, pad .. i % 7, i * 2}
+        t.assert_equals(s:get(i), tuple)
+        t.assert_equals(s.index.hash:get(i * 2), tuple)
+    end
+    local counts = {}
+    for i = 10, 100000, 10 do
+        counts[i % 7] = (counts[i % 7] or 0) + 1
+    end
+    for i = 0, 6 do
+        t.assert_equals(s.index.sk:count(pad .. i), counts[i])
+    end
+end
+
+g.test_compaction = function(cg)
+    cg.server:exec(fill_sparse)
+    cg.server:exec(function()
+        local items_size = box.slab.info().items_size
+        require('internal.tweaks').memtx_compaction_threshold = 0.5
+        t.helpers.retrying({timeout = 60}, function()
+            t.assert_lt(box.slab.info().items_size, items_size / 2)
+        end)
+    end)
+    cg.server:exec(check_sparse)
+end
+
+--
+-- Tuples referenced from Lua and tuples visible from a read view stay
+-- where they are.
+--
+g.test_compaction_pinned = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(fill_sparse)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.space.test
+        local pinned = s:get(10)
+        box.error.injection.set('ERRINJ_SNAP_WRITE_DELAY', true)
+        local f = fiber.new(box.snapshot)
+        f:set_joinable(true)
+        fiber.yield()
+        require('internal.tweaks').memtx_compaction_threshold = 0.5
+        fiber.sleep(2)
+        s:replace{20, 'new', 40}
+        box.error.injection.set('ERRINJ_SNAP_WRITE_DELAY', false)
+        t.assert_equals({f:join()}, {true, 'ok'})
+        t.assert_equals(pinned, s:get(10))
+        s:replace{20, string.rep('x', 100) .. 20 % 7, 40}
+    end)
+    cg.server:exec(check_sparse)
+end
@@ -0,0 +1,147 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_options = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.create_space('test')
+        s:create_index('pk', {type = 'hash', fingerprint = true})
+        s:create_index('sk', {type = 'hash', parts = {2, 'string'}})
+        s:create_index('tk', {type = 'tree', parts = {3, 'unsigned'}})
+        t.assert_equals(s.index.pk.fingerprint, true)
+        t.assert_equals(s.index.sk.fingerprint, false)
+        t.assert_equals(s.index.tk.fingerprint, nil)
+        s.index.pk:alter({fingerprint = false})
+        t.assert_equals(s.index.pk.fingerprint, false)
+        s.index.pk:alter({fingerprint = true})
+        t.assert_equals(s.index.pk.fingerprint, true)
+
+        local msg = "Can't create or modify index 'i' in space 'test': " ..
+                    "fingerprint is only reasonable with memtx hash " ..
+                    "index over one unsigned field"
+        t.assert_error_msg_equals(msg, s.create_index, s, 'i',
+                                  {type = 'tree', fingerprint = true})
+        t.assert_error_msg_equals(msg, s.create_index, s, 'i',
+                                  {type = 'hash', parts = {2, 'string'},
+                                   fingerprint = true})
+        t.assert_error_msg_equals(msg, s.create_index, s, 'i',
+                                  {type = 'hash', fingerprint = true,
+                                   parts = {{3, 'unsigned'},
+                                            {4, 'unsigned'}}})
+
+        local v = box.schema.create_space('test_vinyl', {engine = 'vinyl'})
+        msg = "Can't create or modify index 'pk' in space 'test_vinyl': " ..
+              "fingerprint is only reasonable with memtx hash " ..
+              "index over one unsigned field"
+        t.assert_error_msg_equals(msg, v.create_index, v, 'pk',
+                                  {fingerprint = true})
+        v:drop()
+    end)
+end
+
+--
+-- Keys that fit in the hash and keys that don't may be mixed in the same
+-- index.
+--
+g.test_dml = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.create_space('test')
+        s:create_index('pk', {type = 'hash', fingerprint = true})
+        local keys = {0, 1, 2, 1000, 2^31 - 1, 2^31, 2^31 + 1, 2^32,
+                      2^32 + 1, 2^53, 18446744073709551615ULL}
+        for _, k in ipairs(keys) do
+            s:insert({k, 'a'})
+        end
+        for _, k in ipairs(keys) do
+            t.assert_equals(s:get(k), {k, 'a'})
+            t.assert_equals(s:select(k), {{k, 'a'}})
+            t.assert_error_covers({
+                type = 'ClientError',
+                code = box.error.TUPLE_FOUND,
+            }, s.insert, s, {k, 'b'})
+            s:replace({k, 'b'})
+            t.assert_equals(s:get(k), {k, 'b'})
+        end
+        t.assert_equals(s:get(3), nil)
+        t.assert_equals(s:get(2^31 + 2), nil)
+        t.assert_equals(s:count(), #keys)
+        for i, k in ipairs(keys) do
+            if i % 2 == 0 then
+                t.assert_equals(s:delete(k), {k, 'b'})
+            end
+        end
+        for i, k in ipairs(keys) do
+            if i % 2 == 0 then
+                t.assert_equals(s:get(k), nil)
+            else
+                t.assert_equals(s:get(k), {k, 'b'})
+            end
+        end
+        t.assert_equals(s:count(), math.ceil(#keys / 2))
+    end)
+end
+
+g.test_many = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.create_space('test')
+        s:create_index('pk', {type = 'hash', fingerprint = true})
+        box.begin()
+        for i = 1, 10000 do
+            s:insert({i * 7, i})
+        end
+        box.commit()
+        for i = 1, 10000 do
+            t.assert_equals(s:get(i * 7), {i * 7, i})
+            t.assert_equals(s:get(i * 7 + 1), nil)
+        end
+        box.begin()
+        for i = 1, 10000, 2 do
+            s:delete(i * 7)
+        end
+        box.commit()
+        t.assert_equals(s:len(), 5000)
+        local sum = 0
+        for _, tuple in s:pairs() do
+            sum = sum + tuple[2]
+        end
+        t.assert_equals(sum, 5000 * 5001)
+    end)
+end
+
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.create_space('test')
+        s:create_index('pk', {type = 'hash', fingerprint = true})
+        for i = 1, 100 do
+            s:insert({i})
+        end
+        box.snapshot()
+        s:insert({2^40})
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s.index.pk.fingerprint, true)
+        t.assert_equals(s:len(), 101)
+        t.assert_equals(s:get(50), {50})
+        t.assert_equals(s:get(2^40), {2^40})
+    end)
+end
@@ -0,0 +1,196 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_options = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.create_space('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{2, 'unsigned'}, {3, 'string'}},
+                              prefix_hint = true})
+        s:create_index('hk', {type = 'hash', parts = {4, 'unsigned'}})
+        t.assert_equals(s.index.pk.prefix_hint, false)
+        t.assert_equals(s.index.sk.prefix_hint, true)
+        t.assert_equals(s.index.hk.prefix_hint, nil)
+        s.index.sk:alter({prefix_hint = false})
+        t.assert_equals(s.index.sk.prefix_hint, false)
+        s.index.sk:alter({prefix_hint = true})
+        t.assert_equals(s.index.sk.prefix_hint, true)
+
+        local msg = "Can't create or modify index 'i' in space 'test': " ..
+                    "prefix_hint is only reasonable with memtx tree " ..
+                    "index with hints"
+        t.assert_error_msg_equals(msg, s.create_index, s, 'i',
+                                  {type = 'hash', prefix_hint = true})
+        t.assert_error_msg_equals(msg, s.create_index, s, 'i',
+                                  {hint = false, prefix_hint = true})
+        msg = "Can't create or modify index 'i' in space 'test': " ..
+              "prefix_hint is not supported by multikey and functional " ..
+              "indexes"
+        t.assert_error_msg_equals(msg, s.create_index, s, 'i',
+                                  {parts = {{field = 5, path = '[*]',
+                                              type = 'unsigned'}},
+                                   unique = false, prefix_hint = true})
+
+        local v = box.schema.create_space('test_vinyl', {engine = 'vinyl'})
+        msg = "Can't create or modify index 'pk' in space 'test_vinyl': " ..
+              "prefix_hint is only reasonable with memtx tree index " ..
+              "with hints"
+        t.assert_error_msg_equals(msg, v.create_index, v, 'pk',
+                                  {prefix_hint = true})
+        v:drop()
+    end)
+end
+
+--
+-- An index with prefix hints must return the same results as an index
+-- without them.
+--
+g.test_select = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.create_space('test')
+        s:create_index('pk')
+        s:create_index('plain', {parts = {{2, 'integer'}, {3, 'string'}},
+                                 unique = false})
+        s:create_index('prefix', {parts = {{2, 'integer'}, {3, 'string'}},
+                                  unique = false, prefix_hint = true})
+        local strs = {'', 'a', 'ab', 'abc', 'abcdefgh', 'abcdefghi',
+                      'abcdefghij', 'b', 'ba', 'zzzzzzzzzz'}
+        local ints = {-2^40, -70000, -256, -255, -1, 0, 1, 255, 256, 2^40}
+        box.begin()
+        for i = 1, 1000 do
+            s:insert({i, ints[i % #ints + 1], strs[i % 7 % #strs + 1] ..
+                      strs[i % #strs + 1]})
+        end
+        box.commit()
+        local its = {'EQ', 'REQ', 'GT', 'GE', 'LT', 'LE'}
+        for _, n in ipairs(ints) do
+            for _, str in ipairs(strs) do
+                for _, it in ipairs(its) do
+                    for _, key in ipairs({{n}, {n, str}}) do
+                        local opts = {iterator = it, limit = 20}
+                        t.assert_equals(s.index.prefix:select(key, opts),
+                                        s.index.plain:select(key, opts),
+                                        {key, it})
+                        opts = {iterator = it}
+                        t.assert_equals(s.index.prefix:count(key, opts),
+                                        s.index.plain:count(key, opts))
+                    end
+                end
+            end
+        end
+        t.assert_equals(s.index.prefix:select(), s.index.plain:select())
+        for i = 1, 1000, 3 do
+            s:delete(i)
+        end
+        t.assert_equals(s.index.prefix:select(), s.index.plain:select())
+    end)
+end
+
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.create_space('test')
+        s:create_index('pk', {parts = {{1, 'string'}, {2, 'unsigned'}},
+                              prefix_hint = true})
+        for i = 1, 100 do
+            s:insert({'key', i})
+        end
+        box.snapshot()
+        s:insert({'key', 1000})
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s.index.pk.prefix_hint, true)
+        t.assert_equals(s:len(), 101)
+        t.assert_equals(s:get({'key', 50}), {'key', 50})
+        t.assert_equals(s:select({'key', 100}, {iterator = 'GT'}),
+                        {{'key', 1000}})
+    end)
+end
+
+local g_mvcc = t.group('mvcc')
+
+g_mvcc.before_all(function(cg)
+    cg.server = server:new({box_cfg = {memtx_use_mvcc_engine = true}})
+    cg.server:start()
+end)
+
+g_mvcc.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g_mvcc.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+--
+-- A unique index compares tuples by the key definition without the primary
+-- key parts, so prefix hints stored in it don't include them. MVCC must use
+-- the same hints when it counts tuples skipped by offset.
+--
+g_mvcc.test_count = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.create_space('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{2, 'unsigned'}, {3, 'unsigned'}},
+                              prefix_hint = true})
+        for i = 2, 10, 2 do
+            s:insert({i, 1, i})
+        end
+        local txn_proxy = require('test.box.lua.txn_proxy')
+        local tx1 = txn_proxy.new()
+        local tx2 = txn_proxy.new()
+        local tx3 = txn_proxy.new()
+
+        -- Tuples invisible to the reader are skipped by offset.
+        tx1:begin()
+        tx1('box.space.test:insert({7, 1, 7})')
+        tx1('box.space.test:replace({8, 1, 8, 8})')
+        tx1('box.space.test:delete({6})')
+        for _, it in ipairs({'GE', 'GT', 'LE', 'LT'}) do
+            for _, key in ipairs({{1}, {1, 7}, {1, 8}}) do
+                local all = s.index.sk:select(key, {iterator = it})
+                for offset = 0, #all do
+                    local opts = {iterator = it, offset = offset}
+                    t.assert_equals(s.index.sk:select(key, opts),
+                                    {unpack(all, offset + 1)},
+                                    {it, key, offset})
+                end
+            end
+        end
+        tx1:rollback()
+
+        -- Insertion of a tuple skipped by offset conflicts with the reader.
+        tx2:begin()
+        t.assert_equals(tx2("box.space.test.index.sk:select({1}, " ..
+                            "{iterator = 'LE', offset = 2, limit = 1})"),
+                        {{{6, 1, 6}}})
+        tx3('box.space.test:insert({9, 1, 9})')
+        t.assert_equals(tx2('box.space.test:replace({1, 1, 1})'),
+                        {{error = "Transaction has been aborted by conflict"}})
+        t.assert_equals(s.index.sk:count({1}), 6)
+    end)
+end
@@ -0,0 +1,183 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('memtx_tuple_compression', t.helpers.matrix({
+    compression = {'zstd', 'zstd_dict'},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function(compression)
+        local s = box.schema.create_space('test', {
+            format = {
+                {'id', 'unsigned'},
+                {'s', 'string', compression = compression},
+                {'m', 'map', compression = compression, is_nullable = true},
+                {'x', 'unsigned', is_nullable = true},
+            },
+        })
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{'x', 'unsigned'}}, unique = false,
+                              exclude_null = true})
+    end, {cg.params.compression})
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_compression = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local function make_tuple(id)
+            local m = {}
+            for i = 1, 20 do
+                m['key' .. i] = string.rep('v', i) .. id
+            end
+            return {id, string.rep('text ' .. id % 10, 100), m, id % 5}
+        end
+        local size = 0
+        for id = 1, 1000 do
+            local tuple = s:insert(make_tuple(id))
+            t.assert_equals(tuple, make_tuple(id))
+            size = size + tuple:bsize()
+        end
+        -- The space stores compressed tuples.
+        t.assert_lt(s:bsize(), size / 2)
+        -- Small values aren't compressed.
+        t.assert_equals(s:insert({1001, 'a', {}, 1}), {1001, 'a', {}, 1})
+        t.assert_equals(s:get(1001), {1001, 'a', {}, 1})
+
+        for id = 1, 1000, 97 do
+            t.assert_equals(s:get(id), make_tuple(id))
+        end
+        t.assert_equals(s:select({2}, {iterator = 'ge', limit = 3}),
+                        {make_tuple(2), make_tuple(3), make_tuple(4)})
+        t.assert_equals(#s.index.sk:select(3), 200)
+        for _, tuple in s.index.sk:pairs(4, {iterator = 'eq'}) do
+            t.assert_equals(tuple, make_tuple(tuple.id))
+        end
+
+        local tuple = make_tuple(10)
+        tuple[2] = tuple[2] .. '!'
+        t.assert_equals(s:update(10, {{'||', 's', '!'}}), tuple)
+        t.assert_equals(s:get(10), tuple)
+        t.assert_equals(s:replace(make_tuple(10)), make_tuple(10))
+        t.assert_equals(s:delete(10), make_tuple(10))
+        t.assert_equals(s:get(10), nil)
+        t.assert_equals(s:upsert(make_tuple(10), {{'=', 'x', 0}}), nil)
+        t.assert_equals(s:upsert(make_tuple(10), {{'=', 'x', 100}}), nil)
+        tuple = make_tuple(10)
+        tuple[4] = 100
+        t.assert_equals(s:get(10), tuple)
+
+        -- Rollback restores the compressed tuple.
+        box.begin()
+        s:update(11, {{'=', 's', 'x'}})
+        t.assert_equals(s:get(11).s, 'x')
+        box.rollback()
+        t.assert_equals(s:get(11), make_tuple(11))
+
+        -- The duplicate key error prints the decompressed tuple.
+        t.assert_error_msg_contains(
+            'with old tuple - [12, "text 2text 2text 2',
+            s.insert, s, make_tuple(12))
+    end)
+end
+
+g.test_snapshot = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        for id = 1, 100 do
+            s:insert({id, string.rep('snapshot ' .. id, 20),
+                      {key = string.rep('value', 20)}, box.NULL})
+        end
+        box.snapshot()
+        s:insert({101, string.rep('wal', 50)})
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s:count(), 101)
+        for id = 1, 100 do
+            t.assert_equals(s:get(id), {
+                id, string.rep('snapshot ' .. id, 20),
+                {key = string.rep('value', 20)}, box.NULL,
+            })
+        end
+        t.assert_equals(s:get(101), {101, string.rep('wal', 50)})
+    end)
+end
+
+g.test_unsupported = function(cg)
+    t.tarantool.skip_if_enterprise()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_error_msg_equals(
+            "Indexed field does not support compression",
+            s.create_index, s, 'sk2', {parts = {'s'}})
+        t.assert_error_msg_equals(
+            "Indexed field does not support compression",
+            s.create_index, s, 'sk2', {parts = {{'m.a', 'unsigned'}}})
+        box.schema.func.create('func', {
+            body = 'function(tuple) return {tuple[1]} end',
+            is_deterministic = true,
+            is_sandboxed = true,
+        })
+        t.assert_error_msg_equals(
+            "Functional index does not support compression",
+            s.create_index, s, 'func', {func = 'func',
+                                        parts = {{1, 'unsigned'}}})
+        box.schema.func.drop('func')
+    end)
+end
+
+--
+-- The dictionary is trained in background, values compressed before and
+-- after the training is over are readable. Dropping the space while the
+-- dictionary is being trained is fine.
+--
+g.test_dict_training = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.space.test
+        local function make_tuple(id)
+            return {id, string.rep('dict ' .. id % 10, 50)}
+        end
+        for id = 1, 3000 do
+            s:insert(make_tuple(id))
+        end
+        fiber.sleep(0.1)
+        for id = 3001, 4000 do
+            s:insert(make_tuple(id))
+        end
+        for id = 1, 4000, 37 do
+            t.assert_equals(s:get(id), make_tuple(id))
+        end
+        s:drop()
+        s = box.schema.create_space('test', {
+            format = {
+                {'id', 'unsigned'},
+                {'s', 'string', compression = 'zstd_dict'},
+            },
+        })
+        s:create_index('pk')
+        for id = 1, 3000 do
+            s:insert(make_tuple(id))
+        end
+        s:drop()
+        fiber.sleep(0.1)
+    end)
+end
@@ -0,0 +1,51 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('memtx_use_huge_pages', t.helpers.matrix({
+    use_huge_pages = {false, true},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {memtx_use_huge_pages = cg.params.use_huge_pages},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_huge_pages = function(cg)
+    cg.server:exec(function(use_huge_pages)
+        t.assert_error_msg_equals(
+            "Can't set option 'memtx_use_huge_pages' dynamically",
+            box.cfg, {memtx_use_huge_pages = not use_huge_pages})
+
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'string'}})
+        for i = 1, 10000 do
+            s:insert({i, tostring(i)})
+        end
+        t.assert_equals(s:get(5000), {5000, '5000'})
+        t.assert_equals(s.index.sk:get('5000'), {5000, '5000'})
+
+        local stat = box.stat.memtx().huge_pages
+        if not use_huge_pages then
+            t.assert_equals(stat, {mode = 'none', total = 0})
+        else
+            t.assert_items_include({'none', 'explicit', 'transparent'},
+                                   {stat.mode})
+            t.assert_ge(stat.total, 0)
+            t.assert_le(stat.total, box.slab.info().arena_size)
+        end
+        s:drop()
+    end, {cg.params.use_huge_pages})
+end
+
+g.test_log = function(cg)
+    t.skip_if(not cg.params.use_huge_pages)
+    t.assert(cg.server:grep_log('memtx arena is mapped with') or
+             cg.server:grep_log('memtx_use_huge_pages is set but'))
+end
@@ -0,0 +1,71 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {wal_mode = 'fsync', wal_commit_delay = 0.01},
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.wal_commit_delay, 0.01)
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'wal_commit_delay': " ..
+            "the value must be >= 0",
+            box.cfg, {wal_commit_delay = -1})
+        box.cfg{wal_commit_delay = 0}
+        box.space.test:replace({0})
+        box.cfg{wal_commit_delay = 0.01}
+    end)
+end
+
+g.test_concurrent_commit = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local fibers = {}
+        for i = 1, 100 do
+            local f = fiber.new(box.space.test.replace, box.space.test,
+                                {i})
+            f:set_joinable(true)
+            table.insert(fibers, f)
+        end
+        for _, f in ipairs(fibers) do
+            t.assert((f:join()))
+        end
+        t.assert_equals(box.space.test:count({0}, {iterator = 'gt'}), 100)
+        -- Checkpoint must wait for the pending writes.
+        box.space.test:replace({1000})
+        box.snapshot()
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        t.assert_equals(box.space.test:count({0}, {iterator = 'gt'}), 101)
+    end)
+end
+
+-- Disabling the delay sends the pending writes to WAL immediately.
+g.test_disable = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        box.cfg{wal_commit_delay = 100}
+        local f = fiber.new(box.space.test.replace, box.space.test, {2000})
+        f:set_joinable(true)
+        fiber.yield()
+        box.cfg{wal_commit_delay = 0}
+        t.assert((f:join(10)))
+        t.assert_equals(box.space.test:get(2000), {2000})
+        box.cfg{wal_commit_delay = 0.01}
+    end)
+end
@@ -0,0 +1,53 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server = server:new({box_cfg = {wal_mode = 'fsync'}})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.error.injection.set('ERRINJ_WAL_DATASYNC', false)
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Checks that a batch which failed to be synced in the fsync mode is rolled
+-- back entirely and isn't recovered after restart.
+g.test_datasync_failure = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.schema.create_space('test')
+        s:create_index('pk')
+        s:insert({1})
+        box.error.injection.set('ERRINJ_WAL_DATASYNC', true)
+        local fibers = {}
+        for i = 2, 10 do
+            local f = fiber.new(s.insert, s, {i, string.rep('x', 100 * 1024)})
+            f:set_joinable(true)
+            table.insert(fibers, f)
+        end
+        for _, f in ipairs(fibers) do
+            local ok = f:join()
+            t.assert_not(ok)
+        end
+        t.assert_equals(s:select(), {{1}})
+        box.error.injection.set('ERRINJ_WAL_DATASYNC', false)
+        s:insert({11})
+        t.assert_equals(s:select(), {{1}, {11}})
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        t.assert_equals(box.space.test:select(), {{1}, {11}})
+    end)
+end
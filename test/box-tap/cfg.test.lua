@@ -6,7 +6,7 @@ local socket = require('socket')
 local fio = require('fio')
 local uuid = require('uuid')
 local msgpack = require('msgpack')
-test:plan(113)
+test:plan(114)
 
 --------------------------------------------------------------------------------
 -- Invalid values
@@ -48,6 +48,7 @@ invalid('vinyl_run_count_per_level', 0)
 invalid('vinyl_run_size_ratio', 1)
 invalid('vinyl_bloom_fpr', 0)
 invalid('vinyl_bloom_fpr', 1.1)
+invalid('vinyl_max_subcompactions', 0)
 invalid('wal_queue_max_size', -1)
 invalid('memtx_sort_threads', 'all')
 invalid('memtx_sort_threads', -1)
@@ -5,6 +5,7 @@ errinj = box.error.injection
 function print_features(conn)                                               \
     local f = c.peer_protocol_features                                      \
     f.fetch_snapshot_cursor = nil                                           \
+    f.replication_compression = nil                                         \
     return f                                                                \
 end
 
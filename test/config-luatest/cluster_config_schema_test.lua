@@ -267,6 +267,7 @@ g.test_defaults = function()
                 client = box.NULL,
             },
             threads = 1,
+            reuseport = false,
             net_msg_max = 768,
             readahead = 16320,
         },
@@ -282,8 +283,10 @@ g.test_defaults = function()
         vinyl = {
             dir = 'var/lib/{{ instance_name }}',
             max_tuple_size = 1048576,
+            max_subcompactions = 1,
             bloom_fpr = 0.05,
             page_size = 8192,
+            page_cache = 0,
             range_size = box.NULL,
             run_count_per_level = 2,
             run_size_ratio = 3.5,
@@ -337,6 +340,7 @@ g.test_defaults = function()
             max_size = 268435456,
             dir_rescan_delay = 2,
             queue_max_size = 16777216,
+            commit_delay = 0,
             retention_period = is_enterprise and 0 or nil,
         },
         console = {
@@ -353,6 +357,7 @@ g.test_defaults = function()
             max_tuple_size = 1048576,
             sort_threads = box.NULL,
             use_sort_data = false,
+            use_huge_pages = false,
         },
         config = {
             reload = 'auto',
@@ -447,6 +447,7 @@ g.test_iproto = function()
                 },
             },
             threads = 1,
+            reuseport = true,
             net_msg_max = 1,
             readahead = 1,
         },
@@ -459,6 +460,7 @@ g.test_iproto = function()
             client = box.NULL,
         },
         threads = 1,
+        reuseport = false,
         net_msg_max = 768,
         readahead = 16320,
     }
@@ -514,6 +516,7 @@ g.test_iproto_enterprise = function()
                 },
             },
             threads = 1,
+            reuseport = true,
             net_msg_max = 1,
             readahead = 1,
             ssl = {
@@ -534,6 +537,7 @@ g.test_iproto_enterprise = function()
             client = box.NULL,
         },
         threads = 1,
+        reuseport = false,
         net_msg_max = 768,
         readahead = 16320,
     }
@@ -997,6 +1001,7 @@ g.test_memtx = function()
             max_tuple_size = 1,
             sort_threads = 1,
             use_sort_data = true,
+            use_huge_pages = true,
         },
     }
     instance_config:validate(iconfig)
@@ -1011,6 +1016,7 @@ g.test_memtx = function()
         max_tuple_size = 1048576,
         sort_threads = box.NULL,
         use_sort_data = false,
+        use_huge_pages = false,
     }
     local res = instance_config:apply_default({}).memtx
     t.assert_equals(res, exp)
@@ -1021,8 +1027,10 @@ g.test_vinyl = function()
         vinyl = {
             dir = 'one',
             max_tuple_size = 1,
+            max_subcompactions = 3,
             bloom_fpr = 0.1,
             page_size = 123,
+            page_cache = 12,
             range_size = 321,
             run_count_per_level = 11,
             run_size_ratio = 1.15,
@@ -1040,8 +1048,10 @@ g.test_vinyl = function()
     local exp = {
         dir = 'var/lib/{{ instance_name }}',
         max_tuple_size = 1048576,
+        max_subcompactions = 1,
         bloom_fpr = 0.05,
         page_size = 8192,
+        page_cache = 0,
         range_size = box.NULL,
         run_count_per_level = 2,
         run_size_ratio = 3.5,
@@ -1065,6 +1075,7 @@ g.test_wal = function()
             max_size = 1,
             dir_rescan_delay = 1,
             queue_max_size = 1,
+            commit_delay = 1,
             cleanup_delay = 1,
         },
     }
@@ -1077,6 +1088,7 @@ g.test_wal = function()
         max_size = 268435456,
         dir_rescan_delay = 2,
         queue_max_size = 16777216,
+        commit_delay = 0,
     }
     local res = instance_config:apply_default({}).wal
     t.assert_equals(res, exp)
@@ -1091,6 +1103,7 @@ g.test_wal_enterprise = function()
             max_size = 1,
             dir_rescan_delay = 1,
             queue_max_size = 1,
+            commit_delay = 1,
             cleanup_delay = 1,
             retention_period = 1,
             ext = {
@@ -1114,6 +1127,7 @@ g.test_wal_enterprise = function()
         max_size = 268435456,
         dir_rescan_delay = 2,
         queue_max_size = 16777216,
+        commit_delay = 0,
         retention_period = 0,
     }
     local res = instance_config:apply_default({}).wal
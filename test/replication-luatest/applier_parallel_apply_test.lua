@@ -0,0 +1,153 @@
+local t = require('luatest')
+local server = require('luatest.server')
+local replica_set = require('luatest.replica_set')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.replica_set = replica_set:new({})
+    cg.master = cg.replica_set:build_and_add_server{
+        alias = 'master',
+        box_cfg = {
+            replication_timeout = 0.1,
+        },
+    }
+    cg.replica = cg.replica_set:build_and_add_server{
+        alias = 'replica',
+        box_cfg = {
+            replication_timeout = 0.1,
+            replication = server.build_listen_uri('master',
+                                                  cg.replica_set.id),
+        },
+    }
+    cg.replica_set:start()
+    cg.master:exec(function()
+        local s = box.schema.create_space('test_memtx')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+        s = box.schema.create_space('test_unique')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}})
+        s = box.schema.create_space('test_vinyl', {engine = 'vinyl'})
+        s:create_index('pk', {parts = {{1, 'string'}}})
+        s = box.schema.create_space('test_parent')
+        s:create_index('pk')
+        s = box.schema.create_space('test_child', {
+            format = {
+                {'id', 'unsigned'},
+                {'parent_id', 'unsigned',
+                 foreign_key = {space = 'test_parent', field = 'id'}},
+            },
+        })
+        s:create_index('pk')
+        s:create_index('parent', {parts = {'parent_id'}, unique = false})
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function()
+        require('internal.tweaks').applier_parallel_apply_fibers = 4
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+local function dump_spaces(server)
+    return server:exec(function()
+        local res = {}
+        for _, name in ipairs({'test_memtx', 'test_unique', 'test_vinyl',
+                               'test_parent', 'test_child'}) do
+            res[name] = box.space[name]:select({}, {fullscan = true})
+        end
+        return res
+    end)
+end
+
+--
+-- Independent transactions received in one batch are applied by several
+-- fibers, but the result must be the same as on sequential apply.
+--
+g.test_parallel_apply = function(cg)
+    local replication = cg.replica:exec(function()
+        local replication = box.cfg.replication
+        box.cfg{replication = {}}
+        return replication
+    end)
+    cg.master:exec(function()
+        local fiber = require('fiber')
+        local function load(id)
+            for i = 1, 200 do
+                local k = (id * 1000 + i) % 50
+                box.begin()
+                box.space.test_memtx:replace{k, i}
+                box.space.test_memtx:update(k, {{'+', 2, id}})
+                box.commit()
+                box.space.test_unique:replace{i, id * 1000 + i}
+                box.space.test_unique:delete(i - 1)
+                box.space.test_vinyl:upsert({'k' .. k, i}, {{'+', 2, 1}})
+                if i % 3 == 0 then
+                    box.space.test_vinyl:delete('k' .. (k + 1) % 50)
+                end
+                if i % 10 == 0 then
+                    fiber.yield()
+                end
+            end
+        end
+        local fibers = {}
+        for id = 1, 4 do
+            local f = fiber.new(load, id)
+            f:set_joinable(true)
+            table.insert(fibers, f)
+        end
+        for _, f in ipairs(fibers) do
+            f:join()
+        end
+    end)
+    cg.replica:exec(function(replication)
+        if box.error.injection ~= nil then
+            box.error.injection.set('ERRINJ_APPLIER_PARALLEL_LANES', 0)
+        end
+        box.cfg{replication = replication}
+    end, {replication})
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:assert_follows_upstream(cg.master:get_instance_id())
+    t.assert_equals(dump_spaces(cg.replica), dump_spaces(cg.master))
+    -- Check that transactions were actually applied concurrently.
+    cg.replica:exec(function()
+        if box.error.injection ~= nil then
+            t.assert_gt(box.error.injection.get(
+                'ERRINJ_APPLIER_PARALLEL_LANES'), 1)
+        end
+    end)
+end
+
+--
+-- Transactions modifying spaces linked by a foreign key must be applied
+-- in the master order, otherwise a child may be inserted before its
+-- parent or a parent may be deleted before its children.
+--
+g.test_foreign_key = function(cg)
+    local replication = cg.replica:exec(function()
+        local replication = box.cfg.replication
+        box.cfg{replication = {}}
+        return replication
+    end)
+    cg.master:exec(function()
+        local parent = box.space.test_parent
+        local child = box.space.test_child
+        for i = 1, 200 do
+            parent:insert{i}
+            child:insert{i, i}
+            child:delete(i)
+            parent:delete(i)
+            parent:insert{i}
+            child:insert{i, i}
+        end
+    end)
+    cg.replica:exec(function(replication)
+        box.cfg{replication = replication}
+    end, {replication})
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:assert_follows_upstream(cg.master:get_instance_id())
+    t.assert_equals(dump_spaces(cg.replica), dump_spaces(cg.master))
+end
@@ -0,0 +1,139 @@
+local t = require('luatest')
+local server = require('luatest.server')
+local replica_set = require('luatest.replica_set')
+
+local g = t.group()
+
+local REPLICA_COUNT = 3
+
+g.before_all(function(cg)
+    cg.replica_set = replica_set:new({})
+    cg.master = cg.replica_set:build_and_add_server{
+        alias = 'master',
+        box_cfg = {
+            replication_timeout = 0.1,
+        },
+    }
+    cg.replicas = {}
+    for i = 1, REPLICA_COUNT do
+        cg.replicas[i] = cg.replica_set:build_and_add_server{
+            alias = 'replica' .. i,
+            box_cfg = {
+                replication_timeout = 0.1,
+                replication = server.build_listen_uri('master',
+                                                      cg.replica_set.id),
+            },
+        }
+    end
+    cg.replica_set:start()
+    cg.master:exec(function()
+        require('internal.tweaks').xlog_tx_cache_size = 1024 * 1024
+        local s = box.schema.create_space('test')
+        s:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+--
+-- Relays catching up from the same xlogs share decoded transactions.
+-- The cache is small, so some transactions are evicted and read again.
+--
+g.test_catch_up = function(cg)
+    for _, replica in ipairs(cg.replicas) do
+        replica:stop()
+    end
+    cg.master:exec(function()
+        local s = box.space.test
+        for i = 1, 2000 do
+            box.begin()
+            for j = 1, 10 do
+                s:replace{i * 10 + j, string.rep('x', i % 100)}
+            end
+            box.commit()
+        end
+        -- Make some transactions span a new xlog file.
+        box.snapshot()
+        for i = 1, 100 do
+            s:delete{i * 10 + 1}
+        end
+    end)
+    for _, replica in ipairs(cg.replicas) do
+        replica:start({wait_until_ready = false})
+    end
+    local expected = cg.master:exec(function()
+        return box.space.test:select()
+    end)
+    for _, replica in ipairs(cg.replicas) do
+        replica:wait_until_ready()
+        replica:wait_for_vclock_of(cg.master)
+        replica:assert_follows_upstream(cg.master:get_instance_id())
+        t.assert_equals(replica:exec(function()
+            return box.space.test:select()
+        end), expected)
+    end
+end
+
+--
+-- Relays of caught-up replicas get the WAL tail from the cache filled
+-- by the WAL writer.
+--
+g.test_follow_tail = function(cg)
+    cg.master:exec(function()
+        local fiber = require('fiber')
+        local s = box.space.test
+        for i = 1, 500 do
+            s:replace{i, i}
+            if i % 50 == 0 then
+                fiber.sleep(0.01)
+            end
+        end
+        s:truncate()
+    end)
+    cg.master:exec(function()
+        local s = box.space.test
+        for i = 1, 200 do
+            s:replace{i, string.rep('y', i)}
+        end
+    end)
+    local expected = cg.master:exec(function()
+        return box.space.test:select()
+    end)
+    for _, replica in ipairs(cg.replicas) do
+        replica:wait_for_vclock_of(cg.master)
+        replica:assert_follows_upstream(cg.master:get_instance_id())
+        t.assert_equals(replica:exec(function()
+            return box.space.test:select()
+        end), expected)
+    end
+end
+
+--
+-- A failed WAL write doesn't leave anything in the cache.
+--
+g.test_follow_tail_write_error = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.master:exec(function()
+        local s = box.space.test
+        s:replace{1, 'before'}
+        box.error.injection.set('ERRINJ_WAL_WRITE_DISK', true)
+        t.assert_error_covers({
+            type = 'ClientError',
+            code = box.error.WAL_IO,
+        }, s.replace, s, {2, 'failed'})
+        box.error.injection.set('ERRINJ_WAL_WRITE_DISK', false)
+        s:replace{3, 'after'}
+    end)
+    local expected = cg.master:exec(function()
+        return box.space.test:select()
+    end)
+    for _, replica in ipairs(cg.replicas) do
+        replica:wait_for_vclock_of(cg.master)
+        replica:assert_follows_upstream(cg.master:get_instance_id())
+        t.assert_equals(replica:exec(function()
+            return box.space.test:select()
+        end), expected)
+    end
+end
@@ -0,0 +1,83 @@
+local t = require('luatest')
+local server = require('luatest.server')
+local replica_set = require('luatest.replica_set')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.replica_set = replica_set:new({})
+    cg.master = cg.replica_set:build_and_add_server{
+        alias = 'master',
+        box_cfg = {
+            replication_timeout = 0.1,
+        },
+    }
+    cg.replica = cg.replica_set:build_and_add_server{
+        alias = 'replica',
+        box_cfg = {
+            replication_timeout = 0.1,
+            replication = server.build_listen_uri('master',
+                                                  cg.replica_set.id),
+        },
+    }
+    cg.replica_set:start()
+    cg.master:exec(function()
+        local s = box.schema.create_space('test')
+        s:create_index('pk')
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+end)
+
+g.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+local function reconnect(replica, compression)
+    replica:exec(function(compression)
+        require('internal.tweaks').applier_stream_compression = compression
+        local replication = box.cfg.replication
+        box.cfg{replication = {}}
+        box.cfg{replication = replication}
+    end, {compression})
+end
+
+local function fill(master, count)
+    master:exec(function(count)
+        local s = box.space.test
+        for i = 1, count do
+            s:replace{i, string.rep('text ' .. i, 100)}
+        end
+    end, {count})
+end
+
+local function check(cg)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:assert_follows_upstream(cg.master:get_instance_id())
+    t.assert_equals(
+        cg.replica:exec(function() return box.space.test:select() end),
+        cg.master:exec(function() return box.space.test:select() end))
+end
+
+g.test_compression = function(cg)
+    reconnect(cg.replica, true)
+    t.helpers.retrying({}, function()
+        t.assert(cg.master:grep_log(
+            'replication stream compression requested'))
+    end)
+    -- Both the live stream and the catch-up from xlogs are compressed.
+    fill(cg.master, 1000)
+    check(cg)
+    cg.replica:exec(function()
+        box.cfg{replication = {}}
+    end)
+    fill(cg.master, 2000)
+    reconnect(cg.replica, true)
+    check(cg)
+    -- Compression can be turned off on reconnect.
+    reconnect(cg.replica, false)
+    cg.master:exec(function()
+        box.space.test:truncate()
+    end)
+    fill(cg.master, 100)
+    check(cg)
+end
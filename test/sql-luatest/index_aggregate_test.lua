@@ -0,0 +1,80 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({alias = 'index_aggregate'})
+    g.server:start()
+    g.server:exec(function()
+        box.execute([[CREATE TABLE t (id INT PRIMARY KEY, a INT, d DOUBLE,
+                                      s STRING, b BOOLEAN);]])
+        for id = 1, 10 do
+            box.execute([[INSERT INTO t VALUES (?, ?, ?, ?, ?);]],
+                        {id, id % 3, id + 0.5, 'v' .. id % 4, id % 2 == 0})
+        end
+        box.execute([[INSERT INTO t(id) VALUES (11);]])
+    end)
+end)
+
+g.after_all(function()
+    g.server:exec(function()
+        box.execute([[DROP TABLE t;]])
+    end)
+    g.server:stop()
+end)
+
+-- Simple aggregate queries are computed by the index.
+g.test_index_aggregate = function()
+    g.server:exec(function()
+        local function check(sql, rows)
+            local res, err = box.execute('EXPLAIN QUERY PLAN ' .. sql)
+            t.assert_equals(err, nil)
+            t.assert_equals(res.rows, {{0, 0, 0, 'INDEX AGGREGATE T'}})
+            res, err = box.execute(sql)
+            t.assert_equals(err, nil)
+            t.assert_equals(res.rows, rows)
+        end
+        check([[SELECT COUNT(*), COUNT(a), SUM(a), MIN(s), MAX(d) FROM t
+                WHERE a > 0 AND b = TRUE;]], {{4, 4, 6, 'v0', 10.5}})
+        check([[SELECT SUM(d), MIN(a), MAX(a) FROM t
+                WHERE 1 <= a AND s <> 'v1';]], {{33.5, 1, 2}})
+        check([[SELECT SUM(a), COUNT(s) FROM t;]], {{10, 10}})
+        check([[SELECT COUNT(*) FROM t WHERE d > 5;]], {{6}})
+        check([[SELECT COUNT(*), SUM(a), MIN(s) FROM t WHERE a = 100;]],
+              {{0, box.NULL, box.NULL}})
+    end)
+end
+
+-- Queries the index aggregate can't compute use the generic path.
+g.test_index_aggregate_fallback = function()
+    g.server:exec(function()
+        local function check(sql, rows)
+            local res, err = box.execute('EXPLAIN QUERY PLAN ' .. sql)
+            t.assert_equals(err, nil)
+            t.assert_not_equals(res.rows, {{0, 0, 0, 'INDEX AGGREGATE T'}})
+            res, err = box.execute(sql)
+            t.assert_equals(err, nil)
+            t.assert_equals(res.rows, rows)
+        end
+        check([[SELECT SUM(a) FROM t WHERE id > 5;]], {{4}})
+        check([[SELECT MAX(id) FROM t WHERE a > 0;]], {{10}})
+        check([[SELECT COUNT(DISTINCT a) FROM t;]], {{3}})
+        check([[SELECT SUM(a) + 1 FROM t;]], {{11}})
+        check([[SELECT SUM(a) FROM t WHERE a + 1 > 1;]], {{10}})
+        check([[SELECT SUM(a) FROM t WHERE a > 0 OR b;]], {{10}})
+        check([[SELECT SUM(a) FROM t HAVING SUM(a) > 100;]], {})
+    end)
+end
+
+g.test_index_aggregate_overflow = function()
+    g.server:exec(function()
+        box.execute([[CREATE TABLE t2 (id INT PRIMARY KEY, a INT);]])
+        box.execute([[INSERT INTO t2 VALUES (1, 9223372036854775807),
+                                            (2, 1);]])
+        local _, err = box.execute([[SELECT SUM(a) FROM t2;]])
+        t.assert_equals(err.message, "Failed to execute SQL statement: " ..
+                                     "integer is overflowed")
+        box.execute([[DROP TABLE t2;]])
+    end)
+end
@@ -696,6 +696,55 @@ loading_test()
 	ok(true, "loading test");
 }
 
+static void
+bulk_loading_test()
+{
+	plan(4);
+	header();
+
+	const type_t test_count = 1000;
+	const double fill_factors[] = {1, 0.9, 0.75, 0.5};
+	for (size_t k = 0; k < lengthof(fill_factors); k++) {
+		double fill_factor = fill_factors[k];
+		bool success = true;
+		for (type_t i = 0; i <= test_count; i++) {
+			test tree;
+			test_create(&tree, 0, &allocator, NULL);
+			struct test_builder builder;
+			test_build_begin(&tree, &builder, i, fill_factor);
+			for (type_t j = 0; j < i; j++) {
+				if (test_build_next(&builder, j * 2) != 0)
+					fail("building failed", "true");
+			}
+			test_build_end(&builder);
+			debug_check(&tree);
+
+			struct test_iterator iterator = test_first(&tree);
+			for (type_t j = 0; j < i; j++) {
+				type_t *v = test_iterator_get_elem(&tree,
+								   &iterator);
+				if (v == NULL || *v != j * 2)
+					success = false;
+				test_iterator_next(&tree, &iterator);
+			}
+			if (!test_iterator_is_invalid(&iterator))
+				success = false;
+
+			/* The tree must stay valid after modifications. */
+			for (type_t j = 0; j < i; j += 3)
+				test_insert(&tree, j * 2 + 1, NULL, NULL);
+			for (type_t j = 0; j < i; j += 5)
+				test_delete(&tree, j * 2, NULL);
+			debug_check(&tree);
+			test_destroy(&tree);
+		}
+		ok(success, "bulk loading with fill factor %.2f", fill_factor);
+	}
+
+	footer();
+	check_plan();
+}
+
 static void
 printing_test()
 {
@@ -1173,7 +1222,7 @@ gh_11979_head_view_changes_test()
 int
 main(void)
 {
-	plan(16);
+	plan(17);
 	header();
 
 	matras_allocator_create(&allocator, BPS_TREE_EXTENT_SIZE,
@@ -1184,6 +1233,7 @@ main(void)
 	compare_with_sptree_check_branches();
 	bps_tree_debug_self_check();
 	loading_test();
+	bulk_loading_test();
 	printing_test();
 	white_box_test();
 	approximate_count();
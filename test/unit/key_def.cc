@@ -84,7 +84,7 @@ test_tuple_new(const char *format, ...)
 }
 
 static struct key_def *
-test_key_def_new_va(const char *format, va_list ap, bool for_func_index)
+test_key_def_new_va(const char *format, va_list ap, unsigned flags)
 {
 	struct region *region = &fiber()->gc;
 	size_t region_svp = region_used(region);
@@ -109,8 +109,7 @@ test_key_def_new_va(const char *format, va_list ap, bool for_func_index)
 				     region) != 0);
 
 	/* Create a key def. */
-	struct key_def *def = key_def_new(part_def, part_count, for_func_index ?
-					  KEY_DEF_FOR_FUNC_INDEX : 0);
+	struct key_def *def = key_def_new(part_def, part_count, flags);
 	fail_if(def == NULL);
 	key_def_update_optionality(def, 0);
 
@@ -124,8 +123,7 @@ test_key_def_new(const char *format, ...)
 {
 	va_list ap;
 	va_start(ap, format);
-	struct key_def *def = test_key_def_new_va(format, ap,
-						  /*for_func_index=*/false);
+	struct key_def *def = test_key_def_new_va(format, ap, /*flags=*/0);
 	va_end(ap);
 	return def;
 }
@@ -137,7 +135,19 @@ test_key_def_new_func(const char *format, ...)
 	va_list ap;
 	va_start(ap, format);
 	struct key_def *def = test_key_def_new_va(format, ap,
-						  /*for_func_index=*/true);
+						  KEY_DEF_FOR_FUNC_INDEX);
+	va_end(ap);
+	return def;
+}
+
+/** Creates a key_def with prefix hints from a MsgPack format. */
+static struct key_def *
+test_key_def_new_prefix_hint(const char *format, ...)
+{
+	va_list ap;
+	va_start(ap, format);
+	struct key_def *def = test_key_def_new_va(format, ap,
+						  KEY_DEF_PREFIX_HINT);
 	va_end(ap);
 	return def;
 }
@@ -1398,10 +1408,103 @@ test_key_def_find_by_fieldno(void)
 	check_plan();
 }
 
+/**
+ * Checks that prefix hints built from all key parts agree with the key
+ * order both for tuples and for full and partial keys.
+ */
+static void
+test_prefix_hint(void)
+{
+	plan(3);
+	header();
+
+	struct key_def *def = test_key_def_new_prefix_hint(
+		"[{%s%u%s%s}{%s%u%s%s}{%s%u%s%s}]",
+		"field", 0, "type", "integer",
+		"field", 1, "type", "string",
+		"field", 2, "type", "unsigned");
+	fail_unless(def->has_prefix_hint);
+
+	/* Sorted in ascending order. */
+	std::vector<struct tuple *> tuples = {
+		test_tuple_new("[%lld%s%u]", -70000LL, "zz", 1),
+		test_tuple_new("[%lld%s%u]", -300LL, "", 0),
+		test_tuple_new("[%lld%s%u]", -300LL, "a", 5),
+		test_tuple_new("[%lld%s%u]", -256LL, "a", 5),
+		test_tuple_new("[%lld%s%u]", -255LL, "", 0),
+		test_tuple_new("[%lld%s%u]", -2LL, "abc", 1),
+		test_tuple_new("[%lld%s%u]", -1LL, "", 0),
+		test_tuple_new("[%lld%s%u]", 0LL, "", 0),
+		test_tuple_new("[%lld%s%u]", 0LL, "", 300),
+		test_tuple_new("[%lld%s%u]", 0LL, "a", 0),
+		test_tuple_new("[%lld%s%u]", 0LL, "a", 1),
+		test_tuple_new("[%lld%s%u]", 0LL, "ab", 0),
+		test_tuple_new("[%lld%s%u]", 0LL, "abcdefghij", 0),
+		test_tuple_new("[%lld%s%u]", 0LL, "abcdefghij", 7),
+		test_tuple_new("[%lld%s%u]", 0LL, "abcdefghik", 0),
+		test_tuple_new("[%lld%s%u]", 1LL, "x", 0),
+		test_tuple_new("[%lld%s%u]", 255LL, "", 3),
+		test_tuple_new("[%lld%s%u]", 256LL, "", 0),
+		test_tuple_new("[%lld%s%u]", 70000LL, "zz", 2),
+		test_tuple_new("[%lld%s%u]", 1LL << 40, "a", 0),
+		test_tuple_new("[%lld%s%u]", INT64_MAX, "", 0),
+	};
+
+	bool tuples_ok = true;
+	bool hints_ok = true;
+	for (size_t i = 0; i < tuples.size(); i++) {
+		hint_t hint_i = tuple_hint(tuples[i], def);
+		for (size_t j = 0; j < tuples.size(); j++) {
+			hint_t hint_j = tuple_hint(tuples[j], def);
+			int expected = i < j ? -1 : i > j ? 1 : 0;
+			int rc = tuple_compare(tuples[i], hint_i,
+					       tuples[j], hint_j, def);
+			if ((rc > 0) - (rc < 0) != expected)
+				tuples_ok = false;
+			if (i < j && hint_i > hint_j)
+				hints_ok = false;
+		}
+	}
+	ok(tuples_ok, "tuple_compare with prefix hints");
+	ok(hints_ok, "prefix hints are monotonic");
+
+	bool keys_ok = true;
+	size_t region_svp = region_used(&fiber()->gc);
+	for (size_t i = 0; i < tuples.size(); i++) {
+		const char *key = tuple_extract_key(tuples[i], def,
+						    MULTIKEY_NONE, NULL);
+		uint32_t part_count = mp_decode_array(&key);
+		for (uint32_t n = 1; n <= part_count; n++) {
+			hint_t key_h = key_hint(key, n, def);
+			for (size_t j = 0; j < tuples.size(); j++) {
+				struct tuple *tuple = tuples[j];
+				int expected = tuple_compare_with_key(
+					tuple, HINT_NONE, key, n,
+					HINT_NONE, def);
+				int rc = tuple_compare_with_key(
+					tuple, tuple_hint(tuple, def),
+					key, n, key_h, def);
+				if ((rc > 0) - (rc < 0) !=
+				    (expected > 0) - (expected < 0))
+					keys_ok = false;
+			}
+		}
+	}
+	region_truncate(&fiber()->gc, region_svp);
+	ok(keys_ok, "tuple_compare_with_key with prefix hints");
+
+	for (size_t i = 0; i < tuples.size(); i++)
+		tuple_delete(tuples[i]);
+	key_def_delete(def);
+
+	footer();
+	check_plan();
+}
+
 static int
 test_main(void)
 {
-	plan(51);
+	plan(52);
 	header();
 
 	test_func_compare();
@@ -1455,6 +1558,7 @@ test_main(void)
 	test_key_compare_singlepart(false, true);
 	test_key_compare_singlepart(false, false);
 	test_key_def_find_by_fieldno();
+	test_prefix_hint();
 
 	footer();
 	return check_plan();
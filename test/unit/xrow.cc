@@ -568,6 +568,31 @@ test_xrow_decode_synchro_types(void)
 	footer();
 }
 
+static void
+test_xrow_subscribe_is_compressed(void)
+{
+	header();
+	plan(4);
+
+	struct subscribe_request req;
+	memset(&req, 0, sizeof(req));
+	vclock_create(&req.vclock);
+	struct xrow_header row;
+	struct subscribe_request dec;
+	for (int i = 0; i < 2; i++) {
+		req.is_compressed = i == 1;
+		xrow_encode_subscribe(&row, &req);
+		is(xrow_decode_subscribe(&row, &dec), 0,
+		   "xrow_decode_subscribe");
+		is(dec.is_compressed, req.is_compressed,
+		   "IPROTO_IS_COMPRESSED is %s", i == 1 ? "set" : "not set");
+	}
+	region_free(&fiber()->gc);
+
+	check_plan();
+	footer();
+}
+
 static void
 test_xrow_decode_error_1(void)
 {
@@ -797,7 +822,7 @@ main(void)
 	memory_init();
 	fiber_init(fiber_c_invoke);
 	header();
-	plan(13);
+	plan(14);
 
 	random_init();
 
@@ -815,6 +840,7 @@ main(void)
 	test_xrow_decode_error_gh_9098();
 	test_xrow_decode_error_gh_9136();
 	test_xrow_decode_synchro_types();
+	test_xrow_subscribe_is_compressed();
 
 	random_free();
 	fiber_free();
@@ -0,0 +1,93 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_options = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        t.assert_error_msg_equals(
+            "Wrong index options: compaction_strategy must be either " ..
+            "'tiered' or 'leveled'",
+            s.create_index, s, 'pk', {compaction_strategy = 'foo'})
+        t.assert_error_msg_contains(
+            "options parameter 'compaction_strategy' should be of " ..
+            "type string",
+            s.create_index, s, 'pk', {compaction_strategy = 1})
+
+        local pk = s:create_index('pk')
+        t.assert_equals(pk.options.compaction_strategy, nil)
+        pk:alter({compaction_strategy = 'leveled'})
+        t.assert_equals(pk.options.compaction_strategy, 'leveled')
+        pk:alter({compaction_strategy = 'tiered'})
+        t.assert_equals(pk.options.compaction_strategy, nil)
+    end)
+end
+
+g.test_compaction = function(cg)
+    cg.server:exec(function()
+        -- Returns the number of runs left after the first compaction
+        -- of a range that stores a big run and a few small ones.
+        local function run_count_after_compaction(strategy)
+            local s = box.schema.space.create('test', {engine = 'vinyl'})
+            local pk = s:create_index('pk', {
+                compaction_strategy = strategy,
+                run_count_per_level = 2,
+            })
+            for i = 1, 10000 do
+                s:insert({i, i})
+            end
+            box.snapshot()
+            t.assert_equals(pk:stat().run_count, 1)
+            local i = 0
+            while pk:stat().disk.compaction.count == 0 do
+                i = i + 1
+                s:replace({i, -i})
+                box.snapshot()
+                t.helpers.retrying({}, function()
+                    t.assert_equals(pk:stat().disk.compaction.queue.rows, 0)
+                end)
+            end
+            t.assert_equals(s:count(), 10000)
+            for j = 1, 10000 do
+                t.assert_equals(s:get(j), {j, j <= i and -j or j})
+            end
+            local run_count = pk:stat().run_count
+            s:drop()
+            return run_count
+        end
+        -- Small runs are merged into a new run on top of the big one.
+        t.assert_equals(run_count_after_compaction('tiered'), 2)
+        -- Small runs are merged with the big one.
+        t.assert_equals(run_count_after_compaction('leveled'), 1)
+    end)
+end
+
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {compaction_strategy = 'leveled'})
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        t.assert_equals(box.space.test.index.pk.options.compaction_strategy,
+                        'leveled')
+    end)
+end
@@ -0,0 +1,101 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {
+            -- Disable the tuple cache to force reads from disk.
+            vinyl_cache = 0,
+            vinyl_page_cache = 1024 * 1024,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+        box.cfg{vinyl_page_cache = 1024 * 1024}
+    end)
+end)
+
+g.test_page_cache = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {page_size = 1024})
+        for i = 1, 1000 do
+            s:insert({i, string.rep('x', 100)})
+        end
+        box.snapshot()
+
+        local function stat()
+            local st = box.stat.vinyl()
+            return {
+                hit = st.page_cache.hit,
+                miss = st.page_cache.miss,
+                evict = st.page_cache.evict,
+                mem_used = st.memory.page_cache,
+                pages_read = s.index.pk:stat().disk.iterator.read.pages,
+            }
+        end
+
+        box.stat.reset()
+        t.assert_equals(s:get(500), {500, string.rep('x', 100)})
+        local st = stat()
+        t.assert_equals(st.hit, 0)
+        t.assert_equals(st.miss, 1)
+        t.assert_equals(st.pages_read, 1)
+        t.assert_gt(st.mem_used, 0)
+
+        -- The second lookup is served from the page cache.
+        t.assert_equals(s:get(500), {500, string.rep('x', 100)})
+        st = stat()
+        t.assert_equals(st.hit, 1)
+        t.assert_equals(st.miss, 1)
+        t.assert_equals(st.pages_read, 1)
+
+        -- Full scan reads all the pages and evicts some of them.
+        box.cfg{vinyl_page_cache = 16 * 1024}
+        t.assert_le(box.stat.vinyl().memory.page_cache, 16 * 1024)
+        t.assert_equals(#s:select(), 1000)
+        st = stat()
+        t.assert_gt(st.evict, 0)
+        t.assert_le(st.mem_used, 16 * 1024)
+
+        -- The page accessed twice survives the scan.
+        local hit = st.hit
+        t.assert_equals(s:get(500), {500, string.rep('x', 100)})
+        t.assert_equals(stat().hit, hit + 1)
+
+        -- Compaction invalidates the pages of the deleted run.
+        for i = 1, 1000, 10 do
+            s:replace({i, string.rep('y', 100)})
+        end
+        box.snapshot()
+        s.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().run_count, 1)
+        end)
+        t.assert_equals(s:get(501), {501, string.rep('y', 100)})
+        t.assert_equals(s:get(500), {500, string.rep('x', 100)})
+
+        -- Zero quota disables the cache.
+        box.cfg{vinyl_page_cache = 0}
+        t.assert_equals(box.stat.vinyl().memory.page_cache, 0)
+        box.stat.reset()
+        t.assert_equals(s:get(500), {500, string.rep('x', 100)})
+        t.assert_equals(s:get(500), {500, string.rep('x', 100)})
+        st = stat()
+        t.assert_equals(st.hit, 0)
+        t.assert_equals(st.miss, 0)
+        t.assert_equals(st.pages_read, 2)
+    end)
+end
@@ -0,0 +1,100 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {
+            vinyl_write_threads = 8,
+            vinyl_max_subcompactions = 4,
+            log_level = 'verbose',
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+        box.cfg{vinyl_max_subcompactions = 4}
+    end)
+end)
+
+g.test_invalid_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'vinyl_max_subcompactions': " ..
+            "must be greater than or equal to 1",
+            box.cfg, {vinyl_max_subcompactions = 0})
+    end)
+end
+
+g.test_subcompaction = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {range_size = 64 * 1024, page_size = 1024,
+                              run_count_per_level = 100})
+        -- Write a few overlapping runs so that the range exceeds
+        -- range_size only after compaction is scheduled.
+        for run = 1, 3 do
+            box.begin()
+            for i = 1, 2000 do
+                s:replace({i, run, string.rep('x', 100)})
+            end
+            box.commit()
+            box.snapshot()
+        end
+        t.assert_equals(s.index.pk:stat().range_count, 1)
+        t.assert_equals(s.index.pk:stat().run_count, 3)
+
+        s.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().disk.compaction.queue.rows, 0)
+            t.assert_equals(s.index.pk:stat().run_count,
+                            s.index.pk:stat().range_count)
+        end)
+        t.assert_gt(s.index.pk:stat().range_count, 1)
+
+        t.assert_equals(s:count(), 2000)
+        for _, tuple in s:pairs() do
+            t.assert_equals(tuple[2], 3)
+        end
+    end)
+    t.assert(cg.server:grep_log('in %d parts'))
+
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_gt(s.index.pk:stat().range_count, 1)
+        t.assert_equals(s:count(), 2000)
+        t.assert_equals(s:get(1000), {1000, 3, string.rep('x', 100)})
+    end)
+end
+
+g.test_disabled = function(cg)
+    cg.server:exec(function()
+        box.cfg{vinyl_max_subcompactions = 1}
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {range_size = 64 * 1024, page_size = 1024,
+                              run_count_per_level = 100})
+        for run = 1, 3 do
+            for i = 1, 2000 do
+                s:replace({i, run, string.rep('x', 100)})
+            end
+            box.snapshot()
+        end
+        s.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().run_count,
+                            s.index.pk:stat().range_count)
+        end)
+        t.assert_equals(s:count(), 2000)
+    end)
+end
@@ -0,0 +1,220 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {
+            -- Disable the tuple cache to force reads from disk.
+            vinyl_cache = 0,
+            -- Make each snapshot trigger garbage collection.
+            checkpoint_count = 1,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+            box.snapshot()
+        end
+    end)
+end)
+
+g.test_invalid_option = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_contains(
+            "Illegal parameters, options parameter 'value_log_threshold' " ..
+            "should be of type number",
+            box.schema.space.create, 'test',
+            {engine = 'vinyl', value_log_threshold = 'foo'})
+    end)
+end
+
+g.test_immutable = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {
+            engine = 'vinyl', value_log_threshold = 100,
+        })
+        t.assert_equals(s.value_log_threshold, 100)
+        s:create_index('pk')
+        local flags = box.space._space:get(s.id).flags
+        flags.value_log_threshold = 200
+        t.assert_error_msg_equals(
+            "Can't modify space 'test': value_log_threshold is immutable",
+            box.space._space.update, box.space._space, s.id,
+            {{'=', 'flags', flags}})
+        t.assert_equals(s.value_log_threshold, 100)
+    end)
+end
+
+g.test_value_log = function(cg)
+    cg.server:exec(function()
+        local fio = require('fio')
+
+        local s = box.schema.space.create('test', {
+            engine = 'vinyl', value_log_threshold = 100,
+        })
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'string'}})
+
+        local function value(i, c)
+            return string.rep(c or 'x', 1000) .. i
+        end
+
+        for i = 1, 100 do
+            s:insert({i, 'key' .. i, value(i), 'small'})
+        end
+        box.snapshot()
+
+        local dir = fio.pathjoin(box.cfg.vinyl_dir, s.id, 0)
+        t.assert_equals(#fio.glob(fio.pathjoin(dir, '*.vlog')), 1)
+        -- Secondary indexes never have value logs.
+        dir = fio.pathjoin(box.cfg.vinyl_dir, s.id, 1)
+        t.assert_equals(#fio.glob(fio.pathjoin(dir, '*.vlog')), 0)
+        -- Big values aren't stored in the run file.
+        t.assert_lt(s.index.pk:stat().disk.bytes, 100 * 1000)
+
+        for i = 1, 100 do
+            t.assert_equals(s:get(i), {i, 'key' .. i, value(i), 'small'})
+        end
+        t.assert_equals(s.index.sk:get('key50'),
+                        {50, 'key50', value(50), 'small'})
+        t.assert_equals(#s:select(), 100)
+
+        -- UPDATE and UPSERT work on values stored in the value log.
+        s:update(10, {{'=', 4, 'updated'}})
+        s:upsert({20, 'key20', 'foo'}, {{'=', 3, value(20, 'y')}})
+        s:replace({30, 'key30', value(30, 'z'), 'replaced'})
+        box.snapshot()
+        t.assert_equals(s:get(10), {10, 'key10', value(10), 'updated'})
+        t.assert_equals(s:get(20), {20, 'key20', value(20, 'y'), 'small'})
+        t.assert_equals(s:get(30), {30, 'key30', value(30, 'z'), 'replaced'})
+
+        -- Compaction keeps the data readable and removes value logs
+        -- that aren't referenced any more.
+        s.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().run_count, 1)
+        end)
+        for i = 1, 100 do
+            t.assert_equals(s:get(i)[3], value(i, i == 20 and 'y' or
+                                                  i == 30 and 'z' or nil))
+        end
+        box.snapshot()
+        dir = fio.pathjoin(box.cfg.vinyl_dir, s.id, 0)
+        t.helpers.retrying({}, function()
+            t.assert_equals(#fio.glob(fio.pathjoin(dir, '*.run')), 1)
+        end)
+        t.assert_le(#fio.glob(fio.pathjoin(dir, '*.vlog')), 2)
+    end)
+end
+
+--
+-- Values are read only for statements returned to the user and the read
+-- statistics account them.
+--
+g.test_value_log_read = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {
+            engine = 'vinyl', value_log_threshold = 100,
+        })
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i, string.rep('x', 10000)})
+        end
+        box.snapshot()
+        local function read_bytes()
+            return s.index.pk:stat().disk.iterator.read.bytes
+        end
+        -- Load the page.
+        t.assert_equals(s:get(1), {1, string.rep('x', 10000)})
+        local bytes = read_bytes()
+        t.assert_equals(s:get(2), {2, string.rep('x', 10000)})
+        -- Only the value of the returned tuple is read.
+        t.assert_ge(read_bytes() - bytes, 10000)
+        t.assert_lt(read_bytes() - bytes, 20000)
+    end)
+end
+
+--
+-- A value log is deleted after the range it was written for has been
+-- compacted by major compaction twice, see vy_value_log.h.
+--
+g.test_value_log_gc = function(cg)
+    cg.server:exec(function()
+        local fio = require('fio')
+        local s = box.schema.space.create('test', {
+            engine = 'vinyl', value_log_threshold = 100,
+        })
+        s:create_index('pk')
+        local dir = fio.pathjoin(box.cfg.vinyl_dir, s.id, 0)
+        local function vlogs()
+            local files = fio.glob(fio.pathjoin(dir, '*.vlog'))
+            table.sort(files)
+            return files
+        end
+        local function fill(c, count)
+            for i = 1, count do
+                s:replace({i, string.rep(c, 1000)})
+            end
+            box.snapshot()
+        end
+        local function compact()
+            s.index.pk:compact()
+            t.helpers.retrying({}, function()
+                t.assert_equals(s.index.pk:stat().run_count, 1)
+            end)
+            box.snapshot()
+        end
+
+        fill('a', 100)
+        local old = vlogs()
+        t.assert_equals(#old, 1)
+        fill('b', 50)
+        -- The first major compaction doesn't copy any values so
+        -- the new run still references the first value log.
+        compact()
+        t.assert(fio.path.exists(old[1]))
+        fill('c', 10)
+        -- The second one copies the values that are still alive so
+        -- the first value log is deleted.
+        compact()
+        t.helpers.retrying({}, function()
+            t.assert_not(fio.path.exists(old[1]))
+        end)
+        t.assert_le(#vlogs(), 2)
+        for i = 1, 100 do
+            local c = i <= 10 and 'c' or i <= 50 and 'b' or 'a'
+            t.assert_equals(s:get(i), {i, string.rep(c, 1000)})
+        end
+    end)
+end
+
+g.test_value_log_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {
+            engine = 'vinyl', value_log_threshold = 100,
+        })
+        s:create_index('pk')
+        for i = 1, 10 do
+            s:insert({i, string.rep('x', 1000)})
+        end
+        box.snapshot()
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s.value_log_threshold, 100)
+        for i = 1, 10 do
+            t.assert_equals(s:get(i), {i, string.rep('x', 1000)})
+        end
+    end)
+end
@@ -93,6 +93,8 @@ function gstat()
     st.scheduler.dump_time = nil
     st.scheduler.compaction_time = nil
     st.memory.level0 = nil
+    st.memory.page_cache = nil
+    st.page_cache = nil
     return st
 end;
 